@@ -0,0 +1,135 @@
+#ifndef _FB_COMPRESS_H_
+#define _FB_COMPRESS_H_
+
+#include <stdio.h>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+#include "ifbslib_outsink.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//  Compressed save files (.fbd.gz, .fbd.zst)
+//
+//  IfbsCompressWriter takes the text of a save (e.g. as callback of an
+//  IfbsOutSink) and hands it to a thread that compresses it and writes the
+//  file, so compression runs while the KS walk goes on. At most
+//  IFBS_COMPRESS_QUEUE pieces are outstanding, then put() waits. The thread
+//  starts with the first data. pause() joins it before a fork(), the next
+//  put() starts it again.
+//
+//  IfbsInFile reads a plain, gzip or zstd file. The format is taken from
+//  the first bytes of the file, so the name doesn't matter on reading.
+//  The scanner reads compressed text through it in pieces (YY_INPUT and
+//  fb_parser_readstream), only a compressed .fbb is read into memory.
+//
+//  gzip needs zlib (IFBS_HAVE_ZLIB), zstd needs libzstd (IFBS_HAVE_ZSTD).
+//  Without the library a compressed file gives KS_ERR_NOTIMPLEMENTED.
+///////////////////////////////////////////////////////////////////////////////
+
+// Compression of a save file
+#define IFBS_COMPRESS_NONE  0
+#define IFBS_COMPRESS_GZIP  1
+#define IFBS_COMPRESS_ZSTD  2
+
+// Compression by the extension of the file name (".gz", ".zst")
+int         IFBS_CompressionFromName(const char *filename);
+// Extension of the compression (".gz", ".zst" or "")
+const char* IFBS_CompressionExt(int method);
+// 1 if the library of the compression is built in
+int         IFBS_CompressionAvailable(int method);
+
+class IfbsCompressWriter {
+public :
+    IfbsCompressWriter();
+    ~IfbsCompressWriter() { close(); }
+
+    // Create the file. The compressor thread starts on the first put()
+    KS_RESULT   open(const char *filename, int method);
+    // Copy data into the queue of the thread. Returns 0 if taken
+    int         put(const char *data, size_t len);
+    // Compress the queued data and end the thread, e.g. before fork().
+    // Returns the first error
+    KS_RESULT   pause();
+    // Callback for IfbsOutSink, pUser is the writer
+    static int  sinkFnc(void *pUser, const char *data, size_t len);
+    // End the stream, wait for the thread and close the file. Returns the
+    // first error of compression or writing
+    KS_RESULT   close();
+
+private :
+    void        run();
+    KS_RESULT   compress(const char *data, size_t len, int last);
+    KS_RESULT   writeOut(const char *data, size_t len);
+
+    int                              fd;
+    int                              method;
+    void                            *pStream;   // z_stream bzw. ZSTD_CCtx
+    std::vector<char>                out;       // Ausgabe des Kompressors
+    std::thread                     *worker;
+    std::mutex                       lock;
+    std::condition_variable          cond;
+    std::deque< std::vector<char> >  queue;     // Volle Buffer fuer den Thread
+    std::vector< std::vector<char> > spare;     // Wiederverwendbare Buffer
+    bool                             finish;    // Merker : keine Daten mehr
+    bool                             pausing;   // Merker : Thread beenden, Strom offen
+    KS_RESULT                        err;
+};
+
+// Output file of a save. Compressed in a thread if the name ends in .gz
+// or .zst, else written directly
+class IfbsOutFile {
+public :
+    IfbsOutFile() : fd(-1), pSink(0) {}
+    ~IfbsOutFile() { close(); }
+
+    // binary : no newline conversion (.fbb). Returns KS_ERR_OK,
+    // KS_ERR_BADPATH or KS_ERR_NOTIMPLEMENTED
+    KS_RESULT       open(const char *filename, int binary = 0);
+    // Sink of the open file
+    IfbsOutSink&    sink() { return *pSink; }
+    // End the compressor thread until the next data, e.g. before fork().
+    // Text still in the sink stays there
+    KS_RESULT       pause() { return Zip.pause(); }
+    // Flush the sink, end the compression and close the file. Returns
+    // the first write error
+    KS_RESULT       close();
+
+private :
+    int                  fd;
+    IfbsCompressWriter   Zip;
+    IfbsOutSink         *pSink;
+};
+
+class IfbsInFile {
+public :
+    IfbsInFile();
+    ~IfbsInFile() { close(); }
+
+    // Open the file and detect the compression. Returns KS_ERR_OK,
+    // OV_ERR_CANTOPENFILE or KS_ERR_NOTIMPLEMENTED
+    KS_RESULT   open(const char *filename);
+    void        close();
+    // Read up to len bytes of text. Returns the number of bytes, 0 at the
+    // end of the file, -1 on a read error or bad compressed data
+    long        read(char *buf, size_t len);
+
+    int         getCompression() { return method; }
+    bool        isOpen() { return fp != 0; }
+
+private :
+    long        readRaw(char *buf, size_t len);
+
+    FILE                *fp;
+    int                  method;
+    void                *pStream;  // z_stream bzw. ZSTD_DCtx
+    std::vector<char>    in;       // Komprimierte Eingabe
+    size_t               inPos;
+    size_t               inLen;
+    int                  inEof;
+    int                  streamEnd;
+};
+
+#endif
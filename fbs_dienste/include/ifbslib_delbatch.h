@@ -0,0 +1,73 @@
+#ifndef _FB_DELBATCH_H_
+#define _FB_DELBATCH_H_
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+#include "ks/string.h"
+#include "ks/client.h"
+
+/* Stages of the delete order */
+#define IFBS_DEL_CONNECTION     0
+#define IFBS_DEL_INSTANCE       1
+#define IFBS_DEL_CONTAINER      2
+#define IFBS_DEL_LIBRARY        3
+#define IFBS_DEL_STAGES         4
+
+///////////////////////////////////////////////////////////////////////////////
+//  Bulk delete of objects
+//
+//  Links to other objects (xlinks) are removed first with KS_UNLINK, then
+//  the objects are deleted with KS_DELETEOBJECT in requests of up to
+//  batchSize paths : connections, instances, containers, libraries. Within
+//  a stage the order of addObject is kept, so children have to be added
+//  before their parents. Objects the server rejected are sent again as long
+//  as a round deletes at least one object. Parts are not deleted (they go
+//  with their owner).
+///////////////////////////////////////////////////////////////////////////////
+
+class IfbsDeleteBatch {
+public :
+    // batchSize = 0 : IFBS_GetDeleteBatchSize()
+    IfbsDeleteBatch(KscServerBase *Server, size_t batchSize = 0);
+    ~IfbsDeleteBatch() {}
+
+    // Object to delete. what : name in the log ("Instance", "Library")
+    void        addObject(const char *path, int stage, const char *what = "Instance");
+    // Read the link variables of the object, unlink all elements in run()
+    KS_RESULT   addXlinks(const char *path);
+    void        addUnlink(const char *link_path, const char *elem_path);
+
+    // Unlink and delete. Returns the error of the last object not deleted
+    KS_RESULT   run(PltString *Logging);
+    // Only the queued unlinks. Returns the last error
+    KS_RESULT   unlinkAll();
+
+    // First object not deleted by run(), "" = none
+    const char* getFailed() { return failed.c_str(); }
+    size_t      getRequests() { return requests; }
+
+    static int  isPart(const char *path);
+
+private :
+    struct Item {
+        std::string  path;
+        int          stage;
+        const char  *what;
+    };
+
+    KscServerBase              *Server;
+    size_t                      batchSize;
+    size_t                      requests;
+    std::vector<Item>           items;
+    std::unordered_set<std::string>  added;
+    std::vector<std::string>    linkPath;
+    std::vector<std::string>    elemPath;
+    std::string                 failed;
+
+    size_t      deleteChunk(std::vector<size_t> &chunk, std::vector<KS_RESULT> &errs,
+                            std::vector<size_t> &rejected, PltString *Logging);
+};
+
+#endif
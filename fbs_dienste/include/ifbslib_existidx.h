@@ -0,0 +1,50 @@
+#ifndef _FB_EXISTIDX_H_
+#define _FB_EXISTIDX_H_
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "ks/string.h"
+#include "ks/client.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//  Existence index of the objects in the DB
+//
+//  A container is listed once with getEP (children and parts with their
+//  class). Key is the full path of the object, children with '/' and parts
+//  with '.', so an existence check is a lookup in memory. Objects created
+//  by the loader are added, their children are not read again (reread = 1
+//  reads the container once more, e.g. after KS_ERR_ALREADYEXISTS). A
+//  worker process of the loader records its created objects in a journal,
+//  the parent replays it into its own index.
+///////////////////////////////////////////////////////////////////////////////
+
+class IfbsExistIndex {
+public :
+    IfbsExistIndex() : journal(0) {}
+    ~IfbsExistIndex() {}
+
+    // Object in DB? instClass = 0 : any class
+    int         exists(KscServerBase *Server, const char *path,
+                       const char *instClass = 0, int reread = 0);
+    // Object created by the loader. empty = 0 : the object gets children
+    // on creation (library), they are read on demand
+    void        setCreated(const char *path, const char *instClass, int empty = 1);
+    // Forget all objects
+    void        clear();
+
+    // Record setCreated in a journal (0 = off) and replay a journal
+    void        setJournal(std::string *pJournal) { journal = pJournal; }
+    void        replay(const char *data, size_t len);
+
+private :
+    static size_t parentLen(const char *path);
+    void          listContainer(KscServerBase *Server, const std::string &container);
+
+    std::unordered_set<std::string>                listed;
+    std::unordered_map<std::string, std::string>   objects;    // path -> class
+    std::string                                   *journal;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef _FB_FBBWRITER_H_
+#define _FB_FBBWRITER_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "par_param.h"
+#include "ifbslib_outsink.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//  Writer of a binary save file (.fbb, see ifb_fbbfile.cpp)
+//
+//  begin() writes the file magic, add() appends the libraries, instances
+//  and links of a parsed piece as blocks, finish() writes the string table,
+//  the block index and the footer. The structures passed to add() may be
+//  freed afterwards (names are copied into the string table), so a save
+//  can be written block by block. Memory depends on the distinct names and
+//  the number of blocks, not on the values.
+///////////////////////////////////////////////////////////////////////////////
+
+class IfbsFbbWriter {
+public :
+    IfbsFbbWriter(IfbsOutSink &Sink) : Sink(Sink), pos(0), anzBlocks(0) {}
+    ~IfbsFbbWriter() {}
+
+    void                begin();
+    void                add(Dienst_param *par);
+    KS_RESULT           finish();
+
+    // begin(), add(par), finish()
+    KS_RESULT           write(Dienst_param *par);
+
+private :
+    unsigned long       str(const char *s);
+    void                putStr(const char *s);
+    void                putVariable(Variables *pv);
+    void                putValue(Variables *pv);
+    void                endBlock(int kind, size_t start);
+    void                flush();
+
+    IfbsOutSink                                     &Sink;
+    std::string                                      buf;       // Noch nicht geschriebene Bytes
+    unsigned long long                               pos;       // Position von buf in der Datei
+    std::unordered_map<std::string, unsigned long>   strIdx;
+    std::vector<const char*>                         strs;      // Schluessel in strIdx
+    std::string                                      index;
+    unsigned long                                    anzBlocks;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef _FB_FBDREADER_H_
+#define _FB_FBDREADER_H_
+
+#include <stdio.h>
+#include <vector>
+
+#include "par_param.h"
+#include "ifbslib_compress.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//  Sequential reader of the blocks of a save file
+//
+//  The file is read in pieces of IFBS_FBDREAD_BUFSIZE bytes, compressed
+//  files (gzip, zstd) are decompressed on the fly. next() returns
+//  the kind of the next LIBRARY, INSTANCE or LINK block (with comments in
+//  front of it) and keeps a copy of its text until the following call.
+//  parse() parses this copy into a reused session, so memory depends on
+//  the size of a block, not of the file.
+//
+//  Without a file (openText) the text is pushed with feed(), e.g. from the
+//  callback of an output sink. next() returns IFBS_FBDREAD_MORE until a
+//  block is complete, finish() marks the end of the text.
+///////////////////////////////////////////////////////////////////////////////
+
+class IfbsFbdReader {
+public :
+    IfbsFbdReader();
+    ~IfbsFbdReader() { close(); }
+
+    int         open(const char *filename);
+    void        openText();
+    void        close();
+
+    // Text for openText()
+    void        feed(const char *text, size_t len);
+    void        finish();
+
+    // FB_BLOCK_INSTANCE, FB_BLOCK_LINK, FB_BLOCK_LIBRARY, FB_BLOCK_NONE at
+    // the end of the file, -1 on a read error or an incomplete block
+    int         next();
+    // Parse the current block. Structures of the previous block in ctx
+    // are freed. Returns EXIT_SUCCESS or EXIT_FAILURE
+    int         parse(FB_PARSE_CONTEXT *ctx);
+
+    const char* getText() { return &block[0]; }
+    int         getLine() { return blockLine; }
+
+private :
+    int         fill();
+    void        discard();
+    size_t      matchBlockEnd(size_t i);
+    size_t      skipSpace(size_t start, size_t end);
+    int         blockKind(size_t start, size_t end);
+
+    IfbsInFile           file;
+    std::vector<char>    buf;
+    size_t               len;       // Gelesene Bytes in buf
+    size_t               pos;       // Beginn des naechsten Blocks
+    size_t               scan;      // Bis hier ist buf untersucht
+    int                  state;     // 0 = Text, 1 = String, 2 = Kommentar
+    int                  line;      // Zeile bei scan
+    int                  eof;
+    int                  readErr;   // Lesefehler oder fehlerhafte Kompression
+    int                  pushed;    // Text kommt ueber feed()
+    std::vector<char>    block;     // Text des aktuellen Blocks + 2 Nullbytes
+    size_t               blockLen;
+    int                  blockLine;
+};
+
+#endif
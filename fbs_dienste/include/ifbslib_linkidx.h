@@ -0,0 +1,41 @@
+#ifndef _FB_LINKIDX_H_
+#define _FB_LINKIDX_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "par_param.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//  Index over the parsed links of a Dienst_param
+//
+//  Key is (child_path of the first child, child_role). Lookup and removal
+//  are O(1). Removed links stay in the list until purge() unlinks all of
+//  them in one pass. The memory belongs to the parser.
+///////////////////////////////////////////////////////////////////////////////
+
+class IfbsLinkIndex {
+public :
+    IfbsLinkIndex() {}
+    IfbsLinkIndex(LinksItems *Links) { build(Links); }
+    ~IfbsLinkIndex() {}
+
+    void        build(LinksItems *Links);
+    LinksItems* find(const char *child_path, const char *child_role);
+    void        remove(LinksItems *pLink);
+    int         isRemoved(LinksItems *pLink);
+    // All links whose first child is child_path, in any role
+    void        removeChild(const char *child_path);
+    void        purge(LinksItems **ppLinks);
+
+private :
+    static void makeKey(std::string &key, const char *child_path, const char *child_role);
+
+    std::unordered_map<std::string, std::vector<LinksItems*> > index;
+    std::unordered_set<LinksItems*>                            removed;
+    std::unordered_set<std::string>                            roles;
+};
+
+#endif
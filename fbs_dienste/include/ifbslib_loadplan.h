@@ -0,0 +1,121 @@
+#ifndef _FB_LOADPLAN_H_
+#define _FB_LOADPLAN_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "plt/list.h"
+#include "ks/string.h"
+#include "ks/client.h"
+#include "par_param.h"
+#include "ifbslib_existidx.h"
+
+class ConData;
+
+///////////////////////////////////////////////////////////////////////////////
+//  Ladeplan einer geparsten Sicherung
+//
+//  Abhaengigkeiten der anzulegenden Objekte : Bibliothek -> Container ->
+//  Instanz -> Part -> Verbindung -> Link. Eine Instanz haengt von ihrem
+//  Parent (Container bzw. Besitzer des Parts) und von der Bibliothek ihrer
+//  Klasse ab, eine Verbindung zusaetzlich von Quell- und Ziel-FB, ein Link
+//  von Parent und allen Kindern.
+//
+//  Die Ebene eines Objekts ist eins groesser als die hoechste Ebene seiner
+//  noch nicht angelegten Abhaengigkeiten, die Objekte einer Ebene haengen
+//  also nicht voneinander ab. Je Ebene bleiben die Kinder eines Parents in
+//  der Reihenfolge der Datei zusammen (Reihenfolge im Container). Kinder
+//  verschiedener Parents, Verbindungen und Links werden gleichzeitig von
+//  Kind-Prozessen mit eigener Verbindung angelegt, wenn mehr als eine
+//  Verbindung eingestellt ist (nicht unter NT). Ein Prozess meldet
+//  Ergebnisse, Ausgabe und angelegte Objekte an den Aufrufer. Vorhandene
+//  Objekte stehen im Existenz-Index des Plans. Der Speicher der Eintraege
+//  gehoert dem Parser bzw. dem Aufrufer (Verbindungsdaten).
+///////////////////////////////////////////////////////////////////////////////
+
+class IfbsLoadPlan {
+public :
+    IfbsLoadPlan() : anzConn(1) {}
+    ~IfbsLoadPlan() {}
+
+    // Bibliotheken der Sicherung (Pfad des Bibliotheks-Objekts)
+    void            addLibrary(const char *libPath);
+    void            setLibraryResult(const char *libPath, KS_RESULT err);
+
+    // Instanzen der Sicherung in Reihenfolge der Datei (ohne Verbindungen)
+    void            addInstances(InstanceItems *Instances);
+    InstanceItems*  findInstance(const char *path);
+    void            setCreated(InstanceItems *pinst);
+
+    // Verbindungsobjekt. pCR : Daten der Verbindung (Quell- und Ziel-FB),
+    // 0 = unvollstaendig, wird als einfache Instanz angelegt
+    void            addConnection(InstanceItems *pinst, ConData *pCR);
+    // Link (keine Verbindungs-Links)
+    void            addLink(LinksItems *pLink);
+
+    // Objekte in der DB
+    IfbsExistIndex& getExistIndex() { return existIdx; }
+
+    // Fehlende Parent-Domains der Pfade anlegen. Jeder Pfad wird einmal geprueft
+    void            createParentDomains(KscServerBase      *Server,
+                                        PltList<PltString> &Paths,
+                                        PltString          &out);
+
+    // Ebenen bestimmen. Liefert die Anzahl der Ebenen
+    size_t          build();
+    std::vector<InstanceItems*>& getLevel(size_t lvl) { return levelList[lvl]; }
+    std::vector<InstanceItems*>& getConnections(size_t lvl) { return connList[lvl]; }
+    std::vector<LinksItems*>&    getLinks(size_t lvl) { return linkList[lvl]; }
+    std::vector<InstanceItems*>& getCreated() { return createdList; }
+
+    // Von einer nicht geladenen Bibliothek blockierte Instanzen. Meldet jede
+    // Bibliothek einmal. Liefert den Fehler der ersten Bibliothek oder KS_ERR_OK
+    KS_RESULT       getBlocked(PltString &out, PltString &log);
+
+    // Anzahl der Verbindungen zum Anlegen einer Ebene (Aufrufer mitgezaehlt)
+    size_t          setConnections(size_t anz);
+    // Alle Objekte einer Ebene anlegen. results[i] gehoert zu getLevel(lvl)[i],
+    // conResults[i] zu getConnections(lvl)[i]. Links werden nur protokolliert
+    void            createLevel(KscServerBase *Server, size_t lvl,
+                                KS_RESULT *results, KS_RESULT *conResults,
+                                PltString &out);
+
+private :
+    struct Node {
+        InstanceItems  *pinst;
+        ConData        *pcon;        // Daten der Verbindung, sonst 0
+        int             isConn;      // Verbindungsobjekt
+        long            parent;      // Index des Parents, -1 = nicht in Sicherung
+        long            source;      // Index des Quell-FB, -1 = keiner
+        long            target;      // Index des Ziel-FB, -1 = keiner
+        long            library;     // Index der Bibliothek, -1 = nicht in Sicherung
+        long            blocked;     // Index der blockierenden Bibliothek, -1 = keine
+        int             level;       // -1 = noch nicht bestimmt
+        int             created;     // bereits angelegt (Parent-Domain)
+    };
+
+    static size_t parentLen(const char *path);
+    long          nodeOf(const char *path);
+    int           levelOf(size_t i);
+    int           linkLevelOf(LinksItems *pLink);
+    void          addNode(InstanceItems *pinst, ConData *pcon, int isConn);
+
+    std::vector<Node>                         nodes;
+    std::unordered_map<std::string, size_t>   instIdx;
+    std::vector<std::string>                  libs;
+    std::vector<KS_RESULT>                    libErr;
+    std::unordered_map<std::string, size_t>   libIdx;
+    std::vector<LinksItems*>                  links;
+    std::vector<std::vector<InstanceItems*> > levelList;
+    std::vector<std::vector<size_t> >         groupList;   // Beginn der Parent-Gruppen
+    std::vector<std::vector<InstanceItems*> > connList;
+    std::vector<std::vector<ConData*> >       conDataList;
+    std::vector<std::vector<LinksItems*> >    linkList;
+    std::vector<InstanceItems*>               createdList;
+    size_t                                    anzConn;
+    IfbsExistIndex                            existIdx;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef _FB_OUTSINK_H_
+#define _FB_OUTSINK_H_
+
+#include <vector>
+
+#include "ks/string.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//  Output sink with reusable chunk buffers
+//
+//  Text is copied into up to IFBS_OUTSINK_CHUNKS buffers of chunkSize
+//  bytes. When all buffers are full they are written with one writev() to
+//  a file descriptor or handed one by one to a callback, then reused. Text
+//  of at least chunkSize bytes is passed on without copying. Memory depends
+//  on the buffers, not on the size of the output.
+///////////////////////////////////////////////////////////////////////////////
+
+// Consumer of the callback variant. Returns 0 if the data was taken
+typedef int (*IfbsOutSinkFnc)(void *pUser, const char *data, size_t len);
+
+class IfbsOutSink {
+public :
+    // fd : open file, not closed by the sink. chunkSize = 0 : IFBS_OUTSINK_CHUNKSIZE
+    IfbsOutSink(int fd, size_t chunkSize = 0);
+    IfbsOutSink(IfbsOutSinkFnc fnc, void *pUser, size_t chunkSize = 0);
+    ~IfbsOutSink() { flush(); }
+
+    void        put(const char *text, size_t len);
+    void        put(const char *text);
+    void        put(PltString &Str);
+
+    // Write all buffered text
+    KS_RESULT   flush();
+    // First write error, KS_ERR_OK if none. Later text is dropped
+    KS_RESULT   getError() { return err; }
+    size_t      getWritten() { return written; }
+
+    // Create a file for the fd variant, binary without newline conversion
+    // on NT. Returns -1 on error
+    static int  openFile(const char *filename, int binary = 0);
+    static void closeFile(int fd);
+
+private :
+    void        init(size_t size);
+    void        write(const char *text, size_t len);
+
+    int                             fd;
+    IfbsOutSinkFnc                  fnc;
+    void                           *pUser;
+    size_t                          chunkSize;
+    std::vector< std::vector<char> > chunks;
+    std::vector<size_t>             used;       // Belegte Bytes je Buffer
+    size_t                          cur;        // Aktueller Buffer
+    size_t                          written;
+    KS_RESULT                       err;
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef _FB_SESSION_H_
+#define _FB_SESSION_H_
+
+#include "plt/list.h"
+#include "plt/hashtable.h"
+#include "ks/string.h"
+#include "ks/client.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//  Cached server data
+///////////////////////////////////////////////////////////////////////////////
+
+ENUMDEF(IFBS_SESSION_DATA)
+
+#define IFBS_SD_VERSION   ENUMVAL(IFBS_SESSION_DATA, 0x0001) /* /vendor/server_version */
+#define IFBS_SD_LIBRARIES ENUMVAL(IFBS_SESSION_DATA, 0x0002) /* /vendor/libraries      */
+#define IFBS_SD_CLASSES   ENUMVAL(IFBS_SESSION_DATA, 0x0004) /* /vendor/classes        */
+#define IFBS_SD_ASSOCS    ENUMVAL(IFBS_SESSION_DATA, 0x0008) /* /vendor/associations   */
+#define IFBS_SD_UPLOAD    ENUMVAL(IFBS_SESSION_DATA, 0x0010) /* path of upload instance */
+#define IFBS_SD_LIBDATA   ENUMVAL(IFBS_SESSION_DATA, \
+                                     IFBS_SD_LIBRARIES | IFBS_SD_CLASSES | \
+                                     IFBS_SD_ASSOCS    | IFBS_SD_UPLOAD)
+#define IFBS_SD_ALL       ENUMVAL(IFBS_SESSION_DATA, \
+                                     IFBS_SD_VERSION | IFBS_SD_LIBDATA)
+
+///////////////////////////////////////////////////////////////////////////////
+//  Session of a server connection.
+//
+//  Caches server data which does not change while saving or loading a
+//  database. The data is read on first access. Functions changing the
+//  libraries of the server have to call invalidate().
+//
+//  classHasVariable() looks up a variable in a class and its base classes
+//  and remembers the answer per class and variable name.
+///////////////////////////////////////////////////////////////////////////////
+
+class IfbsSession {
+public :
+    IfbsSession(KscServerBase *Server);
+    ~IfbsSession() { delete pClassVars; }
+
+    KscServerBase*  getServer() { return server; }
+    const KsString& getHostAndName() { return host_and_name; }
+    const KsString& getHost() { return host; }
+    const KsString& getName() { return name; }
+
+    float     getServerVersion();
+    KS_RESULT getLibraries(PltList<PltString> &Liste);
+    KS_RESULT getClasses(PltList<PltString> &Liste);
+    KS_RESULT getAssociations(PltList<PltString> &Liste);
+    KS_RESULT getUploadPath(PltString &path);
+    // 1 : class or a base class defines varName, 0 : not, < 0 : error
+    int       classHasVariable(const char *classPath, const char *varName);
+
+    void      invalidate(IFBS_SESSION_DATA what = IFBS_SD_ALL);
+
+    // Variables
+    IfbsSession         *next;         // next session in list
+    int                  refcount;     // number of IFBS_OpenSession calls
+
+private :
+    KS_RESULT readStringVec(IFBS_SESSION_DATA what,
+                            const char *varPath,
+                            PltList<PltString> &cache,
+                            PltList<PltString> &Liste);
+
+    KscServerBase       *server;
+    KsString             host_and_name;
+    KsString             host;
+    KsString             name;
+
+    IFBS_SESSION_DATA    valid;        // mask of cached data
+    float                version;
+    PltList<PltString>   libraries;
+    PltList<PltString>   classes;
+    PltList<PltString>   associations;
+    PltString            upload_path;
+    PltHashTable<KsString, unsigned long>  *pClassVars;  // "class.var" -> 0/1
+};
+
+#endif
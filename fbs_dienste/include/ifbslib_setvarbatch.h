@@ -0,0 +1,64 @@
+#ifndef _FB_SETVARBATCH_H_
+#define _FB_SETVARBATCH_H_
+
+#include <vector>
+
+#include "plt/list.h"
+#include "ks/string.h"
+#include "ks/client.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//  Batch of SetVar items of several objects
+//
+//  Every object (instance, connection) gets an owner number. The items of
+//  all owners are sent with KS_SETVAR in requests of up to batchSize items
+//  in the order they were added. The result of an owner is the first error
+//  of its items, as with one request per object.
+//
+//  With setSkipUnchanged the current values of each request are read first
+//  with one KS_GETVAR. Items whose value (and state, if given) the server
+//  already holds are not written and count as successful.
+///////////////////////////////////////////////////////////////////////////////
+
+class IfbsSetVarBatch {
+public :
+    // batchSize = 0 : IFBS_GetSetVarBatchSize()
+    IfbsSetVarBatch(KscServerBase *Server, size_t batchSize = 0);
+    ~IfbsSetVarBatch() {}
+
+    // New owner, returns its number
+    size_t      addOwner();
+    // Item of an owner. Full requests are sent at once
+    void        add(size_t owner, KsSetVarItem &item);
+    // Value of a variable (see ifb_setVar)
+    void        add(size_t owner, PltString &VarPath, PltList<PltString> &ValList,
+                    KS_VAR_TYPE Typ, KS_STATE Status = 0,
+                    bool prepareString = TRUE);
+    // Error of an owner which wasn't sent (e.g. bad value)
+    void        setResult(size_t owner, KS_RESULT err);
+
+    // Read before write, only send changed values
+    void        setSkipUnchanged(bool on) { skipUnchanged = on; }
+
+    // Send the remaining items
+    void        flush();
+    KS_RESULT   getResult(size_t owner);
+    size_t      getRequests() { return requests; }
+    // Number of items not written because the value was unchanged
+    size_t      getSkipped() { return skipped; }
+
+private :
+    void        send();
+    void        readCurrent(KsSetVarParams &setpar, std::vector<char> &same);
+
+    KscServerBase              *Server;
+    size_t                      batchSize;
+    size_t                      requests;
+    bool                        skipUnchanged;
+    size_t                      skipped;
+    PltList<KsSetVarItem>       items;
+    std::vector<size_t>         itemOwner;
+    std::vector<KS_RESULT>      results;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef _FB_STAGED_H_
+#define _FB_STAGED_H_
+
+#include <string>
+#include <deque>
+
+#include "ks/string.h"
+#include "ks/client.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//  Staged activation on load
+//
+//  deactivate() replaces the value of a variable (actimode, on) of an object
+//  by its off value before the object is created. activate() puts the saved
+//  values back and writes them with a few SetVar requests after all objects
+//  and links exist. The destructor only puts the values back into the lists,
+//  so objects of a failed load stay inactive.
+//
+//  A variable missing in the file is added with the off value only if the
+//  class of the object (or a base class) defines it, e.g. a function block
+//  saved without actimode. Domains and other classes without the variable
+//  are left alone. activate() doesn't write an added variable, the object
+//  keeps the off value (the default of actimode and on in the fb library).
+//  restore() removes the added variable again. Call deactivate() after the
+//  libraries are loaded, so the classes can be looked up.
+///////////////////////////////////////////////////////////////////////////////
+
+class IfbsStagedActivation {
+public :
+    IfbsStagedActivation() {}
+    ~IfbsStagedActivation() { restore(); }
+
+    // Variable varName of pinst gets offValue. A missing variable of type
+    // varType (KS_VT_INT or KS_VT_BOOL) is added, if the class defines it.
+    // Returns 1, if it was changed
+    int         deactivate(IfbsSession *pses, InstanceItems *pinst,
+                           const char *varName, const char *offValue,
+                           KS_VAR_TYPE varType);
+    // Saved values back to the lists and to the server.
+    KS_RESULT   activate(KscServerBase *Server, PltString &out);
+    // Saved values back to the lists only
+    void        restore();
+
+    size_t      size() { return objects.size(); }
+
+private :
+    struct Object {
+        std::string     Inst_name;
+        InstanceItems  *pinst;
+        Variables      *pvar;
+        VariableItem   *saved;      // Wert aus der Datei
+        VariableItem    off;        // Ersatz beim Anlegen
+        std::string     offValue;
+        Variables       added;      // Variable fehlt in der Datei
+        std::string     varName;
+    };
+
+    std::deque<Object>  objects;
+};
+
+#endif
@@ -124,8 +124,19 @@ ENUMDEF(OV_VAR_TYPE)
 
 #include "fb_macros.h"
 #include "ifbslib_params.h"
+#include "ifbslib_session.h"
 #include "blockparam.h"
 #include "par_param.h"
+#include "ifbslib_linkidx.h"
+#include "ifbslib_existidx.h"
+#include "ifbslib_setvarbatch.h"
+#include "ifbslib_delbatch.h"
+#include "ifbslib_staged.h"
+#include "ifbslib_loadplan.h"
+#include "ifbslib_fbdreader.h"
+#include "ifbslib_outsink.h"
+#include "ifbslib_fbbwriter.h"
+#include "ifbslib_compress.h"
 
 /*
 *   Definitionen
@@ -142,6 +153,52 @@ ENUMDEF(OV_VAR_TYPE)
 #define CLASS_CLASS_PATH      "/acplt/ov/class"
 
 #define LIBRARY_FACTORY_PATH  "/acplt/ov/library"
+
+/* Max. Anzahl Instanzen je CreateObject-Dienst beim Laden (Default) */
+#define IFBS_CREATEOBJ_BATCHSIZE  256
+/* Max. Anzahl Variablen je GetVar-Dienst beim Sichern (Default) */
+#define IFBS_GETVAR_BATCHSIZE     1024
+/* Max. Anzahl Variablen je SetVar-Dienst beim Laden und Aendern (Default) */
+#define IFBS_SETVAR_BATCHSIZE     1024
+/* Max. Anzahl Objekte je DeleteObject-, Link- bzw. Unlink-Dienst (Default) */
+#define IFBS_DELETE_BATCHSIZE     256
+/* Groesse und Anzahl der Buffer der Ausgabe beim Sichern */
+#define IFBS_OUTSINK_CHUNKSIZE    (64*1024)
+#define IFBS_OUTSINK_CHUNKS       16
+/* Kompressionsstufe beim Sichern in .fbd.gz bzw. .fbd.zst */
+#define IFBS_GZIP_LEVEL           6
+#define IFBS_ZSTD_LEVEL           3
+/* Buffergroesse beim (De-)Komprimieren, max. wartende Buffer des Kompressions-Threads */
+#define IFBS_COMPRESS_BUFSIZE     (256*1024)
+#define IFBS_COMPRESS_QUEUE       8
+/* Max. Anzahl Instanzen mit ausstehenden Werten beim Sichern (Default) */
+#define IFBS_SAVEWINDOW           256
+/* Anzahl Verbindungen zum Server beim Sichern (Default, 1 = sequentiell) */
+#define IFBS_SAVECONNECTIONS      1
+/* Max. gepufferte Bytes eines Worker-Prozesses, der dem Schreiben voraus ist */
+#define IFBS_SAVEPROC_PENDING     (4*1024*1024)
+/* Anzahl Verbindungen zum Server beim Laden (Default, 1 = sequentiell) */
+#define IFBS_LOADCONNECTIONS      1
+/* Anzahl Threads beim Parsen der Sicherungsdatei (Default, 0 = Anzahl Prozessoren) */
+#define IFBS_PARSETHREADS         0
+/* Min. Groesse eines parallel geparsten Teils der Datei in Bytes */
+#define IFBS_PARSECHUNK_MIN       (1024*1024)
+/* Anfangsgroesse des Puffers beim blockweisen Lesen einer Sicherungsdatei */
+#define IFBS_FBDREAD_BUFSIZE      (1024*1024)
+/* IfbsFbdReader::next() mit feed() : Block noch nicht vollstaendig */
+#define IFBS_FBDREAD_MORE         (-2)
+/* Max. Bytes eines im Speicher sortierten Laufs beim Vergleich sortierter Dateien */
+#define IFBS_CMPSORT_RUNSIZE      (16*1024*1024)
+
+/* Abschnitte des Vergleichsprotokolls */
+#define IFBS_CMP_DELLIBS          0
+#define IFBS_CMP_NEWLIBS          1
+#define IFBS_CMP_DELETE           2
+#define IFBS_CMP_INSTANCE         3
+#define IFBS_CMP_SET              4
+#define IFBS_CMP_UNLINK           5
+#define IFBS_CMP_LINK             6
+#define IFBS_CMP_SECTIONS         7
 /*
 *   Funtions-Prototypen
 */
@@ -152,14 +209,19 @@ KscServerBase* GetServerByName(                      /*  |> Funktionsrueckmeldun
                                 PltString   &hs      /* >|  Host und Server : Host/Server */
                                 ,KS_RESULT  &res     /*  |> Dienst-Ergebnis               */
                                 );
+/*  Eigene Verbindung zum Server (fuer parallele Dienste) */
+KscServerBase* IFBS_OpenServerConnection(KscServerBase* Server, KS_RESULT &err);
+KscServerBase* IFBS_ConnectServer(PltString &HaS, KS_RESULT &err);
+void IFBS_CloseServerConnection(KscServerBase* Server);
 /*  Klartext-Ausgabe des KS-Fehlers */
 char *GetErrorCode (
                                             KS_RESULT fehler    /* >|  Errorcode                     */
                                             );
 PltString iFBS_SetLastError(int set, KS_RESULT &err, PltString& Str);
 PltString IFBS_GetLastLogError();
-PltString IFBS_GetParserError();
-PltString iFBS_PrintParserError(int set, PltString& Err);
+/*  Parse-Fehler der Sitzung ("" wenn keiner) */
+PltString IFBS_GetParserError(FB_PARSE_CONTEXT *ctx);
+void iFBS_SetParserError(FB_PARSE_CONTEXT *ctx);
 /*
 * Hilfsfunktion.
 * Rueckgabe der Value-Laenge als String in Form "[Laenge]", falls
@@ -314,6 +376,8 @@ KsValue* ifb_CrNewKsValue(
                          ,PltList<PltString>    &ValList
                          ,KS_VAR_TYPE           Typ
                          ,bool                  prepareString = TRUE);
+/*  1, wenn beide Werte gleichen Typ und gleichen Inhalt haben */
+int ifb_sameKsValue(const KsValue *pa, const KsValue *pb);
 KS_RESULT PrepareStringValue(PltString& wert);
 
 KS_RESULT Get_getEP_ErrOnly(KscServerBase* Server,
@@ -324,9 +388,11 @@ KS_RESULT IFBS_DELETE_OBJ(KscServerBase* Server,
 
 KS_RESULT SearchErrorCreateObject(KscServerBase*     Server,
                                   KS_RESULT          &res,
-                                  FbCreateInstParams &pars);
+                                  FbCreateInstParams &pars,
+                                  IfbsExistIndex*    pIdx=0);
 KS_RESULT IFBS_CREATE_INST(KscServerBase*     Server,
-                                                      FbCreateInstParams &Pars);
+                                                      FbCreateInstParams &Pars,
+                                                      IfbsExistIndex*    pIdx=0);
 KS_RESULT IFBS_LINK_TO_TASK(KscServerBase*     Server,
                                                        FbLinkParams       &Pars);
 KS_RESULT IFBS_UNLINK_FROM_TASK(KscServerBase* Server,
@@ -345,6 +411,25 @@ KS_RESULT del_cont_recurs(KscServerBase*  Server,
                           PltString       &tu,
                           PltString*      Logging = 0);
 KS_RESULT delAllXlinks(KscServerBase* Server, PltString &Str);
+/*
+*  Unterobjekte von path in den Loesch-Batch eintragen (Kinder vor dem
+*  Parent) und den Batch mit allen Verbindungen der Instanzen loeschen
+*/
+KS_RESULT del_collect_childs(KscServerBase*       Server,
+                             IfbsDeleteBatch      &Del,
+                             PltString            &path,
+                             int                  inInstance,
+                             PltList<PltString>   &InstListe,
+                             PltList<PltString>   &PartListe,
+                             KS_RESULT            &LastErr,
+                             PltString*           Logging);
+KS_RESULT del_run_batch(KscServerBase*       Server,
+                        IfbsDeleteBatch      &Del,
+                        PltList<PltString>   &InstListe,
+                        PltList<PltString>   &PartListe,
+                        PltString*           Logging);
+void   IFBS_SetDeleteBatchSize(size_t anz);
+size_t IFBS_GetDeleteBatchSize();
 
 //KS_RESULT del_InstAndConsFormInstList(KscServerBase*      Server,
 //                                      PltList<PltString>  &InstListe,
@@ -369,6 +454,21 @@ KS_RESULT get_libs(KscServerBase* Server, PltString& Out);
 
 KS_RESULT IFBS_DBSAVE(KscServerBase* 	Server,
                                       PltString        &datei);
+/*  Sicherung der Datenbasis in einen String. Veraltet, belegt den Text
+*   zweimal. Besser IFBS_DBSAVE_TOCALLBACK */
+KS_RESULT IFBS_DBSAVE_TOSTREAM(KscServerBase*   Server,
+                               PltString        &Out);
+/*  Sicherung der Datenbasis, der Text wird stueckweise an fnc uebergeben */
+KS_RESULT IFBS_DBSAVE_TOCALLBACK(KscServerBase*    Server,
+                                 IfbsOutSinkFnc    fnc,
+                                 void             *pUser);
+int ifb_appendToString(void *pUser, const char *data, size_t len);
+void   IFBS_SetGetVarBatchSize(size_t anz);
+size_t IFBS_GetGetVarBatchSize();
+void   IFBS_SetSaveWindow(size_t anz);
+size_t IFBS_GetSaveWindow();
+void   IFBS_SetSaveConnections(size_t anz);
+size_t IFBS_GetSaveConnections();
 void memfre(Dienst_param* pars);
 KS_RESULT import_eval(KscServerBase*  Server
                       ,Dienst_param*  Params
@@ -378,9 +478,49 @@ KS_RESULT import_eval(KscServerBase*  Server
 KS_RESULT IFBS_DBLOAD(KscServerBase* Server,
                       PltString&     inpfile,
                       PltString&     err_outfile);
-KS_RESULT FB_CreateNewInstance(KscServerBase* Server,
-                               InstanceItems* pinst,
-                               PltString&     out);
+/*
+*  Parst die Datei der Sitzung (fb_parser_openfile), grosse Dateien in
+*  mehreren Threads. Liefert EXIT_SUCCESS oder EXIT_FAILURE
+*/
+int    IFBS_ParseInput(FB_PARSE_CONTEXT *ctx);
+void   IFBS_SetParseThreads(size_t anz);
+size_t IFBS_GetParseThreads();
+/*
+*  pIdx : Index der vorhandenen Objekte (0 = jede Instanz mit getEP pruefen)
+*/
+KS_RESULT FB_CreateNewInstance(KscServerBase*  Server,
+                               InstanceItems*  pinst,
+                               PltString&      out,
+                               IfbsExistIndex* pIdx=0);
+/*
+*  Legt mehrere Instanzen mit einem CreateObject-Dienst an.
+*  results[i] enthaelt das Ergebnis fuer pinst[i]
+*/
+KS_RESULT FB_CreateNewInstances(KscServerBase*  Server,
+                                InstanceItems** pinst,
+                                size_t          anz,
+                                KS_RESULT*      results,
+                                PltString&      out,
+                                IfbsExistIndex* pIdx=0);
+/*
+*  Legt ein Verbindungsobjekt an. pCR : Daten der Verbindung, 0 = ohne Links
+*  als einfache Instanz. Ist die Verbindung schon vorhanden, werden nur die
+*  Werte gesetzt. Fehler werden in out protokolliert
+*/
+KS_RESULT FB_CreateConnection(KscServerBase*  Server,
+                              InstanceItems*  pinst,
+                              ConData*        pCR,
+                              PltString&      out,
+                              IfbsExistIndex* pIdx=0);
+void   IFBS_SetCreateObjBatchSize(size_t anz);
+size_t IFBS_GetCreateObjBatchSize();
+void   IFBS_SetSetVarBatchSize(size_t anz);
+size_t IFBS_GetSetVarBatchSize();
+/* Beim Aendern aktuelle Werte lesen und nur Aenderungen schreiben */
+void   IFBS_SetSkipUnchanged(int on);
+int    IFBS_GetSkipUnchanged();
+void   IFBS_SetLoadConnections(size_t anz);
+size_t IFBS_GetLoadConnections();
 KS_RESULT GetCreateObjectVar( Variables* pvar, KsArray<KsSetVarItem> &pars);
 KS_RESULT aufraeumen(KscServerBase*  Server,
                      Dienst_param*   Params,
@@ -390,7 +530,29 @@ int IsNotInList(PltString& Value, PltList<PltString> &Liste);
 KS_RESULT IFBS_DBCOMPARE(PltString& olddat,
                          PltString& newdat,
                          PltString& proto);
+/*  Vergleich zweier nach Pfaden sortierter Dateien, Block fuer Block. Die
+*   Verbindungsdaten werden extern sortiert (temporaere Dateien), im Speicher
+*   sind nur ein Block, eine Link-Gruppe und ein Sortier-Lauf. Jede Datei
+*   wird dreimal gelesen */
+KS_RESULT IFBS_DBCOMPARE_SORTED(PltString& olddat,
+                                PltString& newdat,
+                                PltString& proto);
+/*  IFBS_DBCOMPARE vergleicht sortierte Dateien mit IFBS_DBCOMPARE_SORTED */
+void IFBS_SetSortedCompare(int on);
+int  IFBS_GetSortedCompare();
+void ifb_putCompareHeader(FILE*       yyout,
+                          PltString&  olddat,
+                          PltString&  newdat,
+                          PltString&  proto);
 
+/*
+*  Vergleich ohne Ausgabe. Die Differenzen bleiben in den Listen von
+*  oldpar, newpar und upd (siehe ifb_compeval.cpp)
+*/
+KS_RESULT compare_model(Dienst_param* newpar,
+                        Dienst_param* oldpar,
+                        Dienst_param* upd,
+                        PltString&    msg);
 KS_RESULT compare_eval(Dienst_param* newpar,
                        Dienst_param* oldpar,
                        PltString& out);
@@ -398,11 +560,17 @@ void compare_libraries(Dienst_param* newpar,Dienst_param* oldpar);
 KS_RESULT compare_any_inst(Dienst_param*,Dienst_param*,Dienst_param*,PltString&);
 int  value_compare(Variables*, Variables*);
 int  param_compare(InstanceItems*, InstanceItems*, PltString&);
-void removeComConnLinks(Dienst_param *param, InstanceItems* ComConn);
-int compareComConnLinks( Dienst_param *Newpar
-                        ,Dienst_param *Oldpar
-                        ,const char   *VerbName);
+int  compareComConnVars(InstanceItems*, InstanceItems*);
+int compareComConnLinks( IfbsLinkIndex &NewIdx
+                        ,IfbsLinkIndex &OldIdx
+                        ,const char    *VerbName);
 void put_variable(Variables* hpv, PltString& Out);
+void put_compare_title(int section, PltString& Out);
+void put_library(const char* name, int del, PltString& Out);
+void put_delete(const char* name, PltString& Out);
+void put_instance(InstanceItems* pinst, PltString& Out);
+void put_set(InstanceItems* pinst, PltString& Out);
+void put_link(LinksItems* plink, const char* what, PltString& Out);
 
 void get_any_links(Dienst_param*, Dienst_param*);
 
@@ -410,6 +578,33 @@ void get_any_links(Dienst_param*, Dienst_param*);
 KS_RESULT  IFBS_DBUPDATE(KscServerBase *Server,
                          PltString     &datei,
                          PltString     &err_outfile);
+/*
+*  Abgleich der Datenbasis des Servers mit einer Datei. Nur die Differenzen
+*  werden geschrieben
+*/
+KS_RESULT  IFBS_DBSYNC(KscServerBase *Server,
+                       PltString     &datei,
+                       PltString     &err_outfile);
+
+/*
+*  Binaere Sicherungsdatei (.fbb, siehe ifb_fbbfile.cpp)
+*/
+int       IFBS_IsFbbName(const char *filename);
+/* Eingabe der Sitzung ist eine .fbb-Datei */
+int       IFBS_IsFbbInput(FB_PARSE_CONTEXT *ctx);
+/* Daten beginnen mit der Kennung einer .fbb-Datei */
+int       IFBS_IsFbbData(const char *data, size_t len);
+/* Liest die .fbb-Eingabe wie der Parser. Liefert EXIT_SUCCESS oder EXIT_FAILURE */
+int       IFBS_ReadFbb(FB_PARSE_CONTEXT *ctx);
+KS_RESULT IFBS_WriteFbb(Dienst_param *par, IfbsOutSink &Sink);
+/* KsValue aus dem typisierten Wert (VariableItem::fbb_value) */
+KsValue*  ifb_fbbNewKsValue(KS_RESULT &err, const char *pValue, KS_VAR_TYPE Typ);
+/* Text des Elements idx (pvi) von pv, typisierte Werte werden in help
+*  (64 Zeichen) formatiert */
+const char* ifb_fbbValueText(Variables *pv, VariableItem *pvi, size_t idx, char *help);
+/* Umwandlung .fbd <-> .fbb, die Endung von outfile bestimmt das Format */
+KS_RESULT IFBS_FBDCONVERT(PltString &infile,
+                          PltString &outfile);
 
 KS_RESULT  update_eval(KscServerBase* Server,
                         Dienst_param*  Params,
@@ -417,6 +612,20 @@ KS_RESULT  update_eval(KscServerBase* Server,
 int unlink_old_link(KscServerBase*, Dienst_param*, PltString&);
 int delete_old_instance(KscServerBase*,Dienst_param*,PltString& );
 int set_new_value(KscServerBase*,Dienst_param*,PltString&);
+/*
+*  Traegt die Variablen einer Instanz in den Batch ein. Liefert die Nummer
+*  der Instanz (Owner) im Batch
+*/
+size_t ifb_addInstanceValues(IfbsSetVarBatch& Batch,
+                             const char*      Inst_name,
+                             Variables*       Inst_var,
+                             int              isVendor = 0);
+
+/*
+*  Gestufte Aktivierung beim Laden (actimode=0, on=FALSE beim Anlegen)
+*/
+void IFBS_SetStagedActivation(int on);
+int  IFBS_GetStagedActivation();
 
 void AddValueToList(PltString& ,  PltList<PltString>&);
 
@@ -425,10 +634,10 @@ KS_RESULT IFBS_DIR(KscServerBase* 	Server,
                    PltList<ObjProps>  &Res);
                    
 
-void writeHeadSelectSave(KscServerBase* Server, PltString &out, FILE* fout=0);
+void writeHeadSelectSave(KscServerBase* Server, PltString &out, IfbsOutSink* pSink=0);
                         
 KS_RESULT write_inst_from_class(KscServerBase*, FbDirParams&,
-                          PltString&, FILE *);
+                          PltString&, IfbsOutSink *);
 
 void write_help_message_from_select_save(PltString &out);
 
@@ -455,6 +664,17 @@ KS_RESULT ifb_deleteLink(KscServerBase*     Server,
                          FbLinkParams       &Pars);
 KS_RESULT ifb_createLink(KscServerBase*     Server,
                          FbLinkParams       &Pars);
+/*
+*  Link- bzw. Unlink-Dienst fuer viele Elemente mit Ergebnis je Element
+*/
+KS_RESULT ifb_createLinks(KscServerBase*            Server,
+                          std::vector<std::string>  &linkPath,
+                          std::vector<std::string>  &elemPath,
+                          std::vector<KS_RESULT>    &results);
+KS_RESULT ifb_deleteLinks(KscServerBase*            Server,
+                          std::vector<std::string>  &linkPath,
+                          std::vector<std::string>  &elemPath,
+                          std::vector<KS_RESULT>    &results);
                          
 void ifb_SortList(PltList<PltString> &Liste);
 
@@ -491,17 +711,31 @@ KS_RESULT ifb_writeInstData(
     bool           recurs,
     bool           saveConLinks,
     bool           linkParentOnly,
-    FILE          *fout
+    IfbsOutSink   *pSink
 );
 
 void ifb_writeLibItem(KsString libname, PltString& Out);
 KS_RESULT saveInstances(KscServerBase* Server, FbDirParams& Pars,
                         PltList<PltString> &libList, PltList<PltString> &conList,
-                        PltString& out, int& Recurs, FILE *fout=0);
+                        PltString& out, int& Recurs, IfbsOutSink *pSink=0);
 KS_RESULT saveConsFromList(KscServerBase* Server, PltList<PltString> &conList,
-                          PltString& out, FILE *fout=0);
-// Holt Server-Version
+                          PltString& out, IfbsOutSink *pSink=0);
+// Holt Server-Version (aus der Sitzung, falls geoeffnet)
 float get_serverVersion(KscServerBase* Server);
+// Liest Server-Version bzw. Pfad der Upload-Instanz immer vom Server
+float ifb_readServerVersion(KscServerBase* Server);
+KS_RESULT ifb_readUploadPath(KscServerBase* Server, PltString &path);
+
+/*
+*  Sitzung einer Server-Verbindung. IFBS_OpenSession liefert die bereits
+*  geoeffnete Sitzung des Servers oder legt eine neue an. Jeder Aufruf
+*  muss mit IFBS_CloseSession abgeschlossen werden.
+*/
+IfbsSession* IFBS_OpenSession(KscServerBase *Server);
+void         IFBS_CloseSession(IfbsSession *Session);
+IfbsSession* IFBS_GetSession(KscServerBase *Server);
+void         IFBS_InvalidateSession(KscServerBase     *Server,
+                                    IFBS_SESSION_DATA  what = IFBS_SD_ALL);
                           
 PltString log_getErrMsg(
     KS_RESULT   err,
@@ -49,20 +49,6 @@
 #define alloca malloc
 #endif
 
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-#ifndef FOR_EH
-int yyerror(char *s);
-int yyparse(void);
-int yylex(void);
-#endif
-
-#ifdef __cplusplus
-}
-#endif
-
 typedef enum {
 	DT_BOOLIAN		= 0x01,
 	DT_GANZZAHL		= 0x02,
@@ -91,7 +77,8 @@ typedef enum {
 
 struct VariableItem {
 	DataType				value_type;
-    char*                   val;
+    char*                   val;			/* Text, NULL bei typisiertem Wert (.fbb, ifb_fbbValueText) */
+	const char*				fbb_value;		/* Typisierter Wert der Variable (.fbb), nur am ersten Element, sonst NULL */
 	struct VariableItem*	next;
 };
 typedef struct VariableItem VariableItem;
@@ -159,19 +146,109 @@ struct Dienst_param {
 };
 typedef struct Dienst_param Dienst_param;
 
+/*
+*	Listen waehrend des Parsens. Das letzte Element wird mitgefuehrt,
+*	damit neue Elemente ohne Durchlaufen der Liste angehaengt werden.
+*/
+struct InstanceList {
+	InstanceItems*			first;
+	InstanceItems*			last;
+};
+typedef struct InstanceList InstanceList;
 
-#ifdef __cplusplus
-extern "C" {
-#endif
+struct LinksList {
+	LinksItems*				first;
+	LinksItems*				last;
+};
+typedef struct LinksList LinksList;
 
-extern Dienst_param 	*ppar;
-extern int 		    yydebug;
-extern int 		    current_line;
-extern FILE 	        *yyin;
+struct ChildList {
+	Child*					first;
+	Child*					last;
+};
+typedef struct ChildList ChildList;
+
+struct DelInstList {
+	DelInstItems*			first;
+	DelInstItems*			last;
+};
+typedef struct DelInstList DelInstList;
+
+struct VariablesList {
+	Variables*				first;
+	Variables*				last;
+};
+typedef struct VariablesList VariablesList;
+
+struct VariableItemList {
+	VariableItem*			first;
+	VariableItem*			last;
+};
+typedef struct VariableItemList VariableItemList;
+
+/*
+*	Letzte Elemente der Listen in Dienst_param
+*/
+struct ParserTails {
+	InstanceItems*			Instance;
+	LinksItems*				Links;
+	DelInstItems*			NewLibs;
+};
+typedef struct ParserTails ParserTails;
 
-#ifdef __cplusplus
-}
-#endif
+
+/*
+*	FB_PARSE_CONTEXT:
+*	-----------------
+*	Zustand einer Parse-Sitzung. Scanner, Speicher und Fehlermeldung
+*	gehoeren der Sitzung. Mehrere Dateien koennen daher gleichzeitig
+*	(in verschiedenen Threads) geparst werden.
+*/
+struct PARSER_ARENA;
+struct LINK_HASH_ENTRY;
+
+/* Art der Bloecke (first_block, last_block) */
+#define FB_BLOCK_NONE			0
+#define FB_BLOCK_INSTANCE		1
+#define FB_BLOCK_LINK			2
+#define FB_BLOCK_LIBRARY		3
+
+struct FB_PARSE_CONTEXT {
+	Dienst_param*			par;			/* Ergebnis des Parsens			*/
+	void*					scanner;		/* reentranter Scanner			*/
+	int						current_line;	/* aktuelle Zeile (ab 0)		*/
+	int						error_line;		/* Zeile des Parse-Fehlers		*/
+	char					error_msg[256];	/* Parse-Fehler, "" wenn keiner	*/
+
+	/* Eingabe-Datei im Speicher (fb_parser_openfile) */
+	char*					input;			/* Inhalt + 2 Nullbytes			*/
+	size_t					input_size;		/* Groesse der Datei			*/
+	size_t					input_mapsize;	/* Groesse des Mappings, 0 = malloc */
+	int						input_used;		/* bereits geparst				*/
+	int						input_inplace;	/* Strings zeigen in die Eingabe */
+	void*					input_stream;	/* komprimierte Text-Datei, statt input */
+	int						input_error;	/* Lesefehler im Strom			*/
+
+	/* Geparste Bloecke. Zum Zusammenfuegen parallel geparster Teile */
+	int						first_block;	/* Art des ersten Blocks		*/
+	int						last_block;		/* Art des letzten Blocks		*/
+	int						link_runs;		/* Anzahl Folgen von LINK-Bloecken */
+
+	/* Speicher der Sitzung */
+	struct PARSER_ARENA*	pArena;
+	char**					pStrHash;
+	size_t					StrHashSize;
+	size_t					StrHashCount;
+
+	/* Bereits gepruefte Links */
+	struct LINK_HASH_ENTRY*	pLinkHash;
+	size_t					LinkHashSize;
+	size_t					LinkHashCount;
+	LinksItems*				pCheckFirst;
+	LinksItems*				pCheckLast;
+	LinksItems**			ppCheckNext;
+};
+typedef struct FB_PARSE_CONTEXT FB_PARSE_CONTEXT;
 
 /*
 *	PARSER_STACK:
@@ -191,20 +268,68 @@ extern "C" {
 
 #endif
 /*
+*	Create a parse session. Returns NULL if out of memory
+*/
+FB_PARSE_CONTEXT* fb_parser_create(void);
+/*
+*	Free the session with all strings and structures allocated by the parser
+*/
+void fb_parser_destroy(FB_PARSE_CONTEXT* ctx);
+/*
+*	Free all structures and the input, keep the session for the next input
+*/
+void fb_parser_reset(FB_PARSE_CONTEXT* ctx);
+/*
+*	Map a file into the session. Compressed text files (gzip, zstd) stay
+*	open and are decompressed in pieces while parsing. Returns 0 if the
+*	file can't be opened
+*/
+int fb_parser_openfile(FB_PARSE_CONTEXT* ctx, const char* filename);
+/*
+*	Open a gzip or zstd compressed file. Returns 0 if the file is not
+*	compressed, -1 on an error, else 1 and either *pstream (text, read with
+*	fb_parser_readstream) or *pbuf (binary .fbb, which needs the whole file:
+*	decompressed into memory, followed by 2 zero bytes, freed with free())
+*/
+int fb_parser_readcompressed(const char* filename, char** pbuf, size_t* psize, void** pstream);
+/*
+*	Read up to len bytes of the stream. Returns the number of bytes, 0 at
+*	the end, -1 on an error
+*/
+long fb_parser_readstream(void* stream, char* buf, size_t len);
+void fb_parser_closestream(void* stream);
+/*
+*	Parse the file of fb_parser_openfile (in place or from the stream) or
+*	a string. Returns EXIT_SUCCESS or EXIT_FAILURE
+*/
+int fb_parser_parseinput(FB_PARSE_CONTEXT* ctx);
+int fb_parser_parsestring(FB_PARSE_CONTEXT* ctx, const char* str);
+/*
+*	Parse a part of the input in place. base[len] and base[len+1] must be 0.
+*	line is the line number of base in the input
+*/
+int fb_parser_parsechunk(FB_PARSE_CONTEXT* ctx, char* base, size_t len, int line);
+/*
+*	Append the results of the parsed parts in file order to ctx.
+*	The parts are freed. Returns EXIT_SUCCESS or EXIT_FAILURE
+*/
+int fb_parser_merge(FB_PARSE_CONTEXT* ctx, FB_PARSE_CONTEXT** chunks, size_t anz);
+/*
+*	Allocate memory for parser structures. Freed with fb_parser_destroy
+*/
+void* fb_parser_alloc(FB_PARSE_CONTEXT* ctx, size_t size);
+/*
 *	Allocate memory for a string
 */
 char* fb_parser_getstring(
+	FB_PARSE_CONTEXT*	ctx,
 	const char*		    string,
 	const unsigned int  length
 );
 /*
-*	Free strings allocated by the scanner
-*/
-void fb_parser_freestrings(void);
-/*
-*	Check structures
+*	Check structures. Returns the last link
 */
-void fb_parser_checkstruct(Dienst_param* par);
+LinksItems* fb_parser_checkstruct(FB_PARSE_CONTEXT* ctx);
 
 #ifdef __cplusplus
 }
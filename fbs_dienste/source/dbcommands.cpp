@@ -1,9 +1,23 @@
 
 #include "ifbslibdef.h"
 
+#if !PLT_SYSTEM_NT
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+/* Kompression der Sicherungsdatei (Option -z bzw. -zstd) */
+static int zipMethod = IFBS_COMPRESS_NONE;
+/* Binaere Sicherungsdatei NAME.fbb (Option -fbb) */
+static int fbbFormat = 0;
+
 void getFileNameFromHS(PltString hs, PltString &filename, PltString &logfile) {
     char            help[256];
     char            *ph;
+    int             method = zipMethod;
+    int             binary = fbbFormat;
     
     if(filename == "") {
         strcpy(help, (const char*)hs);
@@ -17,6 +31,16 @@ void getFileNameFromHS(PltString hs, PltString &filename, PltString &logfile) {
     
     } else {
         strcpy(help, (const char*)filename);
+        
+        /* NAME.fbd.gz : Kompression aus dem Namen uebernehmen */
+        if(IFBS_CompressionFromName(help) != IFBS_COMPRESS_NONE) {
+            method = IFBS_CompressionFromName(help);
+            help[strlen(help) - strlen(IFBS_CompressionExt(method))] = '\0';
+        }
+        /* NAME.fbb : binaere Datei */
+        if(IFBS_IsFbbName(help)) {
+            binary = 1;
+        }
         ph = help;
 
         while ( ph && (*ph) ) ph ++;
@@ -30,7 +54,8 @@ void getFileNameFromHS(PltString hs, PltString &filename, PltString &logfile) {
         }
     }
     filename = help;
-    filename += ".fbd";
+    filename += binary ? ".fbb" : ".fbd";
+    filename += IFBS_CompressionExt(method);
 
     logfile = help;
     logfile += ".log";
@@ -39,26 +64,20 @@ void getFileNameFromHS(PltString hs, PltString &filename, PltString &logfile) {
     return;
 }
 
-int doOneServer(PltString hs, PltString filename, PltString logfile
+static int doServerSteps(KscServerBase* Server
+                ,PltString hs, PltString filename, PltString logfile
                 ,int saveId, int cleanId, int loadId
                 ,unsigned int anzLibs
                 ,PltArray<PltString> *pLibArr
-                ,PltString pwd) {
+                ,PltString pwd
+                ,PltString syncfile
+                ,PltString updfile) {
   
-    KscServerBase*  Server;
     int             err;
     unsigned int    i;
     PltString       libName;
     PltString       Out;
     
-    Server = GetServerByName(hs, err);
-    if(err) {
-        fprintf(stderr," Server '%s' nicht erreichbar: '%s'\n     Error 0x%x (%s)\n\n\n",
-                                     (const char*)hs, (const char*)filename, err, GetErrorCode(err));
-        return 1;
-    }
-    
-    
     /* Datenbasis sichern */
     if(saveId) {
         err = IFBS_DBSAVE(Server, filename);
@@ -114,10 +133,204 @@ int doOneServer(PltString hs, PltString filename, PltString logfile
             fprintf(stderr," Datei '%s' in Server '%s' geladen.\n", (const char*)filename, (const char*)hs);
         }
     }
+ 
+    /* Datenbasis mit Datei abgleichen */
+    if(syncfile != "") {
+        err = IFBS_DBSYNC(Server, syncfile, logfile);
+        if(err) {
+            fprintf(stderr," Fehler beim Abgleich von Server '%s' mit Datei '%s'.\n    Nr. 0x%x (%s)\n\n",
+               (const char*)hs, (const char*)syncfile, err, GetErrorCode(err));
+            return 1;
+        } else{
+            fprintf(stderr," Server '%s' mit Datei '%s' abgeglichen.\n", (const char*)hs, (const char*)syncfile);
+        }
+    }
+ 
+    /* Aenderungen aus Datei (Vergleichsprotokoll) einspielen */
+    if(updfile != "") {
+        err = IFBS_DBUPDATE(Server, updfile, logfile);
+        if(err) {
+            fprintf(stderr," Fehler beim Aktualisieren von Server '%s' mit Datei '%s'.\n    Nr. 0x%x (%s)\n\n",
+               (const char*)hs, (const char*)updfile, err, GetErrorCode(err));
+            return 1;
+        } else{
+            fprintf(stderr," Server '%s' mit Datei '%s' aktualisiert.\n", (const char*)hs, (const char*)updfile);
+        }
+    }
   
     return 0;
 }
 
+int doOneServer(PltString hs, PltString filename, PltString logfile
+                ,int saveId, int cleanId, int loadId
+                ,unsigned int anzLibs
+                ,PltArray<PltString> *pLibArr
+                ,PltString pwd
+                ,int ownConn = 0
+                ,PltString syncfile = ""
+                ,PltString updfile = "") {
+  
+    KscServerBase*  Server;
+    IfbsSession*    pses;
+    KS_RESULT       err;
+    
+    if(ownConn) {
+        /* Eigene Verbindung, nicht ueber den Cache von GetServerByName */
+        Server = IFBS_ConnectServer(hs, err);
+    } else {
+        Server = GetServerByName(hs, err);
+    }
+    if(err) {
+        fprintf(stderr," Server '%s' nicht erreichbar: '%s'\n     Error 0x%x (%s)\n\n\n",
+                                     (const char*)hs, (const char*)filename, err, GetErrorCode(err));
+        return 1;
+    }
+    
+    /* Server-Daten fuer alle Schritte nur einmal lesen */
+    pses = IFBS_OpenSession(Server);
+    err = doServerSteps(Server, hs, filename, logfile, saveId, cleanId, loadId,
+                        anzLibs, pLibArr, pwd, syncfile, updfile);
+    IFBS_CloseSession(pses);
+    
+    if(ownConn) {
+        IFBS_CloseServerConnection(Server);
+    }
+    
+    return err;
+}
+
+/*
+*   Ergebnis eines Servers im Modus -all
+*/
+#define SRV_NOT_RUN  -1   /* Schritt nicht ausgefuehrt */
+#define SRV_OK        0
+#define SRV_FAILED    1
+
+static void getServerFiles(PltString HS, size_t anzHS, PltString filename, int protoId
+                           ,PltString &filName, PltString &logfile) {
+    filName = "";
+    if(anzHS == 1) {
+        if(filename != "") {
+            filName = filename;
+        }
+    }
+    
+    getFileNameFromHS(HS, filName, logfile);
+    if(protoId == 0) {
+        logfile = "";
+    }
+}
+
+/*
+*   Fuehrt die Schritte fuer alle Server aus. Mit jobs > 1 laufen bis zu
+*   jobs Server gleichzeitig, jeder in einem eigenen Prozess mit eigener
+*   Server-Verbindung. Kehrt erst zurueck, wenn alle Server fertig sind.
+*/
+static void doServerPhase(PltArray<PltString> &hsLst, size_t anzHS
+                          ,PltString filename, int protoId
+                          ,int saveId, int cleanId, int loadId
+                          ,unsigned int anzLibs
+                          ,PltArray<PltString> *pLibArr
+                          ,PltString pwd
+                          ,int jobs
+                          ,int *status) {
+    PltString       filName;
+    PltString       logfile;
+    size_t          i;
+    
+#if !PLT_SYSTEM_NT
+    if(jobs > 1) {
+        pid_t*      pids = new pid_t[anzHS];
+        size_t      next = 0;
+        int         running = 0;
+        int         st;
+        pid_t       pid;
+        
+        while( (next < anzHS) || running ) {
+            /* Freie Worker mit weiteren Servern starten */
+            while( (running < jobs) && (next < anzHS) ) {
+                getServerFiles(hsLst[next], anzHS, filename, protoId, filName, logfile);
+                
+                fflush(stdout);
+                fflush(stderr);
+                pid = fork();
+                if(pid == 0) {
+                    st = doOneServer(hsLst[next], filName, logfile, saveId, cleanId, loadId,
+                                     anzLibs, pLibArr, pwd, 1);
+                    fflush(NULL);
+                    _exit(st ? SRV_FAILED : SRV_OK);
+                }
+                if(pid < 0) {
+                    /* Kein Prozess moeglich: Server selbst bearbeiten */
+                    pids[next] = 0;
+                    st = doOneServer(hsLst[next], filName, logfile, saveId, cleanId, loadId,
+                                     anzLibs, pLibArr, pwd, 1);
+                    status[next] = st ? SRV_FAILED : SRV_OK;
+                } else {
+                    pids[next] = pid;
+                    running++;
+                }
+                next++;
+            }
+            if(!running) {
+                continue;
+            }
+            
+            /* Auf einen Worker warten */
+            pid = waitpid(-1, &st, 0);
+            if(pid < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                /* Keine Worker mehr: restliche als fehlerhaft markieren */
+                for(i=0; i<next; i++) {
+                    if(pids[i]) {
+                        status[i] = SRV_FAILED;
+                    }
+                }
+                running = 0;
+                continue;
+            }
+            for(i=0; i<next; i++) {
+                if(pids[i] == pid) {
+                    pids[i] = 0;
+                    if( WIFEXITED(st) && (WEXITSTATUS(st) == 0) ) {
+                        status[i] = SRV_OK;
+                    } else {
+                        status[i] = SRV_FAILED;
+                    }
+                    running--;
+                    break;
+                }
+            }
+        }
+        
+        delete [] pids;
+        return;
+    }
+#endif
+    
+    for(i=0; i<anzHS; i++) {
+        getServerFiles(hsLst[i], anzHS, filename, protoId, filName, logfile);
+        
+        if(doOneServer(hsLst[i], filName, logfile, saveId, cleanId, loadId,
+                       anzLibs, pLibArr, pwd) != 0) {
+            status[i] = SRV_FAILED;
+        } else {
+            status[i] = SRV_OK;
+        }
+    }
+}
+
+static const char* srvStatusText(int status) {
+    switch(status) {
+        case SRV_OK:        return "OK";
+        case SRV_FAILED:    return "Fehler";
+        default:            break;
+    }
+    return "-";
+}
+
 int doAllServers(PltString  hst
                  ,PltString filename
                  ,int       saveId
@@ -126,14 +339,13 @@ int doAllServers(PltString  hst
                  ,int       protoId
                  ,unsigned int anzLibs
                  ,PltArray<PltString> *pLibArr
-                 ,PltString pwd) {
+                 ,PltString pwd
+                 ,int       jobs) {
 
         char*                    ph;
     char            help[256];
     PltString       HS;
     KS_RESULT       err;
-    PltString       filName;
-    PltString       logfile;
     int             ret = 0;
     KscServerBase*  Server;
     KsGetEPParams  param;
@@ -212,47 +424,42 @@ int doAllServers(PltString  hst
         anzHS++;
     }
     
-    // Alle Server sichern und loeschen
+    if(jobs > (int)anzHS) {
+        jobs = (int)anzHS;
+    }
+    
+    int*    status1 = new int[anzHS];
+    int*    status2 = new int[anzHS];
     for(i=0; i<anzHS; i++) {
-        filName = "";
-        if(anzHS == 1) {
-            if(filename != "") {
-                filName = filename;
-            }
-        }
-        
-        HS = hsLst[i];
-        getFileNameFromHS(HS, filName, logfile);
-        if(protoId == 0) {
-            logfile = "";
-        }
-        
-        err = doOneServer(HS, filName, logfile, saveId, cleanId, 0, 0, 0, pwd);
-        if(err != 0) {
-            ret = 1;
-        }
+        status1[i] = SRV_NOT_RUN;
+        status2[i] = SRV_NOT_RUN;
+    }
+    
+    // Alle Server sichern und loeschen
+    if(saveId || cleanId) {
+        doServerPhase(hsLst, anzHS, filename, protoId, saveId, cleanId, 0,
+                      0, 0, pwd, jobs, status1);
     }
 
-    // Bibliotheken und DB laden
+    // Bibliotheken und DB laden. Erst wenn alle Server gesichert und geloescht sind.
+    if(anzLibs || loadId) {
+        doServerPhase(hsLst, anzHS, filename, protoId, 0, 0, loadId,
+                      anzLibs, pLibArr, pwd, jobs, status2);
+    }
+    
+    // Zusammenfassung
+    fprintf(stderr, "\n %-40s %-16s %-16s\n", "Server", "Sichern/Loeschen", "Laden");
     for(i=0; i<anzHS; i++) {
-        filName = "";
-        if(anzHS == 1) {
-            if(filename != "") {
-                filName = filename;
-            }
-        }
-        
-        HS = hsLst[i];
-        getFileNameFromHS(HS, filName, logfile);
-        if(protoId == 0) {
-            logfile = "";
-        }
-        
-        err = doOneServer(HS, filName, logfile, 0, 0, loadId, anzLibs, pLibArr, pwd);
-        if(err != 0) {
+        fprintf(stderr, " %-40s %-16s %-16s\n", (const char*)hsLst[i],
+                srvStatusText(status1[i]), srvStatusText(status2[i]));
+        if( (status1[i] == SRV_FAILED) || (status2[i] == SRV_FAILED) ) {
             ret = 1;
         }
     }
+    fprintf(stderr, "\n");
+    
+    delete [] status1;
+    delete [] status2;
     
     return ret;
 }
@@ -269,6 +476,13 @@ int main(int argc, char **argv) {
     PltString       logfile("");
     PltString       AV("");
     PltString       PWD("");
+    PltString       syncfile("");
+    PltString       updfile("");
+    PltString       convIn("");
+    PltString       convOut("");
+    PltString       cmpOld("");
+    PltString       cmpNew("");
+    PltString       cmpProto("");
     const char*     servername = "localhost/fb_database";
     int             i;
     int             saveId   = 0;
@@ -276,6 +490,7 @@ int main(int argc, char **argv) {
     int             cleanId  = 0;
     int             allId    = 0;
     int             protoId  = 1;
+    int             jobs     = 1;
     
     unsigned int    l;
     unsigned int    libNr    = 0;
@@ -330,6 +545,95 @@ int main(int argc, char **argv) {
                         }
                 }
                 /*
+                *        Anzahl Instanzen je CreateObject-Dienst
+                */
+                else if(!strcmp(argv[i], "-crbatch")) {
+                        i++;
+                        if( (i<argc) && (atoi(argv[i]) > 0) ) {
+                IFBS_SetCreateObjBatchSize((size_t)atoi(argv[i]));
+                        } else {
+                                goto HELP;
+                        }
+                }
+                /*
+                *        Anzahl Variablen je GetVar-Dienst
+                */
+                else if(!strcmp(argv[i], "-varbatch")) {
+                        i++;
+                        if( (i<argc) && (atoi(argv[i]) > 0) ) {
+                IFBS_SetGetVarBatchSize((size_t)atoi(argv[i]));
+                        } else {
+                                goto HELP;
+                        }
+                }
+                /*
+                *        Anzahl Variablen je SetVar-Dienst
+                */
+                else if(!strcmp(argv[i], "-setbatch")) {
+                        i++;
+                        if( (i<argc) && (atoi(argv[i]) > 0) ) {
+                IFBS_SetSetVarBatchSize((size_t)atoi(argv[i]));
+                        } else {
+                                goto HELP;
+                        }
+                }
+                /*
+                *        Anzahl Objekte je DeleteObject-Dienst
+                */
+                else if(!strcmp(argv[i], "-delbatch")) {
+                        i++;
+                        if( (i<argc) && (atoi(argv[i]) > 0) ) {
+                IFBS_SetDeleteBatchSize((size_t)atoi(argv[i]));
+                        } else {
+                                goto HELP;
+                        }
+                }
+                /*
+                *        Anzahl Instanzen mit ausstehenden Werten
+                */
+                else if(!strcmp(argv[i], "-window")) {
+                        i++;
+                        if( (i<argc) && (atoi(argv[i]) > 0) ) {
+                IFBS_SetSaveWindow((size_t)atoi(argv[i]));
+                        } else {
+                                goto HELP;
+                        }
+                }
+                /*
+                *        Anzahl paralleler Verbindungen beim Sichern und Laden
+                */
+                else if(!strcmp(argv[i], "-conn")) {
+                        i++;
+                        if( (i<argc) && (atoi(argv[i]) > 0) ) {
+                IFBS_SetSaveConnections((size_t)atoi(argv[i]));
+                IFBS_SetLoadConnections((size_t)atoi(argv[i]));
+                        } else {
+                                goto HELP;
+                        }
+                }
+                /*
+                *        Anzahl Threads beim Parsen der Sicherungsdatei
+                */
+                else if(!strcmp(argv[i], "-pthreads")) {
+                        i++;
+                        if( (i<argc) && (atoi(argv[i]) > 0) ) {
+                IFBS_SetParseThreads((size_t)atoi(argv[i]));
+                        } else {
+                                goto HELP;
+                        }
+                }
+                /*
+                *        Anzahl gleichzeitig bearbeiteter Server (-all)
+                */
+                else if(!strcmp(argv[i], "-j")) {
+                        i++;
+                        if( (i<argc) && (atoi(argv[i]) > 0) ) {
+                jobs = atoi(argv[i]);
+                        } else {
+                                goto HELP;
+                        }
+                }
+                /*
                 *        set option
                 */
                 else if(!strcmp(argv[i], "-save")) {
@@ -344,6 +648,87 @@ int main(int argc, char **argv) {
                 else if(!strcmp(argv[i], "-nolog")) {
                         protoId = 0;
                 }
+                /*
+                *        Sicherungsdatei komprimieren
+                */
+                else if(!strcmp(argv[i], "-z")) {
+                        zipMethod = IFBS_COMPRESS_GZIP;
+                }
+                else if(!strcmp(argv[i], "-zstd")) {
+                        zipMethod = IFBS_COMPRESS_ZSTD;
+                }
+                /*
+                *        Binaere Sicherungsdatei
+                */
+                else if(!strcmp(argv[i], "-fbb")) {
+                        fbbFormat = 1;
+                }
+                /*
+                *        Datei umwandeln (.fbd <-> .fbb), ohne Server
+                */
+                else if(!strcmp(argv[i], "-convert")) {
+                        if(i + 2 < argc) {
+                convIn = argv[i + 1];
+                convOut = argv[i + 2];
+                i += 2;
+                        } else {
+                                goto HELP;
+                        }
+                }
+                /*
+                *        Zwei Dateien vergleichen, ohne Server
+                */
+                else if(!strcmp(argv[i], "-compare")) {
+                        if(i + 3 < argc) {
+                cmpOld = argv[i + 1];
+                cmpNew = argv[i + 2];
+                cmpProto = argv[i + 3];
+                i += 3;
+                        } else {
+                                goto HELP;
+                        }
+                }
+                /*
+                *        Nach Pfaden sortierte Dateien blockweise vergleichen
+                */
+                else if(!strcmp(argv[i], "-sorted")) {
+                IFBS_SetSortedCompare(1);
+                }
+                /*
+                *        Server mit Datei abgleichen, nur Differenzen schreiben
+                */
+                else if(!strcmp(argv[i], "-sync")) {
+                        i++;
+                        if(i<argc) {
+                syncfile = argv[i];
+                        } else {
+                                goto HELP;
+                        }
+                }
+                /*
+                *        Vergleichsprotokoll auf den Server anwenden
+                */
+                else if(!strcmp(argv[i], "-update")) {
+                        i++;
+                        if(i<argc) {
+                updfile = argv[i];
+                        } else {
+                                goto HELP;
+                        }
+                }
+                /*
+                *        Aktuelle Werte vorher lesen, nur Aenderungen schreiben
+                */
+                else if(!strcmp(argv[i], "-changed")) {
+                IFBS_SetSkipUnchanged(1);
+                }
+                /*
+                *        Instanzen und Verbindungen inaktiv anlegen, am Ende
+                *        mit wenigen SetVar-Diensten aktivieren
+                */
+                else if(!strcmp(argv[i], "-staged")) {
+                IFBS_SetStagedActivation(1);
+                }
                 else if(!strcmp(argv[i], "-upload")) {
                         i++;
                         if(i<argc) {
@@ -391,6 +776,24 @@ HELP:                fprintf(stderr, "\nUsage: fb_dbcommands [arguments]\n"
                                 "-uploadPwd    PASSWORD       password for replace library\n"
                                 "-all                         Save, clean or load all fb-server on host HOST (option \"-s HOST\")\n"
                                 "-nolog                       Do not protocol file\n"
+                                "-z                           Save and load NAME.fbd.gz (gzip compressed)\n"
+                                "-zstd                        Save and load NAME.fbd.zst (zstd compressed)\n"
+                                "-fbb                         Save and load NAME.fbb (binary, faster to load)\n"
+                                "-convert      IN OUT         Convert IN to OUT (.fbd <-> .fbb) without a server\n"
+                                "-compare      OLD NEW LOG    Compare the saves OLD and NEW without a server, write the changes to LOG\n"
+                                "-sorted                      With -compare read the files block by block (both sorted by path)\n"
+                                "-sync         FILE           Bring the server in line with FILE, write only the differences\n"
+                                "-update       FILE           Apply the changes in FILE (a -compare log) to the server\n"
+                                "-changed                     With -update read the values first and skip those the server already has\n"
+                                "-staged                      Load with actimode=0 and on=FALSE, restore the values at the end\n"
+                                "-crbatch      N              Create up to N instances per request on load (default 256)\n"
+                                "-varbatch     N              Read up to N variables per request on save (default 1024)\n"
+                                "-setbatch     N              Write up to N variables per request on load and update (default 1024)\n"
+                                "-delbatch     N              Delete, link or unlink up to N objects per request (default 256)\n"
+                                "-window       N              Keep reads of up to N instances outstanding on save (default 256)\n"
+                                "-conn         N              Save and load using N parallel connections to the server (default 1)\n"
+                                "-pthreads     N              Parse the load file with up to N threads (default: number of processors)\n"
+                                "-j            N              With -all work on up to N servers at the same time (default 1)\n"
                                 "-h OR --help                 Display this help message and exit\n"
                                 "\n"
                                 "Sample:\n"
@@ -409,10 +812,38 @@ HELP:                fprintf(stderr, "\nUsage: fb_dbcommands [arguments]\n"
                 }
         }
 
-    if((saveId + loadId + cleanId + libNr) == 0 ) {
+    if(convIn != "") {
+        KS_RESULT convErr = IFBS_FBDCONVERT(convIn, convOut);
+        if(convErr) {
+            fprintf(stderr," Fehler beim Umwandeln der Datei '%s'.\n    Nr. 0x%x (%s)\n    Datei '%s'\n\n",
+                    (const char*)convIn, convErr, GetErrorCode(convErr), (const char*)convOut);
+        } else {
+            fprintf(stderr," Datei '%s' umgewandelt. Dateiname: '%s'\n",
+                    (const char*)convIn, (const char*)convOut);
+        }
+        return convErr ? 1 : 0;
+    }
+
+    if(cmpOld != "") {
+        KS_RESULT cmpErr = IFBS_DBCOMPARE(cmpOld, cmpNew, cmpProto);
+        if(cmpErr) {
+            fprintf(stderr," Fehler beim Vergleich der Dateien '%s' und '%s'.\n    Nr. 0x%x (%s)\n    Protokoll '%s'\n\n",
+                    (const char*)cmpOld, (const char*)cmpNew, cmpErr, GetErrorCode(cmpErr), (const char*)cmpProto);
+        } else {
+            fprintf(stderr," Dateien '%s' und '%s' verglichen. Protokoll: '%s'\n",
+                    (const char*)cmpOld, (const char*)cmpNew, (const char*)cmpProto);
+        }
+        return cmpErr ? 1 : 0;
+    }
+
+    if( ((saveId + loadId + cleanId + libNr) == 0) && (syncfile == "") && (updfile == "") ) {
         fprintf(stderr, "\n\n Option ?\n");
         goto HELP;
     }
+    if( allId && ((syncfile != "") || (updfile != "")) ) {
+        fprintf(stderr, "\n\n Option -sync or -update only for one server\n");
+        goto HELP;
+    }
 
 
  PltString  hs(servername);
@@ -423,14 +854,15 @@ HELP:                fprintf(stderr, "\nUsage: fb_dbcommands [arguments]\n"
  
  // Alle FB-Servers ?
  if(allId) {
-    err = doAllServers(hs, filename, saveId, cleanId, loadId, protoId, libNr, libArr, PWD);
+    err = doAllServers(hs, filename, saveId, cleanId, loadId, protoId, libNr, libArr, PWD, jobs);
     return err;
  } else {
     getFileNameFromHS(hs, filename, logfile);
     if(protoId == 0) {
         logfile = "";
     }
-    err = doOneServer(hs, filename, logfile, saveId, cleanId, loadId, libNr, libArr, PWD);
+    err = doOneServer(hs, filename, logfile, saveId, cleanId, loadId, libNr, libArr, PWD,
+                      0, syncfile, updfile);
  }
  
  return err ? 1 : 0;
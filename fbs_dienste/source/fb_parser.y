@@ -38,7 +38,7 @@
 *   bison C declarations
 *   --------------------
 */
-%{
+%code requires {
 /*
 *    Includes
 */
@@ -46,17 +46,28 @@
 #include "par_param.h"
 #include <stdio.h>
 #include <stdlib.h>
-
-void iFBS_SetParserError(int, char*);
+#include <string.h>
+}
 
 /*
-*    globale Variablen
+*    Reentranter Parser. Alle Daten der Sitzung liegen in ctx
 */
+%define api.pure full
+%lex-param   {void* scanner}
+%parse-param {void* scanner} {FB_PARSE_CONTEXT* ctx}
 
-//extern int                 current_line;
-//extern Dienst_param*     ppar;
+%code {
+/*
+*    Funktionsprototypen
+*/
+int yylex(YYSTYPE* yylval_param, void* scanner);
+static int yyerror(void* scanner, FB_PARSE_CONTEXT* ctx, const char* s);
 
-%}
+/*
+*    Art des ersten und letzten Blocks merken (fb_parser_merge)
+*/
+#define FB_PARSER_BLOCK(kind) { if(!ctx->first_block) ctx->first_block = (kind); ctx->last_block = (kind); }
+}
 /*****************************************************************************/
 /*
 *   bison declarations
@@ -76,6 +87,13 @@ void iFBS_SetParserError(int, char*);
         LinksItems*             link;
         DelInstItems*           delinstans;
         PortType                pt;
+        ParserTails             tails;
+        InstanceList            inst_list;
+        LinksList               link_list;
+        ChildList               child_list;
+        DelInstList             delinst_list;
+        VariablesList           var_list;
+        VariableItemList        item_list;
 }
 /*
 *   Typen von Terminalen (Token)
@@ -88,14 +106,19 @@ void iFBS_SetParserError(int, char*);
                     TOK_CHILDREN TOK_END_LINK 
                     TOK_PARAM_PORT TOK_INPUT_PORT TOK_DUMMY_PORT
                     TOK_LIBRARY TOK_END_LIBRARY TOK_STATE
-%type<variable>     scalar_variable_value variable_values_opt variable_values
+%type<variable>     scalar_variable_value variable_values_opt
                     variable_value variable_values_block_opt vector_variable_value
-%type<var_item>     scalar_value vector_value vector_value_list
-%type<par>          blocks block
-%type<instans>      instance_block instance_blocks
-%type<link>         link_block link_blocks
-%type<ch_path>      child_paths
-%type<delinstans>   newlibs_blocks newlibs_block
+%type<var_list>     variable_values
+%type<var_item>     scalar_value vector_value
+%type<item_list>    vector_value_list
+%type<tails>        blocks
+%type<instans>      instance_block
+%type<inst_list>    instance_blocks
+%type<link>         link_block
+%type<link_list>    link_blocks
+%type<child_list>   child_paths
+%type<delinstans>   newlibs_block
+%type<delinst_list> newlibs_blocks
 %type<pt>           port_types
 %type<string>       state_opt
 /*****************************************************************************/
@@ -117,85 +140,76 @@ start:*/                                        /* empty */
 ;
 */
 
-blocks:                 {
-                        /* empty */
-                        }
-                        | block
-                        {
-                            $$ = $1;
-                        }
-                        | blocks block
+blocks:                 /* empty */
                         {
-                            $$ = $2;
+                            /* Ende der bereits vorhandenen Listen suchen */
+                            $$.Instance = ctx->par->Instance;
+                            while($$.Instance && $$.Instance->next) {
+                                $$.Instance = $$.Instance->next;
+                            }
+                            $$.Links = ctx->par->Links;
+                            while($$.Links && $$.Links->next) {
+                                $$.Links = $$.Links->next;
+                            }
+                            $$.NewLibs = ctx->par->NewLibs;
+                            while($$.NewLibs && $$.NewLibs->next) {
+                                $$.NewLibs = $$.NewLibs->next;
+                            }
                         }
-;
-block:                  instance_blocks
+                        | blocks instance_blocks
                         {
-                            InstanceItems* pII;
-                            /* Schon Instanzen gefunden ? */
-                            if (ppar->Instance) {
-                                /* Neue Instanz am Ende hinzufuegen */
-                                pII = ppar->Instance;
-                                while(pII->next) {
-                                    pII=pII->next;
-                                }
-                                pII->next = $1;
-                                    
+                            $$ = $1;
+                            /* Neue Instanzen am Ende hinzufuegen */
+                            if($$.Instance) {
+                                $$.Instance->next = $2.first;
                             } else {
                                 /* Noch keine Instanzen */
-                                ppar->Instance = $1;
+                                ctx->par->Instance = $2.first;
                             }
-                            $$ = ppar;
+                            $$.Instance = $2.last;
+                            FB_PARSER_BLOCK(FB_BLOCK_INSTANCE);
                         }
-                        | link_blocks
+                        | blocks link_blocks
                         {
-                            LinksItems* pLI;
+                            $$ = $1;
                             /* Schon Links gefunden ? */
-                            if(ppar->Links) {
+                            if($$.Links) {
                                 /* Am Ende hinzufuegen */
-                                pLI = ppar->Links;
-                                while(pLI->next) {
-                                    pLI=pLI->next;
-                                }
-                                pLI->next = $1;
-                                
-                                /* Doppelte Eintraege? */
-                                fb_parser_checkstruct(ppar);
+                                $$.Links->next = $2.first;
                                 
+                                /* Doppelte Eintraege? Liefert das neue Listen-Ende */
+                                $$.Links = fb_parser_checkstruct(ctx);
                             } else {
                                 /* Noch keine Links */
-                                ppar->Links = $1;
+                                ctx->par->Links = $2.first;
+                                $$.Links = $2.last;
                             }
-                            $$ = ppar;
+                            ctx->link_runs++;
+                            FB_PARSER_BLOCK(FB_BLOCK_LINK);
                         }
-                        | newlibs_blocks
+                        | blocks newlibs_blocks
                         {
-                            DelInstItems* pDI;
-                            if(ppar->NewLibs) {
-                                pDI=ppar->NewLibs;
-                                while(pDI->next) {
-                                    pDI=pDI->next;
-                                }
-                                pDI->next = $1;
+                            $$ = $1;
+                            if($$.NewLibs) {
+                                $$.NewLibs->next = $2.first;
                             } else {
-                                ppar->NewLibs = $1;
+                                ctx->par->NewLibs = $2.first;
                             }
-                            $$ = ppar;
+                            $$.NewLibs = $2.last;
+                            FB_PARSER_BLOCK(FB_BLOCK_LIBRARY);
                         }
 ;
 instance_blocks:        instance_block
                         {
-                            $$ = $1;
+                            $$.first = $1;
+                            $$.last = $1;
                         }
                         | instance_blocks instance_block
                         {
-                            InstanceItems *pInstList = $1;
                             /* Neue Instanze am List-Ende hinzufuegen */
-                            while( pInstList->next) {
-                                pInstList = pInstList->next;
-                            }
-                            pInstList->next = $2;
                             $$ = $1;
+                            $$.last->next = $2;
+                            $$.last = $2;
                         }
 ;
 instance_block:         TOK_INSTANCE TOK_PATH ':'
@@ -203,26 +217,10 @@ instance_block:         TOK_INSTANCE TOK_PATH ':'
                             variable_values_block_opt
                             TOK_END_INSTANCE ';'
                         {
-                            Variables      *pVar;
-                            InstanceItems  *pinst = (InstanceItems*)malloc(sizeof(InstanceItems));
+                            InstanceItems  *pinst = (InstanceItems*)fb_parser_alloc(ctx, sizeof(InstanceItems));
                                                         
                             if( (!$2) || (!$5) || (!pinst) ) {
-                                if(pinst) free(pinst);
-                                pVar = $7;
-                                while(pVar) {
-                                    $7 = pVar->next;
-                                    if(pVar->value) {
-                                        VariableItem *pVal = pVar->value;
-                                        while(pVal) {
-                                            pVar->value = pVar->value->next;
-                                            free(pVal);
-                                            pVal = pVar->value;
-                                        }
-                                    }
-                                    free(pVar);
-                                    pVar = $7;
-                                }
-                                yyerror("out of memory");
+                                yyerror(scanner, ctx, "out of memory");
                                 return EXIT_FAILURE;
                             }
                             pinst->next = 0;
@@ -235,16 +233,15 @@ instance_block:         TOK_INSTANCE TOK_PATH ':'
 ;
 link_blocks:                link_block
                             {
-                                $$ = $1;
+                                $$.first = $1;
+                                $$.last = $1;
                             }
                             | link_blocks link_block
                             {
-                                LinksItems *pLinkList = $1;
                                 /* Neues Itens am ende der Liste hinzufuegen */
-                                while ( pLinkList->next)
-                                        pLinkList = pLinkList->next;
-                                pLinkList->next = $2;
                                 $$ = $1;
+                                $$.last->next = $2;
+                                $$.last = $2;
                             }
 ;
 link_block:                 TOK_LINK TOK_OF_ASSOCIATION TOK_IDENTIFIER ';'
@@ -255,18 +252,10 @@ link_block:                 TOK_LINK TOK_OF_ASSOCIATION TOK_IDENTIFIER ';'
                             TOK_END_LINK ';'
                             {
                                 LinksItems*         plink;
-                                Child*              pchild;
                                                         
-                                plink = (LinksItems*)malloc(sizeof(LinksItems));
-                                if( (!plink) || (!$11) || (!$14) || (!$20) ) {
-                                    if(plink) free(plink);
-                                    pchild = $20;
-                                    while(pchild) {
-                                        $20 = pchild->next;
-                                        free(pchild);
-                                        pchild = $20;
-                                    }
-                                    yyerror("out of memory");
+                                plink = (LinksItems*)fb_parser_alloc(ctx, sizeof(LinksItems));
+                                if( (!plink) || (!$11) || (!$14) || (!$20.first) ) {
+                                    yyerror(scanner, ctx, "out of memory");
                                     return EXIT_FAILURE;
                                 }
                                 plink->next = 0;
@@ -276,7 +265,7 @@ link_block:                 TOK_LINK TOK_OF_ASSOCIATION TOK_IDENTIFIER ';'
                                 plink->parent_path = $11;
                                 plink->child_role = $14;
                                 plink->child_class = $17;
-                                plink->children = $20;
+                                plink->children = $20.first;
 
                                 $$ = plink;
                             }
@@ -285,66 +274,59 @@ child_paths:                TOK_PATH
                             {
                                 Child* pchild;
                                 if(!$1) {
-                                    yyerror("out of memory");
+                                    yyerror(scanner, ctx, "out of memory");
                                     return EXIT_FAILURE;
                                 }
-                                pchild = (Child*)malloc(sizeof(Child));
+                                pchild = (Child*)fb_parser_alloc(ctx, sizeof(Child));
                                 if(!pchild) {
-                                    yyerror("out of memory");
+                                    yyerror(scanner, ctx, "out of memory");
                                     return EXIT_FAILURE;
                                 }
                                 pchild->next = 0;
                                 pchild->child_path = $1;
-                                $$ = pchild;
+                                $$.first = pchild;
+                                $$.last = pchild;
                             }
                             | child_paths ',' TOK_PATH
                             {
                                 Child* pchild;
-                                Child* pchilds;
                                 
                                 if(!$3) {
-                                    yyerror("out of memory");
+                                    yyerror(scanner, ctx, "out of memory");
                                     return EXIT_FAILURE;
                                 }
-                                pchild = (Child*)malloc(sizeof(Child));
+                                pchild = (Child*)fb_parser_alloc(ctx, sizeof(Child));
                                 if(!pchild) {
-                                    yyerror("out of memory");
+                                    yyerror(scanner, ctx, "out of memory");
                                     return EXIT_FAILURE;
                                 }
                                 pchild->next = 0;
                                 pchild->child_path = $3;
                                 
                                 /* Neues Element am ende der Liste hinzufuegen */
-                                pchilds = $1;
-                                while(pchilds->next) {
-                                    pchilds = pchilds->next;
-                                }
-                                pchilds->next = pchild;
                                 $$ = $1;
+                                $$.last->next = pchild;
+                                $$.last = pchild;
                             }
 ;
 newlibs_blocks:             newlibs_block
                             {
-                                $$ = $1;
+                                $$.first = $1;
+                                $$.last = $1;
                             }
                             | newlibs_blocks newlibs_block
                             {
-                                DelInstItems* pdelinst;
-                                pdelinst = $1;
                                 /* Neue Bibliothek am Ende der Liste hinzufuegen */
-                                while ( pdelinst->next) {
-                                        pdelinst = pdelinst->next;
-                                }
-                                pdelinst->next = $2;
                                 $$ = $1;
+                                $$.last->next = $2;
+                                $$.last = $2;
                             }
 ;
 newlibs_block:              TOK_LIBRARY TOK_IDENTIFIER TOK_END_LIBRARY ';'
                             {
-                                    DelInstItems* pd = (DelInstItems*)malloc(sizeof(DelInstItems));
+                                    DelInstItems* pd = (DelInstItems*)fb_parser_alloc(ctx, sizeof(DelInstItems));
                                     if( (!pd) || (!$2) ) {
-                                        if(pd) free(pd);
-                                        yyerror("out of memory");
+                                        yyerror(scanner, ctx, "out of memory");
                                         return EXIT_FAILURE;
                                     }
                                     pd->next = NULL;
@@ -354,10 +336,9 @@ newlibs_block:              TOK_LIBRARY TOK_IDENTIFIER TOK_END_LIBRARY ';'
                             }
                             | TOK_LIBRARY TOK_PATH TOK_END_LIBRARY ';'
                             {
-                                    DelInstItems* pd = (DelInstItems*)malloc(sizeof(DelInstItems));
+                                    DelInstItems* pd = (DelInstItems*)fb_parser_alloc(ctx, sizeof(DelInstItems));
                                     if( (!pd) || (!$2) ) {
-                                        if(pd) free(pd);
-                                        yyerror("out of memory");
+                                        yyerror(scanner, ctx, "out of memory");
                                         return EXIT_FAILURE;
                                     }
                                     pd->next = NULL;
@@ -381,26 +362,28 @@ variable_values_opt:        /* empty */
                             }
                             | variable_values
                             {
-                                $$ = $1;
+                                $$ = $1.first;
                             }
 ;
 variable_values:            variable_value
                             {
-                                    $$ = $1;
+                                    $$.first = $1;
+                                    $$.last = $1;
                             }
                             | variable_values variable_value
                             {
-                                Variables* pVarList = $1;
-                                /* Schon Variable vorhanden? */
-                                if(pVarList) {
-                                    /* Am Ende der Var-Liste hinzufuegen */
-                                    while ( pVarList->next)
-                                            pVarList = pVarList->next;
-                                    pVarList->next = $2;
-                                    $$=$1;
-                                } else {
-                                    /* Es waren nur Dummy-Ports */
-                                    $$=$2;
+                                $$ = $1;
+                                /* Dummy-Ports liefern keine Variable */
+                                if($2) {
+                                    /* Schon Variable vorhanden? */
+                                    if($$.last) {
+                                        /* Am Ende der Var-Liste hinzufuegen */
+                                        $$.last->next = $2;
+                                    } else {
+                                        /* Es waren nur Dummy-Ports */
+                                        $$.first = $2;
+                                    }
+                                    $$.last = $2;
                                 }
                             }
 ;
@@ -423,11 +406,9 @@ scalar_variable_value:       TOK_IDENTIFIER ':' port_types TOK_DATATYPE '=' scal
                                                         
                                 if($3) {
                                     /* Es ist Input oder Parameter Port */
-                                    pvar = (Variables*)malloc(sizeof(Variables));
+                                    pvar = (Variables*)fb_parser_alloc(ctx, sizeof(Variables));
                                     if( (!pvar) || (!$1) ) {
-                                        if(pvar) free(pvar);
-                                        free($6);
-                                        yyerror("out of memory");
+                                        yyerror(scanner, ctx, "out of memory");
                                         return EXIT_FAILURE;
                                     }
                                     pvar->next = 0;
@@ -446,56 +427,56 @@ scalar_variable_value:       TOK_IDENTIFIER ':' port_types TOK_DATATYPE '=' scal
                                     switch($4) {        /* Verzweigung : Typ der Variable */
                                         case KS_VT_BOOL:
                                                             if(pvar->value->value_type != DT_BOOLIAN) {
-                                                                yyerror("Bad variable type");
+                                                                yyerror(scanner, ctx, "Bad variable type");
                                                                 return EXIT_FAILURE;
                                                             }
                                                             break;
                                         case KS_VT_INT:
                                                             if(pvar->value->value_type != DT_GANZZAHL) {
-                                                                yyerror("Bad variable type");
+                                                                yyerror(scanner, ctx, "Bad variable type");
                                                                 return EXIT_FAILURE;
                                                             }
                                                             break;
                                         case KS_VT_UINT:
                                                             if(pvar->value->value_type != DT_GANZZAHL) {
-                                                                yyerror("Bad variable type");
+                                                                yyerror(scanner, ctx, "Bad variable type");
                                                                 return EXIT_FAILURE;
                                                             }
                                                             break;
                                         case KS_VT_SINGLE:
                                                             if( (pvar->value->value_type != DT_FLIESSCOMMA) &&
                                                                 (pvar->value->value_type != DT_GANZZAHL) ) {
-                                                                yyerror("Bad variable type");
+                                                                yyerror(scanner, ctx, "Bad variable type");
                                                                 return EXIT_FAILURE;
                                                             }
                                                             break;
                                         case KS_VT_DOUBLE:
                                                             if( (pvar->value->value_type != DT_FLIESSCOMMA) &&
                                                                 (pvar->value->value_type != DT_GANZZAHL) ) {
-                                                                yyerror("Bad variable type");
+                                                                yyerror(scanner, ctx, "Bad variable type");
                                                                 return EXIT_FAILURE;
                                                             }
                                                             break;
                                         case KS_VT_TIME:
                                                             if(pvar->value->value_type != DT_TIMESTRUCT) {
-                                                                yyerror("Bad variable type");
+                                                                yyerror(scanner, ctx, "Bad variable type");
                                                                 return EXIT_FAILURE;
                                                             }
                                                             break;
                                         case KS_VT_TIME_SPAN:
                                                             if(pvar->value->value_type != DT_FLIESSCOMMA) {
-                                                                yyerror("Bad variable type");
+                                                                yyerror(scanner, ctx, "Bad variable type");
                                                                 return EXIT_FAILURE;
                                                             }
                                                             break;
                                         case KS_VT_STRING:
                                                             if(pvar->value->value_type != DT_ZEICHEN) {
-                                                                yyerror("Bad variable type");
+                                                                yyerror(scanner, ctx, "Bad variable type");
                                                                 return EXIT_FAILURE;
                                                             }
                                                             break;
                                             default:
-                                                            yyerror("Unknown variable type");
+                                                            yyerror(scanner, ctx, "Unknown variable type");
                                                             return EXIT_FAILURE;
                                     }
                             
@@ -505,8 +486,7 @@ scalar_variable_value:       TOK_IDENTIFIER ':' port_types TOK_DATATYPE '=' scal
                                 
                                 } else {
                                     /* Es ist Hidden oder Output Port */
-                                    /* Speicher freigeben */
-                                    if($6) free($6);
+                                    /* Speicher gehoert dem Parser */
                                     $$ = NULL;
                                 }
                             }
@@ -518,7 +498,7 @@ state_opt:                  /* empty */
                             | TOK_STATE '=' TOK_INTEGERVALUE
                             {
                                 if(!$3) {
-                                    yyerror("out of memory");
+                                    yyerror(scanner, ctx, "out of memory");
                                     return EXIT_FAILURE;
                                 }
                                 $$ = $3;
@@ -536,16 +516,9 @@ vector_variable_value:      TOK_IDENTIFIER '[' TOK_INTEGERVALUE ']' ':' port_typ
 
                                 if($6) {
                                     /* Es ist Input oder Parameter Port */
-                                    pvar = (Variables*)malloc(sizeof(Variables));
+                                    pvar = (Variables*)fb_parser_alloc(ctx, sizeof(Variables));
                                     if(( !pvar) || (!$1) || (!$3) ) {
-                                        if(pvar) free(pvar);
-                                        pvar_item = $9;
-                                        while(pvar_item) {
-                                            $9 = pvar_item->next;
-                                            free(pvar_item);
-                                            pvar_item = $9;
-                                        }
-                                        yyerror("out of memory");
+                                        yyerror(scanner, ctx, "out of memory");
                                         return EXIT_FAILURE;
                                     }
 
@@ -569,56 +542,56 @@ vector_variable_value:      TOK_IDENTIFIER '[' TOK_INTEGERVALUE ']' ':' port_typ
                                             switch(pvar->var_typ) {        /* Verzweigung Typ der Variable */
                                                 case KS_VT_BOOL:
                                                                     if(pvar_item->value_type != DT_BOOLIAN) {
-                                                                        yyerror("Bad variable type");
+                                                                        yyerror(scanner, ctx, "Bad variable type");
                                                                         return EXIT_FAILURE;
                                                                     }
                                                                     break;
                                                 case KS_VT_INT:
                                                                     if(pvar_item->value_type != DT_GANZZAHL) {
-                                                                        yyerror("Bad variable type");
+                                                                        yyerror(scanner, ctx, "Bad variable type");
                                                                         return EXIT_FAILURE;
                                                                     }
                                                                     break;
                                                 case KS_VT_UINT:
                                                                     if(pvar_item->value_type != DT_GANZZAHL) {
-                                                                        yyerror("Bad variable type");
+                                                                        yyerror(scanner, ctx, "Bad variable type");
                                                                         return EXIT_FAILURE;
                                                                     }
                                                                     break;
                                                 case KS_VT_SINGLE:
                                                                     if( (pvar_item->value_type != DT_FLIESSCOMMA) &&
                                                                         (pvar->value->value_type != DT_GANZZAHL) ) {
-                                                                        yyerror("Bad variable type");
+                                                                        yyerror(scanner, ctx, "Bad variable type");
                                                                         return EXIT_FAILURE;
                                                                     }
                                                                     break;
                                                 case KS_VT_DOUBLE:
                                                                     if( (pvar_item->value_type != DT_FLIESSCOMMA) &&
                                                                         (pvar->value->value_type != DT_GANZZAHL) ) {
-                                                                        yyerror("Bad variable type");
+                                                                        yyerror(scanner, ctx, "Bad variable type");
                                                                         return EXIT_FAILURE;
                                                                     }
                                                                     break;
                                                 case KS_VT_TIME:
                                                                     if(pvar_item->value_type != DT_TIMESTRUCT) {
-                                                                        yyerror("Bad variable type");
+                                                                        yyerror(scanner, ctx, "Bad variable type");
                                                                         return EXIT_FAILURE;
                                                                     }
                                                                     break;
                                                 case KS_VT_TIME_SPAN:
                                                                     if(pvar_item->value_type != DT_FLIESSCOMMA) {
-                                                                        yyerror("Bad variable type");
+                                                                        yyerror(scanner, ctx, "Bad variable type");
                                                                         return EXIT_FAILURE;
                                                                     }
                                                                 break;
                                                 case KS_VT_STRING:
                                                                 if(pvar_item->value_type != DT_ZEICHEN) {
-                                                                    yyerror("Bad variable type");
+                                                                    yyerror(scanner, ctx, "Bad variable type");
                                                                     return EXIT_FAILURE;
                                                                 }
                                                                 break;
                                                 default:
-                                                        yyerror("Unknown variable type");
+                                                        yyerror(scanner, ctx, "Unknown variable type");
                                                         return EXIT_FAILURE;
                                             }
                                             pvar_item->value_type = (DataType)$7;
@@ -629,11 +602,11 @@ vector_variable_value:      TOK_IDENTIFIER '[' TOK_INTEGERVALUE ']' ':' port_typ
                                 
                                     /* Anzahl elementen pruefen */
                                     if(count > pvar->len) {
-                                        yyerror("Too many arguments for initialization.");
+                                        yyerror(scanner, ctx, "Too many arguments for initialization.");
                                         return EXIT_FAILURE;
                                     }
                                     if(count < pvar->len) {
-                                        yyerror("Too little arguments for initialization.");
+                                        yyerror(scanner, ctx, "Too little arguments for initialization.");
                                         return EXIT_FAILURE;
                                     }
 
@@ -641,13 +614,7 @@ vector_variable_value:      TOK_IDENTIFIER '[' TOK_INTEGERVALUE ']' ':' port_typ
 
                                 } else {
                                     /* Es ist Hidden oder Output Port */
-                                    /* Speicher freigeben */
-                                    pvar_item = $9;
-                                    while(pvar_item) {
-                                        $9 = pvar_item->next;
-                                        free(pvar_item);
-                                        pvar_item = $9;
-                                    }
+                                    /* Speicher gehoert dem Parser */
                                     $$ = NULL;
                                 }
                             }
@@ -663,29 +630,28 @@ port_types:                 TOK_INPUT_PORT
 ;
 vector_value:              '{' vector_value_list '}'
                             {
-                                $$ = $2;
+                                $$ = $2.first;
                             }
 ;
 vector_value_list:          /* empty */
                             {
-                                $$ = NULL;
+                                $$.first = NULL;
+                                $$.last = NULL;
                             }
                             | scalar_value
                             {
-                                $$ = $1;
+                                $$.first = $1;
+                                $$.last = $1;
                             }
                             | vector_value_list ',' scalar_value
                             { 
-                                VariableItem* pvar_item = $1;
+                                $$ = $1;
                                     
                                 /* Neues Array Element am Ende der Liste hinzufuegen */
-                                if(pvar_item) {
-                                    while(pvar_item->next) {
-                                        pvar_item=pvar_item->next;
-                                    }
-                                    pvar_item->next = $3;
+                                if( $$.first && $3 ) {
+                                    $$.last->next = $3;
+                                    $$.last = $3;
                                 }
-                                $$ = $1;
                             }
 ;
 scalar_value:               /* empty */
@@ -694,13 +660,13 @@ scalar_value:               /* empty */
                             }
                             | TOK_FLOATVALUE 
                             {
-                                VariableItem* pvar_item = (VariableItem*)malloc(sizeof(VariableItem));
+                                VariableItem* pvar_item = (VariableItem*)fb_parser_alloc(ctx, sizeof(VariableItem));
                                 if( (!pvar_item) || (!$1) ) {
-                                    if(pvar_item) free(pvar_item);
-                                    yyerror("out of memory");
+                                    yyerror(scanner, ctx, "out of memory");
                                     return EXIT_FAILURE;
                                 }
                                 pvar_item->next = 0;
+                                pvar_item->fbb_value = NULL;
                                 pvar_item->value_type = DT_FLIESSCOMMA;
                                 pvar_item->val = $1;
     
@@ -708,13 +674,13 @@ scalar_value:               /* empty */
                             }
                             | TOK_INTEGERVALUE 
                             {
-                                VariableItem* pvar_item = (VariableItem*)malloc(sizeof(VariableItem));
+                                VariableItem* pvar_item = (VariableItem*)fb_parser_alloc(ctx, sizeof(VariableItem));
                                 if((!pvar_item) || (!$1) ) {
-                                    if(pvar_item) free(pvar_item);
-                                    yyerror("out of memory");
+                                    yyerror(scanner, ctx, "out of memory");
                                     return EXIT_FAILURE;
                                 }
                                 pvar_item->next = 0;
+                                pvar_item->fbb_value = NULL;
                                 pvar_item->value_type = DT_GANZZAHL;
                                 pvar_item->val = $1;
     
@@ -722,13 +688,13 @@ scalar_value:               /* empty */
                             }
                             | TOK_BOOLVALUE 
                             {
-                                VariableItem* pvar_item = (VariableItem*)malloc(sizeof(VariableItem));
+                                VariableItem* pvar_item = (VariableItem*)fb_parser_alloc(ctx, sizeof(VariableItem));
                                 if((!pvar_item) || (!$1) ) {
-                                    if(pvar_item) free(pvar_item);
-                                    yyerror("out of memory");
+                                    yyerror(scanner, ctx, "out of memory");
                                     return EXIT_FAILURE;
                                 }
                                 pvar_item->next = 0;
+                                pvar_item->fbb_value = NULL;
                                 pvar_item->value_type = DT_BOOLIAN;
                                 pvar_item->val = $1;
     
@@ -736,13 +702,13 @@ scalar_value:               /* empty */
                             }
                             | TOK_STRINGVALUE 
                             {
-                                VariableItem* pvar_item = (VariableItem*)malloc(sizeof(VariableItem));
+                                VariableItem* pvar_item = (VariableItem*)fb_parser_alloc(ctx, sizeof(VariableItem));
                                 if((!pvar_item) || (!$1) ) {
-                                    if(pvar_item) free(pvar_item);
-                                    yyerror("out of memory");
+                                    yyerror(scanner, ctx, "out of memory");
                                     return EXIT_FAILURE;
                                 }
                                 pvar_item->next = 0;
+                                pvar_item->fbb_value = NULL;
                                 pvar_item->value_type = DT_ZEICHEN;
     
                                 pvar_item->val = $1;
@@ -750,13 +716,13 @@ scalar_value:               /* empty */
                             }
                             |  TOK_TIMEVALUE
                             {
-                                VariableItem* pvar_item = (VariableItem*)malloc(sizeof(VariableItem));
+                                VariableItem* pvar_item = (VariableItem*)fb_parser_alloc(ctx, sizeof(VariableItem));
                                 if((!pvar_item) || (!$1) ) {
-                                    if(pvar_item) free(pvar_item);
-                                        yyerror("out of memory");
+                                        yyerror(scanner, ctx, "out of memory");
                                         return EXIT_FAILURE;
                                 }
                                 pvar_item->next = 0;
+                                pvar_item->fbb_value = NULL;
                                 pvar_item->value_type = DT_TIMESTRUCT;
                                 pvar_item->val = $1;
     
@@ -772,13 +738,11 @@ scalar_value:               /* empty */
 /*
 *   Fehlermeldungen
 */
-int yyerror(char *s)
+static int yyerror(void* scanner, FB_PARSE_CONTEXT* ctx, const char* s)
 {
-  static char msg[1024];
-  
-  strcpy(msg, s);
-  
-  iFBS_SetParserError(current_line+1, msg);
+  ctx->error_line = ctx->current_line+1;
+  strncpy(ctx->error_msg, s, sizeof(ctx->error_msg) - 1);
+  ctx->error_msg[sizeof(ctx->error_msg) - 1] = 0;
   
   return EXIT_FAILURE;
 }
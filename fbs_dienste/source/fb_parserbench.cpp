@@ -0,0 +1,213 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   fb_parserbench.cpp                                                       *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Laufzeitmessung des FBD-Parsers. Erzeugt Sicherungsdateien mit 1k bis    *
+*   N Instanz-Bloecken und misst die Zeit fuer das Parsen. Die Zeit je Block *
+*   muss ueber alle Groessen etwa gleich bleiben. Mit -threads wird die      *
+*   Datei in mehreren Parse-Sitzungen gleichzeitig geparst, mit -pthreads    *
+*   wird eine Sitzung geteilt und parallel geparst (IFBS_ParseInput).        *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+#include <thread>
+
+/*
+*   Schreibt eine Sicherungsdatei mit anz Instanzen
+*/
+static int writeBenchFile(const char *filename, long anz, int withLinks) {
+    FILE   *fout;
+    long    i;
+
+    fout = fopen(filename, "w");
+    if(!fout) {
+        return 0;
+    }
+
+    fprintf(fout, " LIBRARY\n    iec61131stdfb\n END_LIBRARY;\n\n");
+
+    for(i = 0; i < anz; i++) {
+        fprintf(fout,
+            " INSTANCE  /TechUnits/bench/add%ld :\n"
+            "    CLASS /Libraries/iec61131stdfb/ADD;\n"
+            "    VARIABLE_VALUES\n"
+            "        actimode : INPUT  INT = 1;\n"
+            "        iexreq : INPUT  BOOL = TRUE;\n"
+            "        IN1 : INPUT  DOUBLE = %ld.5;\n"
+            "        IN2 : INPUT  DOUBLE = 2.0;\n"
+            "        ARR[3] : INPUT  INT = {1,2,3};\n"
+            "        comment : INPUT  STRING = \"block %ld\";\n"
+            "        OUT : OUTPUT DOUBLE = 0.0;\n"
+            "    END_VARIABLE_VALUES;\n"
+            " END_INSTANCE;\n\n", i, i, i);
+
+        if(withLinks) {
+            fprintf(fout,
+                " LINK\n"
+                "    OF_ASSOCIATION  tasklist;\n"
+                "    PARENT  taskparent : CLASS task\n"
+                "        = /Tasks/UrTask;\n"
+                "    CHILDREN  taskchild : CLASS task\n"
+                "        = {/TechUnits/bench/add%ld};\n"
+                " END_LINK;\n\n", i);
+        }
+    }
+
+    fclose(fout);
+    return 1;
+}
+
+/*
+*   Parst die Datei in einer eigenen Sitzung. Ergebnis in *pStatus
+*/
+static void parseBenchSession(const char *filename, int *pStatus) {
+    FB_PARSE_CONTEXT  *ctx;
+
+    *pStatus = EXIT_FAILURE;
+
+    ctx = fb_parser_create();
+    if(!ctx) {
+        return;
+    }
+    if(fb_parser_openfile(ctx, filename)) {
+        *pStatus = IFBS_ParseInput(ctx);
+    }
+    fb_parser_destroy(ctx);
+}
+
+/*
+*   Parst die Datei anzThreads mal gleichzeitig.
+*   Liefert die Laufzeit in Sekunden, < 0 bei Fehler
+*/
+static double parseBenchFile(const char *filename, int anzThreads) {
+    PltArray<std::thread*>  Threads(anzThreads);
+    PltArray<int>           Status(anzThreads);
+    PltTime                 t0, t1;
+    int                     i;
+    int                     ok = 1;
+
+    if( (Threads.size() != (size_t)anzThreads) || (Status.size() != (size_t)anzThreads) ) {
+        return -1.0;
+    }
+
+    t0 = PltTime::now();
+
+    if(anzThreads == 1) {
+        parseBenchSession(filename, &Status[0]);
+    } else {
+        for(i = 0; i < anzThreads; i++) {
+            Threads[i] = new std::thread(parseBenchSession, filename, &Status[i]);
+        }
+        for(i = 0; i < anzThreads; i++) {
+            Threads[i]->join();
+            delete Threads[i];
+        }
+    }
+
+    t1 = PltTime::now();
+
+    for(i = 0; i < anzThreads; i++) {
+        if(Status[i] != EXIT_SUCCESS) {
+            ok = 0;
+        }
+    }
+    if(!ok) {
+        return -1.0;
+    }
+
+    return (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_usec - t0.tv_usec) / 1000000.0;
+}
+
+int main(int argc, char **argv) {
+    const char*     filename = "fb_parserbench.fbd";
+    long            maxAnz = 1000000;
+    long            anz;
+    int             withLinks = 0;
+    int             anzThreads = 1;
+    int             anzParse = 1;
+    int             i;
+    double          sec;
+
+    for(i=1; i<argc; i++) {
+        if(!strcmp(argv[i], "-f")) {
+            i++;
+            if(i<argc) {
+                filename = argv[i];
+            } else {
+                goto HELP;
+            }
+        }
+        else if(!strcmp(argv[i], "-n")) {
+            i++;
+            if( (i<argc) && (atol(argv[i]) >= 1000) ) {
+                maxAnz = atol(argv[i]);
+            } else {
+                goto HELP;
+            }
+        }
+        else if(!strcmp(argv[i], "-links")) {
+            withLinks = 1;
+        }
+        else if(!strcmp(argv[i], "-threads")) {
+            i++;
+            if( (i<argc) && (atoi(argv[i]) > 0) ) {
+                anzThreads = atoi(argv[i]);
+            } else {
+                goto HELP;
+            }
+        }
+        else if(!strcmp(argv[i], "-pthreads")) {
+            i++;
+            if( (i<argc) && (atoi(argv[i]) > 0) ) {
+                anzParse = atoi(argv[i]);
+            } else {
+                goto HELP;
+            }
+        } else {
+HELP:       fprintf(stderr, "\nUsage: fb_parserbench [arguments]\n"
+                            "\n"
+                            "The following optional arguments are available:\n"
+                            "-f            NAME           Temporary file NAME (default 'fb_parserbench.fbd')\n"
+                            "-n            N              Parse files with 1000 up to N instance blocks (default 1000000)\n"
+                            "-links                       Write a task link after each instance\n"
+                            "-threads      N              Parse the file N times in parallel sessions (default 1)\n"
+                            "-pthreads     N              Split each session into up to N parts parsed in parallel (default 1)\n"
+                            "\n");
+            return 1;
+        }
+    }
+
+    IFBS_SetParseThreads((size_t)anzParse);
+
+    fprintf(stdout, " %10s %12s %14s\n", "Blocks", "Time [s]", "Time/Block [us]");
+
+    for(anz = 1000; anz <= maxAnz; anz *= 10) {
+        if(!writeBenchFile(filename, anz, withLinks)) {
+            fprintf(stderr, " Can't write file '%s'\n", filename);
+            return 1;
+        }
+
+        sec = parseBenchFile(filename, anzThreads);
+        if(sec < 0) {
+            fprintf(stderr, " Error parsing file '%s'\n", filename);
+            remove(filename);
+            return 1;
+        }
+
+        fprintf(stdout, " %10ld %12.3f %14.3f\n", anz, sec, sec * 1000000.0 / ((double)anz * anzThreads));
+        fflush(stdout);
+    }
+
+    remove(filename);
+
+    return 0;
+}
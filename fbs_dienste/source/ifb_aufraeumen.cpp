@@ -76,14 +76,24 @@ KS_RESULT aufraeumen(KscServerBase*  Server,
         del_inst = del_inst->next;
     }
     
-    // Verbindungen ausschalten und loeschen
+    // Verbindungen und Instanzen ausschalten
     TurnComConOff(Server, VerbList);
-    DelObjsFromList(Server, VerbList, &out);
-
-        
-    // Instanzen aussschalten und loeschen
     TurnInstOff(Server, InstList);
-    res = DelObjsFromList(Server, InstList, &out);
+
+    // Mit einem Loesch-Batch loeschen, erst Verbindungen, dann Instanzen
+    // (Liste in umgekehrter Reihenfolge des Anlegens)
+    IfbsDeleteBatch Del(Server);
+    while(VerbList.size()) {
+        Str = VerbList.removeFirst();
+        Del.addXlinks(Str);
+        Del.addObject(Str, IFBS_DEL_CONNECTION);
+    }
+    while(InstList.size()) {
+        Str = InstList.removeFirst();
+        Del.addXlinks(Str);
+        Del.addObject(Str, IFBS_DEL_INSTANCE);
+    }
+    res = Del.run(&out);
 
     return res;
     
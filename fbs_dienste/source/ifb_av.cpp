@@ -40,6 +40,7 @@ KscAvSimpleModule *CreateClientAV( int &set, PltString &AV) {
 /*****************************************************************************/
 
     static PltString          ticket;
+    // Je Thread ein Modul (paralleles Sichern/Laden mit eigenen Verbindungen)
     static KscAvSimpleModule* AVM = 0;
 
     if( set == 1 ) {
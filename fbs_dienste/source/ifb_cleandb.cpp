@@ -83,6 +83,10 @@ KS_RESULT IFBS_CLEANDB(KscServerBase*  Server, PltString*  Logging) {
     }
 
     err = clean_all_libs(Server, Logging);
+    
+    // Bibliotheken, Klassen und Assoziationen neu lesen
+    IFBS_InvalidateSession(Server, IFBS_SD_LIBDATA);
+    
     if(err) {
         log = IFBS_GetLastLogError();
         if(log == "") {
@@ -166,9 +170,6 @@ KS_RESULT clean_all_inst(KscServerBase*  Server, PltString* Logging) {
     KsGetEPParams       params;
     KsGetEPResult       result;
     KS_RESULT           err = KS_ERR_OK;
-    KS_RESULT           lastErr = KS_ERR_OK;
-    char                *help;
-    char                *ph;
     
     params.path = "/" ;
     params.path += FB_INSTANZ_CONTAINER;
@@ -214,90 +215,38 @@ KS_RESULT clean_all_inst(KscServerBase*  Server, PltString* Logging) {
         }
     }
 
-    while(TuListe.size() ) {
+    // Alles mit einem Loesch-Batch : Verbindungen, Instanzen, Container
+    IfbsDeleteBatch     Del(Server);
+    PltList<PltString>  PartListe;
+    PltList<PltString>  OffListe;
+    KS_RESULT           LastErr = KS_ERR_OK;
 
+    while(TuListe.size() ) {
         hStr = TuListe.removeFirst();
-        err = del_cont_recurs(Server, hStr, Logging);
+        err = del_collect_childs(Server, Del, hStr, 0, OffListe, PartListe, LastErr, Logging);
         if(err) {
             return err;
         }
+        Del.addObject(hStr, IFBS_DEL_CONTAINER);
     }
 
-    // Instanzen ausschalten
-    TurnInstOff(Server, InstListe);
-
-    // Anzahl der Versuche
-    int count = 10;
-    while(count > 0) {
-        PltList<PltString> tmpLst;
-        while(InstListe.size()) {
-            hStr = InstListe.removeFirst();
-
-            err = del_inst_childs(Server, hStr, Logging);
-            if(err) {
-                // Naechste Runde abwarten?
-                lastErr = err;
-                tmpLst.addLast(hStr);
-            } else {
-                delAllXlinks(Server, hStr);
-                err = IFBS_DELETE_OBJ(Server,hStr);
-                if(err) {
-                    // Part?
-                    int part = 0;
-                    help = (char*)((const char*)hStr);
-                    ph = help;
-                    while(ph && (*ph)) ph++;
-                    while(ph != help) {
-                        ph--;
-                        if((*ph) == '.') {
-                            part = 1;
-                            break;
-                        }
-                        if((*ph) == '/') {
-                            // Kein Part
-                            break;
-                        }
-                    }
-                    if(!part) {
-                        lastErr = err;
-                        tmpLst.addLast(hStr);
-                    }
-                } else {
-                    if(Logging && (*Logging) ) {
-                        *Logging += log_getOkMsg("Instance",(const char*)hStr,"deleted.");
-                    }
-                }
-            }
-        }
-        
-        if(tmpLst.size() == 0) {
-            break;
-        }
-        while(tmpLst.size()) {
-            InstListe.addLast(tmpLst.removeFirst());
-        }
-        
-        count--;
-    }
-    
-    // Alle Instanzen geloescht?
     while(InstListe.size()) {
         hStr = InstListe.removeFirst();
-        err = del_inst_childs(Server, hStr, Logging);
-        if(err == KS_ERR_OK) {
-            delAllXlinks(Server, hStr);
-            err = IFBS_DELETE_OBJ(Server,hStr);
-        }
+        err = del_collect_childs(Server, Del, hStr, 1, OffListe, PartListe, LastErr, Logging);
         if(err) {
-            if(Logging && (*Logging)) {
-                *Logging += log_getErrMsg(err,"Instance",(const char*)hStr,"not deleted.");
-            }
-            
-            return err;
+            LastErr = err;
         }
+        Del.addXlinks(hStr);
+        Del.addObject(hStr, IFBS_DEL_INSTANCE);
+        OffListe.addLast(hStr);
+    }
+
+    err = del_run_batch(Server, Del, OffListe, PartListe, Logging);
+    if(err) {
+        return err;
     }
     
-    return KS_ERR_OK;
+    return LastErr;
 }
 
 /******************************************************************************/
@@ -308,10 +257,6 @@ KS_RESULT clean_all_libs(KscServerBase*  Server, PltString* Logging) {
     KsGetEPResult      result;
     PltString          hStr;
     KS_RESULT          err = KS_ERR_OK;
-    KS_RESULT          LastErr = KS_ERR_OK;
-    PltList<PltString> NotDeletedLibs;
-    int                i, anz;
-    int                anzLoops = 5;
     
     params.path = "/" ;
     params.path += FB_LIBRARIES_CONTAINER;
@@ -337,50 +282,17 @@ KS_RESULT clean_all_libs(KscServerBase*  Server, PltString* Logging) {
 
     params.path += "/";
 
+    // Bibliotheken haengen voneinander ab. Abgelehnte Bibliotheken werden
+    // wiederholt, solange andere geloescht werden
+    IfbsDeleteBatch Del(Server);
     while ( result.items.size() ) {
         KsEngPropsHandle hpp = result.items.removeFirst();
         hStr = (const char*)params.path;
         hStr += (const char*)hpp->identifier;
-    
-        err = IFBS_DELETE_OBJ(Server,hStr);
-        if(err) {
-            LastErr = err;
-        }
-        if(Logging && (*Logging) ) {
-            if(err) {
-                *Logging += log_getErrMsg(err,"Can't delete library",
-                            (const char*)hStr);
-                
-                NotDeletedLibs.addLast(hStr);
-                
-            } else {
-                *Logging += log_getOkMsg("Library",(const char*)hStr," deleted.");
-            }
-        }
+        Del.addObject(hStr, IFBS_DEL_LIBRARY, "Library");
     }
     
-    // Gibt es nicht geloeschte Bibliotheken?
-    while(NotDeletedLibs.size() && anzLoops > 0) {
-        anz = NotDeletedLibs.size();
-        for(i=0; i<anz; i++) {
-            hStr = NotDeletedLibs.removeFirst();
-            
-            err = IFBS_DELETE_OBJ(Server,hStr);
-            if(err != KS_ERR_OK) {
-                NotDeletedLibs.addLast(hStr);
-            } else {
-                *Logging += log_getOkMsg("Library",(const char*)hStr,"deleted.");                   
-            }
-        }
-        anzLoops--;
-    }
-    
-    // Alles geloescht?
-    if(NotDeletedLibs.size() > 0) {
-        return LastErr;
-    }
-    
-    return KS_ERR_OK;
+    return Del.run(Logging);
 }
 
 
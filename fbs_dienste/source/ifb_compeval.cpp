@@ -39,6 +39,92 @@
 */
 #include "ifbslibdef.h"
 
+#include <deque>
+
+/*
+*  Haengt die markierten Elemente aus einer Liste aus. Der Speicher gehoert
+*  dem Parser
+*/
+/*****************************************************************************/
+template<class T>
+static void ifb_unlinkItems(T **ppList, std::unordered_set<T*> &removed)
+/*****************************************************************************/
+{
+    T *pItem;
+
+    if(removed.empty()) {
+        return;
+    }
+    while(*ppList) {
+        pItem = *ppList;
+        if(removed.count(pItem)) {
+            *ppList = pItem->next;
+            pItem->next = 0;
+        } else {
+            ppList = &(pItem->next);
+        }
+    }
+    removed.clear();
+}
+
+/*
+*  Ueberschriften der Abschnitte des Vergleichsprotokolls (IFBS_CMP_...)
+*/
+static const char *ifb_CompareTitles[IFBS_CMP_SECTIONS] = {
+    "/*\n* Zu loeschende Bibliotheken :\n* ----------------------------\n*/\n\n",
+    "/*\n* Zu ladende Bibliotheken :\n* -------------------------\n*/\n\n",
+    "/*\n* Zu loeschende Instanzen :\n* -------------------------\n*/\n\n",
+    "\n/*\n* Zu erzeugende Instanzen :\n* -------------------------\n*/\n\n",
+    "\n/*\n* Instanzen mit geaenderten Parameter :\n* -------------------------------------\n*/\n\n",
+    "\n/*\n* Zu loesende Links :\n* -------------------\n*/\n\n",
+    "\n/*\n* Zu erstellende Links :\n* ----------------------\n*/\n\n"
+};
+
+/*****************************************************************************/
+KS_RESULT compare_model(Dienst_param* newpar,
+                        Dienst_param* oldpar,
+                        Dienst_param* upd,
+                        PltString&    msg)
+/*****************************************************************************/
+{
+    /*
+    *  Vergleicht die Modelle ohne Ausgabe. Danach enthalten
+    *    oldpar->NewLibs  : zu loeschende Bibliotheken
+    *    newpar->NewLibs  : zu ladende Bibliotheken
+    *    oldpar->Instance : zu loeschende Instanzen
+    *    newpar->Instance : zu erzeugende Instanzen
+    *    upd->Instance    : Instanzen mit geaenderten Parametern
+    *    oldpar->Links    : zu loesende Links
+    *    newpar->Links    : zu erstellende Links
+    *  Meldungen des Vergleichs (Typ-Fehler) werden an msg angehaengt.
+    */
+    InstanceItems*   phelp;
+    KS_RESULT        fehler;
+
+    compare_libraries(newpar,oldpar);
+
+    fehler = compare_any_inst(newpar,oldpar,upd,msg);
+    if(fehler) {
+            return fehler;
+    }
+
+    IfbsLinkIndex   OldLinks(oldpar->Links);
+
+    phelp = oldpar->Instance;
+    while(phelp) {
+        // Wenn die Instanz eine Verbindung ist, loesche auch ihre links
+        if( !strcmp(phelp->Class_name, CONNECTION_CLASS_PATH) ) {
+            OldLinks.removeChild(phelp->Inst_name);
+        }
+            phelp = phelp->next;
+    }
+    OldLinks.purge(&oldpar->Links);
+
+    get_any_links(newpar, oldpar);
+
+    return KS_ERR_OK;
+}
+
 /*****************************************************************************/
 KS_RESULT compare_eval(Dienst_param* newpar,
                        Dienst_param* oldpar,
@@ -52,8 +138,8 @@ KS_RESULT compare_eval(Dienst_param* newpar,
 
     InstanceItems*   phelp;
     LinksItems*      philf;
-    Child*           pchild;
     DelInstItems*    plibs;
+    PltString        msg;
 
     Dienst_param*    upd = (Dienst_param*)malloc(sizeof(Dienst_param));
     if(!upd) {
@@ -67,104 +153,62 @@ KS_RESULT compare_eval(Dienst_param* newpar,
     upd->Links = 0;
     upd->UnLinks = 0;
 
-    compare_libraries(newpar,oldpar);
+    fehler = compare_model(newpar, oldpar, upd, msg);
 
-    out += "/*\n* Zu loeschende Bibliotheken :\n";
-    out += "* ----------------------------\n*/\n\n";
+    put_compare_title(IFBS_CMP_DELLIBS, out);
 
     plibs = oldpar->NewLibs;
     while(plibs) {
-        out += " DELETE_LIBRARY\n    ";
-        out += plibs->Inst_name;
-        out += "\n END_DELETE_LIBRARY;\n\n";
+        put_library(plibs->Inst_name, 1, out);
             plibs = plibs->next;
     }
 
-    out += "/*\n* Zu ladende Bibliotheken :\n";
-    out += "* -------------------------\n*/\n\n";
+    put_compare_title(IFBS_CMP_NEWLIBS, out);
 
     plibs = newpar->NewLibs;
     while(plibs) {
-        out += " LIBRARY\n    ";
-        out += plibs->Inst_name;
-        out += "\n END_LIBRARY;\n\n";
+        put_library(plibs->Inst_name, 0, out);
             plibs = plibs->next;
     }
 
+    out += msg;
 
-    fehler = compare_any_inst(newpar,oldpar,upd,out);
     if(fehler) {
         memfre(upd);
         free(upd);
             return KS_ERR_BADPARAM;
     }
 
-    out += "/*\n* Zu loeschende Instanzen :\n";
-    out += "* -------------------------\n*/\n\n";
+    put_compare_title(IFBS_CMP_DELETE, out);
 
     phelp = oldpar->Instance;
     while(phelp) {
-        // Wenn die Instanz eine Verbindung ist, loesche auch ihre links
-        if( !strcmp(phelp->Class_name, CONNECTION_CLASS_PATH) ) {
-            removeComConnLinks(oldpar, phelp);
-        }
-            out += " DELETE\n\t";
-            out += phelp->Inst_name;
-            out += "\n END_DELETE;\n\n" ;
+            put_delete(phelp->Inst_name, out);
             phelp = phelp->next;
     }
 
 
-    out += "\n/*\n* Zu erzeugende Instanzen :\n";
-    out += "* -------------------------\n*/\n\n";
+    put_compare_title(IFBS_CMP_INSTANCE, out);
 
     phelp = newpar->Instance;
     while(phelp) {
-    
-            out += " INSTANCE  ";
-            out += phelp->Inst_name;
-            out += " :\n    CLASS ";
-            out += phelp->Class_name;
-            out += ";\n";
-
-            if(phelp->Inst_var) {
-                    out += "\tVARIABLE_VALUES\n";
-
-                    put_variable(phelp->Inst_var, out);
-
-                    out += "\tEND_VARIABLE_VALUES;\n";
-            }
-
-            out += " END_INSTANCE;\n\n";
-
+            put_instance(phelp, out);
             phelp = phelp->next;
     }
 
 
-    out += "\n/*\n* Instanzen mit geaenderten Parameter :\n";
-    out += "* -------------------------------------\n*/\n\n";
+    put_compare_title(IFBS_CMP_SET, out);
 
     phelp = upd->Instance;
     while(phelp) {
-            out += " SET ";
-            out += phelp->Inst_name;
-            out += " :\n\tVARIABLE_VALUES\n";
-
-            put_variable(phelp->Inst_var, out);
-
-            out += "\tEND_VARIABLE_VALUES;\n";
-            out += " END_SET;\n\n";
-
+            put_set(phelp, out);
             phelp = phelp->next;
     }
 
     memfre(upd);
     free(upd);
 
-    get_any_links(newpar, oldpar);
-    
-    out += "\n/*\n* Zu loesende Links :\n";
-    out += "* -------------------\n*/\n\n";
+    put_compare_title(IFBS_CMP_UNLINK, out);
 
     philf = oldpar->Links;
     PltString               InpConLinkName("inputcon");
@@ -178,67 +222,19 @@ KS_RESULT compare_eval(Dienst_param* newpar,
             continue;
         }
         
-            out += " UNLINK\n    OF_ASSOCIATION  ";
-            
-            out += philf->asso_ident;
-            out += "\n    PARENT  ";
-            out += philf->parent_role;
-            out += " : CLASS ";
-            out += philf->parent_class;
-            out += "\n        = ";
-            out += philf->parent_path;
-            out += ";\n    CHILDREN ";
-            out += philf->child_role;
-            out += " : CLASS ";
-            out += philf->child_class;
-            out += "\n        = {";
-
-            pchild = philf->children;
-            while(pchild) {
-                    out += pchild->child_path;
-                    pchild = pchild->next;
-                    if(pchild)
-                            out += ",";
-            }
-            out += "};\n";
-            out += " END_UNLINK;\n\n";
+            put_link(philf, "UNLINK", out);
 
             philf = philf->next;
 
     }
 
-    out += "\n/*\n* Zu erstellende Links :\n";
-    out += "* ----------------------\n*/\n\n";
+    put_compare_title(IFBS_CMP_LINK, out);
 
     philf = newpar->Links;
     while(philf) {
     
-            out += " LINK\n    OF_ASSOCIATION  ";
-            
-            out += philf->asso_ident;
-            out += "\n    PARENT  ";
-            out += philf->parent_role;
-            out += " : CLASS ";
-            out += philf->parent_class;
-            out += "\n        = ";
-            out += philf->parent_path;
-            out += ";\n    CHILDREN ";
-            out += philf->child_role;
-            out += " : CLASS ";
-            out += philf->child_class;
-            out += "\n        = {";
-            
-            pchild = philf->children;
-            while(pchild) {
-                    out += pchild->child_path;
-                    pchild = pchild->next;
-                    if(pchild)
-                            out += ",";
-            }
-            out += "};\n";
-
+            put_link(philf, "LINK", out);
             philf = philf->next;
-            out += " END_LINK;\n\n";
     }
 
     return KS_ERR_OK;
@@ -249,267 +245,194 @@ KS_RESULT compare_eval(Dienst_param* newpar,
 void compare_libraries(Dienst_param* newpar, Dienst_param* oldpar)
 /*****************************************************************************/
 {
-    DelInstItems*        pol = oldpar->NewLibs;  // Zeiger auf alle Bibliotheken in alter Database
-    DelInstItems*        pnl = newpar->NewLibs;  // Zeiger auf alle Bibliotheken in neuer Database
-    DelInstItems*        ph;                     // Hilfszeiger
-
-    while(pol) {
-        while(pol && pnl) {
-            
-            if( !strcmp(pol->Inst_name, pnl->Inst_name) ) {
-                /* Bibliothek in alter DB gibt es auch in neuen */
-                        /* Loesche Lib-Strukturen : */
-                        /* Old-DB */
-                        ph = oldpar->NewLibs;
-                        if(ph != pol) {
-                            /* pol zeigt nicht auf erste Lib in Structur */
-                        
-                                while(ph->next != pol) {
-                                        ph = ph->next;
-                                }
-                                ph->next = pol->next;
-                                
-                                free(pol);
-                                pol = ph->next;
-                            
-                        } else {
-                            /* gleich die erste Lib in old DB gibt's auch in new DB */
-                        
-                                oldpar->NewLibs = pol->next;
-                                
-                                free(pol);
-                                pol = oldpar->NewLibs;
-                        }
-                        
-                        /* new DB : */
-                        ph = newpar->NewLibs;
-                        if(ph != pnl) {
-                            /* pnl zeigt nicht auf erste Lib in Structur */
-                        
-                                while(ph->next != pnl) {
-                                        ph = ph->next;
-                                }
-                                ph->next = pnl->next;
-                                
-                                free(pnl);
-                                pnl = ph->next;
-                            
-                        } else {
-                            /* gleich die erste Lib in new DB gibt's auch in old DB */
-                        
-                                newpar->NewLibs = pnl->next;
-                                
-                                free(pnl);
-                                pnl = newpar->NewLibs;
-                            }
-                } else {
-                    /* Durchsuche neue Structur */
-                        pnl = pnl->next;
-                }
-            } /* while pnl */
+    /*
+    *  Bibliotheken, die es in beiden Datenbasen gibt, werden aus beiden
+    *  Listen entfernt. Die neuen Bibliotheken werden nach Namen indiziert,
+    *  jede Bibliothek der alten DB wird einmal gesucht.
+    */
+    std::unordered_map<std::string, std::deque<DelInstItems*> >           newLibs;
+    std::unordered_map<std::string, std::deque<DelInstItems*> >::iterator it;
+    std::unordered_set<DelInstItems*>  delOld;
+    std::unordered_set<DelInstItems*>  delNew;
+    DelInstItems*                      pl;
+
+    for(pl = newpar->NewLibs; pl; pl = pl->next) {
+        newLibs[std::string(pl->Inst_name)].push_back(pl);
+    }
 
-            if( (!pnl) && pol) {
-                // Wir sind am Ende der Striktur der neuen DB.
-                // Pruefe naechste Lib in Old-DB
-                    pol = pol->next;
-            }
-        
-            pnl = newpar->NewLibs;
+    for(pl = oldpar->NewLibs; pl; pl = pl->next) {
+        it = newLibs.find(std::string(pl->Inst_name));
+        if( (it == newLibs.end()) || it->second.empty() ) {
+            // Bibliothek gibt es nur in alter DB
+            continue;
+        }
+        /* Bibliothek in alter DB gibt es auch in neuen */
+        delOld.insert(pl);
+        delNew.insert(it->second.front());
+        it->second.pop_front();
+    }
 
-    } /* while pol */
+    /* Loesche Lib-Strukturen in Old-DB und New-DB */
+    ifb_unlinkItems(&oldpar->NewLibs, delOld);
+    ifb_unlinkItems(&newpar->NewLibs, delNew);
 
     return;
 
 } /* compare_libraries() */
 
 
+// Vergleicht die Variablen zweier Verbindungen. 1 = unterschiedlich
+/*****************************************************************************/
+int compareComConnVars(InstanceItems* poi, InstanceItems* pni)
+/*****************************************************************************/
+{
+    Variables* pold;
+    Variables* pnew;
+
+    for(pold = poi->Inst_var; pold; pold = pold->next) {
+        // Parameter mit dem gleichen Name suchen
+        for(pnew = pni->Inst_var; pnew; pnew = pnew->next) {
+            if(!strcmp(pold->var_name, pnew->var_name) ) {
+                break;
+            }
+        }
+        if(!pnew) {
+            // Parameter nicht gefunden
+            return 1;
+        }
+        if( value_compare(pold, pnew) ) {
+            // Werte eines Parameter-Ports unterscheiden sich
+            return 1;
+        }
+    }
+    return 0;
+}
+
 /*****************************************************************************/
 KS_RESULT compare_any_inst(Dienst_param* newpar, Dienst_param* oldpar,
                      Dienst_param* upd,    PltString& out)
 /*****************************************************************************/
 {
-    InstanceItems*    pinst = oldpar->Instance;
-    InstanceItems*    ph = newpar->Instance;
-    InstanceItems*    help;
-    KS_RESULT         fehler;
-  
-    while(pinst && ph) {
-    
-            while(pinst && ph) {
-                // Namen gleich ?
-                      if( !(strcmp(pinst->Inst_name, ph->Inst_name)) ) {
-                          // Klass gleich?
-                            if( !(strcmp(pinst->Class_name, ph->Class_name)) ) {
-                            
-                                // Name und Klass der Instanzen sind gleich
-                                // Puefe, ob das eine Verbindung ist
-                                if( !strcmp(pinst->Class_name, CONNECTION_CLASS_PATH) ) {
-                                    // Es ist eine Verbindung. Vergleiche Variablen
-                                    Variables* pold = pinst->Inst_var;
-                                    Variables* pnew = ph->Inst_var;
-                                    while(pold && pnew) {
-                                        if(!strcmp(pold->var_name, pnew->var_name) ) {
-                                        // Parameter mit dem gleichen Name gefunden.
-                                            if( value_compare(pold, pnew) ) {
-                                                // Werte eines Parameter-Ports unterscheiden sich
-                                                break;
-                                            }
-                                        } else {
-                                            pnew = pnew->next;
-                                            continue;
-                                        }
-                                        pold = pold->next;
-                                        pnew = ph->Inst_var;
-                                    }
-                                    if(pold) {
-                                        // Vergleich wurde mit dem Fehler abgebrochen
-                                        // Alte Verbindung und ihre Links loeschen, neue anlegen
-                                        removeComConnLinks(oldpar, pinst);
-                                        pinst = pinst->next;
-                                        ph = newpar->Instance;
-                                        // Naechsten Instanzen vergleichen
-                                        continue;
-                                    }
-                                    // Werte der Variablen sind gleich. Pruefe ob Verbindungen
-                                    // auch die gleichen Links haben
-                                    if(compareComConnLinks( newpar, oldpar, pinst->Inst_name) ) {
-                                        // Die Verbindungen haben unterschiedliche Links.
-                                        // Alte Verbindung und ihre Links loeschen, neue anlegen
-                                        removeComConnLinks(oldpar, pinst);
-                                        pinst = pinst->next;
-                                        ph = newpar->Instance;
-                                        // Naechsten Instanzen vergleichen
-                                        continue;
-                                    }
-                                }
-                                
-                                    fehler = param_compare(pinst, ph, out);
-                                    if(fehler == KS_ERR_TYPEMISMATCH) {
-                                            return fehler;
-                                    }
-                                
-                                    /* Alte Instanz-Information wird in diesem Fall (Instanz aus der alten 
-                                    *  Datenbasis gibt es auch in neuer) geloescht, unabhaengig davon, ob die 
-                                    *  neue fuer updaten bleibt ( fehler==1 : Parameter sind unterschiedlich) 
-                                    *  oder nicht.
-                                    */
-                    // Falls es eine Verbindung ist, loesche auch ihre Links-Structuren
-                                        if( !strcmp(pinst->Class_name, CONNECTION_CLASS_PATH) ) {
-                                            removeComConnLinks(oldpar,pinst);
-                                        }
-                                    if(oldpar->Instance != pinst) {
-                                            help = oldpar->Instance;
-                                            while(help->next != pinst) {
-                                                    help = help->next;
-                                            }
-                                            help->next = pinst->next;
-                                            
-                                            free(pinst);
-                                            pinst = help->next;
-                                    } else {
-                                            oldpar->Instance = pinst->next;
-                                            free(pinst);
-                                            pinst = oldpar->Instance;
-                                    }
-
-                                    /* Trenne aktuelle Instanz von gesammten Struktur und
-                                     loesche, wenn Parameter gleich sind (fehler==0),
-                                         oder schiebe in update-Baum                   */
-
-                                    if(newpar->Instance != ph) {
-                                            help = newpar->Instance;
-                                            while(help->next != ph) {
-                                                    help=help->next;
-                                            }
-                                            help->next = ph->next;
-                                            ph->next = 0;
-                                    } else {
-                                            newpar->Instance = ph->next;
-                                            ph->next = 0;
-                                    }
-
-                                    if(!fehler) {
-                                        /* alle Parameter sind gleich. Struktur loeschen */
-                                        // Falls es eine Verbindung ist, loesche auch ihre Links-Structuren
-                                        if( !strcmp(ph->Class_name, CONNECTION_CLASS_PATH) ) {
-                                                removeComConnLinks(newpar,ph);
-                                            }
-                                            free(ph);
-                                            ph = newpar->Instance;
-                                    } else {
-                                        // Instanze zur Update-Structur hinzufuegen
-                                            if(upd->Instance) {
-                                                    help = upd->Instance;
-                                                    while(help->next) {
-                                                            help = help->next;
-                                                    }
-                                                    help->next = ph;
-                                            } else {
-                                                    upd->Instance = ph;
-                                            }
-                                            ph = newpar->Instance;
-                                    }
-                            } else {
-                                // Unterschiedlichen Klassen. Naechste Instanzen
-                                    pinst = pinst->next;
-                                    ph = newpar->Instance;
-                            }
-                      } else {
-                          // Unterschiedlichen Namen. Weiter suchen
-                            ph = ph->next;
-                    }
-            }
-        if(!ph && pinst) {
+    /*
+    *  Die Instanzen der neuen DB werden nach Namen indiziert. Zu jeder
+    *  Instanz der alten DB wird die erste noch nicht verglichene Instanz mit
+    *  dem gleichen Namen gesucht. Verglichene Instanzen und Links werden erst
+    *  am Ende aus den Listen ausgehaengt.
+    */
+    std::unordered_map<std::string, std::deque<InstanceItems*> >           newInst;
+    std::unordered_map<std::string, std::deque<InstanceItems*> >::iterator it;
+    std::unordered_set<InstanceItems*>  delOld;
+    std::unordered_set<InstanceItems*>  delNew;
+    std::vector<InstanceItems*>         updInst;
+    IfbsLinkIndex                       OldLinks(oldpar->Links);
+    IfbsLinkIndex                       NewLinks(newpar->Links);
+    InstanceItems*                      pinst;
+    InstanceItems*                      ph;
+    InstanceItems**                     ppUpd;
+    KS_RESULT                           fehler;
+    KS_RESULT                           result = KS_ERR_OK;
+    int                                 isConn;
+    size_t                              i;
+
+    for(ph = newpar->Instance; ph; ph = ph->next) {
+        newInst[std::string(ph->Inst_name)].push_back(ph);
+    }
+
+    for(pinst = oldpar->Instance; pinst; pinst = pinst->next) {
+        // Namen gleich ?
+        it = newInst.find(std::string(pinst->Inst_name));
+        if( (it == newInst.end()) || it->second.empty() ) {
             // Instanz in Old-DB ist in neuer nicht vorhanden.
-                pinst = pinst->next;
+            continue;
         }
-        ph = newpar->Instance;
+        ph = it->second.front();
 
-    } /* while pinst && ph */
+        // Klass gleich?
+        if( strcmp(pinst->Class_name, ph->Class_name) ) {
+            // Unterschiedlichen Klassen. Naechste Instanzen
+            continue;
+        }
 
-    return KS_ERR_OK;
+        // Name und Klass der Instanzen sind gleich
+        // Puefe, ob das eine Verbindung ist
+        isConn = !strcmp(pinst->Class_name, CONNECTION_CLASS_PATH);
+        if(isConn) {
+            // Es ist eine Verbindung. Vergleiche Variablen und Links
+            if( compareComConnVars(pinst, ph) ||
+                compareComConnLinks(NewLinks, OldLinks, pinst->Inst_name) ) {
+                // Alte Verbindung und ihre Links loeschen, neue anlegen
+                OldLinks.removeChild(pinst->Inst_name);
+                continue;
+            }
+        }
+
+        fehler = param_compare(pinst, ph, out);
+        if(fehler == KS_ERR_TYPEMISMATCH) {
+            result = fehler;
+            break;
+        }
+
+        /* Alte Instanz-Information wird in diesem Fall (Instanz aus der alten 
+        *  Datenbasis gibt es auch in neuer) geloescht, unabhaengig davon, ob die 
+        *  neue fuer updaten bleibt ( fehler==1 : Parameter sind unterschiedlich) 
+        *  oder nicht.
+        */
+        // Falls es eine Verbindung ist, loesche auch ihre Links-Structuren
+        if(isConn) {
+            OldLinks.removeChild(pinst->Inst_name);
+        }
+        delOld.insert(pinst);
+        delNew.insert(ph);
+        it->second.pop_front();
+
+        if(!fehler) {
+            /* alle Parameter sind gleich. Struktur loeschen */
+            if(isConn) {
+                NewLinks.removeChild(ph->Inst_name);
+            }
+        } else {
+            // Instanze zur Update-Structur hinzufuegen
+            updInst.push_back(ph);
+        }
+    }
+
+    // Verglichene Instanzen und Links aus den Strukturen aushaengen
+    ifb_unlinkItems(&oldpar->Instance, delOld);
+    ifb_unlinkItems(&newpar->Instance, delNew);
+    OldLinks.purge(&oldpar->Links);
+    NewLinks.purge(&newpar->Links);
+
+    // Zu aktualisierende Instanzen in der Reihenfolge der alten DB anhaengen
+    ppUpd = &upd->Instance;
+    while(*ppUpd) {
+        ppUpd = &((*ppUpd)->next);
+    }
+    for(i = 0; i < updInst.size(); i++) {
+        *ppUpd = updInst[i];
+        ppUpd = &(updInst[i]->next);
+    }
+
+    return result;
 
 } /* get_any_inst */
 
 /*****************************************************************************/
-int compareComConnLinks( Dienst_param *Newpar
-                        ,Dienst_param *Oldpar
-                        ,const char   *VerbName) {
+int compareComConnLinks( IfbsLinkIndex &NewIdx
+                        ,IfbsLinkIndex &OldIdx
+                        ,const char    *VerbName) {
 /*****************************************************************************/
-    PltString   Name;
-    PltString   Role;
+    const char *Roles[2] = { "inputcon", "outputcon" };
     LinksItems *oldlink;
     LinksItems *newlink;
     int         i;      // Laufvariable
     
-    Name = VerbName;    // Name der Verbindung merken
-    Role = "inputcon";  // Association-Ident merken
-    
     for(i = 0; i < 2; i++) {
-        oldlink = Oldpar->Links;
-        newlink = Newpar->Links;
-        
-        while(oldlink) {
-            if( (Name == oldlink->children->child_path) &&
-                (Role == oldlink->child_role) ) {
-                // Link gefunden
-                break;
-            }
-            oldlink = oldlink->next;
-        }
+        oldlink = OldIdx.find(VerbName, Roles[i]);
         if(!oldlink) {
             // Link nicht gefunden ?
             return 1;
         }
- 
-        while(newlink) {
-            if( (Name == newlink->children->child_path) &&
-                (Role == newlink->child_role) ) {
-                // Link gefunden
-                break;
-            }
-            newlink = newlink->next;
-        }
+        newlink = NewIdx.find(VerbName, Roles[i]);
         if(!newlink) {
             // Link nicht gefunden ?
             return 1;
@@ -520,47 +443,11 @@ int compareComConnLinks( Dienst_param *Newpar
             // Verbindungen haben unterschiedliche Links
             return 1;
         }
-        Role = "outputcon";
     }
 
     return 0;
 }
 
-/*****************************************************************************/
-void removeComConnLinks(Dienst_param *param, InstanceItems* ComConn) {
-/*****************************************************************************/
-    LinksItems *link = param->Links;
-    LinksItems *help;
-    PltString   Name;
-    
-    // Name der Verbindung merken
-    Name = ComConn->Inst_name;
-
-    while(link) {
-        if(Name == link->children->child_path) {
-            // Link gefunden
-            help = param->Links;
-            if(help == link) {
-                // Es ist erste link in der Struktur
-                param->Links = link->next;
-            } else {
-                // Link suchen
-                while(help->next != link) {
-                    help = help->next;
-                }
-                help->next = link->next;
-            }
-            free(link->children);
-            free(link);
-            link = param->Links;
-            continue;
-        }
-        link = link->next;
-    }
-    
-    return;
-}
-
 /*****************************************************************************/
 int param_compare(InstanceItems* poi, InstanceItems* pni, PltString& out)
 /*****************************************************************************/
@@ -571,7 +458,6 @@ int param_compare(InstanceItems* poi, InstanceItems* pni, PltString& out)
                                        vorhandenen Instanz */
                                        
     Variables*    hilfsvar;
-    VariableItem* pval;               /* Hilfsvariable fuer loeschen Value-Information */
     PltString     err;
   
     int error = 0;
@@ -711,12 +597,6 @@ int param_compare(InstanceItems* poi, InstanceItems* pni, PltString& out)
 
                       poi->Inst_var = pold->next;
 
-                    while(pold->value) {
-                            pval = pold->value;
-                            pold->value = pval->next;
-                            free(pval);
-                    }
-                    free(pold);
 
                     if(pnew != pni->Inst_var) {
                             hilfsvar = pni->Inst_var;
@@ -730,12 +610,6 @@ int param_compare(InstanceItems* poi, InstanceItems* pni, PltString& out)
                     
                     pnew->next = 0;
 
-                    while(pnew->value) {
-                            pval = pnew->value;
-                            pnew->value = pval->next;
-                            free(pval);
-                    }
-                    free(pnew);
 
                     pold = poi->Inst_var;
                     pnew = pni->Inst_var;
@@ -769,13 +643,7 @@ int param_compare(InstanceItems* poi, InstanceItems* pni, PltString& out)
         */
             poi->Inst_var = pold->next;
 
-            while(pold->value) {
-                    pval = pold->value;
-                    pold->value = pval->next;
-                    free(pval);
-            }
 
-            free(pold);
             pold = poi->Inst_var;
 
             if(!error) {
@@ -791,12 +659,6 @@ int param_compare(InstanceItems* poi, InstanceItems* pni, PltString& out)
                             pni->Inst_var = pnew->next;
                     }
                     
-                    while(pnew->value) {
-                            pval = pnew->value;
-                            pnew->value = pval->next;
-                            free(pval);
-                    }
-                    free(pnew);
                 
             } else {
                 // Merke : Instanz-Variable zu updaten
@@ -817,6 +679,11 @@ int value_compare(Variables* pold, Variables* pnew)
 
     VariableItem* ov = pold->value;
     VariableItem* nv = pnew->value;
+    const char*   ot;       /* Text der Elemente, typisierte Werte (.fbb) formatiert */
+    const char*   nt;
+    char          ohelp[64];
+    char          nhelp[64];
+    size_t        idx = 0;
 
     // Haben beide Variablen Value ?
     if( (!ov) && (!nv) ) {
@@ -843,32 +710,34 @@ int value_compare(Variables* pold, Variables* pnew)
 
                     return KS_ERR_TYPEMISMATCH;
             }
+            ot = ifb_fbbValueText(pold, ov, idx, ohelp);
+            nt = ifb_fbbValueText(pnew, nv, idx, nhelp);
             switch(ov->value_type) {
                 
                     /*
                      * FIXME warning: case label value exceeds maximum value for type (x86 build)
                      * valuetype is of type DataType; checked values are for KS_VAR_TYPE
                      */
-                    case KS_VT_UINT             :  if(((unsigned long)atol(ov->val)) !=
-                                               ((unsigned long)atol(nv->val)) ) {
+                    case KS_VT_UINT             :  if(((unsigned long)atol(ot)) !=
+                                               ((unsigned long)atol(nt)) ) {
                                                 return 1;
                                             }
                                             break;
-                    case KS_VT_INT             :        if(((long)atol(ov->val)) !=
-                                               ((long)atol(nv->val)) ) {
+                    case KS_VT_INT             :        if(((long)atol(ot)) !=
+                                               ((long)atol(nt)) ) {
                                                 return 1;
                                             }
                                             break;
                     case KS_VT_SINGLE         :
                     case KS_VT_TIME_SPAN :
-                    case KS_VT_DOUBLE         :        if( atof(ov->val) !=
-                                                atof(nv->val) ) {
+                    case KS_VT_DOUBLE         :        if( atof(ot) !=
+                                                atof(nt) ) {
                                                 return 1;
                                             }
                                             break;
                     case KS_VT_TIME            :
                     case KS_VT_BOOL            :
-                    case KS_VT_STRING        :        if(strcmp(ov->val,nv->val)) {
+                    case KS_VT_STRING        :        if(strcmp(ot,nt)) {
                                                                             return 1;
                                             }
                                                                     break;
@@ -879,6 +748,7 @@ int value_compare(Variables* pold, Variables* pnew)
              
             ov = ov->next;
             nv = nv->next;
+            idx++;
 
     } /* while ov && nv */
 
@@ -898,6 +768,7 @@ void put_variable(Variables* hpv, PltString& Out)
     Variables* pv = hpv; /* Hilfszeiger ueber die Variablenliste */
 
     VariableItem* pvi;
+    size_t idx;
     char   help[64];
 
     while(pv) {
@@ -923,6 +794,7 @@ void put_variable(Variables* hpv, PltString& Out)
                 Out += "{";
             }
                 pvi = pv->value;
+                idx = 0;
                 
                 while(pvi) {
                     switch(pv->var_typ) {
@@ -932,10 +804,11 @@ void put_variable(Variables* hpv, PltString& Out)
                                                 Out += "\"";
                                                 break;
                             default:
-                                                Out += pvi->val;
+                                                Out += ifb_fbbValueText(pv, pvi, idx, help);
                                                 break;
                     }
                         pvi = pvi->next;
+                        idx++;
                         if(pvi) {
                             Out += " , ";
                         }
@@ -957,113 +830,172 @@ void put_variable(Variables* hpv, PltString& Out)
 
 } /* put_variable() */
 
+/*****************************************************************************/
+void put_compare_title(int section, PltString& Out)
+/*****************************************************************************/
+{
+    Out += ifb_CompareTitles[section];
+}
 
 /*****************************************************************************/
-void get_any_links(Dienst_param* newpar, Dienst_param* oldpar)
+void put_library(const char* name, int del, PltString& Out)
 /*****************************************************************************/
 {
-    LinksItems* newlinks = newpar->Links;
-    LinksItems* oldlinks = oldpar->Links;
-    LinksItems* helplinks;
+    if(del) {
+        Out += " DELETE_LIBRARY\n    ";
+        Out += name;
+        Out += "\n END_DELETE_LIBRARY;\n\n";
+    } else {
+        Out += " LIBRARY\n    ";
+        Out += name;
+        Out += "\n END_LIBRARY;\n\n";
+    }
+}
 
-    Child*                oldchild;
-    Child*                newchild;
+/*****************************************************************************/
+void put_delete(const char* name, PltString& Out)
+/*****************************************************************************/
+{
+    Out += " DELETE\n\t";
+    Out += name;
+    Out += "\n END_DELETE;\n\n" ;
+}
 
-    int                    error;
+/*****************************************************************************/
+void put_instance(InstanceItems* pinst, PltString& Out)
+/*****************************************************************************/
+{
+    Out += " INSTANCE  ";
+    Out += pinst->Inst_name;
+    Out += " :\n    CLASS ";
+    Out += pinst->Class_name;
+    Out += ";\n";
 
-    while(oldlinks && newlinks) {
-    
-            while(oldlinks && newlinks) {
-                error = 0;
-                
-                    if( !strcmp(oldlinks->parent_path, newlinks->parent_path) ) {
-                    
-                            if( !strcmp(oldlinks->child_role, newlinks->child_role) ) {
-                            
-                                    oldchild = oldlinks->children;
-                                    newchild = newlinks->children;
-
-                                    while(oldchild && newchild) {
-                                    
-                                            if( strcmp(oldchild->child_path,newchild->child_path) ) {
-                                                    error = 1;
-                                                    break;
-                                            }
-                                            oldchild = oldchild->next;
-                                            newchild = newchild->next;
-                                    }
-
-                                    if( (!oldchild) && (!newchild) && (!error) ) {
-                                        /* == wenn beide gleichzeitig auf null zeigen
-                                            (dann ist Anzahl der Kinder auch gleich)
-                                            Loesche gleiche Child-Informationen      */
-                                        
-                                            if(oldlinks == oldpar->Links) {
-                                                    oldpar->Links = oldlinks->next;
-                                                    oldlinks->next = 0;
-                                                    helplinks = oldpar->Links;
-                                            } else {
-                                                    helplinks = oldpar->Links;
-                                                    while(helplinks->next != oldlinks)
-                                                            helplinks = helplinks->next;
-
-                                                    helplinks->next = oldlinks->next;
-                                                    oldlinks->next = 0;
-                                                    helplinks = helplinks->next;
-                                            }
+    if(pinst->Inst_var) {
+        Out += "\tVARIABLE_VALUES\n";
 
-                                            while(oldlinks->children) {
-                                                    oldchild = oldlinks->children;
-                                                    oldlinks->children = oldchild->next;
-                                                    free(oldchild);
-                                            }
+        put_variable(pinst->Inst_var, Out);
 
-                                            free(oldlinks);
-                                            oldlinks = helplinks;
-
-
-                                            if(newlinks == newpar->Links) {
-                                                    newpar->Links = newlinks->next;
-                                                    newlinks->next = 0;
-                                                    helplinks = newpar->Links;
-                                            } else {
-                                                    helplinks = newpar->Links;
-                                                    while(helplinks->next != newlinks)
-                                                            helplinks = helplinks->next;
-                                                    helplinks->next = newlinks->next;
-                                                    newlinks->next = 0;
-                                                    helplinks = helplinks->next;
-                                            }
+        Out += "\tEND_VARIABLE_VALUES;\n";
+    }
 
-                                            while(newlinks->children) {
-                                                    newchild = newlinks->children;
-                                                    newlinks->children = newchild->next;
-                                                    free(newchild);
-                                            }
+    Out += " END_INSTANCE;\n\n";
+}
 
-                                            free(newlinks);
-                                            newlinks = helplinks;
+/*****************************************************************************/
+void put_set(InstanceItems* pinst, PltString& Out)
+/*****************************************************************************/
+{
+    Out += " SET ";
+    Out += pinst->Inst_name;
+    Out += " :\n\tVARIABLE_VALUES\n";
 
-                                    } else { /* Fehler beim Kinder-Vergleich */
-                                            oldlinks = oldlinks->next;
-                                            newlinks = newpar->Links;
-                                    }
-                            } else {
-                                /* unterschiedliche Assoziation. Weiter suchen */
-                                    newlinks = newlinks->next;
-                            }
-                    } else {
-                        /*  parent_path nicht gleich */
-                            newlinks = newlinks->next;
-                    }
-            } /* while oldlinks && newlinks innen */
+    put_variable(pinst->Inst_var, Out);
+
+    Out += "\tEND_VARIABLE_VALUES;\n";
+    Out += " END_SET;\n\n";
+}
 
-            if(oldlinks && (!newlinks) ) {
-                    oldlinks = oldlinks->next;
-                    newlinks = newpar->Links;
+// what : "LINK" oder "UNLINK"
+/*****************************************************************************/
+void put_link(LinksItems* plink, const char* what, PltString& Out)
+/*****************************************************************************/
+{
+    Child*  pchild;
+
+    Out += " ";
+    Out += what;
+    Out += "\n    OF_ASSOCIATION  ";
+    Out += plink->asso_ident;
+    Out += "\n    PARENT  ";
+    Out += plink->parent_role;
+    Out += " : CLASS ";
+    Out += plink->parent_class;
+    Out += "\n        = ";
+    Out += plink->parent_path;
+    Out += ";\n    CHILDREN ";
+    Out += plink->child_role;
+    Out += " : CLASS ";
+    Out += plink->child_class;
+    Out += "\n        = {";
+
+    pchild = plink->children;
+    while(pchild) {
+        Out += pchild->child_path;
+        pchild = pchild->next;
+        if(pchild)
+            Out += ",";
+    }
+    Out += "};\n";
+    Out += " END_";
+    Out += what;
+    Out += ";\n\n";
+}
+
+
+/*****************************************************************************/
+void get_any_links(Dienst_param* newpar, Dienst_param* oldpar)
+/*****************************************************************************/
+{
+    /*
+    *  Gleiche Links (Parent, Rolle und alle Kinder) werden aus beiden Listen
+    *  entfernt. Die neuen Links werden nach Parent und Rolle indiziert.
+    */
+    std::unordered_map<std::string, std::deque<LinksItems*> >           newLinks;
+    std::unordered_map<std::string, std::deque<LinksItems*> >::iterator it;
+    std::unordered_set<LinksItems*>  delOld;
+    std::unordered_set<LinksItems*>  delNew;
+    std::string                      key;
+    LinksItems*                      oldlinks;
+    LinksItems*                      newlinks;
+
+    Child*                oldchild;
+    Child*                newchild;
+
+    for(newlinks = newpar->Links; newlinks; newlinks = newlinks->next) {
+        key  = newlinks->parent_path;
+        key += '\0';
+        key += newlinks->child_role;
+        newLinks[key].push_back(newlinks);
+    }
+
+    for(oldlinks = oldpar->Links; oldlinks; oldlinks = oldlinks->next) {
+        key  = oldlinks->parent_path;
+        key += '\0';
+        key += oldlinks->child_role;
+        it = newLinks.find(key);
+        if( (it == newLinks.end()) || it->second.empty() ) {
+            /* Parent oder Assoziation nicht gefunden */
+            continue;
+        }
+        newlinks = it->second.front();
+
+        oldchild = oldlinks->children;
+        newchild = newlinks->children;
+
+        while(oldchild && newchild) {
+            if( strcmp(oldchild->child_path,newchild->child_path) ) {
+                break;
             }
+            oldchild = oldchild->next;
+            newchild = newchild->next;
+        }
+
+        if( oldchild || newchild ) {
+            /* Fehler beim Kinder-Vergleich */
+            continue;
+        }
+
+        /* == wenn beide gleichzeitig auf null zeigen
+            (dann ist Anzahl der Kinder auch gleich)
+            Loesche gleiche Child-Informationen      */
+        delOld.insert(oldlinks);
+        delNew.insert(newlinks);
+        it->second.pop_front();
+    }
 
-    } /* while oldlinks && newlinks aussen */
+    ifb_unlinkItems(&oldpar->Links, delOld);
+    ifb_unlinkItems(&newpar->Links, delNew);
 
     return;
 
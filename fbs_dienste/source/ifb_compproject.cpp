@@ -42,23 +42,54 @@
 #include "par_param.h"
 
 /*
-*        globale Variablen
-*        -----------------
+*   Kopf des Vergleichsprotokolls schreiben
 */
+/*****************************************************************************/
+void ifb_putCompareHeader(FILE*       yyout,
+                          PltString&  olddat,
+                          PltString&  newdat,
+                          PltString&  proto)
+/*****************************************************************************/
+{
+fprintf(yyout,"/******************************************************************************\n");
+fprintf(yyout,"***                                                                         ***\n");
+fprintf(yyout,"***      Vergleichsprotokoll                                                ***\n");
+fprintf(yyout,"***      ###################                                                ***\n");
+fprintf(yyout,"***                                                                         ***\n");
+fprintf(yyout,"*******************************************************************************\n");
+fprintf(yyout,"*\n");
+fprintf(yyout,"*  Datei : %s\n*\n", (const char*)proto);
+fprintf(yyout,"*  Ergebnis des Vergleiches zweier Datenbasen :\n*\n");
+fprintf(yyout,"*  comparison : %s\n", (const char*)olddat);
+fprintf(yyout,"*  reference  : %s\n", (const char*)newdat);
+fprintf(yyout,"*\n*\n");
+fprintf(yyout,"*  Historie\n");
+fprintf(yyout,"*  --------\n");
+fflush(yyout);
 
-//extern Dienst_param*         ppar;
+PltTime t0;
+PltTime tt = t0.now();
+struct        tm* t;
+time_t        timer;
 
-//extern int                 yydebug;
-//extern FILE*         yyin;
-//extern int                 current_line;
+timer = (time_t)tt.tv_sec;
 
-/*
-*        Funktionsprototypen
-*        -------------------
-*/
+t=localtime(&timer);
+if(t) {
+    fprintf(yyout,"*   %4.4d-%2.2d-%2.2d %2.2d:%2.2d:%2.2d",
+                t->tm_year+1900, t->tm_mon+1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
+}
+fprintf(yyout," : Automatische Erstellung\n");
 
-int yyparse(void);
-extern "C" void InitInputFileStream(FILE*);
+fprintf(yyout,"*\n*\n");
+fprintf(yyout,"*   ACHTUNG!\n");
+fprintf(yyout,"*   --------\n");
+fprintf(yyout,"*   DIESE DATEI DARF NICHT VERAENDERT WERDEN!\n");
+fprintf(yyout,"*\n");
+fprintf(yyout,"******************************************************************************/\n");
+fprintf(yyout,"\n\n");
+fflush(yyout);
+}
 
 /*
 *   Hauptprogramm
@@ -76,13 +107,17 @@ KS_RESULT IFBS_DBCOMPARE(PltString& olddat,
         */
     int             exit_status;
     KS_RESULT       fehler; /* Funktionsrueckmeldung */
-    Dienst_param*   oldpar;
-    Dienst_param*   newpar;
+    FB_PARSE_CONTEXT* oldctx;   /* Parse-Sitzung der zu vergleichenden Datei */
+    FB_PARSE_CONTEXT* newctx;   /* Parse-Sitzung der aktuellen Datei */
     FILE*           yyout;
     PltString       out;
     
-        yydebug = 0;
-        current_line = 0;
+        /*
+        *        Sortierte Dateien blockweise vergleichen?
+        */
+        if( IFBS_GetSortedCompare() ) {
+                return IFBS_DBCOMPARE_SORTED(olddat, newdat, proto);
+        }
 
         /*
         *        check options
@@ -105,83 +140,31 @@ KS_RESULT IFBS_DBCOMPARE(PltString& olddat,
         return OV_ERR_CANTOPENFILE;
         }
 
-fprintf(yyout,"/******************************************************************************\n");
-fprintf(yyout,"***                                                                         ***\n");
-fprintf(yyout,"***      Vergleichsprotokoll                                                ***\n");
-fprintf(yyout,"***      ###################                                                ***\n");
-fprintf(yyout,"***                                                                         ***\n");
-fprintf(yyout,"*******************************************************************************\n");
-fprintf(yyout,"*\n");
-fprintf(yyout,"*  Datei : %s\n*\n", (const char*)proto);
-fprintf(yyout,"*  Ergebnis des Vergleiches zweier Datenbasen :\n*\n");
-fprintf(yyout,"*  comparison : %s\n", (const char*)olddat);
-fprintf(yyout,"*  reference  : %s\n", (const char*)newdat);
-fprintf(yyout,"*\n*\n");
-fprintf(yyout,"*  Historie\n");
-fprintf(yyout,"*  --------\n");
-fflush(yyout);
-
-PltTime t0;
-PltTime tt = t0.now();
-struct        tm* t;
-time_t        timer;
-
-timer = (time_t)tt.tv_sec;
+        ifb_putCompareHeader(yyout, olddat, newdat, proto);
 
-t=localtime(&timer);
-if(t) {
-    fprintf(yyout,"*   %4.4d-%2.2d-%2.2d %2.2d:%2.2d:%2.2d",
-                t->tm_year+1900, t->tm_mon+1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
-}
-fprintf(yyout," : Automatische Erstellung\n");
-
-fprintf(yyout,"*\n*\n");
-fprintf(yyout,"*   ACHTUNG!\n");
-fprintf(yyout,"*   --------\n");
-fprintf(yyout,"*   DIESE DATEI DARF NICHT VERAENDERT WERDEN!\n");
-fprintf(yyout,"*\n");
-fprintf(yyout,"******************************************************************************/\n");
-fprintf(yyout,"\n\n");
-fflush(yyout);
+        oldctx = fb_parser_create();
+        if( !oldctx ) {
+                fclose(yyout);
+                return OV_ERR_HEAPOUTOFMEMORY;
+        }
 
-    yyin = fopen((const char*)olddat, "r");
-        if(!yyin) {
+        if(!fb_parser_openfile(oldctx, (const char*)olddat)) {
                 fprintf(yyout,"%s",
                     (const char*)log_getErrMsg(KS_ERR_OK,"can't open file", (const char*)olddat));
+                fb_parser_destroy(oldctx);
                 fclose(yyout);
                 return OV_ERR_CANTOPENFILE;
         }
 
-        ppar = (Dienst_param*)malloc(sizeof(Dienst_param));
-        if( !ppar ) {
-                fclose(yyin);
-                fclose(yyout);
-                return OV_ERR_HEAPOUTOFMEMORY;
-        }
-        ppar->Instance = 0;
-        ppar->Set_Inst_Var = 0;
-        ppar->DelInst = 0;
-        ppar->OldLibs = 0;
-        ppar->NewLibs = 0;
-        ppar->Links = 0;
-        ppar->UnLinks = 0;
-
-    /*
-    *   Parser initialisieren
-    */
-    InitInputFileStream(yyin);
-
         /*
         *   Zu vergleichende Datei parsen
         */
 
-        out = "";
-    iFBS_PrintParserError(1, out); /* LastError loeschen */
-
-        exit_status = yyparse();
+        exit_status = IFBS_ParseInput(oldctx);
         if(exit_status != EXIT_SUCCESS) {
             
-            out = IFBS_GetParserError();
+            iFBS_SetParserError(oldctx);
+            out = IFBS_GetParserError(oldctx);
             if( out == "" ) {
                 fprintf(yyout,"%s",
                     (const char*)log_getErrMsg(KS_ERR_OK,"Parse error. File", (const char*)olddat));
@@ -189,56 +172,36 @@ fflush(yyout);
                 fprintf(yyout,"%s",
                  (const char*)log_getErrMsg(KS_ERR_OK, (const char*)out, "File", (const char*)olddat));
             }
-                memfre(ppar);
-        free(ppar);
-        fb_parser_freestrings();
-                fclose(yyin);
+        fb_parser_destroy(oldctx);
                 fclose(yyout);
         return KS_ERR_BADPARAM;
     }
 
-        fclose(yyin);
-
-        oldpar = ppar;
+        newctx = fb_parser_create();
+        if( !newctx ) {
+        fb_parser_destroy(oldctx);
+                fclose(yyout);
+                return OV_ERR_HEAPOUTOFMEMORY;
+        }
 
-    yyin = fopen((const char*)newdat, "r");
-        if(!yyin) {            
+        if(!fb_parser_openfile(newctx, (const char*)newdat)) {            
                 fprintf(yyout,"%s",
                     (const char*)log_getErrMsg(KS_ERR_OK,"can't open file", (const char*)newdat));
-                memfre(oldpar);
-                free(oldpar);
-        fb_parser_freestrings();
+        fb_parser_destroy(newctx);
+        fb_parser_destroy(oldctx);
                 fclose(yyout);
         return OV_ERR_CANTOPENFILE;
         }
 
-        ppar = (Dienst_param*)malloc(sizeof(Dienst_param));
-        if( !ppar ) {
-                memfre(oldpar);
-                free(oldpar);
-                fclose(yyin);
-                fclose(yyout);
-        fb_parser_freestrings();
-                return OV_ERR_HEAPOUTOFMEMORY;
-        }
-        ppar->Instance = 0;
-        ppar->Set_Inst_Var = 0;
-        ppar->DelInst = 0;
-        ppar->OldLibs = 0;
-        ppar->NewLibs = 0;
-        ppar->Links = 0;
-        ppar->UnLinks = 0;
-
         /*
         *   Aktuelle Datei parsen
         */
 
-        current_line = 0;
-
-        exit_status = yyparse();
+        exit_status = IFBS_ParseInput(newctx);
         if(exit_status != EXIT_SUCCESS) {
             
-            out = IFBS_GetParserError();
+            iFBS_SetParserError(newctx);
+            out = IFBS_GetParserError(newctx);
             if( out == "" ) {
                 fprintf(yyout,"%s",
                     (const char*)log_getErrMsg(KS_ERR_OK,"Parse error. File ", (const char*)newdat));
@@ -246,36 +209,24 @@ fflush(yyout);
                 fprintf(yyout,"%s",
                     (const char*)log_getErrMsg(KS_ERR_OK, (const char*)out,"File", (const char*)newdat));
             }
-                memfre(ppar);
-                free(ppar);
-                memfre(oldpar);
-        free(oldpar);
-                fclose(yyin);
+        fb_parser_destroy(newctx);
+        fb_parser_destroy(oldctx);
                 fclose(yyout);
-        fb_parser_freestrings();
         return KS_ERR_BADPARAM;
     }
 
-        fclose(yyin);
-
-        newpar = ppar;
-
         /*
         *        Ausgabe erzeugen
         */
 
         out = "";
-    fehler = compare_eval(newpar, oldpar, out);
+    fehler = compare_eval(newctx->par, oldctx->par, out);
 
     fputs((const char*)out, yyout);
     fclose(yyout);
 
-        memfre(oldpar);
-        free(oldpar);
-        memfre(newpar);
-        free(newpar);
-
-    fb_parser_freestrings();
+    fb_parser_destroy(oldctx);
+    fb_parser_destroy(newctx);
 
     return fehler;
 }
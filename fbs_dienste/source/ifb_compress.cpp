@@ -0,0 +1,811 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_compress.cpp                                                         *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Komprimierte Sicherungsdateien (.fbd.gz, .fbd.zst). Beim Schreiben       *
+*   komprimiert ein eigener Thread den Text, waehrend die Sicherung weiter   *
+*   den Server liest. Beim Lesen wird das Format an den ersten Bytes der     *
+*   Datei erkannt und der Text stueckweise entpackt.                         *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+#include <fcntl.h>
+#if !PLT_SYSTEM_NT
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#else
+#include <io.h>
+#endif
+
+#ifdef IFBS_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef IFBS_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+/*****************************************************************************/
+int IFBS_CompressionFromName(const char *filename)
+/*****************************************************************************/
+{
+    size_t  len;
+
+    if(!filename) {
+        return IFBS_COMPRESS_NONE;
+    }
+    len = strlen(filename);
+    if( (len > 3) && !strcmp(filename + len - 3, ".gz") ) {
+        return IFBS_COMPRESS_GZIP;
+    }
+    if( (len > 4) && !strcmp(filename + len - 4, ".zst") ) {
+        return IFBS_COMPRESS_ZSTD;
+    }
+    return IFBS_COMPRESS_NONE;
+}
+
+/*****************************************************************************/
+const char* IFBS_CompressionExt(int method)
+/*****************************************************************************/
+{
+    switch(method) {
+        case IFBS_COMPRESS_GZIP:
+            return ".gz";
+        case IFBS_COMPRESS_ZSTD:
+            return ".zst";
+        default:
+            return "";
+    }
+}
+
+/*****************************************************************************/
+int IFBS_CompressionAvailable(int method)
+/*****************************************************************************/
+{
+    switch(method) {
+        case IFBS_COMPRESS_NONE:
+            return 1;
+#ifdef IFBS_HAVE_ZLIB
+        case IFBS_COMPRESS_GZIP:
+            return 1;
+#endif
+#ifdef IFBS_HAVE_ZSTD
+        case IFBS_COMPRESS_ZSTD:
+            return 1;
+#endif
+        default:
+            return 0;
+    }
+}
+
+/*****************************************************************************/
+IfbsCompressWriter::IfbsCompressWriter()
+/*****************************************************************************/
+  : fd(-1),
+    method(IFBS_COMPRESS_NONE),
+    pStream(0),
+    worker(0),
+    finish(false),
+    pausing(false),
+    err(KS_ERR_OK)
+{
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsCompressWriter::open(const char *filename, int meth)
+/*****************************************************************************/
+{
+    close();
+
+    err = KS_ERR_OK;
+    finish = false;
+    pausing = false;
+    method = meth;
+    if( (method == IFBS_COMPRESS_NONE) || !IFBS_CompressionAvailable(method) ) {
+        return KS_ERR_NOTIMPLEMENTED;
+    }
+
+#ifdef IFBS_HAVE_ZLIB
+    if(method == IFBS_COMPRESS_GZIP) {
+        z_stream *z = new z_stream;
+        memset(z, 0, sizeof(z_stream));
+        // 15 + 16 : gzip-Kopf statt zlib-Kopf
+        if(deflateInit2(z, IFBS_GZIP_LEVEL, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            delete z;
+            return OV_ERR_HEAPOUTOFMEMORY;
+        }
+        pStream = z;
+    }
+#endif
+#ifdef IFBS_HAVE_ZSTD
+    if(method == IFBS_COMPRESS_ZSTD) {
+        ZSTD_CCtx *cctx = ZSTD_createCCtx();
+        if(!cctx) {
+            return OV_ERR_HEAPOUTOFMEMORY;
+        }
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, IFBS_ZSTD_LEVEL);
+        pStream = cctx;
+    }
+#endif
+
+#if !PLT_SYSTEM_NT
+    fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+#else
+    fd = _open(filename, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#endif
+    if(fd < 0) {
+        close();
+        return KS_ERR_BADPATH;
+    }
+
+    // Der Thread startet mit den ersten Daten (put)
+    out.resize(IFBS_COMPRESS_BUFSIZE);
+
+    return KS_ERR_OK;
+}
+
+/*****************************************************************************/
+int IfbsCompressWriter::put(const char *data, size_t len)
+/*****************************************************************************/
+{
+    std::vector<char>   buf;
+
+    if(!len) {
+        return 0;
+    }
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        // Warten, bis der Thread Buffer abgearbeitet hat
+        while( (!err) && (queue.size() >= IFBS_COMPRESS_QUEUE) ) {
+            cond.wait(guard);
+        }
+        if( err || (fd < 0) ) {
+            return 1;
+        }
+        if(!worker) {
+            // Erste Daten bzw. Daten nach pause()
+            worker = new std::thread(&IfbsCompressWriter::run, this);
+        }
+        if(spare.size()) {
+            buf.swap(spare.back());
+            spare.pop_back();
+        }
+    }
+
+    // Kopieren ausserhalb der Sperre
+    buf.assign(data, data + len);
+
+    std::lock_guard<std::mutex> guard(lock);
+    queue.push_back(std::vector<char>());
+    queue.back().swap(buf);
+    cond.notify_all();
+
+    return 0;
+}
+
+/*****************************************************************************/
+int IfbsCompressWriter::sinkFnc(void *pUser, const char *data, size_t len)
+/*****************************************************************************/
+{
+    return ((IfbsCompressWriter*)pUser)->put(data, len);
+}
+
+// Thread : Buffer der Reihe nach komprimieren und schreiben
+/*****************************************************************************/
+void IfbsCompressWriter::run()
+/*****************************************************************************/
+{
+    std::vector<char>   buf;
+    KS_RESULT           res = KS_ERR_OK;
+    bool                last = false;
+
+    for(;;) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            if(buf.capacity()) {
+                // Buffer zur Wiederverwendung zurueckgeben
+                if(spare.size() < IFBS_COMPRESS_QUEUE) {
+                    spare.push_back(std::vector<char>());
+                    spare.back().swap(buf);
+                }
+                buf.clear();
+            }
+            if(res && !err) {
+                err = res;
+                cond.notify_all();
+            }
+            while( queue.empty() && !finish && !pausing ) {
+                cond.wait(guard);
+            }
+            if(queue.empty()) {
+                last = finish;
+                break;
+            }
+            buf.swap(queue.front());
+            queue.pop_front();
+            cond.notify_all();
+        }
+        if(!res) {
+            res = compress(&buf[0], buf.size(), 0);
+        }
+    }
+
+    // Ende des Datenstroms, bei pause() folgen weitere Daten
+    if( last && !res ) {
+        res = compress(0, 0, 1);
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    if(res && !err) {
+        err = res;
+    }
+    cond.notify_all();
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsCompressWriter::compress(const char *data, size_t len, int last)
+/*****************************************************************************/
+{
+    size_t  anz;
+
+#ifdef IFBS_HAVE_ZLIB
+    if(method == IFBS_COMPRESS_GZIP) {
+        z_stream *z = (z_stream*)pStream;
+        int       res;
+
+        z->next_in = (Bytef*)data;
+        z->avail_in = (uInt)len;
+        for(;;) {
+            z->next_out = (Bytef*)&out[0];
+            z->avail_out = (uInt)out.size();
+            res = deflate(z, last ? Z_FINISH : Z_NO_FLUSH);
+            if(res == Z_STREAM_ERROR) {
+                return OV_ERR_CANTWRITETOFILE;
+            }
+            anz = out.size() - z->avail_out;
+            if( anz && writeOut(&out[0], anz) ) {
+                return OV_ERR_CANTWRITETOFILE;
+            }
+            if(last) {
+                if(res == Z_STREAM_END) {
+                    break;
+                }
+            } else if(z->avail_out) {
+                // Eingabe verbraucht
+                break;
+            }
+        }
+        return KS_ERR_OK;
+    }
+#endif
+#ifdef IFBS_HAVE_ZSTD
+    if(method == IFBS_COMPRESS_ZSTD) {
+        ZSTD_CCtx      *cctx = (ZSTD_CCtx*)pStream;
+        ZSTD_inBuffer   input = { data, len, 0 };
+        size_t          rest;
+
+        for(;;) {
+            ZSTD_outBuffer output = { &out[0], out.size(), 0 };
+            rest = ZSTD_compressStream2(cctx, &output, &input, last ? ZSTD_e_end : ZSTD_e_continue);
+            if(ZSTD_isError(rest)) {
+                return OV_ERR_CANTWRITETOFILE;
+            }
+            if( output.pos && writeOut(&out[0], output.pos) ) {
+                return OV_ERR_CANTWRITETOFILE;
+            }
+            if(last ? (rest == 0) : (input.pos == input.size)) {
+                break;
+            }
+        }
+        return KS_ERR_OK;
+    }
+#endif
+    (void)data;
+    (void)len;
+    (void)last;
+    (void)anz;
+    return KS_ERR_NOTIMPLEMENTED;
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsCompressWriter::writeOut(const char *data, size_t len)
+/*****************************************************************************/
+{
+#if !PLT_SYSTEM_NT
+    ssize_t res;
+
+    while(len) {
+        res = ::write(fd, data, len);
+        if(res < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return OV_ERR_CANTWRITETOFILE;
+        }
+        data += res;
+        len -= (size_t)res;
+    }
+#else
+    if(_write(fd, data, (unsigned int)len) != (int)len) {
+        return OV_ERR_CANTWRITETOFILE;
+    }
+#endif
+    return KS_ERR_OK;
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsCompressWriter::pause()
+/*****************************************************************************/
+{
+    if(worker) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            pausing = true;
+            cond.notify_all();
+        }
+        worker->join();
+        delete worker;
+        worker = 0;
+        pausing = false;
+    }
+    return err;
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsCompressWriter::close()
+/*****************************************************************************/
+{
+    if(worker) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            finish = true;
+            cond.notify_all();
+        }
+        worker->join();
+        delete worker;
+        worker = 0;
+    } else if( (fd >= 0) && pStream && !err ) {
+        // Thread laeuft nicht (keine Daten oder pause()) : Ende selbst schreiben
+        err = compress(0, 0, 1);
+    }
+
+#ifdef IFBS_HAVE_ZLIB
+    if( pStream && (method == IFBS_COMPRESS_GZIP) ) {
+        deflateEnd((z_stream*)pStream);
+        delete (z_stream*)pStream;
+    }
+#endif
+#ifdef IFBS_HAVE_ZSTD
+    if( pStream && (method == IFBS_COMPRESS_ZSTD) ) {
+        ZSTD_freeCCtx((ZSTD_CCtx*)pStream);
+    }
+#endif
+    pStream = 0;
+
+    if(fd >= 0) {
+#if !PLT_SYSTEM_NT
+        if( (::close(fd) != 0) && !err ) {
+#else
+        if( (_close(fd) != 0) && !err ) {
+#endif
+            err = OV_ERR_CANTWRITETOFILE;
+        }
+        fd = -1;
+    }
+    queue.clear();
+    spare.clear();
+    std::vector<char>().swap(out);
+
+    return err;
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsOutFile::open(const char *filename, int binary)
+/*****************************************************************************/
+{
+    KS_RESULT   err;
+    int         method;
+
+    close();
+
+    method = IFBS_CompressionFromName(filename);
+    if(method != IFBS_COMPRESS_NONE) {
+        err = Zip.open(filename, method);
+        if(err) {
+            return err;
+        }
+        pSink = new IfbsOutSink(IfbsCompressWriter::sinkFnc, &Zip);
+    } else {
+        fd = IfbsOutSink::openFile(filename, binary);
+        if(fd < 0) {
+            return KS_ERR_BADPATH;
+        }
+        pSink = new IfbsOutSink(fd);
+    }
+    return KS_ERR_OK;
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsOutFile::close()
+/*****************************************************************************/
+{
+    KS_RESULT   err = KS_ERR_OK;
+    KS_RESULT   res;
+
+    if(pSink) {
+        err = pSink->flush();
+        delete pSink;
+        pSink = 0;
+    }
+    if(fd >= 0) {
+        IfbsOutSink::closeFile(fd);
+        fd = -1;
+    } else {
+        res = Zip.close();
+        if(!err) {
+            err = res;
+        }
+    }
+    return err;
+}
+
+/*****************************************************************************/
+IfbsInFile::IfbsInFile()
+/*****************************************************************************/
+  : fp(0),
+    method(IFBS_COMPRESS_NONE),
+    pStream(0),
+    inPos(0),
+    inLen(0),
+    inEof(0),
+    streamEnd(0)
+{
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsInFile::open(const char *filename)
+/*****************************************************************************/
+{
+    long            anz;
+    unsigned char  *p;
+
+    close();
+
+    fp = fopen(filename, "rb");
+    if(!fp) {
+        return OV_ERR_CANTOPENFILE;
+    }
+
+    // Nur die Kennung lesen. Bei unkomprimierten Dateien wird der Rest
+    // direkt in den Buffer des Aufrufers gelesen
+    in.resize(IFBS_COMPRESS_BUFSIZE);
+    anz = readRaw(&in[0], 4);
+    if(anz < 0) {
+        close();
+        return OV_ERR_CANTOPENFILE;
+    }
+    inLen = (size_t)anz;
+    p = (unsigned char*)&in[0];
+
+    if( (inLen >= 2) && (p[0] == 0x1f) && (p[1] == 0x8b) ) {
+        method = IFBS_COMPRESS_GZIP;
+    } else if( (inLen >= 4) && (p[0] == 0x28) && (p[1] == 0xb5) &&
+               (p[2] == 0x2f) && (p[3] == 0xfd) ) {
+        method = IFBS_COMPRESS_ZSTD;
+    }
+    if(!IFBS_CompressionAvailable(method)) {
+        close();
+        return KS_ERR_NOTIMPLEMENTED;
+    }
+
+#ifdef IFBS_HAVE_ZLIB
+    if(method == IFBS_COMPRESS_GZIP) {
+        z_stream *z = new z_stream;
+        memset(z, 0, sizeof(z_stream));
+        // 15 + 16 : nur gzip-Format
+        if(inflateInit2(z, 15 + 16) != Z_OK) {
+            delete z;
+            close();
+            return OV_ERR_HEAPOUTOFMEMORY;
+        }
+        pStream = z;
+    }
+#endif
+#ifdef IFBS_HAVE_ZSTD
+    if(method == IFBS_COMPRESS_ZSTD) {
+        ZSTD_DCtx *dctx = ZSTD_createDCtx();
+        if(!dctx) {
+            close();
+            return OV_ERR_HEAPOUTOFMEMORY;
+        }
+        pStream = dctx;
+    }
+#endif
+
+    return KS_ERR_OK;
+}
+
+/*****************************************************************************/
+void IfbsInFile::close()
+/*****************************************************************************/
+{
+#ifdef IFBS_HAVE_ZLIB
+    if( pStream && (method == IFBS_COMPRESS_GZIP) ) {
+        inflateEnd((z_stream*)pStream);
+        delete (z_stream*)pStream;
+    }
+#endif
+#ifdef IFBS_HAVE_ZSTD
+    if( pStream && (method == IFBS_COMPRESS_ZSTD) ) {
+        ZSTD_freeDCtx((ZSTD_DCtx*)pStream);
+    }
+#endif
+    pStream = 0;
+    if(fp) {
+        fclose(fp);
+    }
+    fp = 0;
+    method = IFBS_COMPRESS_NONE;
+    inPos = 0;
+    inLen = 0;
+    inEof = 0;
+    streamEnd = 0;
+    std::vector<char>().swap(in);
+}
+
+/*****************************************************************************/
+long IfbsInFile::readRaw(char *buf, size_t len)
+/*****************************************************************************/
+{
+    size_t  anz;
+
+    if( (!fp) || inEof ) {
+        return 0;
+    }
+    anz = fread(buf, 1, len, fp);
+    if(anz < len) {
+        if(ferror(fp)) {
+            return -1;
+        }
+        inEof = 1;
+    }
+    return (long)anz;
+}
+
+/*****************************************************************************/
+long IfbsInFile::read(char *buf, size_t len)
+/*****************************************************************************/
+{
+    size_t  done = 0;
+    size_t  before;
+    long    anz;
+    int     flushOnly;
+
+    if(!fp) {
+        return -1;
+    }
+
+    if(method == IFBS_COMPRESS_NONE) {
+        // Zuerst die gelesene Kennung liefern
+        if(inPos < inLen) {
+            anz = (long)(inLen - inPos);
+            if((size_t)anz > len) {
+                anz = (long)len;
+            }
+            memcpy(buf, &in[inPos], (size_t)anz);
+            inPos += (size_t)anz;
+            return anz;
+        }
+        return readRaw(buf, len);
+    }
+
+    while(done < len) {
+        if( (inPos == inLen) && !inEof ) {
+            anz = readRaw(&in[0], in.size());
+            if(anz < 0) {
+                return -1;
+            }
+            inPos = 0;
+            inLen = (size_t)anz;
+        }
+        if(streamEnd) {
+            if(inPos == inLen) {
+                // Ende der Datei
+                break;
+            }
+            // Weiteres gzip-Member bzw. zstd-Frame (z.B. aneinandergehaengte Dateien)
+#ifdef IFBS_HAVE_ZLIB
+            if(method == IFBS_COMPRESS_GZIP) {
+                inflateReset((z_stream*)pStream);
+            }
+#endif
+            streamEnd = 0;
+        }
+        // Eingabe verbraucht : Der Dekompressor kann noch Daten gepuffert
+        // haben (Ausgabe war voll), daher einmal ohne Eingabe aufrufen
+        flushOnly = (inPos == inLen);
+        before = done;
+
+#ifdef IFBS_HAVE_ZLIB
+        if(method == IFBS_COMPRESS_GZIP) {
+            z_stream *z = (z_stream*)pStream;
+            size_t    outLen = len - done;
+            int       res;
+
+            if(outLen > IFBS_COMPRESS_BUFSIZE) {
+                outLen = IFBS_COMPRESS_BUFSIZE;
+            }
+            z->next_in = (Bytef*)(in.data() + inPos);
+            z->avail_in = (uInt)(inLen - inPos);
+            z->next_out = (Bytef*)(buf + done);
+            z->avail_out = (uInt)outLen;
+            res = inflate(z, Z_NO_FLUSH);
+            if(res == Z_STREAM_END) {
+                streamEnd = 1;
+            } else if( (res != Z_OK) && (res != Z_BUF_ERROR) ) {
+                return -1;
+            }
+            inPos = inLen - z->avail_in;
+            done += outLen - z->avail_out;
+        }
+#endif
+#ifdef IFBS_HAVE_ZSTD
+        if(method == IFBS_COMPRESS_ZSTD) {
+            ZSTD_inBuffer   input = { in.data() + inPos, inLen - inPos, 0 };
+            ZSTD_outBuffer  output = { buf + done, len - done, 0 };
+            size_t          rest;
+
+            rest = ZSTD_decompressStream((ZSTD_DCtx*)pStream, &output, &input);
+            if(ZSTD_isError(rest)) {
+                return -1;
+            }
+            if(rest == 0) {
+                streamEnd = 1;
+            }
+            inPos += input.pos;
+            done += output.pos;
+        }
+#endif
+        if( flushOnly && (done == before) && !streamEnd ) {
+            // Datei endet vor dem Ende der komprimierten Daten
+            return -1;
+        }
+    }
+
+    return (long)done;
+}
+
+/*
+*   Komprimierte Eingabe des Scanners. Die ersten Bytes werden gelesen, um
+*   eine .fbb-Datei zu erkennen, und danach zuerst geliefert
+*/
+#define IFB_INSTREAM_HEAD   8
+
+struct IfbInStream {
+    IfbsInFile  File;
+    char        head[IFB_INSTREAM_HEAD];
+    size_t      headLen;
+    size_t      headPos;
+};
+
+/*****************************************************************************/
+extern "C" long fb_parser_readstream(void* stream, char* buf, size_t len)
+/*****************************************************************************/
+{
+    IfbInStream *ps = (IfbInStream*)stream;
+    size_t       anz;
+
+    if(ps->headPos < ps->headLen) {
+        anz = ps->headLen - ps->headPos;
+        if(anz > len) {
+            anz = len;
+        }
+        memcpy(buf, ps->head + ps->headPos, anz);
+        ps->headPos += anz;
+        return (long)anz;
+    }
+    return ps->File.read(buf, len);
+}
+
+/*****************************************************************************/
+extern "C" void fb_parser_closestream(void* stream)
+/*****************************************************************************/
+{
+    delete (IfbInStream*)stream;
+}
+
+/*
+*   Komprimierte Datei fuer den Scanner oeffnen. Text wird beim Parsen
+*   stueckweise gelesen. Nur eine .fbb-Datei wird komplett in den Speicher
+*   gelesen, da ihr Index am Ende steht
+*/
+/*****************************************************************************/
+extern "C" int fb_parser_readcompressed(const char* filename, char** pbuf, size_t* psize, void** pstream)
+/*****************************************************************************/
+{
+    IfbInStream *ps;
+    char        *pNew;
+    char        *pBuf;
+    size_t       size;
+    size_t       len;
+    long         anz;
+
+    ps = new IfbInStream;
+    if(!ps) {
+        return -1;
+    }
+    switch(ps->File.open(filename)) {
+        case KS_ERR_OK:
+            break;
+        case OV_ERR_CANTOPENFILE:
+            // Fehler meldet fb_parser_openfile()
+            delete ps;
+            return 0;
+        default:
+            delete ps;
+            return -1;
+    }
+    if(ps->File.getCompression() == IFBS_COMPRESS_NONE) {
+        delete ps;
+        return 0;
+    }
+
+    anz = ps->File.read(ps->head, IFB_INSTREAM_HEAD);
+    if(anz < 0) {
+        delete ps;
+        return -1;
+    }
+    ps->headLen = (size_t)anz;
+    ps->headPos = 0;
+    if(!IFBS_IsFbbData(ps->head, ps->headLen)) {
+        *pstream = ps;
+        return 1;
+    }
+
+    // .fbb : ganze Datei entpacken
+    size = 4 * IFBS_COMPRESS_BUFSIZE;
+    len = 0;
+    pBuf = (char*)malloc(size + 2);
+    if(pBuf) {
+        memcpy(pBuf, ps->head, ps->headLen);
+        len = ps->headLen;
+    }
+    while(pBuf) {
+        anz = ps->File.read(pBuf + len, size - len);
+        if(anz < 0) {
+            free(pBuf);
+            delete ps;
+            return -1;
+        }
+        len += (size_t)anz;
+        if(len < size) {
+            break;
+        }
+        size *= 2;
+        pNew = (char*)realloc(pBuf, size + 2);
+        if(!pNew) {
+            free(pBuf);
+        }
+        pBuf = pNew;
+    }
+    delete ps;
+    if(!pBuf) {
+        /* Out of memory */
+        return -1;
+    }
+    pBuf[len] = 0;
+    pBuf[len+1] = 0;
+
+    *pbuf = pBuf;
+    *psize = len;
+    return 1;
+}
@@ -0,0 +1,1194 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_compstream.cpp                                                       *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   iFBSpro-Dienst "IFBS_DBCOMPARE_SORTED". Vergleicht zwei Sicherungs-      *
+*   dateien, deren INSTANCE-Bloecke nach Pfaden und deren LINK-Bloecke nach  *
+*   Parent-Pfaden sortiert sind, Block fuer Block wie beim Mischen. Es wird  *
+*   nie eine ganze Datei geparst. Das Protokoll entspricht IFBS_DBCOMPARE.   *
+*                                                                            *
+*   Jede Datei wird dreimal gelesen :                                        *
+*     1. Bibliotheken, Endpunkte der Verbindungen (inputcon/outputcon) und   *
+*        erstes Kind jedes Links                                             *
+*     2. Instanzen                                                           *
+*     3. Links, je Parent-Pfad eine Gruppe                                   *
+*   Die Abschnitte werden in temporaere Dateien geschrieben und am Ende in   *
+*   der Reihenfolge von IFBS_DBCOMPARE in das Protokoll kopiert.             *
+*                                                                            *
+*   Die Links inputcon/outputcon sind nach dem Pfad des FB sortiert, nicht   *
+*   nach der Verbindung. Ihre Endpunkte werden daher extern nach dem Namen   *
+*   der Verbindung sortiert (Laeufe in temporaeren Dateien, gemischt) und    *
+*   beim Mischen der Instanzen mitgelesen. Die Namen der geloeschten und     *
+*   unveraenderten Verbindungen entstehen dort sortiert und werden mit den   *
+*   sortierten ersten Kindern der Links verknuepft. Das ergibt die sortierte *
+*   Liste der Links, die beim Mischen der Links entfallen. Im Speicher sind  *
+*   nur ein Block je Datei, eine Link-Gruppe, die Bibliotheken und ein       *
+*   Sortier-Lauf (IFBS_CMPSORT_RUNSIZE).                                     *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+#include "par_param.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+/*
+*  Eine der beiden Dateien : Leser und Parse-Sitzung des aktuellen Blocks
+*/
+struct IfbCmpFile {
+    IfbsFbdReader       Reader;
+    FB_PARSE_CONTEXT*   ctx;
+    const char*         name;
+    int                 kind;       // Art des aktuellen Blocks
+};
+
+/*
+*  Kopie eines Links. Die Strukturen des Parsers gelten nur bis zum
+*  naechsten Block, eine Link-Gruppe reicht ueber mehrere Bloecke.
+*/
+struct IfbCmpLink {
+    std::string                 asso_ident;
+    std::string                 parent_role;
+    std::string                 parent_class;
+    std::string                 parent_path;
+    std::string                 child_role;
+    std::string                 child_class;
+    std::vector<std::string>    children;
+};
+
+/*
+*  Externes Sortieren. Zeilen (ohne '\n', Felder mit '\t' getrennt) werden
+*  bis IFBS_CMPSORT_RUNSIZE im Speicher sortiert und als Lauf in eine
+*  temporaere Datei geschrieben. Die Laeufe werden zu je IFB_CMPSORT_FANIN
+*  gemischt. '\t' ist kleiner als jedes Zeichen eines Pfades, die Zeilen
+*  stehen daher in der Reihenfolge von strcmp() auf dem ersten Feld.
+*/
+#define IFB_CMPSORT_FANIN   32
+
+struct IfbCmpSort {
+    std::vector<std::string>    lines;
+    size_t                      bytes;
+    std::vector<FILE*>          runs;
+
+    IfbCmpSort() : bytes(0) {}
+    ~IfbCmpSort() {
+        for(size_t i = 0; i < runs.size(); i++) {
+            if(runs[i]) {
+                fclose(runs[i]);
+            }
+        }
+    }
+};
+
+/*
+*  Sortierte Datei, zeilenweise gelesen
+*/
+struct IfbCmpLines {
+    FILE*           fp;
+    std::string     line;
+    int             have;   // line gueltig
+
+    IfbCmpLines() : fp(0), have(0) {}
+    ~IfbCmpLines() {
+        if(fp) {
+            fclose(fp);
+        }
+    }
+};
+
+/*
+*  Links einer Datei, gruppenweise gelesen. Im ersten Durchlauf werden
+*  dabei Bibliotheken, Endpunkte und erste Kinder gesammelt (pLibs), im
+*  letzten die Links aus pSkip verworfen. seq zaehlt die Links der Gruppen
+*  in beiden Durchlaeufen gleich.
+*/
+struct IfbCmpLinkReader {
+    IfbCmpFile*                 pFile;
+    std::deque<IfbCmpLink>      Next;   // Bereits gelesene Links der naechsten Gruppe
+    unsigned long long          seq;    // Nummer des naechsten Links
+    std::vector<std::string>*   pLibs;  // Nur erster Durchlauf, sonst 0
+    IfbCmpSort*                 pEnds;  // Verbindung, Rolle, Nr., Parent
+    IfbCmpSort*                 pKeys;  // Erstes Kind, Nr. des Links
+    unsigned long long          endSeq; // Nummer des naechsten Endpunkts
+    IfbCmpLines*                pSkip;  // Nr. der zu verwerfenden Links, sonst 0
+
+    IfbCmpLinkReader(IfbCmpFile *pf)
+        : pFile(pf), seq(0), pLibs(0), pEnds(0), pKeys(0), endSeq(0), pSkip(0) {}
+};
+
+/*
+*  Vergleich sortierter Dateien statt IFBS_DBCOMPARE ein/aus
+*/
+static int ifbs_SortedCompare = 0;
+
+/******************************************************************************/
+void IFBS_SetSortedCompare(int on) {
+/******************************************************************************/
+    ifbs_SortedCompare = on;
+}
+
+/******************************************************************************/
+int IFBS_GetSortedCompare() {
+/******************************************************************************/
+    return ifbs_SortedCompare;
+}
+
+// Nummer mit fester Breite, sortiert wie die Zahl
+static void ifb_cmpSeq(std::string &s, unsigned long long seq) {
+    char    help[32];
+
+    sprintf(help, "%016llx", seq);
+    s = help;
+}
+
+// Feld nr (ab 0) einer Zeile
+static void ifb_cmpField(const std::string &line, int nr, std::string &field) {
+    size_t  pos = 0;
+    size_t  end;
+
+    while( nr-- && (pos != std::string::npos) ) {
+        pos = line.find('\t', pos);
+        if(pos != std::string::npos) {
+            pos++;
+        }
+    }
+    if(pos == std::string::npos) {
+        field = "";
+        return;
+    }
+    end = line.find('\t', pos);
+    field = line.substr(pos, (end == std::string::npos) ? std::string::npos : end - pos);
+}
+
+/*****************************************************************************/
+static int ifb_cmpGetLine(FILE *fp, std::string &line)
+/*****************************************************************************/
+{
+    char    buf[1024];
+    size_t  len;
+
+    line = "";
+    while(fgets(buf, sizeof(buf), fp)) {
+        len = strlen(buf);
+        if( len && (buf[len-1] == '\n') ) {
+            line.append(buf, len - 1);
+            return 1;
+        }
+        line.append(buf, len);
+    }
+    return line.size() ? 1 : 0;
+}
+
+/*****************************************************************************/
+static void ifb_cmpLinesOpen(IfbCmpLines &Lines, FILE *fp)
+/*****************************************************************************/
+{
+    Lines.fp = fp;
+    rewind(fp);
+    Lines.have = ifb_cmpGetLine(fp, Lines.line);
+}
+
+/*****************************************************************************/
+static void ifb_cmpLinesNext(IfbCmpLines &Lines)
+/*****************************************************************************/
+{
+    Lines.have = ifb_cmpGetLine(Lines.fp, Lines.line);
+}
+
+// Lauf im Speicher sortieren und schreiben
+/*****************************************************************************/
+static KS_RESULT ifb_sortFlush(IfbCmpSort &Sort)
+/*****************************************************************************/
+{
+    FILE*   fp;
+    size_t  i;
+
+    std::sort(Sort.lines.begin(), Sort.lines.end());
+
+    fp = tmpfile();
+    if(!fp) {
+        return OV_ERR_CANTOPENFILE;
+    }
+    Sort.runs.push_back(fp);
+    for(i = 0; i < Sort.lines.size(); i++) {
+        fputs(Sort.lines[i].c_str(), fp);
+        fputc('\n', fp);
+    }
+    std::vector<std::string>().swap(Sort.lines);
+    Sort.bytes = 0;
+
+    return ferror(fp) ? OV_ERR_CANTWRITETOFILE : KS_ERR_OK;
+}
+
+/*****************************************************************************/
+static KS_RESULT ifb_sortAdd(IfbCmpSort &Sort, const std::string &line)
+/*****************************************************************************/
+{
+    Sort.lines.push_back(line);
+    Sort.bytes += line.size() + sizeof(std::string);
+    if(Sort.bytes >= IFBS_CMPSORT_RUNSIZE) {
+        return ifb_sortFlush(Sort);
+    }
+    return KS_ERR_OK;
+}
+
+// Sortierte Laeufe in eine neue Datei mischen
+/*****************************************************************************/
+static KS_RESULT ifb_sortMerge(FILE **In, size_t anz, FILE **pOut)
+/*****************************************************************************/
+{
+    typedef std::pair<std::string, size_t>  Item;
+
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item> >  Heap;
+    std::string     line;
+    FILE*           fp;
+    size_t          i;
+
+    fp = tmpfile();
+    if(!fp) {
+        return OV_ERR_CANTOPENFILE;
+    }
+    for(i = 0; i < anz; i++) {
+        rewind(In[i]);
+        if(ifb_cmpGetLine(In[i], line)) {
+            Heap.push(Item(line, i));
+        }
+    }
+    while(!Heap.empty()) {
+        i = Heap.top().second;
+        fputs(Heap.top().first.c_str(), fp);
+        fputc('\n', fp);
+        Heap.pop();
+        if(ifb_cmpGetLine(In[i], line)) {
+            Heap.push(Item(line, i));
+        }
+    }
+    *pOut = fp;
+
+    return ferror(fp) ? OV_ERR_CANTWRITETOFILE : KS_ERR_OK;
+}
+
+// Alle Zeilen sortiert in einer Datei. *pOut gehoert dem Aufrufer
+/*****************************************************************************/
+static KS_RESULT ifb_sortFinish(IfbCmpSort &Sort, FILE **pOut)
+/*****************************************************************************/
+{
+    std::vector<FILE*>  Next;
+    FILE*               fp;
+    KS_RESULT           fehler;
+    size_t              i, k, anz;
+
+    if( Sort.lines.size() || Sort.runs.empty() ) {
+        fehler = ifb_sortFlush(Sort);
+        if(fehler) {
+            return fehler;
+        }
+    }
+
+    while(Sort.runs.size() > 1) {
+        Next.clear();
+        for(i = 0; i < Sort.runs.size(); i += anz) {
+            anz = Sort.runs.size() - i;
+            if(anz > IFB_CMPSORT_FANIN) {
+                anz = IFB_CMPSORT_FANIN;
+            }
+            if(anz == 1) {
+                Next.push_back(Sort.runs[i]);
+                Sort.runs[i] = 0;
+                continue;
+            }
+            fehler = ifb_sortMerge(&Sort.runs[i], anz, &fp);
+            if(fp) {
+                Next.push_back(fp);
+            }
+            for(k = i; k < i + anz; k++) {
+                fclose(Sort.runs[k]);
+                Sort.runs[k] = 0;
+            }
+            if(fehler) {
+                Sort.runs.swap(Next);
+                return fehler;
+            }
+        }
+        Sort.runs.swap(Next);
+    }
+
+    *pOut = Sort.runs[0];
+    Sort.runs.clear();
+    return KS_ERR_OK;
+}
+
+/*****************************************************************************/
+static KS_RESULT ifb_cmpOpen(IfbCmpFile &File, FILE *yyout)
+/*****************************************************************************/
+{
+    // Bloecke werden als Text gelesen, .fbb nur im normalen Vergleich
+    if(IFBS_IsFbbName(File.name)) {
+        fprintf(yyout,"%s",
+            (const char*)log_getErrMsg(KS_ERR_OK,"binary file not supported in sorted compare", File.name));
+        return KS_ERR_NOTIMPLEMENTED;
+    }
+    if(!File.Reader.open(File.name)) {
+        fprintf(yyout,"%s",
+            (const char*)log_getErrMsg(KS_ERR_OK,"can't open file", File.name));
+        return OV_ERR_CANTOPENFILE;
+    }
+    File.kind = FB_BLOCK_NONE;
+    return KS_ERR_OK;
+}
+
+// Unvollstaendiger oder unbekannter Block
+/*****************************************************************************/
+static KS_RESULT ifb_cmpReadError(IfbCmpFile &File, FILE *yyout)
+/*****************************************************************************/
+{
+    char    help[32];
+
+    sprintf(help, "%d", File.Reader.getLine() + 1);
+    fprintf(yyout,"%s",
+        (const char*)log_getErrMsg(KS_ERR_OK,"Parse error. File", File.name, "line", help));
+    return KS_ERR_BADPARAM;
+}
+
+/*****************************************************************************/
+static KS_RESULT ifb_cmpParse(IfbCmpFile &File, FILE *yyout)
+/*****************************************************************************/
+{
+    PltString   out;
+
+    if(File.Reader.parse(File.ctx) == EXIT_SUCCESS) {
+        return KS_ERR_OK;
+    }
+    iFBS_SetParserError(File.ctx);
+    out = IFBS_GetParserError(File.ctx);
+    if( out == "" ) {
+        fprintf(yyout,"%s",
+            (const char*)log_getErrMsg(KS_ERR_OK,"Parse error. File", File.name));
+    } else {
+        fprintf(yyout,"%s",
+            (const char*)log_getErrMsg(KS_ERR_OK, (const char*)out, "File", File.name));
+    }
+    return KS_ERR_BADPARAM;
+}
+
+// Naechsten Block der Art kind lesen und parsen. Andere Bloecke werden
+// uebersprungen. Am Dateiende ist File.kind == FB_BLOCK_NONE
+/*****************************************************************************/
+static KS_RESULT ifb_cmpNext(IfbCmpFile &File, int kind, FILE *yyout)
+/*****************************************************************************/
+{
+    for(;;) {
+        File.kind = File.Reader.next();
+        if(File.kind == FB_BLOCK_NONE) {
+            return KS_ERR_OK;
+        }
+        if(File.kind < 0) {
+            return ifb_cmpReadError(File, yyout);
+        }
+        if(File.kind == kind) {
+            return ifb_cmpParse(File, yyout);
+        }
+    }
+}
+
+/*****************************************************************************/
+static void ifb_cmpNotSorted(FILE *yyout, IfbCmpFile &File, const char *path)
+/*****************************************************************************/
+{
+    fprintf(yyout,"%s",
+        (const char*)log_getErrMsg(KS_ERR_OK,"File not sorted by path. File", File.name,
+                                   "path", path));
+}
+
+// Bibliotheken wie compare_libraries : gleiche Namen werden paarweise
+// gestrichen, die uebrigen in Dateireihenfolge ausgegeben
+/*****************************************************************************/
+static void ifb_cmpPutLibs(std::vector<std::string> &OldLibs,
+                           std::vector<std::string> &NewLibs,
+                           FILE                     *yyout)
+/*****************************************************************************/
+{
+    std::unordered_map<std::string, size_t>   oldCnt;
+    std::unordered_map<std::string, size_t>   newCnt;
+    std::unordered_map<std::string, size_t>   seen;
+    PltString                                 out;
+    size_t                                    i, paare;
+
+    for(i = 0; i < OldLibs.size(); i++) {
+        oldCnt[OldLibs[i]]++;
+    }
+    for(i = 0; i < NewLibs.size(); i++) {
+        newCnt[NewLibs[i]]++;
+    }
+
+    put_compare_title(IFBS_CMP_DELLIBS, out);
+    for(i = 0; i < OldLibs.size(); i++) {
+        paare = newCnt[OldLibs[i]];
+        if(seen[OldLibs[i]]++ >= paare) {
+            put_library(OldLibs[i].c_str(), 1, out);
+        }
+    }
+
+    seen.clear();
+    put_compare_title(IFBS_CMP_NEWLIBS, out);
+    for(i = 0; i < NewLibs.size(); i++) {
+        paare = oldCnt[NewLibs[i]];
+        if(seen[NewLibs[i]]++ >= paare) {
+            put_library(NewLibs[i].c_str(), 0, out);
+        }
+    }
+
+    fputs((const char*)out, yyout);
+}
+
+// Endpunkte einer Verbindung aus der sortierten Endpunkt-Datei. Die Namen
+// werden aufsteigend abgefragt. Je Rolle gilt der erste Link
+/*****************************************************************************/
+static void ifb_cmpFindEnds(IfbCmpLines &Ends, const char *VerbName, std::string *Parents)
+/*****************************************************************************/
+{
+    std::string     field;
+    int             i, c;
+
+    for(i = 0; i < 2; i++) {
+        Parents[i] = "";
+    }
+    while(Ends.have) {
+        ifb_cmpField(Ends.line, 0, field);
+        c = strcmp(field.c_str(), VerbName);
+        if(c > 0) {
+            break;
+        }
+        if(c == 0) {
+            ifb_cmpField(Ends.line, 1, field);
+            i = (field == "inputcon") ? 0 : 1;
+            if(Parents[i].empty()) {
+                ifb_cmpField(Ends.line, 3, Parents[i]);
+            }
+        }
+        ifb_cmpLinesNext(Ends);
+    }
+}
+
+// Endpunkte einer Verbindung wie compareComConnLinks. 1 = unterschiedlich
+/*****************************************************************************/
+static int ifb_cmpConnEnds(IfbCmpLines &OldEnds, IfbCmpLines &NewEnds, const char *VerbName)
+/*****************************************************************************/
+{
+    std::string     OldParents[2];
+    std::string     NewParents[2];
+    int             i;
+
+    ifb_cmpFindEnds(OldEnds, VerbName, OldParents);
+    ifb_cmpFindEnds(NewEnds, VerbName, NewParents);
+    for(i = 0; i < 2; i++) {
+        if( OldParents[i].empty() || NewParents[i].empty() ) {
+            return 1;
+        }
+        if(OldParents[i] != NewParents[i]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*****************************************************************************/
+static void ifb_cmpPut(FILE *fout, PltString &out)
+/*****************************************************************************/
+{
+    fputs((const char*)out, fout);
+    out = "";
+}
+
+// Instanzen beider Dateien mischen. Geloeschte Verbindungen der alten Datei
+// und unveraenderte Verbindungen werden fuer den Link-Vergleich in OldConns
+// und EqualConns geschrieben, aufsteigend sortiert
+/*****************************************************************************/
+static KS_RESULT ifb_cmpInstances(IfbCmpFile    &Old,
+                                  IfbCmpFile    &New,
+                                  IfbCmpLines   &OldEnds,
+                                  IfbCmpLines   &NewEnds,
+                                  FILE          *OldConns,
+                                  FILE          *EqualConns,
+                                  FILE          **Sect,
+                                  FILE          *yyout)
+/*****************************************************************************/
+{
+    InstanceItems*  poi;
+    InstanceItems*  pni;
+    std::string     lastOld;
+    std::string     lastNew;
+    PltString       out;
+    KS_RESULT       fehler;
+    int             c, isConn;
+
+    fehler = ifb_cmpOpen(Old, yyout);
+    if(!fehler) {
+        fehler = ifb_cmpOpen(New, yyout);
+    }
+    if(!fehler) {
+        fehler = ifb_cmpNext(Old, FB_BLOCK_INSTANCE, yyout);
+    }
+    if(!fehler) {
+        fehler = ifb_cmpNext(New, FB_BLOCK_INSTANCE, yyout);
+    }
+
+    while( (!fehler) && ((Old.kind != FB_BLOCK_NONE) || (New.kind != FB_BLOCK_NONE)) ) {
+        poi = (Old.kind != FB_BLOCK_NONE) ? Old.ctx->par->Instance : 0;
+        pni = (New.kind != FB_BLOCK_NONE) ? New.ctx->par->Instance : 0;
+
+        // Reihenfolge pruefen (Pfade streng aufsteigend)
+        if( poi && lastOld.size() && (strcmp(lastOld.c_str(), poi->Inst_name) >= 0) ) {
+            ifb_cmpNotSorted(yyout, Old, poi->Inst_name);
+            return KS_ERR_BADPARAM;
+        }
+        if( pni && lastNew.size() && (strcmp(lastNew.c_str(), pni->Inst_name) >= 0) ) {
+            ifb_cmpNotSorted(yyout, New, pni->Inst_name);
+            return KS_ERR_BADPARAM;
+        }
+
+        if(!poi) {
+            c = 1;
+        } else if(!pni) {
+            c = -1;
+        } else {
+            c = strcmp(poi->Inst_name, pni->Inst_name);
+        }
+
+        if(c < 0) {
+            // Instanz gibt es nur in alter Datei
+            if( !strcmp(poi->Class_name, CONNECTION_CLASS_PATH) ) {
+                fprintf(OldConns, "%s\n", poi->Inst_name);
+            }
+            put_delete(poi->Inst_name, out);
+            ifb_cmpPut(Sect[IFBS_CMP_DELETE], out);
+
+        } else if(c > 0) {
+            // Instanz gibt es nur in neuer Datei
+            put_instance(pni, out);
+            ifb_cmpPut(Sect[IFBS_CMP_INSTANCE], out);
+
+        } else {
+            isConn = !strcmp(poi->Class_name, CONNECTION_CLASS_PATH);
+            if(isConn) {
+                // Links der alten Verbindung werden nie geloest
+                fprintf(OldConns, "%s\n", poi->Inst_name);
+            }
+
+            if( strcmp(poi->Class_name, pni->Class_name) ||
+                (isConn && (compareComConnVars(poi, pni) ||
+                            ifb_cmpConnEnds(OldEnds, NewEnds, poi->Inst_name))) ) {
+                // Alte Instanz loeschen, neue anlegen
+                put_delete(poi->Inst_name, out);
+                ifb_cmpPut(Sect[IFBS_CMP_DELETE], out);
+                put_instance(pni, out);
+                ifb_cmpPut(Sect[IFBS_CMP_INSTANCE], out);
+            } else {
+                fehler = param_compare(poi, pni, out);
+                ifb_cmpPut(yyout, out);
+                if(fehler == KS_ERR_TYPEMISMATCH) {
+                    return KS_ERR_BADPARAM;
+                }
+                if(fehler) {
+                    put_set(pni, out);
+                    ifb_cmpPut(Sect[IFBS_CMP_SET], out);
+                    fehler = KS_ERR_OK;
+                } else if(isConn) {
+                    // Links der neuen Verbindung muessen nicht erstellt werden
+                    fprintf(EqualConns, "%s\n", pni->Inst_name);
+                }
+            }
+        }
+
+        if(c <= 0) {
+            lastOld = poi->Inst_name;
+            fehler = ifb_cmpNext(Old, FB_BLOCK_INSTANCE, yyout);
+        }
+        if( (!fehler) && (c >= 0) ) {
+            lastNew = pni->Inst_name;
+            fehler = ifb_cmpNext(New, FB_BLOCK_INSTANCE, yyout);
+        }
+    }
+
+    Old.Reader.close();
+    New.Reader.close();
+
+    if( (!fehler) && (ferror(OldConns) || ferror(EqualConns)) ) {
+        fehler = OV_ERR_CANTWRITETOFILE;
+    }
+    return fehler;
+}
+
+// Naechsten Link-Block lesen. Im ersten Durchlauf werden dabei die
+// Bibliotheken und die Endpunkte der Verbindungen gesammelt
+/*****************************************************************************/
+static KS_RESULT ifb_cmpNextLinks(IfbCmpLinkReader &Links, FILE *yyout)
+/*****************************************************************************/
+{
+    IfbCmpFile&     File = *Links.pFile;
+    DelInstItems*   plib;
+    LinksItems*     plink;
+    std::string     line;
+    std::string     seq;
+    KS_RESULT       fehler;
+
+    if(!Links.pLibs) {
+        return ifb_cmpNext(File, FB_BLOCK_LINK, yyout);
+    }
+
+    for(;;) {
+        File.kind = File.Reader.next();
+        if(File.kind == FB_BLOCK_NONE) {
+            return KS_ERR_OK;
+        }
+        if(File.kind < 0) {
+            return ifb_cmpReadError(File, yyout);
+        }
+        if(File.kind == FB_BLOCK_INSTANCE) {
+            continue;
+        }
+        fehler = ifb_cmpParse(File, yyout);
+        if(fehler) {
+            return fehler;
+        }
+        if(File.kind == FB_BLOCK_LIBRARY) {
+            for(plib = File.ctx->par->NewLibs; plib; plib = plib->next) {
+                Links.pLibs->push_back(std::string(plib->Inst_name));
+            }
+            continue;
+        }
+
+        for(plink = File.ctx->par->Links; plink; plink = plink->next) {
+            if( (!plink->children) ||
+                (strcmp(plink->child_role, "inputcon") && strcmp(plink->child_role, "outputcon")) ) {
+                continue;
+            }
+            // Verbindung, Rolle, Nr. (der erste Link gilt), Parent
+            ifb_cmpSeq(seq, Links.endSeq++);
+            line  = plink->children->child_path;
+            line += '\t';
+            line += plink->child_role;
+            line += '\t';
+            line += seq;
+            line += '\t';
+            line += plink->parent_path;
+            fehler = ifb_sortAdd(*Links.pEnds, line);
+            if(fehler) {
+                return fehler;
+            }
+        }
+        return KS_ERR_OK;
+    }
+}
+
+// Links des aktuellen Blocks kopieren
+/*****************************************************************************/
+static void ifb_cmpCopyLinks(IfbCmpLinkReader &Links)
+/*****************************************************************************/
+{
+    LinksItems*     plink;
+    Child*          pchild;
+
+    for(plink = Links.pFile->ctx->par->Links; plink; plink = plink->next) {
+        if(!plink->children) {
+            continue;
+        }
+        Links.Next.push_back(IfbCmpLink());
+        IfbCmpLink &Link = Links.Next.back();
+        Link.asso_ident   = plink->asso_ident;
+        Link.parent_role  = plink->parent_role;
+        Link.parent_class = plink->parent_class;
+        Link.parent_path  = plink->parent_path;
+        Link.child_role   = plink->child_role;
+        Link.child_class  = plink->child_class;
+        for(pchild = plink->children; pchild; pchild = pchild->next) {
+            Link.children.push_back(std::string(pchild->child_path));
+        }
+    }
+}
+
+// Alle Links mit dem naechsten Parent-Pfad lesen
+/*****************************************************************************/
+static KS_RESULT ifb_cmpReadGroup(IfbCmpLinkReader          &Links,
+                                  std::vector<IfbCmpLink>   &Group,
+                                  FILE                      *yyout)
+/*****************************************************************************/
+{
+    KS_RESULT   fehler;
+
+    Group.clear();
+
+    for(;;) {
+        while( Links.Next.empty() && (Links.pFile->kind != FB_BLOCK_NONE) ) {
+            fehler = ifb_cmpNextLinks(Links, yyout);
+            if(fehler) {
+                return fehler;
+            }
+            if(Links.pFile->kind != FB_BLOCK_NONE) {
+                ifb_cmpCopyLinks(Links);
+            }
+        }
+        if(Links.Next.empty()) {
+            break;
+        }
+        if( Group.size() &&
+            (Links.Next.front().parent_path != Group[0].parent_path) ) {
+            if(Links.Next.front().parent_path < Group[0].parent_path) {
+                ifb_cmpNotSorted(yyout, *Links.pFile, Links.Next.front().parent_path.c_str());
+                return KS_ERR_BADPARAM;
+            }
+            break;
+        }
+        Group.push_back(IfbCmpLink());
+        std::swap(Group.back(), Links.Next.front());
+        Links.Next.pop_front();
+    }
+
+    return KS_ERR_OK;
+}
+
+// Naechste Gruppe mit Links. Doppelte Kinder (gleiche Rolle) bleiben wie in
+// fb_parser_checkstruct nur im ersten Link mit diesem Kind. Die uebrigen
+// Links werden numeriert. Im ersten Durchlauf wird das erste Kind jedes Links
+// mit der Nummer nach pKeys geschrieben, im letzten werden die Links aus
+// pSkip verworfen (wie IfbsLinkIndex::removeChild). Eine leere Gruppe gibt
+// es nur am Dateiende
+/*****************************************************************************/
+static KS_RESULT ifb_cmpLinkGroup(IfbCmpLinkReader          &Links,
+                                  std::vector<IfbCmpLink>   &Group,
+                                  FILE                      *yyout)
+/*****************************************************************************/
+{
+    std::unordered_map<std::string, size_t>     owner;
+    std::string                                 key;
+    std::string                                 seq;
+    std::vector<std::string>                    children;
+    KS_RESULT                                   fehler;
+    size_t                                      i, k;
+    int                                         skip;
+
+    do {
+        fehler = ifb_cmpReadGroup(Links, Group, yyout);
+        if(fehler) {
+            return fehler;
+        }
+
+        owner.clear();
+        for(i = 0; i < Group.size(); i++) {
+            children.clear();
+            for(k = 0; k < Group[i].children.size(); k++) {
+                key  = Group[i].child_role;
+                key += '\0';
+                key += Group[i].children[k];
+                if(owner.insert(std::make_pair(key, i)).first->second == i) {
+                    children.push_back(Group[i].children[k]);
+                }
+            }
+            Group[i].children.swap(children);
+        }
+        for(i = k = 0; i < Group.size(); i++) {
+            if(Group[i].children.empty()) {
+                continue;
+            }
+            ifb_cmpSeq(seq, Links.seq++);
+            skip = 0;
+            if(Links.pKeys) {
+                key  = Group[i].children[0];
+                key += '\t';
+                key += seq;
+                fehler = ifb_sortAdd(*Links.pKeys, key);
+                if(fehler) {
+                    return fehler;
+                }
+            }
+            if(Links.pSkip) {
+                while( Links.pSkip->have && (Links.pSkip->line < seq) ) {
+                    ifb_cmpLinesNext(*Links.pSkip);
+                }
+                skip = Links.pSkip->have && (Links.pSkip->line == seq);
+            }
+            if(!skip) {
+                if(i != k) {
+                    std::swap(Group[k], Group[i]);
+                }
+                k++;
+            }
+        }
+        Group.resize(k);
+    } while( Group.empty() && Links.Next.size() );
+
+    return KS_ERR_OK;
+}
+
+/*****************************************************************************/
+static void ifb_cmpPutLink(IfbCmpLink &Link, const char *what, FILE *fout)
+/*****************************************************************************/
+{
+    std::vector<Child>  children(Link.children.size());
+    LinksItems          link;
+    PltString           out;
+    size_t              i;
+
+    for(i = 0; i < children.size(); i++) {
+        children[i].child_path = (char*)Link.children[i].c_str();
+        children[i].next = (i + 1 < children.size()) ? &children[i+1] : 0;
+    }
+    link.asso_ident   = (char*)Link.asso_ident.c_str();
+    link.parent_role  = (char*)Link.parent_role.c_str();
+    link.parent_class = (char*)Link.parent_class.c_str();
+    link.parent_path  = (char*)Link.parent_path.c_str();
+    link.child_role   = (char*)Link.child_role.c_str();
+    link.child_class  = (char*)Link.child_class.c_str();
+    link.children     = children.size() ? &children[0] : 0;
+    link.next         = 0;
+
+    put_link(&link, what, out);
+    fputs((const char*)out, fout);
+}
+
+// Links beider Dateien gruppenweise mischen. Innerhalb einer Gruppe wie
+// get_any_links : gleiche Rolle und gleiche Kinder heben sich auf
+/*****************************************************************************/
+static KS_RESULT ifb_cmpLinks(IfbCmpFile    &Old,
+                              IfbCmpFile    &New,
+                              IfbCmpLines   &OldSkip,
+                              IfbCmpLines   &NewSkip,
+                              FILE          **Sect,
+                              FILE          *yyout)
+/*****************************************************************************/
+{
+    IfbCmpLinkReader                                    OldLinks(&Old);
+    IfbCmpLinkReader                                    NewLinks(&New);
+    std::vector<IfbCmpLink>                             OldGroup;
+    std::vector<IfbCmpLink>                             NewGroup;
+    std::vector<char>                                   oldDone;
+    std::vector<char>                                   newDone;
+    std::unordered_map<std::string, std::deque<size_t> >            byRole;
+    std::unordered_map<std::string, std::deque<size_t> >::iterator  it;
+    KS_RESULT                                           fehler;
+    size_t                                              i, k;
+    int                                                 c;
+
+    fehler = ifb_cmpOpen(Old, yyout);
+    if(!fehler) {
+        fehler = ifb_cmpOpen(New, yyout);
+    }
+    if(fehler) {
+        return fehler;
+    }
+    // kind != FB_BLOCK_NONE : Datei noch nicht zu Ende
+    Old.kind = FB_BLOCK_LINK;
+    New.kind = FB_BLOCK_LINK;
+    OldLinks.pSkip = &OldSkip;
+    NewLinks.pSkip = &NewSkip;
+
+    fehler = ifb_cmpLinkGroup(OldLinks, OldGroup, yyout);
+    if(!fehler) {
+        fehler = ifb_cmpLinkGroup(NewLinks, NewGroup, yyout);
+    }
+
+    while( (!fehler) && (OldGroup.size() || NewGroup.size()) ) {
+        if(OldGroup.empty()) {
+            c = 1;
+        } else if(NewGroup.empty()) {
+            c = -1;
+        } else {
+            c = OldGroup[0].parent_path.compare(NewGroup[0].parent_path);
+        }
+
+        oldDone.assign(OldGroup.size(), 0);
+        newDone.assign(NewGroup.size(), 0);
+
+        if(c == 0) {
+            byRole.clear();
+            for(k = 0; k < NewGroup.size(); k++) {
+                byRole[NewGroup[k].child_role].push_back(k);
+            }
+            for(i = 0; i < OldGroup.size(); i++) {
+                it = byRole.find(OldGroup[i].child_role);
+                if( (it == byRole.end()) || it->second.empty() ) {
+                    continue;
+                }
+                k = it->second.front();
+                if(OldGroup[i].children != NewGroup[k].children) {
+                    continue;
+                }
+                oldDone[i] = 1;
+                newDone[k] = 1;
+                it->second.pop_front();
+            }
+        }
+
+        if(c <= 0) {
+            for(i = 0; i < OldGroup.size(); i++) {
+                if( oldDone[i] ||
+                    (OldGroup[i].child_role == "inputcon") ||
+                    (OldGroup[i].child_role == "outputcon") ) {
+                    continue;
+                }
+                ifb_cmpPutLink(OldGroup[i], "UNLINK", Sect[IFBS_CMP_UNLINK]);
+            }
+            fehler = ifb_cmpLinkGroup(OldLinks, OldGroup, yyout);
+        }
+        if(c >= 0) {
+            for(k = 0; k < NewGroup.size(); k++) {
+                if(!newDone[k]) {
+                    ifb_cmpPutLink(NewGroup[k], "LINK", Sect[IFBS_CMP_LINK]);
+                }
+            }
+            if(!fehler) {
+                fehler = ifb_cmpLinkGroup(NewLinks, NewGroup, yyout);
+            }
+        }
+    }
+
+    Old.Reader.close();
+    New.Reader.close();
+
+    return fehler;
+}
+
+// Erster Durchlauf einer Datei : Bibliotheken sammeln, Endpunkte der
+// Verbindungen und erste Kinder der Links sortiert in Dateien schreiben
+/*****************************************************************************/
+static KS_RESULT ifb_cmpReadLinks(IfbCmpFile                &File,
+                                  std::vector<std::string>  &Libs,
+                                  FILE                      **pEnds,
+                                  FILE                      **pKeys,
+                                  FILE                      *yyout)
+/*****************************************************************************/
+{
+    IfbCmpLinkReader            Links(&File);
+    IfbCmpSort                  Ends;
+    IfbCmpSort                  Keys;
+    std::vector<IfbCmpLink>     Group;
+    KS_RESULT                   fehler;
+
+    fehler = ifb_cmpOpen(File, yyout);
+    if(fehler) {
+        return fehler;
+    }
+    File.kind = FB_BLOCK_LINK;
+    Links.pLibs = &Libs;
+    Links.pEnds = &Ends;
+    Links.pKeys = &Keys;
+
+    do {
+        fehler = ifb_cmpLinkGroup(Links, Group, yyout);
+    } while( (!fehler) && Group.size() );
+    File.Reader.close();
+
+    if(!fehler) {
+        fehler = ifb_sortFinish(Ends, pEnds);
+    }
+    if(!fehler) {
+        fehler = ifb_sortFinish(Keys, pKeys);
+    }
+    return fehler;
+}
+
+// Nummern der Links, deren erstes Kind in Conns steht (beide sortiert),
+// sortiert nach *pSkip
+/*****************************************************************************/
+static KS_RESULT ifb_cmpSkipList(FILE *KeysFile, FILE *ConnsFile, FILE **pSkip)
+/*****************************************************************************/
+{
+    IfbCmpLines     Keys;
+    IfbCmpLines     Conns;
+    IfbCmpSort      Skip;
+    std::string     child;
+    std::string     seq;
+    KS_RESULT       fehler = KS_ERR_OK;
+    int             c;
+
+    ifb_cmpLinesOpen(Keys, KeysFile);
+    ifb_cmpLinesOpen(Conns, ConnsFile);
+
+    while( (!fehler) && Keys.have && Conns.have ) {
+        ifb_cmpField(Keys.line, 0, child);
+        c = strcmp(child.c_str(), Conns.line.c_str());
+        if(c > 0) {
+            ifb_cmpLinesNext(Conns);
+            continue;
+        }
+        if(c == 0) {
+            ifb_cmpField(Keys.line, 1, seq);
+            fehler = ifb_sortAdd(Skip, seq);
+        }
+        ifb_cmpLinesNext(Keys);
+    }
+    // Die Dateien gehoeren dem Aufrufer
+    Keys.fp  = 0;
+    Conns.fp = 0;
+
+    if(!fehler) {
+        fehler = ifb_sortFinish(Skip, pSkip);
+    }
+    return fehler;
+}
+
+/*****************************************************************************/
+KS_RESULT IFBS_DBCOMPARE_SORTED(PltString& olddat,
+                                PltString& newdat,
+                                PltString& proto)
+/*****************************************************************************/
+{
+    IfbCmpFile                          Old;
+    IfbCmpFile                          New;
+    std::vector<std::string>            OldLibs;
+    std::vector<std::string>            NewLibs;
+    IfbCmpLines                         OldEnds;
+    IfbCmpLines                         NewEnds;
+    IfbCmpLines                         OldSkip;
+    IfbCmpLines                         NewSkip;
+    FILE*                               OldKeys = 0;
+    FILE*                               NewKeys = 0;
+    FILE*                               OldConns = 0;
+    FILE*                               EqualConns = 0;
+    FILE*                               Sect[IFBS_CMP_SECTIONS];
+    FILE*                               yyout;
+    PltString                           out;
+    KS_RESULT                           fehler;
+    char                                buf[4096];
+    size_t                              anz;
+    int                                 i;
+
+    if( (!olddat.len()) || (!newdat.len()) || (!proto.len()) ) {
+        return KS_ERR_BADNAME;
+    }
+
+    yyout = fopen((const char*)proto, "w");
+    if(!yyout) {
+        return OV_ERR_CANTOPENFILE;
+    }
+    ifb_putCompareHeader(yyout, olddat, newdat, proto);
+
+    Old.name = (const char*)olddat;
+    New.name = (const char*)newdat;
+    Old.ctx = fb_parser_create();
+    New.ctx = fb_parser_create();
+    for(i = 0; i < IFBS_CMP_SECTIONS; i++) {
+        Sect[i] = 0;
+    }
+    if( (!Old.ctx) || (!New.ctx) ) {
+        fehler = OV_ERR_HEAPOUTOFMEMORY;
+        goto ENDE;
+    }
+    for(i = IFBS_CMP_DELETE; i < IFBS_CMP_SECTIONS; i++) {
+        Sect[i] = tmpfile();
+        if(!Sect[i]) {
+            fehler = OV_ERR_CANTOPENFILE;
+            goto ENDE;
+        }
+    }
+
+    OldConns   = tmpfile();
+    EqualConns = tmpfile();
+    if( (!OldConns) || (!EqualConns) ) {
+        fehler = OV_ERR_CANTOPENFILE;
+        goto ENDE;
+    }
+
+    /*
+    *   1. Bibliotheken, Endpunkte der Verbindungen, erste Kinder der Links
+    */
+    fehler = ifb_cmpReadLinks(Old, OldLibs, &OldEnds.fp, &OldKeys, yyout);
+    if(!fehler) {
+        fehler = ifb_cmpReadLinks(New, NewLibs, &NewEnds.fp, &NewKeys, yyout);
+    }
+    if(fehler) {
+        goto ENDE;
+    }
+    ifb_cmpPutLibs(OldLibs, NewLibs, yyout);
+    std::vector<std::string>().swap(OldLibs);
+    std::vector<std::string>().swap(NewLibs);
+
+    /*
+    *   2. Instanzen
+    */
+    ifb_cmpLinesOpen(OldEnds, OldEnds.fp);
+    ifb_cmpLinesOpen(NewEnds, NewEnds.fp);
+    fehler = ifb_cmpInstances(Old, New, OldEnds, NewEnds, OldConns, EqualConns, Sect, yyout);
+    if(fehler) {
+        goto ENDE;
+    }
+
+    /*
+    *   Zu verwerfende Links : erstes Kind ist eine geloeschte (alte Datei)
+    *   bzw. unveraenderte Verbindung (neue Datei)
+    */
+    fehler = ifb_cmpSkipList(OldKeys, OldConns, &OldSkip.fp);
+    if(!fehler) {
+        fehler = ifb_cmpSkipList(NewKeys, EqualConns, &NewSkip.fp);
+    }
+    if(fehler) {
+        goto ENDE;
+    }
+    ifb_cmpLinesOpen(OldSkip, OldSkip.fp);
+    ifb_cmpLinesOpen(NewSkip, NewSkip.fp);
+
+    /*
+    *   3. Links
+    */
+    fehler = ifb_cmpLinks(Old, New, OldSkip, NewSkip, Sect, yyout);
+    if(fehler) {
+        goto ENDE;
+    }
+
+    /*
+    *   Abschnitte in das Protokoll kopieren
+    */
+    for(i = IFBS_CMP_DELETE; i < IFBS_CMP_SECTIONS; i++) {
+        out = "";
+        put_compare_title(i, out);
+        fputs((const char*)out, yyout);
+
+        rewind(Sect[i]);
+        while( (anz = fread(buf, 1, sizeof(buf), Sect[i])) > 0 ) {
+            fwrite(buf, 1, anz, yyout);
+        }
+    }
+
+ENDE:
+    for(i = 0; i < IFBS_CMP_SECTIONS; i++) {
+        if(Sect[i]) {
+            fclose(Sect[i]);
+        }
+    }
+    if(OldKeys) {
+        fclose(OldKeys);
+    }
+    if(NewKeys) {
+        fclose(NewKeys);
+    }
+    if(OldConns) {
+        fclose(OldConns);
+    }
+    if(EqualConns) {
+        fclose(EqualConns);
+    }
+    Old.Reader.close();
+    New.Reader.close();
+    if(Old.ctx) {
+        fb_parser_destroy(Old.ctx);
+    }
+    if(New.ctx) {
+        fb_parser_destroy(New.ctx);
+    }
+    fclose(yyout);
+
+    return fehler;
+}
@@ -35,10 +35,31 @@
 
 #include "ifbslibdef.h"
 
+/*
+*  Max. Anzahl Instanzen je CreateObject-Dienst beim Laden der Sicherung
+*/
+static size_t ifbs_CreateObjBatchSize = IFBS_CREATEOBJ_BATCHSIZE;
+
+/******************************************************************************/
+void IFBS_SetCreateObjBatchSize(size_t anz) {
+/******************************************************************************/
+    if(anz == 0) {
+        anz = 1;
+    }
+    ifbs_CreateObjBatchSize = anz;
+}
+
+/******************************************************************************/
+size_t IFBS_GetCreateObjBatchSize() {
+/******************************************************************************/
+    return ifbs_CreateObjBatchSize;
+}
+
 /******************************************************************************/
 KS_RESULT SearchErrorCreateObject(KscServerBase*     Server,
                                   KS_RESULT          &res,
-                                  FbCreateInstParams &pars) {
+                                  FbCreateInstParams &pars,
+                                  IfbsExistIndex*    pIdx) {
 /******************************************************************************/
 
   KsGetEPParams params;
@@ -74,7 +95,11 @@ KS_RESULT SearchErrorCreateObject(KscServerBase*     Server,
   params.name_mask = "*";
   params.scope_flags = KS_EPF_DEFAULT;
 
-  err = Get_getEP_ErrOnly(Server, params);
+  if(pIdx) {
+    err = pIdx->exists(Server, (const char*)pars.factory) ? KS_ERR_OK : KS_ERR_BADPATH;
+  } else {
+    err = Get_getEP_ErrOnly(Server, params);
+  }
   if(err) {
     log  = "\"%s\"  \"";
     log += pars.factory;
@@ -125,9 +150,13 @@ KS_RESULT SearchErrorCreateObject(KscServerBase*     Server,
 
   params.path = help;
 
+  if(pIdx) {
+    err = pIdx->exists(Server, help) ? KS_ERR_OK : KS_ERR_BADPATH;
+  } else {
+    err = Get_getEP_ErrOnly(Server, params);
+  }
   free(help);
   
-  err = Get_getEP_ErrOnly(Server, params);
   if(err) {
     log  = "\"%s\"  \"";
     log += pars.path;
@@ -142,7 +171,8 @@ KS_RESULT SearchErrorCreateObject(KscServerBase*     Server,
 
 /******************************************************************************/
 KS_RESULT IFBS_CREATE_INST(KscServerBase*     Server,
-                           FbCreateInstParams &pars)
+                           FbCreateInstParams &pars,
+                           IfbsExistIndex*    pIdx)
 
 /******************************************************************************/
  {
@@ -178,8 +208,12 @@ KS_RESULT IFBS_CREATE_INST(KscServerBase*     Server,
             err = res.obj_results[0].result;
         }
 
+    if( (!err) && pIdx ) {
+        // Z.B. Bibliothek : Klassen beim Bedarf lesen
+        pIdx->setCreated((const char*)pars.path, (const char*)pars.factory, 0);
+    }
     if(err) {
-             SearchErrorCreateObject(Server,err,pars);
+             SearchErrorCreateObject(Server,err,pars,pIdx);
             log = IFBS_GetLastLogError();
             if(log == "") {
                 log = "\"%s %s\"  \"";
@@ -302,10 +336,69 @@ int test_InstanceExists(KscServerBase* Server,
     
     return 0;
 }
+
+/*****************************************************************************/
+static int FB_InstanceIsPart(InstanceItems* pinst)
+/*****************************************************************************/
+{
+    char    *ph;
+    char    *pc;
+    
+    ph = pinst->Inst_name;
+    pc = ph;
+    while(pc && (*pc)) pc++;    // String-Ende suchen
+    while(pc != ph) {
+        pc--;
+        if((*pc) == '.') {
+            return 1;
+        }
+        if((*pc) == '/') {
+            // Kein Part
+            break;
+        }
+    }
+    
+    return 0;
+}
+
 /*****************************************************************************/
-KS_RESULT FB_CreateNewInstance(KscServerBase* Server,
-                               InstanceItems* pinst,
-                               PltString&     out)  
+static KS_RESULT FB_SetInstanceValues(KscServerBase* Server,
+                                      InstanceItems* pinst,
+                                      PltString&     out)
+/*****************************************************************************/
+{
+    // Part-Objekt bereits mit Parent-Objekt angelegt. Nur Werte setzen.
+    KS_RESULT err = KS_ERR_OK;
+    if(pinst->Inst_var) {
+        Dienst_param        svcPar;
+        SetInstVarItems         setVars;
+        
+        setVars.next = 0;
+        setVars.Inst_name = pinst->Inst_name;
+        setVars.Inst_var  = pinst->Inst_var;
+        
+        svcPar.Set_Inst_Var = &setVars;
+        svcPar.DelInst = 0;
+        svcPar.OldLibs = 0;
+        svcPar.NewLibs = 0;
+        svcPar.Links   = 0;
+        svcPar.UnLinks = 0;
+        
+        err = (KS_RESULT)set_new_value(Server, &svcPar, out);
+        if(err == KS_ERR_NOACCESS) {
+            err = KS_ERR_OK;
+        }
+    } else {
+        // Keine Variablen in Domain
+    }
+    return err;
+}
+
+/*****************************************************************************/
+KS_RESULT FB_CreateNewInstance(KscServerBase*  Server,
+                               InstanceItems*  pinst,
+                               PltString&      out,
+                               IfbsExistIndex* pIdx)
 /*****************************************************************************/
 {   
     KsCreateObjParams        objpar;
@@ -315,8 +408,6 @@ KS_RESULT FB_CreateNewInstance(KscServerBase* Server,
     KS_RESULT                remErr;
     
     int                      part = 0;
-    char                     *ph;
-    char                     *pc;
 
     if(!Server) {
         out += log_getErrMsg(KS_ERR_SERVERUNKNOWN, "Instance",
@@ -325,54 +416,19 @@ KS_RESULT FB_CreateNewInstance(KscServerBase* Server,
         return KS_ERR_SERVERUNKNOWN;
     }
     // ist das ein Part?
-    ph = pinst->Inst_name;
-    pc = ph;
-    while(pc && (*pc)) pc++;    // String-Ende suchen
-    while(pc != ph) {
-        pc--;
-        if((*pc) == '.') {
-            part = 1;
-            break;
-        }
-        if((*pc) == '/') {
-            // Kein Part
-            break;
-        }
-    }
+    part = FB_InstanceIsPart(pinst);
 
     // Instanz bereits vorhanden?
     if(part == 0 ) {
-        if( test_InstanceExists(Server, pinst->Inst_name, pinst->Class_name) ) {
+        if(pIdx) {
+            part = pIdx->exists(Server, pinst->Inst_name, pinst->Class_name);
+        } else if( test_InstanceExists(Server, pinst->Inst_name, pinst->Class_name) ) {
             part = 1;
         }
     }
     
     if(part == 1) {
-        // Part-Objekt bereits mit Parent-Objekt angelegt. Nur Werte setzen.
-        err = KS_ERR_OK;
-        if(pinst->Inst_var) {
-            Dienst_param        svcPar;
-            SetInstVarItems         setVars;
-            
-            setVars.next = 0;
-            setVars.Inst_name = pinst->Inst_name;
-            setVars.Inst_var  = pinst->Inst_var;
-            
-            svcPar.Set_Inst_Var = &setVars;
-            svcPar.DelInst = 0;
-            svcPar.OldLibs = 0;
-            svcPar.NewLibs = 0;
-            svcPar.Links   = 0;
-            svcPar.UnLinks = 0;
-            
-            err = (KS_RESULT)set_new_value(Server, &svcPar, out);
-            if(err == KS_ERR_NOACCESS) {
-                err = KS_ERR_OK;
-            }
-        } else {
-            // Keine Variablen in Domain
-        }
-        return err;
+        return FB_SetInstanceValues(Server, pinst, out);
     }
     
     objitem[0].factory_path = pinst->Class_name;
@@ -415,15 +471,203 @@ KS_RESULT FB_CreateNewInstance(KscServerBase* Server,
     }
     
     
+    if( (remErr == KS_ERR_ALREADYEXISTS) && pIdx &&
+        pIdx->exists(Server, pinst->Inst_name, pinst->Class_name, 1) ) {
+        // Index war nicht aktuell (z.B. vom Konstruktor angelegt)
+        return FB_SetInstanceValues(Server, pinst, out);
+    }
     if(remErr != KS_ERR_OK) {
         out += log_getErrMsg(remErr, "Instance",pinst->Inst_name,"couldn't be created.");
     } else {
         out += log_getOkMsg("Instance", pinst->Inst_name,"created.");    
+        if(pIdx) {
+            pIdx->setCreated(pinst->Inst_name, pinst->Class_name);
+        }
     }
     
     return remErr;
 }
 
+/*****************************************************************************/
+KS_RESULT FB_CreateNewInstances(KscServerBase*  Server,
+                                InstanceItems** pinst,
+                                size_t          anz,
+                                KS_RESULT*      results,
+                                PltString&      out,
+                                IfbsExistIndex* pIdx)
+/*****************************************************************************/
+{
+    /*
+    *  Alle neuen Instanzen (keine Parts) werden mit einem CreateObject-Dienst
+    *  angelegt. Der Server legt die Objekte in der Reihenfolge der Items an,
+    *  d.h. ein Parent-Objekt aus der gleichen Liste ist vorhanden, bevor
+    *  seine Kinder angelegt werden. Die Werte der Parts werden erst nach dem
+    *  Dienst gesetzt. Fehlgeschlagene Instanzen werden einzeln mit
+    *  FB_CreateNewInstance wiederholt (z.B. Instanz bereits vorhanden).
+    *  Mit dem Index werden vorhandene Instanzen wie Parts behandelt, ohne
+    *  den Umweg ueber das fehlgeschlagene Anlegen.
+    */
+    KsCreateObjParams        objpar;
+    KsCreateObjResult        res;
+    KS_RESULT                err;
+    size_t                   i, k, anzObj;
+    int                      *isPart;
+    size_t                   *objIdx;
+    size_t                   *setIdx;
+
+    if(!anz) {
+        return KS_ERR_OK;
+    }
+    if( (!Server) || (anz == 1) ) {
+        err = KS_ERR_OK;
+        for(i=0; i<anz; i++) {
+            results[i] = FB_CreateNewInstance(Server, pinst[i], out, pIdx);
+            if( results[i] && (!err) ) {
+                err = results[i];
+            }
+        }
+        return err;
+    }
+
+    isPart = (int*)malloc(anz * sizeof(int));
+    objIdx = (size_t*)malloc(anz * sizeof(size_t));
+    setIdx = (size_t*)malloc(anz * sizeof(size_t));
+    if( (!isPart) || (!objIdx) || (!setIdx) ) {
+        if(isPart) free(isPart);
+        if(objIdx) free(objIdx);
+        if(setIdx) free(setIdx);
+        for(i=0; i<anz; i++) {
+            results[i] = OV_ERR_HEAPOUTOFMEMORY;
+        }
+        return OV_ERR_HEAPOUTOFMEMORY;
+    }
+
+    // Parts aussortieren
+    anzObj = 0;
+    for(i=0; i<anz; i++) {
+        results[i] = KS_ERR_OK;
+        isPart[i] = FB_InstanceIsPart(pinst[i]);
+        if( (!isPart[i]) && pIdx ) {
+            isPart[i] = pIdx->exists(Server, pinst[i]->Inst_name, pinst[i]->Class_name);
+        }
+        if(!isPart[i]) {
+            objIdx[anzObj] = i;
+            anzObj++;
+        }
+    }
+
+    if(anzObj) {
+        KsArray<KsCreateObjItem> objitem(anzObj);
+        if(objitem.size() != anzObj) {
+            for(k=0; k<anzObj; k++) {
+                results[objIdx[k]] = OV_ERR_HEAPOUTOFMEMORY;
+            }
+        } else {
+            size_t n = 0;
+            for(k=0; k<anzObj; k++) {
+                i = objIdx[k];
+                objitem[n].factory_path = pinst[i]->Class_name;
+                objitem[n].new_path = pinst[i]->Inst_name;
+                objitem[n].place.hint = KS_PMH_END;
+                // Parameter einer zuvor fehlgeschlagenen Instanz verwerfen
+                objitem[n].parameters = KsArray<KsSetVarItem>();
+                if(pinst[i]->Inst_var) {
+                    err = GetCreateObjectVar(pinst[i]->Inst_var,objitem[n].parameters);
+                    if(err) {
+                        // Instanz nicht im Dienst anlegen, wird einzeln wiederholt
+                        results[i] = err;
+                        continue;
+                    }
+                }
+                objIdx[n] = i;
+                n++;
+            }
+            
+            if(n != anzObj) {
+                KsArray<KsCreateObjItem> hilf(n);
+                for(k=0; k<n; k++) {
+                    hilf[k] = objitem[k];
+                }
+                objitem = hilf;
+                anzObj = n;
+            }
+            objpar.items = objitem;
+        
+            bool ok = TRUE;
+            if(anzObj) {
+                ok = Server->requestByOpcode ( KS_CREATEOBJECT, GetClientAV(), objpar, res);
+            }
+            err = KS_ERR_OK;
+            if(!anzObj) {
+                // Nichts angelegt
+            } else if(!ok) {
+                err = Server->getLastResult();
+                if(err == KS_ERR_OK) {
+                    err = KS_ERR_GENERIC;
+                }
+            } else if( res.result ) {
+                err = res.result;
+            } else if( res.obj_results.size() != anzObj ) {
+                err = KS_ERR_GENERIC;
+            }
+            
+            for(k=0; k<anzObj; k++) {
+                i = objIdx[k];
+                if(err) {
+                    results[i] = err;
+                } else if(res.obj_results[k].result) {
+                    results[i] = res.obj_results[k].result;
+                }
+            }
+        }
+    }
+    
+    // Werte der Parts und vorhandenen Instanzen mit wenigen SetVar-Diensten
+    IfbsSetVarBatch Batch(Server);
+    for(i=0; i<anz; i++) {
+        if( isPart[i] && pinst[i]->Inst_var ) {
+            setIdx[i] = ifb_addInstanceValues(Batch, pinst[i]->Inst_name, pinst[i]->Inst_var);
+        }
+    }
+    Batch.flush();
+    
+    // Ergebnisse in urspruenglicher Reihenfolge auswerten
+    err = KS_ERR_OK;
+    for(i=0; i<anz; i++) {
+        if(isPart[i]) {
+            // Wie FB_SetInstanceValues
+            if(pinst[i]->Inst_var) {
+                results[i] = Batch.getResult(setIdx[i]);
+                if(results[i]) {
+                    out += log_getErrMsg(results[i], "Instance",pinst[i]->Inst_name,"couldn't be updated.");
+                } else {
+                    out += log_getOkMsg("Instance",pinst[i]->Inst_name,"updated");
+                }
+                if(results[i] == KS_ERR_NOACCESS) {
+                    results[i] = KS_ERR_OK;
+                }
+            }
+        } else if(results[i] == KS_ERR_OK) {
+            out += log_getOkMsg("Instance", pinst[i]->Inst_name,"created.");
+            if(pIdx) {
+                pIdx->setCreated(pinst[i]->Inst_name, pinst[i]->Class_name);
+            }
+        } else {
+            // Einzeln wiederholen
+            results[i] = FB_CreateNewInstance(Server, pinst[i], out, pIdx);
+        }
+        if( results[i] && (!err) ) {
+            err = results[i];
+        }
+    }
+    
+    free(isPart);
+    free(objIdx);
+    free(setIdx);
+    
+    return err;
+}
+
 /******************************************************************************/
 KsSetVarItem* obj_CreateObjectVar( Variables* pvar)
 /******************************************************************************/
@@ -442,12 +686,6 @@ KsSetVarItem* obj_CreateObjectVar( Variables* pvar)
 
     var_props->state = pvar->state;
 
-    var_val = pvar->value;
-    // Alle Elemente in Liste einfuegen
-    while(var_val) {
-        ValList.addLast(var_val->val);
-        var_val = var_val->next;
-    }
     vt = pvar->var_typ;
     // Ist die Variable ein Vektor ?
     if(pvar->vector) {
@@ -474,7 +712,18 @@ KsSetVarItem* obj_CreateObjectVar( Variables* pvar)
         }
     }
 
-    var_props->value.bindTo(ifb_CrNewKsValue(err, ValList, vt), PltOsNew);
+    if(pvar->value && pvar->value->fbb_value) {
+        // Typisierter Wert aus .fbb-Datei, ohne Umwandlung aus Text
+        var_props->value.bindTo(ifb_fbbNewKsValue(err, pvar->value->fbb_value, vt), PltOsNew);
+    } else {
+        var_val = pvar->value;
+        // Alle Elemente in Liste einfuegen
+        while(var_val) {
+            ValList.addLast(var_val->val);
+            var_val = var_val->next;
+        }
+        var_props->value.bindTo(ifb_CrNewKsValue(err, ValList, vt), PltOsNew);
+    }
     if(err) {
         delete var_props;
         return 0;
@@ -35,30 +35,47 @@
 
 #include "ifbslibdef.h"
 
+#include <string>
+#include <vector>
+#if !PLT_SYSTEM_NT
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+static void ifb_putOut(PltString &Out, IfbsOutSink *pSink);
+static KS_RESULT ifb_writeLinkItems(KscServerBase *Server, KsString &path,
+                                    PltList<KsEngPropsHandle> &items, KsString &instClass,
+                                    PltString &Out, bool saveConLinks, bool parentOnly,
+                                    IfbsOutSink *pSink);
+class IfbLinkItem;
+static KS_RESULT ifb_readLinkList(KscServerBase *Server, PltList<IfbLinkItem*> &Liste, PltString &Out);
+
+/*
+*  Link, dessen Wert noch nicht abgeholt ist
+*/
+class IfbLinkItem {
+public:
+    IfbLinkItem() : istParent(1) {}
+    
+    KsString          path;       // Pfad der Link-Variable
+    int               istParent;  // Merker, ob Parent-Seite
+    FbAssoParam       assPar;     // Daten der Assoziation
+};
+
 /******************************************************************************/
-void ifb_writeLinkItem(
-    KscServerBase    *Server,
-    KsString         &path,
-    int               istParent,
-    FbAssoParam      &assPar,
-    PltString        &Out) {
+static void ifb_writeLinkValue(
+    const KsVarCurrProps *cp,
+    int                   istParent,
+    FbAssoParam          &assPar,
+    PltString            &Out) {
 /******************************************************************************/
     PltString help;                               // Hilfsstring
     char      hStr[256];                          // Hilfsstring
     char     *ph;                                 // Hilfszeiger
-    KsString  root = Server->getHostAndName();    // Merke : //host/server
-    
-    // Daten holen
-    KscVariable  var(root + path);
-    if(!var.getUpdate() ) {
-        // ?
-        return;
-    }
-    const KsVarCurrProps* cp = var.getCurrProps();
-    if(!cp || !cp->value) {
-        // ?
-        return;
-    }
 
     PltString hs("");
     ifb_getValueOnly(                          /*  |> Funktionsrueckmeldung                     */
@@ -136,6 +153,61 @@ void ifb_writeLinkItem(
     return;
 }
 
+/******************************************************************************/
+void ifb_writeLinkItem(
+    KscServerBase    *Server,
+    KsString         &path,
+    int               istParent,
+    FbAssoParam      &assPar,
+    PltString        &Out) {
+/******************************************************************************/
+    KsString  root = Server->getHostAndName();    // Merke : //host/server
+    
+    // Daten holen
+    KscVariable  var(root + path);
+    if(!var.getUpdate() ) {
+        // ?
+        return;
+    }
+    const KsVarCurrProps* cp = var.getCurrProps();
+    if(!cp || !cp->value) {
+        // ?
+        return;
+    }
+
+    ifb_writeLinkValue(cp, istParent, assPar, Out);
+}
+
+/******************************************************************************/
+static KS_RESULT ifb_addLinkItem(
+    KsString                 &path,
+    int                       istParent,
+    FbAssoParam              &assPar,
+    PltList<IfbLinkItem*>    &Liste) {
+/******************************************************************************/
+    IfbLinkItem *pi = new IfbLinkItem;
+    if(!pi) {
+        return OV_ERR_HEAPOUTOFMEMORY;
+    }
+    pi->path = path;
+    pi->istParent = istParent;
+    pi->assPar = assPar;
+    Liste.addLast(pi);
+    
+    return KS_ERR_OK;
+}
+
+/******************************************************************************/
+static void ifb_freeLinkList(PltList<IfbLinkItem*> &Liste) {
+/******************************************************************************/
+    while(Liste.size() ) {
+        IfbLinkItem *pi = Liste.removeFirst();
+        if(pi) {
+            delete pi;
+        }
+    }
+}
+
 /******************************************************************************/
 KS_RESULT ifb_writeLinks(
     KscServerBase    *Server,
@@ -144,7 +216,7 @@ KS_RESULT ifb_writeLinks(
     PltString        &Out,
     bool              saveConLinks,
     bool              parentOnly,
-    FILE             *fout) {
+    IfbsOutSink      *pSink) {
 /******************************************************************************/
     KsGetEPResult    result;
     KS_RESULT        err;
@@ -163,9 +235,25 @@ KS_RESULT ifb_writeLinks(
         return result.result;
     }
 
+    return ifb_writeLinkItems(Server,params.path,result.items,instClass,Out,saveConLinks,parentOnly,pSink);
+}
+
+// Links aus bereits geholter Liste dokumentieren
+/******************************************************************************/
+static KS_RESULT ifb_writeLinkItems(
+    KscServerBase             *Server,
+    KsString                  &path,
+    PltList<KsEngPropsHandle> &items,
+    KsString                  &instClass,
+    PltString                 &Out,
+    bool                       saveConLinks,
+    bool                       parentOnly,
+    IfbsOutSink               *pSink) {
+/******************************************************************************/
+    KS_RESULT                  err;
     size_t                     Anz ;            /* Merker : Anzahl gefundenen Objekten */
     
-    Anz = result.items.size();
+    Anz = items.size();
     if(!Anz) {
         // Keine Objekten gefungen
         return KS_ERR_OK;
@@ -175,9 +263,9 @@ KS_RESULT ifb_writeLinks(
     PltList<KsEngPropsHandle>    childList;       /* Merker : gefundene Links */
     KS_LINK_TYPE                 LinkTyp;         /* Merker : Link-Typ        */
     KsString                     hs;              /* Hilfsstring              */
-    while ( result.items.size() ) {
+    while ( items.size() ) {
 
-        KsEngPropsHandle hpp = result.items.removeFirst();
+        KsEngPropsHandle hpp = items.removeFirst();
         if(!hpp) {
             return KS_ERR_GENERIC;
         }
@@ -220,9 +308,10 @@ KS_RESULT ifb_writeLinks(
         return KS_ERR_OK;
     }
     
-    KsString    help;
-    int         istParent;
-    FbAssoParam assPar;
+    KsString                help;
+    int                     istParent;
+    FbAssoParam             assPar;
+    PltList<IfbLinkItem*>   linkList;         /* Merker : zu lesende Links */
 
     while( parentList.size() || childList.size() ) {
         
@@ -240,7 +329,7 @@ KS_RESULT ifb_writeLinks(
             assPar.identifier  = (const char*)((KsLinkEngProps &)(*hpv)).association_identifier;
             assPar.parent_ident= (const char*)((KsLinkEngProps &)(*hpv)).opposite_role_identifier;
             assPar.parent_class= (const char*)instClass;
-            assPar.parent_path = (const char*)params.path;
+            assPar.parent_path = (const char*)path;
             assPar.child_ident = (const char*)hs;
             assPar.child_class = "unknown";
             assPar.child_path = "";
@@ -259,35 +348,46 @@ KS_RESULT ifb_writeLinks(
             assPar.parent_path = "";
             assPar.child_ident = (const char*)((KsLinkEngProps &)(*hpv)).opposite_role_identifier;
             assPar.child_class = (const char*)instClass;
-            assPar.child_path  = (const char*)params.path;
+            assPar.child_path  = (const char*)path;
         }
         
-        help = params.path;
+        help = path;
         help += ".";
         help += hs;
 
-        // Link dokumentieren
-        ifb_writeLinkItem(Server,help,istParent,assPar,Out);
-        
-
-        // Schreiben in Datei ?
-        
-        if(fout) {
-            if( Out.len() ) {
-                fputs((const char*)Out, fout);
-                Out = "";
-            }
+        // Link merken
+        err = ifb_addLinkItem(help,istParent,assPar,linkList);
+        if(err) {
+            ifb_freeLinkList(linkList);
+            return err;
         }
-        
     }
     
-    return KS_ERR_OK;
+    // Alle Links der Instanz mit einem Dienst lesen und dokumentieren
+    err = ifb_readLinkList(Server, linkList, Out);
+    
+    // Schreiben in Datei ?
+    ifb_putOut(Out, pSink);
+    
+    return err;
 }
 
-// Holt Server-Version
+// Holt Server-Version. Bei geoeffneter Sitzung nur einmal vom Server lesen
 /*****************************************************************************/
 float get_serverVersion(KscServerBase* Server)
 /*****************************************************************************/
+{
+    IfbsSession *pses = IFBS_GetSession(Server);
+    if(pses) {
+        return pses->getServerVersion();
+    }
+    return ifb_readServerVersion(Server);
+}
+
+// Liest Server-Version
+/*****************************************************************************/
+float ifb_readServerVersion(KscServerBase* Server)
+/*****************************************************************************/
 {
     PltString   hStr("");
     KsString    Var;
@@ -342,204 +442,564 @@ float get_serverVersion(KscServerBase* Server)
     return (float)atof(versString);
 }
 
-// Objekt-Variablen protokollieren
-/*****************************************************************************/
- KS_RESULT get_variable(KscServerBase* Server,KsGetEPParams& params,PltString& Out)
-/*****************************************************************************/
-{
-    KS_RESULT      err;
-    KsGetEPResult  result;
-    KsString       Var;
-    KsString       root;
-    size_t         i;               /* Laufvariable */
-    size_t         AnzVars;         /* Merker : Anzahl gefundenen Variablen */
-    size_t         AnzFoundObjs;    /* Merker : Anzahl gefundenen Unterobjekten */
-    char           PortType[32];
-    PltString      hStr;
-    float          srvVersion;
-    PltString      trenner;
-    
-    // Wir suchen Variablen
-    trenner = ".";
-    params.type_mask = KS_OT_VARIABLE;
-    params.scope_flags = KS_EPF_PARTS;
-    
-    // Sonderfall "Vendor"
-    if(params.path == "/vendor") {
-        trenner = "/";
-        params.scope_flags = KS_EPF_DEFAULT;
-    }
-    
-    // Zugriffsrechte ab iFBSpro v2.4.0 geaendert
-    srvVersion = get_serverVersion(Server);
+/*
+*  Max. Anzahl Variablen je gemeinsamen GetVar-Dienst beim Sichern
+*/
+static size_t ifbs_GetVarBatchSize = IFBS_GETVAR_BATCHSIZE;
 
-    // Alle Variablennamen holen
-    bool ok = Server->getEP(0, params, result);
-    if( !ok ) {
-        err = Server->getLastResult();
-        if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
-        return err;
+/******************************************************************************/
+void IFBS_SetGetVarBatchSize(size_t anz) {
+/******************************************************************************/
+    if(anz == 0) {
+        anz = 1;
     }
-    if( result.result != KS_ERR_OK ) {
-        return result.result;
+    ifbs_GetVarBatchSize = anz;
+}
+
+/******************************************************************************/
+size_t IFBS_GetGetVarBatchSize() {
+/******************************************************************************/
+    return ifbs_GetVarBatchSize;
+}
+
+/*
+*  Max. Anzahl Instanzen mit ausstehenden Werten beim Sichern
+*/
+static size_t ifbs_SaveWindow = IFBS_SAVEWINDOW;
+
+/******************************************************************************/
+void IFBS_SetSaveWindow(size_t anz) {
+/******************************************************************************/
+    if(anz == 0) {
+        anz = 1;
     }
+    ifbs_SaveWindow = anz;
+}
+
+/******************************************************************************/
+size_t IFBS_GetSaveWindow() {
+/******************************************************************************/
+    return ifbs_SaveWindow;
+}
 
-    AnzFoundObjs = result.items.size();
+/*
+*  Element der zurueckgehaltenen Ausgabe : Text oder Variable, deren Wert
+*  noch nicht abgeholt ist
+*/
+class IfbSaveItem {
+public:
+    IfbSaveItem() : isVar(false), link(0) {}
+    ~IfbSaveItem() { if(link) delete link; }
     
-    if ( !AnzFoundObjs ) {
-        // Keine Variablen in Domain
-        return KS_ERR_OK;
-    }
+    PltString         text;    // Text (falls isVar == false)
+    KsString          path;    // Pfad der Variable
+    bool              isVar;   // Merker, ob Variable
+    KsEngPropsHandle  hpp;     // Eigenschaften der Variable
+    IfbLinkItem      *link;    // Link-Daten, falls die Variable ein Link ist
+};
+
+/*
+*  Sammelt die Variablen und Links mehrerer Instanzen fuer einen gemeinsamen
+*  GetVar-Dienst. Die Ausgabe wird bis zum Abholen der Werte zurueckgehalten
+*  und danach in urspruenglicher Reihenfolge geschrieben. Das Fenster ist
+*  durch die Anzahl Variablen und die Anzahl Instanzen begrenzt.
+*  Der Dienst geht ueber die Verbindung des Sammlers, nicht ueber den
+*  Server-Cache des Clients.
+*/
+class IfbVarBatch {
+public:
+    IfbVarBatch(KscServerBase *Server, size_t maxVars, size_t maxInst)
+    : server(Server), anzVars(0), maxAnzVars(maxVars), anzInst(0), maxAnzInst(maxInst), srvVersion(0) {}
+    ~IfbVarBatch() { clear(); }
+    
+    bool      isEmpty() { return items.isEmpty(); }
+    bool      isFull()  { return (anzVars >= maxAnzVars) || (anzInst >= maxAnzInst); }
+    void      addText(PltString &Out);
+    KS_RESULT addVariable(KsString &path, KsEngPropsHandle &hpp);
+    KS_RESULT addLink(IfbLinkItem *link);
+    void      instDone() { if(!isEmpty()) anzInst++; }
+    KS_RESULT flush(PltString &Out, IfbsOutSink *pSink);
+    void      clear();
+    
+    KscServerBase             *server;
+    PltList<IfbSaveItem*>      items;
+    size_t                     anzVars;
+    size_t                     maxAnzVars;
+    size_t                     anzInst;
+    size_t                     maxAnzInst;
+    float                      srvVersion;
+};
+
+/*
+*  Aktiver Sammler der Sicherung (nur waehrend IFBS_GETDBCONTENTS).
+*  Bei paralleler Sicherung hat jeder Worker-Prozess seinen eigenen.
+*/
+static IfbVarBatch *pVarBatch = 0;
+
+/*
+*  Datei der laufenden IFBS_DBSAVE. Ihr Kompressor-Thread wird vor dem
+*  Start der Worker-Prozesse beendet (kein fork() mit laufendem Thread).
+*/
+static IfbsOutFile *pSaveFile = 0;
 
-    /* Variablen sichern */
+/*****************************************************************************/
+void IfbVarBatch::clear() {
+/*****************************************************************************/
+    while(items.size()) {
+        IfbSaveItem *pi = items.removeFirst();
+        if(pi) delete pi;
+    }
+    anzVars = 0;
+    anzInst = 0;
+}
 
-    Out += "    VARIABLE_VALUES\n";
+/*****************************************************************************/
+void IfbVarBatch::addText(PltString &Out) {
+/*****************************************************************************/
+    if(!Out.len()) {
+        return;
+    }
+    IfbSaveItem *pi = new IfbSaveItem;
+    if(pi) {
+        pi->text = Out;
+        items.addLast(pi);
+    }
+    Out = "";
+}
 
-    /* Alle Variable merken */
-    PltArray<KscVariable*> VarArray(AnzFoundObjs);
-    if(VarArray.size() != AnzFoundObjs) {
-            return OV_ERR_HEAPOUTOFMEMORY;
+/*****************************************************************************/
+KS_RESULT IfbVarBatch::addVariable(KsString &path, KsEngPropsHandle &hpp) {
+/*****************************************************************************/
+    IfbSaveItem *pi = new IfbSaveItem;
+    if(!pi) {
+        return OV_ERR_HEAPOUTOFMEMORY;
     }
+    pi->path = path;
+    pi->isVar = true;
+    pi->hpp = hpp;
+    items.addLast(pi);
+    anzVars++;
     
+    return KS_ERR_OK;
+}
 
-    // Package anlegen
-    KscPackage        *pkg = new KscPackage;
-    if(!pkg) {
+/*****************************************************************************/
+KS_RESULT IfbVarBatch::addLink(IfbLinkItem *link) {
+/*****************************************************************************/
+    IfbSaveItem *pi = new IfbSaveItem;
+    if(!pi) {
+        delete link;
         return OV_ERR_HEAPOUTOFMEMORY;
     }
+    pi->path = link->path;
+    pi->isVar = true;
+    pi->link = link;
+    items.addLast(pi);
+    anzVars++;
+    
+    return KS_ERR_OK;
+}
 
-    PltList<KsEngPropsHandle>  ListEP;
-    AnzVars = 0;
-    root = Server->getHostAndName();
+/*****************************************************************************/
+static void ifb_writeVarValue(KsEngPropsHandle     &hpp,
+                              const KsVarCurrProps *cp,
+                              float                 srvVersion,
+                              PltString            &Out)
+/*****************************************************************************/
+{
+    char           PortType[32];
     
-    for(i = 0; i < AnzFoundObjs; i++) {
-        
-        KsEngPropsHandle pv(result.items.removeFirst());
-        if(!pv) {
-            delete pkg;
-            return KS_ERR_GENERIC;
-        }
-        
-        // Ist das eine Variable?
-        if(pv->xdrTypeCode() == KS_OT_VARIABLE) {
-            
-            // FIX: "ServerPassword" in "/vendor" ignorieren
-            if( (params.path == "/vendor") && (pv->identifier == "server_password") ) {
-                // Ignorieren
+    // Zugriffsrechte ab iFBSpro v2.4.0 geaendert
+    if(srvVersion < 2.4) {
+    
+       if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 'i') ) {
+                strcpy(PortType,"INPUT");
+        } else if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 'p') ) {
+                strcpy(PortType,"PARAMETER");
+        } else if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 'o') ) {
+                strcpy(PortType,"OUTPUT");
+        } else if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 'n') ) {
+              strcpy(PortType,"HIDDEN");
+        } else {
+            // Instanz hat keine FB-Flags. Dann ist die von OV.
+            if( ((KsVarEngProps&)(*hpp)).access_mode & KS_AC_WRITE ) {
+                strcpy(PortType,"INPUT");
             } else {
-                ListEP.addLast(pv);
-             
-                Var = params.path;
-                Var += trenner;
-                Var += pv->identifier;  /* /. */    
-
-                VarArray[AnzVars] = new KscVariable(root+Var);
-                if(!VarArray[AnzVars]) {
-                    delete pkg;
-                    return OV_ERR_HEAPOUTOFMEMORY;
-                }
-            
-                if(!pkg->add(KscVariableHandle(VarArray[AnzVars], PltOsNew)) ) {
-                    delete pkg;
-                         return KS_ERR_GENERIC;
-                }
-            
-                // Eine Variable mehr
-                AnzVars++;
+                // Es bleiben nur Outputs
+                strcpy(PortType,"OUTPUT");
             }
         }
-    } /* for (alle Unterobjkte) */
-  
-    if(!pkg->getUpdate() ) {
-        err = pkg->getLastResult();
-        
-        if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
-        delete pkg;
-        return err;
-    }
-
-    for(i = 0; i < AnzVars; i++) {
-        
-        KsEngPropsHandle hpp = ListEP.removeFirst();
-        if(!hpp) {
-            delete pkg;
-            return KS_ERR_GENERIC;
-        }
-
-        const KsVarCurrProps *cp = VarArray[i]->getCurrProps();
-        if( (!cp) || (!cp->value) ) {
-            delete pkg;
-            return KS_ERR_GENERIC;
-        }
-
-        // Zugriffsrechte ab iFBSpro v2.4.0 geaendert
-        if(srvVersion < 2.4) {
-        
-           if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 'i') ) {
-                    strcpy(PortType,"INPUT");
-            } else if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 'p') ) {
-                    strcpy(PortType,"PARAMETER");
-            } else if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 'o') ) {
-                    strcpy(PortType,"OUTPUT");
-            } else if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 'n') ) {
-                  strcpy(PortType,"HIDDEN");
+    
+    // Version >= 2.4
+    } else {
+        /* 
+        *  Da die Flags zB. in CAEX-Server fuer Objekte "missbraucht" werden,
+        *  setze INPUT/OUTPUT-Merker anhand Zugriffs-Rechten
+        */
+        if( ((KsVarEngProps&)(*hpp)).access_mode & KS_AC_WRITE ) {
+            if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 'p') ) {
+                // Parameter
+                strcpy(PortType,"PARAMETER");
             } else {
-                // Instanz hat keine FB-Flags. Dann ist die von OV.
-                if( ((KsVarEngProps&)(*hpp)).access_mode & KS_AC_WRITE ) {
-                    strcpy(PortType,"INPUT");
-                } else {
-                    // Es bleiben nur Outputs
-                    strcpy(PortType,"OUTPUT");
-                }
+                // Input
+                strcpy(PortType,"INPUT");
             }
-        
-        // Version >= 2.4
         } else {
-            /* 
-            *  Da die Flags zB. in CAEX-Server fuer Objekte "missbraucht" werden,
-            *  setze INPUT/OUTPUT-Merker anhand Zugriffs-Rechten
-            */
-            if( ((KsVarEngProps&)(*hpp)).access_mode & KS_AC_WRITE ) {
-                if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 'p') ) {
-                    // Parameter
-                    strcpy(PortType,"PARAMETER");
-                } else {
-                    // Input
-                    strcpy(PortType,"INPUT");
-                }
+            
+            if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 'n') ) {
+                  strcpy(PortType,"HIDDEN");
             } else {
-                
-                if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 'n') ) {
-                      strcpy(PortType,"HIDDEN");
-                } else {
-                    // Es bleiben nur Outputs
-                    strcpy(PortType,"OUTPUT");
-                }
+                // Es bleiben nur Outputs
+                strcpy(PortType,"OUTPUT");
             }
         }
-        Out += "        ";
-        Out += (const char*)hpp->identifier;
-        Out += ifb_getValueLength(cp);
-        Out += " : ";
+    }
+    Out += "        ";
+    Out += (const char*)hpp->identifier;
+    Out += ifb_getValueLength(cp);
+    Out += " : ";
+    Out += PortType;
+    Out += "  ";
+    Out += ifb_getOvValueType(cp->value->xdrTypeCode() );
+    Out += " = ";
+    ifb_getValueOnly(
+                            cp              /* >|  Eigenschaften der Variable            */
+                            ,Out            /* >|> Value als String                      */
+                            ,ULONG_MAX      /* Max. Anzahl Elementen in Array            */
+                            ,FALSE          /* Merker, ob Time-Ausgabe "... hh:mm:ss"    */
+                            ,FALSE          /* Merker, ob TRUE als "1" und FALSE als "0" */
+                            ,TRUE           /* Merker, ob Array als Liste "{...}"        */
+                            ," , "          /* Trenner der Array-Elementen               */
+                            );
+    if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 's') ) {
+        sprintf(PortType," STATE = %d", cp->state);
         Out += PortType;
-        Out += "  ";
-        Out += ifb_getOvValueType(cp->value->xdrTypeCode() );
-        Out += " = ";
-        ifb_getValueOnly(
-                                cp              /* >|  Eigenschaften der Variable            */
-                                ,Out            /* >|> Value als String                      */
-                                ,ULONG_MAX      /* Max. Anzahl Elementen in Array            */
-                                ,FALSE          /* Merker, ob Time-Ausgabe "... hh:mm:ss"    */
-                                ,FALSE          /* Merker, ob TRUE als "1" und FALSE als "0" */
-                                ,TRUE           /* Merker, ob Array als Liste "{...}"        */
-                                ," , "          /* Trenner der Array-Elementen               */
-                                );
-        if( IsFlagSet( ((KsVarEngProps&)(*hpp)).semantic_flags, 's') ) {
-            sprintf(PortType," STATE = %d", cp->state);
-            Out += PortType;
-        }
-        
-        Out += ";\n";
+    }
+    
+    Out += ";\n";
+}
+
+/*****************************************************************************/
+KS_RESULT IfbVarBatch::flush(PltString &Out, IfbsOutSink *pSink) {
+/*****************************************************************************/
+    KS_RESULT       err = KS_ERR_OK;
+    PltString       Str("");
+    size_t          i;
+    KsGetVarParams  params(anzVars);
+    KsGetVarResult  result;
+    
+    if(anzVars) {
+        if(params.identifiers.size() != anzVars) {
+            err = OV_ERR_HEAPOUTOFMEMORY;
+        } else {
+            i = 0;
+            PltListIterator<IfbSaveItem*> *it = (PltListIterator<IfbSaveItem*> *)items.newIterator();
+            if(!it) {
+                err = OV_ERR_HEAPOUTOFMEMORY;
+            } else {
+                for(; *it; ++(*it) ) {
+                    if((**it)->isVar) {
+                        params.identifiers[i++] = (**it)->path;
+                    }
+                }
+                delete it;
+            }
+        }
+        if(!err) {
+            // Alle gesammelten Variablen mit einem Dienst holen
+            bool ok = server->requestByOpcode(KS_GETVAR, 0, params, result);
+            if(!ok) {
+                err = server->getLastResult();
+                if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
+            } else if(result.result) {
+                err = result.result;
+            } else if(result.items.size() != anzVars) {
+                err = KS_ERR_GENERIC;
+            }
+        }
+    }
+    
+    // Ausgabe in urspruenglicher Reihenfolge
+    i = 0;
+    while( (!err) && items.size() ) {
+        IfbSaveItem *pi = items.removeFirst();
+        if(!pi) {
+            continue;
+        }
+        if(!pi->isVar) {
+            Str += pi->text;
+        } else {
+            KsVarCurrProps *cp = 0;
+            KS_RESULT       res = result.items[i].result;
+            if(!res) {
+                cp = PLT_DYNAMIC_PCAST(KsVarCurrProps, result.items[i].item.getPtr());
+            }
+            i++;
+            bool ok = (!res) && cp && cp->value;
+            if(pi->link) {
+                // Nicht lesbare Links werden uebersprungen
+                if(ok) {
+                    ifb_writeLinkValue(cp, pi->link->istParent, pi->link->assPar, Str);
+                }
+            } else if(!ok) {
+                err = res;
+                if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
+            } else {
+                ifb_writeVarValue(pi->hpp, cp, srvVersion, Str);
+            }
+        }
+        delete pi;
+        
+        // Schreiben in Datei ?
+        if(pSink) {
+            if(Str.len() > IFBS_OUTSINK_CHUNKSIZE) {
+                pSink->put(Str);
+                Str = "";
+            }
+        }
+    }
+    
+    // Zurueckgehaltene Ausgabe steht vor dem aktuellen Text
+    Str += Out;
+    Out = Str;
+    if(pSink) {
+        if(Out.len() ) {
+            pSink->put(Out);
+            Out = "";
+        }
+    }
+    
+    clear();
+    
+    return err;
+}
+
+/*****************************************************************************/
+static void ifb_putOut(PltString &Out, IfbsOutSink *pSink)
+/*****************************************************************************/
+{
+    // Schreiben in Datei ?
+    if(pSink) {
+        if(Out.len() ) {
+            if(pVarBatch && !pVarBatch->isEmpty()) {
+                // Es gibt noch ausstehende Werte. Text zurueckhalten
+                pVarBatch->addText(Out);
+            } else {
+                pSink->put(Out);
+                // String-Buffer leeren
+                Out = "";
+            }
+        }
+    }
+}
+
+// Links lesen. Waehrend der Sicherung zusammen mit anderen Instanzen
+/*****************************************************************************/
+static KS_RESULT ifb_readLinkList(KscServerBase *Server, PltList<IfbLinkItem*> &Liste, PltString &Out)
+/*****************************************************************************/
+{
+    KS_RESULT    err = KS_ERR_OK;
+    IfbVarBatch  linkBatch(Server, Liste.size(), 1);
+    IfbVarBatch *pbatch = pVarBatch;
+    
+    if(Liste.isEmpty() ) {
+        return KS_ERR_OK;
+    }
+    if(!pbatch) {
+        // Eigener Dienst nur fuer diese Links
+        pbatch = &linkBatch;
+    }
+    
+    // Bisherige Ausgabe steht vor den Links
+    pbatch->addText(Out);
+    
+    while( Liste.size() ) {
+        err = pbatch->addLink(Liste.removeFirst());
+        if(err) {
+            ifb_freeLinkList(Liste);
+            return err;
+        }
+    }
+    
+    if(pbatch == &linkBatch) {
+        err = linkBatch.flush(Out, 0);
+    }
+    return err;
+}
+
+// Objekt-Variablen in gemeinsames Package aufnehmen
+/*****************************************************************************/
+static KS_RESULT get_variable_batch(
+    KsString                  &path,
+    PltString                 &trenner,
+    PltList<KsEngPropsHandle> &items,
+    PltString                 &Out)
+/*****************************************************************************/
+{
+    KS_RESULT      err;
+    KsString       Var;
+    
+    // Bisherige Ausgabe steht vor den Variablen
+    Out += "    VARIABLE_VALUES\n";
+    pVarBatch->addText(Out);
+    
+    while(items.size() ) {
+        KsEngPropsHandle pv(items.removeFirst());
+        if(!pv) {
+            return KS_ERR_GENERIC;
+        }
+        
+        // Ist das eine Variable?
+        if(pv->xdrTypeCode() != KS_OT_VARIABLE) {
+            continue;
+        }
+        // FIX: "ServerPassword" in "/vendor" ignorieren
+        if( (path == "/vendor") && (pv->identifier == "server_password") ) {
+            continue;
+        }
+        
+        Var = path;
+        Var += trenner;
+        Var += pv->identifier;  /* /. */    
+        
+        err = pVarBatch->addVariable(Var, pv);
+        if(err) {
+            return err;
+        }
+    }
+    
+    Out += "    END_VARIABLE_VALUES;\n";
+    
+    return KS_ERR_OK;
+}
+
+// Variablen aus bereits geholter Liste protokollieren
+/*****************************************************************************/
+static KS_RESULT ifb_writeVariables(
+    KscServerBase             *Server,
+    KsString                  &path,
+    PltList<KsEngPropsHandle> &items,
+    PltString                 &Out)
+/*****************************************************************************/
+{
+    KS_RESULT      err;
+    KsString       Var;
+    KsString       root;
+    size_t         i;               /* Laufvariable */
+    size_t         AnzVars;         /* Merker : Anzahl gefundenen Variablen */
+    size_t         AnzFoundObjs;    /* Merker : Anzahl gefundenen Unterobjekten */
+    PltString      hStr;
+    float          srvVersion;
+    PltString      trenner;
+    
+    trenner = ".";
+    
+    // Sonderfall "Vendor"
+    if(path == "/vendor") {
+        trenner = "/";
+    }
+    
+    // Zugriffsrechte ab iFBSpro v2.4.0 geaendert
+    if(pVarBatch) {
+        srvVersion = pVarBatch->srvVersion;
+    } else {
+        srvVersion = get_serverVersion(Server);
+    }
+
+    AnzFoundObjs = items.size();
+    
+    if ( !AnzFoundObjs ) {
+        // Keine Variablen in Domain
+        return KS_ERR_OK;
+    }
+
+    if(pVarBatch) {
+        // Werte werden spaeter mit anderen Instanzen zusammen abgeholt
+        return get_variable_batch(path, trenner, items, Out);
+    }
+
+    /* Variablen sichern */
+
+    Out += "    VARIABLE_VALUES\n";
+
+    /* Alle Variable merken */
+    PltArray<KscVariable*> VarArray(AnzFoundObjs);
+    if(VarArray.size() != AnzFoundObjs) {
+            return OV_ERR_HEAPOUTOFMEMORY;
+    }
+    
+
+    // Package anlegen
+    KscPackage        *pkg = new KscPackage;
+    if(!pkg) {
+        return OV_ERR_HEAPOUTOFMEMORY;
+    }
+
+    PltList<KsEngPropsHandle>  ListEP;
+    AnzVars = 0;
+    root = Server->getHostAndName();
+    
+    for(i = 0; i < AnzFoundObjs; i++) {
+        
+        KsEngPropsHandle pv(items.removeFirst());
+        if(!pv) {
+            delete pkg;
+            return KS_ERR_GENERIC;
+        }
+        
+        // Ist das eine Variable?
+        if(pv->xdrTypeCode() == KS_OT_VARIABLE) {
+            
+            // FIX: "ServerPassword" in "/vendor" ignorieren
+            if( (path == "/vendor") && (pv->identifier == "server_password") ) {
+                // Ignorieren
+            } else {
+                ListEP.addLast(pv);
+             
+                Var = path;
+                Var += trenner;
+                Var += pv->identifier;  /* /. */    
+
+                VarArray[AnzVars] = new KscVariable(root+Var);
+                if(!VarArray[AnzVars]) {
+                    delete pkg;
+                    return OV_ERR_HEAPOUTOFMEMORY;
+                }
+            
+                if(!pkg->add(KscVariableHandle(VarArray[AnzVars], PltOsNew)) ) {
+                    delete pkg;
+                         return KS_ERR_GENERIC;
+                }
+            
+                // Eine Variable mehr
+                AnzVars++;
+            }
+        }
+    } /* for (alle Unterobjkte) */
+  
+    if(!pkg->getUpdate() ) {
+        err = pkg->getLastResult();
+        
+        if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
+        delete pkg;
+        return err;
+    }
+
+    for(i = 0; i < AnzVars; i++) {
+        
+        KsEngPropsHandle hpp = ListEP.removeFirst();
+        if(!hpp) {
+            delete pkg;
+            return KS_ERR_GENERIC;
+        }
+
+        const KsVarCurrProps *cp = VarArray[i]->getCurrProps();
+        if( (!cp) || (!cp->value) ) {
+            delete pkg;
+            return KS_ERR_GENERIC;
+        }
+
+        ifb_writeVarValue(hpp, cp, srvVersion, Out);
         
     } // for alle Variablen
 
@@ -550,7 +1010,38 @@ float get_serverVersion(KscServerBase* Server)
 
     return KS_ERR_OK;
 
-} /* get_variable */
+} /* ifb_writeVariables */
+
+// Objekt-Variablen protokollieren
+/*****************************************************************************/
+ KS_RESULT get_variable(KscServerBase* Server,KsGetEPParams& params,PltString& Out)
+/*****************************************************************************/
+{
+    KS_RESULT      err;
+    KsGetEPResult  result;
+    
+    // Wir suchen Variablen
+    params.type_mask = KS_OT_VARIABLE;
+    params.scope_flags = KS_EPF_PARTS;
+    
+    // Sonderfall "Vendor"
+    if(params.path == "/vendor") {
+        params.scope_flags = KS_EPF_DEFAULT;
+    }
+    
+    // Alle Variablennamen holen
+    bool ok = Server->getEP(0, params, result);
+    if( !ok ) {
+        err = Server->getLastResult();
+        if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
+        return err;
+    }
+    if( result.result != KS_ERR_OK ) {
+        return result.result;
+    }
+
+    return ifb_writeVariables(Server, params.path, result.items, Out);
+}
 
 /*****************************************************************************/
  void ifb_writeLibItem(KsString libname, PltString& Out)
@@ -566,25 +1057,22 @@ float get_serverVersion(KscServerBase* Server)
  KS_RESULT get_libs(KscServerBase* Server, PltString& Out)
 /*****************************************************************************/
 {
-    size_t   i, siz;
-    KsString Path("");
-    Path = Server->getHostAndName();
-    Path += "/vendor/libraries";
-    
-    KscVariable Var(Path);
-    if(!Var.getUpdate() ) {
-        KS_RESULT err = Var.getLastResult();
-        if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
-        return err;
+    KsString            Path("");
+    PltList<PltString>  Libs;
+    KS_RESULT           err;
+    
+    IfbsSession *pses = IFBS_OpenSession(Server);
+    if(!pses) {
+        return OV_ERR_HEAPOUTOFMEMORY;
     }
-    const KsVarCurrProps *cp = Var.getCurrProps();
-    if((!cp) || (!(cp->value)) ) {
-        return KS_ERR_GENERIC;
+    err = pses->getLibraries(Libs);
+    IFBS_CloseSession(pses);
+    if(err) {
+        return err;
     }
     
-    siz = ((KsStringVecValue &) *cp->value).size();
-    for ( i = 0; i < siz; i++ ) {
-        Path = ((KsStringVecValue &) *cp->value)[i];
+    while( Libs.size() ) {
+        Path = Libs.removeFirst();
         
         if(Path != "/acplt/ov") {
             // Bibliothek sichern
@@ -660,23 +1148,31 @@ void ifb_writeInstBlockEnd(PltString &Out) {
     Out += " END_INSTANCE;\n\n";
 }
 
+// Variablen, Unterobjekte und Links einer Instanz mit einem Dienst holen
 /*****************************************************************************/
-KS_RESULT ifb_writeInstData(
-    KscServerBase *Server,
-    KsGetEPParams &params,
-    PltString     &Out,
-    bool           recurs,
-    bool           saveConLinks,
-    bool           linkParentOnly,
-    FILE          *fout
+static KS_RESULT ifb_getInstParts(
+    KscServerBase             *Server,
+    KsString                  &path,
+    bool                       recurs,
+    PltList<KsEngPropsHandle> &vars,
+    PltList<KsEngPropsHandle> &childs,
+    PltList<KsEngPropsHandle> &links
 ) {
 /*****************************************************************************/
- 
-
     KS_RESULT      fehler;
+    KsGetEPParams  params;
     KsGetEPResult  result;
-    KsString       instClass;
-    KsString       instPath;
+    
+    params.path = path;
+    params.name_mask = "*";
+    params.type_mask = KS_OT_DOMAIN | KS_OT_HISTORY | KS_OT_VARIABLE | KS_OT_LINK;
+    if(recurs == TRUE) {
+        // Alle Unterobjekte
+        params.scope_flags = KS_EPF_DEFAULT;
+    } else {
+        // Nur Parts
+        params.scope_flags = KS_EPF_PARTS;
+    }
     
     bool ok = Server->getEP(0, params, result);
     if( !ok ) {
@@ -687,16 +1183,55 @@ KS_RESULT ifb_writeInstData(
     if( result.result != KS_ERR_OK ) {
         return result.result;
     }
-
-    /* Alle Instanzen sichern */
+    
+    // Nach Typ aufteilen. Die Reihenfolge je Typ bleibt erhalten
     while ( result.items.size() ) {
         KsEngPropsHandle hpp = result.items.removeFirst();
         if(!hpp) {
             return KS_ERR_GENERIC;
         }
+        switch(hpp->xdrTypeCode() ) {
+            case KS_OT_VARIABLE:
+                vars.addLast(hpp);
+                break;
+            case KS_OT_LINK:
+                links.addLast(hpp);
+                break;
+            default:
+                childs.addLast(hpp);
+                break;
+        }
+    }
+    
+    return KS_ERR_OK;
+}
+
+// Instanzen aus bereits geholter Liste sichern
+/*****************************************************************************/
+static KS_RESULT ifb_writeInstItems(
+    KscServerBase             *Server,
+    KsString                  &path,
+    PltList<KsEngPropsHandle> &items,
+    PltString                 &Out,
+    bool                       recurs,
+    bool                       saveConLinks,
+    bool                       linkParentOnly,
+    IfbsOutSink               *pSink
+) {
+/*****************************************************************************/
+    KS_RESULT      fehler;
+    KsString       instClass;
+    KsString       instPath;
+
+    /* Alle Instanzen sichern */
+    while ( items.size() ) {
+        KsEngPropsHandle hpp = items.removeFirst();
+        if(!hpp) {
+            return KS_ERR_GENERIC;
+        }
         
 
-        if( (params.path == FB_TASK_CONTAINER_PATH) && (hpp->identifier == FB_URTASK) ) {
+        if( (path == FB_TASK_CONTAINER_PATH) && (hpp->identifier == FB_URTASK) ) {
             // UrTask nicht sichern
             continue;
         }
@@ -717,7 +1252,7 @@ KS_RESULT ifb_writeInstData(
             continue;
         }
         
-        instPath = (const char*)params.path;
+        instPath = (const char*)path;
         if( hpp->access_mode & KS_AC_PART) {
             instPath += ".";
         } else {
@@ -727,64 +1262,53 @@ KS_RESULT ifb_writeInstData(
 
         ifb_writeInstBlockAnfang(instPath, instClass, Out);
         
+        // Variablen, Unterobjekte und Links der Instanz holen
+        PltList<KsEngPropsHandle> varList;
+        PltList<KsEngPropsHandle> childList;
+        PltList<KsEngPropsHandle> linkList;
+        
+        fehler = ifb_getInstParts(Server, instPath, recurs, varList, childList, linkList);
+        if (fehler) {
+            return fehler;
+        }
+        
         if( hpp->xdrTypeCode() != KS_OT_HISTORY) {
             // Instanz oder Container
-            KsGetEPParams helpParams;
-            
-            helpParams.path = instPath;
-            helpParams.name_mask = "*";
-        
             if( ((KsDomainEngProps &)(*hpp)).class_identifier != CONTAINER_CLASS_PATH ) {
                 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
                 // Es ist eine Instanz vom benutzerdefiniertem Typ
                 // Variablen von Instanz rueckdokumentieren :
                 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-                fehler = get_variable(Server, helpParams, Out);
+                fehler = ifb_writeVariables(Server, instPath, varList, Out);
                 if (fehler) {
                     return fehler;
                 }
             }
         }
         ifb_writeInstBlockEnd(Out);
-                    
-        // Schreiben in Datei ?
-        if(fout) {
-            if(Out.len() ) {
-                fputs((const char*)Out, fout);
-                // String-Buffer leeren
-                Out = "";
+        
+        // Genug Werte ausstehend?
+        if(pVarBatch) {
+            pVarBatch->instDone();
+            if(pVarBatch->isFull()) {
+                fehler = pVarBatch->flush(Out, pSink);
+                if(fehler) {
+                    return fehler;
+                }
             }
         }
+                    
+        // Schreiben in Datei ?
+        ifb_putOut(Out, pSink);
         
         // Unterliegende Instanzen sichern
-        KsGetEPParams helpPars;
-        
-        helpPars.path = params.path;
-        if( hpp->access_mode & KS_AC_PART) {
-            helpPars.path += ".";
-        } else {
-            helpPars.path += "/";
-        }
-        
-        helpPars.path += hpp->identifier;
-        helpPars.name_mask = "*";
-        helpPars.type_mask = KS_OT_DOMAIN | KS_OT_HISTORY;
-        
-        
-        if(recurs == TRUE) {
-            // Alle Unterobjekte
-            helpPars.scope_flags = KS_EPF_DEFAULT;
-        } else {
-            // Nur Parts
-            helpPars.scope_flags = KS_EPF_PARTS;
-        }
-        fehler = ifb_writeInstData(Server,helpPars,Out,recurs,saveConLinks,linkParentOnly,fout);
+        fehler = ifb_writeInstItems(Server,instPath,childList,Out,recurs,saveConLinks,linkParentOnly,pSink);
         if(fehler) {
             return fehler;
         }
         
         // Links sichern
-        fehler = ifb_writeLinks(Server,helpPars,instClass,Out,saveConLinks,linkParentOnly,fout);
+        fehler = ifb_writeLinkItems(Server,instPath,linkList,instClass,Out,saveConLinks,linkParentOnly,pSink);
         if(fehler) {
             return fehler;
         }
@@ -793,6 +1317,36 @@ KS_RESULT ifb_writeInstData(
 
     return KS_ERR_OK;
 
+} /* ifb_writeInstItems */
+
+/*****************************************************************************/
+KS_RESULT ifb_writeInstData(
+    KscServerBase *Server,
+    KsGetEPParams &params,
+    PltString     &Out,
+    bool           recurs,
+    bool           saveConLinks,
+    bool           linkParentOnly,
+    IfbsOutSink   *pSink
+) {
+/*****************************************************************************/
+ 
+
+    KS_RESULT      fehler;
+    KsGetEPResult  result;
+    
+    bool ok = Server->getEP(0, params, result);
+    if( !ok ) {
+        fehler = Server->getLastResult();
+        if(fehler == KS_ERR_OK) fehler = KS_ERR_GENERIC;
+        return fehler;
+    }
+    if( result.result != KS_ERR_OK ) {
+        return result.result;
+    }
+
+    return ifb_writeInstItems(Server,params.path,result.items,Out,recurs,saveConLinks,linkParentOnly,pSink);
+
 } /* ifb_writeInstData */
 
 /******************************************************************************/
@@ -802,7 +1356,7 @@ KS_RESULT ifb_writeXlinksOfObj(KscServerBase *Server,
                                KsString      &path,
                                KsString      &instClass,
                                PltString     &Out,
-                               FILE          *fout)
+                               IfbsOutSink   *pSink)
 /******************************************************************************/
 {
     KsGetEPParams       params;
@@ -829,7 +1383,8 @@ KS_RESULT ifb_writeXlinksOfObj(KscServerBase *Server,
 
 
     /* Ueber alle Objekte */
-    FbAssoParam assPar;
+    FbAssoParam             assPar;
+    PltList<IfbLinkItem*>   linkList;         /* Merker : zu lesende Links */
     while( result.items.size() ) {
         KsEngPropsHandle hpp = result.items.removeFirst();
         if(!hpp) {
@@ -862,32 +1417,34 @@ KS_RESULT ifb_writeXlinksOfObj(KscServerBase *Server,
                 assPar.child_class = "unknown";
                 assPar.child_path = "";
                 
-                // Link dokumentieren
+                // Link merken
                 hs = path;
                 hs += ".";
                 hs += hpp->identifier;
-                ifb_writeLinkItem(Server, hs, 1, assPar, Out);
+                err = ifb_addLinkItem(hs, 1, assPar, linkList);
+                if(err) {
+                    ifb_freeLinkList(linkList);
+                    return err;
+                }
         
                 break;
             default:
                 break;
         }
-        
-        // Schreiben in Datei ?
-        if(fout) {
-            if( Out.len() ) {
-                fputs((const char*)Out, fout);
-                Out = "";
-            }
-        }
     } // Ueber alle vorhandene Links
     
-    return KS_ERR_OK;        
+    // Alle Links des Objekts mit einem Dienst lesen und dokumentieren
+    err = ifb_readLinkList(Server, linkList, Out);
+    
+    // Schreiben in Datei ?
+    ifb_putOut(Out, pSink);
+    
+    return err;
 }
 /******************************************************************************/
 KS_RESULT ifb_writeXlinksOfBases(KscServerBase *Server,
                                  PltString     &Out,
-                                 FILE          *fout)
+                                 IfbsOutSink   *pSink)
 /******************************************************************************/
 {
     KsGetEPParams       params;
@@ -906,106 +1463,415 @@ KS_RESULT ifb_writeXlinksOfBases(KscServerBase *Server,
     params.type_mask = KS_OT_DOMAIN;
     params.scope_flags = KS_EPF_CHILDREN;
 
-    bool ok = Server->getEP(0, params, result);
-    if( !ok ) {
-        err = Server->getLastResult();
-        if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
-        return err;
+    bool ok = Server->getEP(0, params, result);
+    if( !ok ) {
+        err = Server->getLastResult();
+        if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
+        return err;
+    }
+    if( result.result != KS_ERR_OK ) {
+        return result.result;
+    }
+
+    /* Ueber alle Objekte */
+    while( result.items.size() ) {
+        KsEngPropsHandle hpp = result.items.removeFirst();
+        if(!hpp) {
+            return KS_ERR_GENERIC;
+        }
+        
+        // Merke Pfad
+        path = "/";
+        path += hpp->identifier;
+        instClass = ((KsDomainEngProps &)(*hpp)).class_identifier;
+        err = ifb_writeXlinksOfObj(Server, path, instClass, Out, pSink);
+        
+        // Schreiben in Datei?
+        if(pSink) {
+            if( Out.len() ) {
+                pSink->put(Out);
+                // String-Buffer leeren
+                Out = "";
+            }
+        }
+        // Fehler bei Ausfuehrung?
+        if(err) {
+            return err;
+        }
+    } /* Ueber alle Root-Objekte */
+
+
+    // -----------------------
+    // Ueber alle Bibliotheken,Klassen,Associationen
+    // -----------------------
+    PltList<PltString> objList;
+    IfbsSession       *pses = IFBS_OpenSession(Server);
+    if(!pses) {
+        return OV_ERR_HEAPOUTOFMEMORY;
+    }
+    
+    for(i = 0; i < 3; i++) {
+        switch(i) {
+            case 0:  instClass = "library";
+                     err = pses->getLibraries(objList);
+                     break;
+            case 1:  instClass = "class";
+                     err = pses->getClasses(objList);
+                     break;
+            default: instClass = "association";
+                     err = pses->getAssociations(objList);
+                     break;
+        }
+        if(err == KS_ERR_BADTYPE) {
+            // Typ der Variable ist kein KS_VT_STRING_VEC !!!?
+            continue;
+        }
+        if(err) {
+            IFBS_CloseSession(pses);
+            return KS_ERR_GENERIC;
+        }
+        
+        while( objList.size() ) {
+            path = objList.removeFirst();
+            err = ifb_writeXlinksOfObj(Server, path, instClass, Out, pSink);
+            
+            // Schreiben in Datei?
+            if(pSink) {
+                if( Out.len() ) {
+                    pSink->put(Out);
+                    // String-Buffer leeren
+                    Out = "";
+                }
+            }
+            // Fehler bei Ausfuehrung?
+            if(err) {
+                IFBS_CloseSession(pses);
+                return err;
+            }
+        }
+    }
+    
+    IFBS_CloseSession(pses);
+    return KS_ERR_OK;
+}
+
+/*
+*  Max. Anzahl paralleler Verbindungen beim Sichern
+*/
+static size_t ifbs_SaveConnections = IFBS_SAVECONNECTIONS;
+
+/******************************************************************************/
+void IFBS_SetSaveConnections(size_t anz) {
+/******************************************************************************/
+    if(anz == 0) {
+        anz = 1;
+    }
+    ifbs_SaveConnections = anz;
+}
+
+/******************************************************************************/
+size_t IFBS_GetSaveConnections() {
+/******************************************************************************/
+    return ifbs_SaveConnections;
+}
+
+/*
+*  Abschnitt der parallelen Sicherung : fertiger Text oder eine Instanz
+*  (mit Unterobjekten und Links), die ein Worker-Prozess sichert
+*/
+class IfbSaveSegment {
+public:
+    IfbSaveSegment() : state(0) {}
+    
+    PltString          text;     // Ausgabe
+    KsString           path;     // Pfad des Eltern-Objekts
+    KsEngPropsHandle   hpp;      // Instanz (leer bei reinem Text)
+    int                state;    // 0 = Instanz, 2 = fertiger Text
+};
+
+/*
+*  Gemeinsame Daten der parallelen Sicherung
+*/
+class IfbParSave {
+public:
+    IfbParSave(KscServerBase *Server)
+    : server(Server), segs(0), srvVersion(0) {}
+    ~IfbParSave();
+    
+    void             addText(PltString &Out);
+    KS_RESULT        addInst(KsString &path, KsEngPropsHandle &hpp);
+    KS_RESULT        fix();
+    
+    KscServerBase                *server;     // Verbindung des Aufrufers
+    PltList<IfbSaveSegment*>      segList;    // Abschnitte beim Sammeln
+    PltArray<IfbSaveSegment*>    *segs;       // Abschnitte beim Sichern
+    float                         srvVersion;
+};
+
+/*****************************************************************************/
+IfbParSave::~IfbParSave() {
+/*****************************************************************************/
+    size_t i;
+    
+    while(segList.size() ) {
+        IfbSaveSegment *pseg = segList.removeFirst();
+        if(pseg) delete pseg;
+    }
+    if(segs) {
+        for(i = 0; i < segs->size(); i++) {
+            if((*segs)[i]) delete (*segs)[i];
+        }
+        delete segs;
+    }
+}
+
+/*****************************************************************************/
+void IfbParSave::addText(PltString &Out) {
+/*****************************************************************************/
+    if(!Out.len() ) {
+        return;
+    }
+    IfbSaveSegment *pseg = new IfbSaveSegment;
+    if(pseg) {
+        pseg->text = Out;
+        pseg->state = 2;
+        segList.addLast(pseg);
+    }
+    Out = "";
+}
+
+/*****************************************************************************/
+KS_RESULT IfbParSave::addInst(KsString &path, KsEngPropsHandle &hpp) {
+/*****************************************************************************/
+    IfbSaveSegment *pseg = new IfbSaveSegment;
+    if(!pseg) {
+        return OV_ERR_HEAPOUTOFMEMORY;
+    }
+    pseg->path = path;
+    pseg->hpp = hpp;
+    segList.addLast(pseg);
+    
+    return KS_ERR_OK;
+}
+
+// Gesammelte Abschnitte fuer den Zugriff ueber Index ablegen
+/*****************************************************************************/
+KS_RESULT IfbParSave::fix() {
+/*****************************************************************************/
+    size_t i;
+    size_t anz = segList.size();
+    
+    segs = new PltArray<IfbSaveSegment*>(anz);
+    if( (!segs) || (segs->size() != anz) ) {
+        return OV_ERR_HEAPOUTOFMEMORY;
+    }
+    for(i = 0; i < anz; i++) {
+        (*segs)[i] = segList.removeFirst();
+    }
+    return KS_ERR_OK;
+}
+
+// Eine Instanz mit Unterobjekten und Links sichern
+/*****************************************************************************/
+static KS_RESULT ifb_saveSegment(KscServerBase *Server, IfbSaveSegment *pseg, PltString &Out)
+/*****************************************************************************/
+{
+    KS_RESULT                   err;
+    KS_RESULT                   flushErr;
+    PltList<KsEngPropsHandle>   items;
+    
+    items.addLast(pseg->hpp);
+    
+    //                                                      Recurs conLnk parentOnly
+    err = ifb_writeInstItems(Server,pseg->path,items,Out,TRUE,  TRUE,  FALSE,  0);
+    
+    // Restliche Werte holen
+    flushErr = pVarBatch->flush(Out, 0);
+    if(!err) {
+        err = flushErr;
     }
-    if( result.result != KS_ERR_OK ) {
-        return result.result;
+    return err;
+}
+
+#if !PLT_SYSTEM_NT
+/*
+*  Kopf eines Abschnitts in der Pipe eines Worker-Prozesses. Danach folgt
+*  der Text mit Nullbyte
+*/
+struct IfbSaveFrame {
+    KS_RESULT   err;
+    size_t      len;        // Laenge des Textes ohne Nullbyte
+};
+
+/*
+*  Worker-Prozess der parallelen Sicherung
+*/
+struct IfbSaveProc {
+    pid_t           pid;        // 0 = kein Prozess
+    int             fd;         // Lese-Ende der Pipe, -1 = Ende
+    std::string     buf;        // Gelesene Daten
+    size_t          pos;        // Beginn des naechsten Abschnitts in buf
+};
+
+// Alles schreiben. Liefert 0 bei Erfolg
+/*****************************************************************************/
+static int ifb_writeAll(int fd, const char *data, size_t len)
+/*****************************************************************************/
+{
+    ssize_t res;
+    
+    while(len) {
+        res = write(fd, data, len);
+        if(res < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        data += res;
+        len -= (size_t)res;
     }
+    return 0;
+}
 
-    /* Ueber alle Objekte */
-    while( result.items.size() ) {
-        KsEngPropsHandle hpp = result.items.removeFirst();
-        if(!hpp) {
-            return KS_ERR_GENERIC;
+// Worker-Prozess mit eigener Verbindung zum Server. Sichert jede anzProc-te
+// Instanz ab Nummer nr und schreibt die Abschnitte in die Pipe fd.
+// Der Prozess hat eine Kopie aller Daten, es gibt keinen gemeinsamen Zustand
+/*****************************************************************************/
+static void ifb_saveWorker(IfbParSave *par, size_t nr, size_t anzProc, int fd)
+/*****************************************************************************/
+{
+    KS_RESULT        err;
+    KscServerBase   *conn;
+    IfbSaveSegment  *pseg;
+    IfbSaveFrame     frame;
+    size_t           i;
+    size_t           k = 0;
+    
+    conn = IFBS_OpenServerConnection(par->server, err);
+    if(!conn) {
+        // Instanzen ohne Abschnitt sichert der Eltern-Prozess
+        return;
+    }
+    IfbVarBatch VarBatch(conn, IFBS_GetGetVarBatchSize(), IFBS_GetSaveWindow());
+    VarBatch.srvVersion = par->srvVersion;
+    pVarBatch = &VarBatch;
+    
+    for(i = 0; i < par->segs->size(); i++) {
+        pseg = (*par->segs)[i];
+        if(pseg->state != 0) {
+            continue;
+        }
+        if( (k++ % anzProc) != nr ) {
+            continue;
         }
         
-        // Merke Pfad
-        path = "/";
-        path += hpp->identifier;
-        instClass = ((KsDomainEngProps &)(*hpp)).class_identifier;
-        err = ifb_writeXlinksOfObj(Server, path, instClass, Out, fout);
+        PltString Out("");
+        err = ifb_saveSegment(conn, pseg, Out);
         
-        // Schreiben in Datei?
-        if(fout) {
-            if( Out.len() ) {
-                fputs((const char*)Out, fout);
-                // String-Buffer leeren
-                Out = "";
-            }
+        frame.err = err;
+        frame.len = Out.len();
+        if( ifb_writeAll(fd, (const char*)&frame, sizeof(frame)) ||
+            ifb_writeAll(fd, (const char*)Out, frame.len + 1) ) {
+            // Eltern-Prozess liest nicht mehr
+            break;
         }
-        // Fehler bei Ausfuehrung?
         if(err) {
-            return err;
+            break;
         }
-    } /* Ueber alle Root-Objekte */
-
+    }
+    
+    pVarBatch = 0;
+    IFBS_CloseServerConnection(conn);
+}
 
-    // -----------------------
-    // Ueber alle Bibliotheken,Klassen,Associationen
-    // -----------------------
-    PltList<PltString> varList;
-    PltList<PltString> typList;
-    varList.addLast("/vendor/libraries");    typList.addLast("library");
-    varList.addLast("/vendor/classes");      typList.addLast("class");
-    varList.addLast("/vendor/associations");  typList.addLast("association");
+// Verfuegbare Daten der Pipes lesen. Wartet, bis eine Pipe Daten hat.
+// Prozesse mit IFBS_SAVEPROC_PENDING Bytes im Buffer werden nicht gelesen,
+// bis sie ausgegeben sind (die volle Pipe haelt sie an), ausser nr, auf
+// dessen Abschnitt gewartet wird
+/*****************************************************************************/
+static void ifb_readProcs(std::vector<IfbSaveProc> &Procs, size_t nr)
+/*****************************************************************************/
+{
+    std::vector<struct pollfd>  fds;
+    std::vector<size_t>         idx;
+    char                        help[64 * 1024];
+    ssize_t                     res;
+    size_t                      i;
     
-    KsString  root = Server->getHostAndName();    // Merke : //host/server
-    while( varList.size() ) {
-        path = varList.removeFirst();
-        instClass = typList.removeFirst();
-        
-        KscVariable  varL(root + path);
-        if(!varL.getUpdate() ) {
-            // ?
-            return KS_ERR_GENERIC;
+    for(i = 0; i < Procs.size(); i++) {
+        if( (i != nr) && (Procs[i].buf.size() - Procs[i].pos >= IFBS_SAVEPROC_PENDING) ) {
+            continue;
         }
-        const KsVarCurrProps* cpi = varL.getCurrProps();
-        if(!cpi || !cpi->value) {
-            // ?
-            return KS_ERR_GENERIC;
+        if(Procs[i].fd >= 0) {
+            struct pollfd pfd;
+            pfd.fd = Procs[i].fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            fds.push_back(pfd);
+            idx.push_back(i);
         }
-
-        switch(cpi->value->xdrTypeCode() ) {
-            case KS_VT_STRING_VEC: {
-                    size_t size  = ((KsStringVecValue &) *(cpi->value)).size();
-                    for ( i = 0; i < size; ++i ) {
-                        path = (const char*)(((KsStringVecValue &) *(cpi->value))[i]);
-                        err = ifb_writeXlinksOfObj(Server, path, instClass, Out, fout);
-                        
-                        // Schreiben in Datei?
-                        if(fout) {
-                            if( Out.len() ) {
-                                fputs((const char*)Out, fout);
-                                // String-Buffer leeren
-                                Out = "";
-                            }
-                        }
-                        // Fehler bei Ausfuehrung?
-                        if(err) {
-                            return err;
-                        }
-                    }
-                }
-                break;
-            default :
-                // Typ der Variable ist kein KS_VT_STRING_VEC !!!?
-                break;
+    }
+    if(fds.empty()) {
+        return;
+    }
+    if(poll(&fds[0], (nfds_t)fds.size(), -1) < 0) {
+        return;
+    }
+    for(i = 0; i < fds.size(); i++) {
+        if(!fds[i].revents) {
+            continue;
+        }
+        IfbSaveProc &Proc = Procs[idx[i]];
+        res = read(Proc.fd, help, sizeof(help));
+        if(res > 0) {
+            // Ausgegebene Abschnitte vorne entfernen
+            if(Proc.pos && (Proc.pos >= Proc.buf.size() / 2)) {
+                Proc.buf.erase(0, Proc.pos);
+                Proc.pos = 0;
+            }
+            Proc.buf.append(help, (size_t)res);
+        } else if( (res == 0) || (errno != EINTR) ) {
+            close(Proc.fd);
+            Proc.fd = -1;
         }
     }
+}
+
+// Naechsten Abschnitt des Prozesses nr an Out anhaengen. Liefert 0, wenn
+// der Prozess keinen Abschnitt mehr liefert
+/*****************************************************************************/
+static int ifb_nextFrame(std::vector<IfbSaveProc> &Procs, size_t nr, KS_RESULT &err, PltString &Out)
+/*****************************************************************************/
+{
+    IfbSaveProc    &Proc = Procs[nr];
+    IfbSaveFrame    frame;
     
-    return KS_ERR_OK;
+    for(;;) {
+        if(Proc.buf.size() - Proc.pos >= sizeof(frame)) {
+            memcpy(&frame, Proc.buf.data() + Proc.pos, sizeof(frame));
+            if(Proc.buf.size() - Proc.pos - sizeof(frame) >= frame.len + 1) {
+                err = frame.err;
+                Out += Proc.buf.data() + Proc.pos + sizeof(frame);
+                Proc.pos += sizeof(frame) + frame.len + 1;
+                return 1;
+            }
+        }
+        if(Proc.fd < 0) {
+            return 0;
+        }
+        ifb_readProcs(Procs, nr);
+    }
 }
+#endif
 
 /*****************************************************************************/
 KS_RESULT ifb_writeRootObjs(
     KscServerBase *Server,
     KsGetEPParams &params,
     PltString     &Out,
-    FILE          *fout
+    IfbsOutSink   *pSink,
+    IfbParSave    *par
 ) {
 /*****************************************************************************/
     KS_RESULT      fehler;
@@ -1065,13 +1931,18 @@ KS_RESULT ifb_writeRootObjs(
         instPath = "/";
         instPath += (const char*)hpp->identifier;
         ifb_writeInstBlockAnfang(instPath, instClass, Out);
+        
+        // Variablen, Unterobjekte und Links der Instanz holen
+        PltList<KsEngPropsHandle> varList;
+        PltList<KsEngPropsHandle> childList;
+        PltList<KsEngPropsHandle> linkList;
+        
+        fehler = ifb_getInstParts(Server, instPath, TRUE, varList, childList, linkList);
+        if (fehler) {
+            return fehler;
+        }
                 
         if( hpp->xdrTypeCode() != KS_OT_HISTORY) {
-            KsGetEPParams helpParams;
-            
-            helpParams.path = instPath;
-            helpParams.name_mask = "*";
-            
             if( ((KsDomainEngProps &)(*hpp)).class_identifier != CONTAINER_CLASS_PATH ) {
                 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
                 // Es ist eine Instanz vom benutzerdefiniertem Typ
@@ -1079,42 +1950,63 @@ KS_RESULT ifb_writeRootObjs(
                 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
 
-                fehler = get_variable(Server, helpParams, Out);
+                fehler = ifb_writeVariables(Server, instPath, varList, Out);
                 if (fehler) {
                     return fehler;
                 }
             }
         }
         ifb_writeInstBlockEnd(Out);
-                    
-        // Schreiben in Datei ?
-        if(fout) {
-            if( Out.len() ) {
-                fputs((const char*)Out, fout);
-                // String-Buffer leeren
-                Out = "";
+        
+        // Genug Werte ausstehend?
+        if(pVarBatch) {
+            pVarBatch->instDone();
+            if(pVarBatch->isFull()) {
+                fehler = pVarBatch->flush(Out, pSink);
+                if(fehler) {
+                    return fehler;
+                }
             }
         }
+                    
+        // Schreiben in Datei ?
+        ifb_putOut(Out, pSink);
 
-        // Unterliegende Instanzen sichern
-        KsGetEPParams helpPars;
-        
-        helpPars.path = instPath;
-        helpPars.name_mask = "*";
-        helpPars.type_mask = KS_OT_DOMAIN | KS_OT_HISTORY;
-        helpPars.scope_flags = KS_EPF_DEFAULT;
-    
-        //                                      Recurs conLnk parentOnly
-        fehler = ifb_writeInstData(Server,helpPars,Out,TRUE,TRUE,  FALSE,  fout);
-        if(fehler) {
-            return fehler;
+        if(par) {
+            // Parallel : Unterliegende Instanzen sichern die Worker-Prozesse
+            fehler = pVarBatch->flush(Out, 0);
+            if(fehler) {
+                return fehler;
+            }
+            par->addText(Out);
+            while( childList.size() ) {
+                KsEngPropsHandle hpc = childList.removeFirst();
+                fehler = par->addInst(instPath, hpc);
+                if(fehler) {
+                    return fehler;
+                }
+            }
+        } else {
+            // Unterliegende Instanzen sichern
+            //                                                        Recurs conLnk parentOnly
+            fehler = ifb_writeInstItems(Server,instPath,childList,Out,TRUE,  TRUE,  FALSE,  pSink);
+            if(fehler) {
+                return fehler;
+            }
         }
             
         // Links sichern
-        fehler = ifb_writeLinks(Server,helpPars,instClass,Out,TRUE,FALSE,fout);
+        fehler = ifb_writeLinkItems(Server,instPath,linkList,instClass,Out,TRUE,FALSE,pSink);
         if(fehler) {
             return fehler;
     }
+        if(par) {
+            fehler = pVarBatch->flush(Out, 0);
+            if(fehler) {
+                return fehler;
+            }
+            par->addText(Out);
+        }
 
     } /* while size() */
 
@@ -1136,22 +2028,144 @@ KS_RESULT ifb_writeRootObjs(
 
 
         // Schreiben in Datei ?
-        if(fout) {
-            if( Out.len() ) {
-                fputs((const char*)Out, fout);
-                // String-Buffer leeren
-                Out = "";
-            }
+        ifb_putOut(Out, pSink);
+    }
+    if(par) {
+        fehler = pVarBatch->flush(Out, 0);
+        if(fehler) {
+            return fehler;
         }
+        par->addText(Out);
     }
     
     return KS_ERR_OK;
 }
 
+#if !PLT_SYSTEM_NT
+// Parallele Sicherung der Root-Domains ueber mehrere Verbindungen. Der
+// KS-Client ist nicht thread-sicher, daher sichern Worker-Prozesse. Die
+// Ausgabe wird in der Reihenfolge der sequentiellen Sicherung geschrieben.
+/*****************************************************************************/
+static KS_RESULT ifb_writeRootObjsPar(
+    KscServerBase *Server,
+    KsGetEPParams &params,
+    PltString     &Out,
+    IfbsOutSink   *pSink,
+    size_t         anzConn
+) {
+/*****************************************************************************/
+    KS_RESULT              fehler;
+    size_t                 i, k, nr;
+    size_t                 anzProc;
+    size_t                 anzInst = 0;
+    IfbParSave             par(Server);
+    IfbSaveSegment        *pseg;
+    int                    fds[2];
+    int                    st;
+    pid_t                  pid;
+    
+    par.srvVersion = pVarBatch->srvVersion;
+    
+    // Root-Domains lesen und Instanzen fuer die Worker sammeln
+    PltString Str("");
+    fehler = ifb_writeRootObjs(Server, params, Str, 0, &par);
+    if(!fehler) {
+        fehler = par.fix();
+    }
+    if(fehler) {
+        return fehler;
+    }
+    for(i = 0; i < par.segs->size(); i++) {
+        if((*par.segs)[i]->state == 0) {
+            anzInst++;
+        }
+    }
+    if(!anzInst) {
+        anzInst = 1;
+    }
+    
+    // Worker-Prozesse starten. Der Kompressor-Thread startet erst mit der
+    // naechsten Ausgabe wieder
+    if(pSaveFile) {
+        fehler = pSaveFile->pause();
+        if(fehler) {
+            return fehler;
+        }
+    }
+    anzProc = (anzConn < anzInst) ? anzConn : anzInst;
+    std::vector<IfbSaveProc> Procs(anzProc);
+    fflush(NULL);
+    for(i = 0; i < anzProc; i++) {
+        Procs[i].pid = 0;
+        Procs[i].fd = -1;
+        Procs[i].pos = 0;
+        if(pipe(fds)) {
+            // Instanzen dieses Workers sichert der Eltern-Prozess
+            continue;
+        }
+        pid = fork();
+        if(pid == 0) {
+            close(fds[0]);
+            for(k = 0; k < i; k++) {
+                if(Procs[k].fd >= 0) {
+                    close(Procs[k].fd);
+                }
+            }
+            signal(SIGPIPE, SIG_IGN);
+            ifb_saveWorker(&par, i, anzProc, fds[1]);
+            close(fds[1]);
+            _exit(0);
+        }
+        close(fds[1]);
+        if(pid < 0) {
+            close(fds[0]);
+            continue;
+        }
+        Procs[i].pid = pid;
+        Procs[i].fd = fds[0];
+    }
+    
+    // Ausgabe in urspruenglicher Reihenfolge
+    k = 0;
+    for(i = 0; (!fehler) && (i < par.segs->size()); i++) {
+        pseg = (*par.segs)[i];
+        if(pseg->state == 0) {
+            nr = (k++) % anzProc;
+            if(!ifb_nextFrame(Procs, nr, fehler, Out)) {
+                // Kein Worker (z.B. keine Verbindung). Selbst sichern
+                fehler = ifb_saveSegment(Server, pseg, Out);
+            }
+        } else {
+            Out += pseg->text;
+            pseg->text = "";
+        }
+        
+        // Schreiben in Datei ?
+        ifb_putOut(Out, pSink);
+    }
+    
+    // Worker beenden
+    for(i = 0; i < anzProc; i++) {
+        if(Procs[i].fd >= 0) {
+            close(Procs[i].fd);
+        }
+        if(Procs[i].pid > 0) {
+            if(fehler) {
+                kill(Procs[i].pid, SIGTERM);
+            }
+            while( (waitpid(Procs[i].pid, &st, 0) < 0) && (errno == EINTR) ) {
+            }
+        }
+    }
+    
+    return fehler;
+}
+#endif
+
 /******************************************************************************/
 KS_RESULT IFBS_GETDBCONTENTS(KscServerBase *Server,
                              PltString     &Out,
-                             FILE *fout = 0)
+                             IfbsOutSink *pSink = 0)
 /******************************************************************************/
  {
     KsGetEPParams       params;
@@ -1191,8 +2205,8 @@ Out += "  Sicherung der Datenbasis.\n\n";
     Out += help;
   
     // Schreiben in Datei ?
-    if(fout) {
-        fputs((const char*)Out, fout);
+    if(pSink) {
+        pSink->put(Out);
         // String-Buffer leeren
         Out = "";
     }
@@ -1202,8 +2216,8 @@ Out += "======================================================================\n
 Out += "*********************************************************************/\n\n";
 
     // Schreiben in Datei ?
-    if(fout) {
-        fputs((const char*)Out, fout);
+    if(pSink) {
+        pSink->put(Out);
         // String-Buffer leeren
         Out = "";
     }
@@ -1214,9 +2228,9 @@ Out += "*********************************************************************/\n
 
     err = get_libs(Server, Out);
     if(err) {
-        if(fout) {
+        if(pSink) {
             if(Out.len() ) {
-                fputs((const char*)Out, fout);
+                pSink->put(Out);
                 // String-Buffer leeren
                 Out = "";
             }
@@ -1226,9 +2240,9 @@ Out += "*********************************************************************/\n
     }
 
     // Schreiben in Datei ?
-    if(fout) {
+    if(pSink) {
         if( Out.len() ) {
-            fputs((const char*)Out, fout);
+            pSink->put(Out);
             // String-Buffer leeren
             Out = "";
         }
@@ -1242,11 +2256,32 @@ Out += "*********************************************************************/\n
     params.type_mask = KS_OT_DOMAIN;
     params.name_mask = "*";
     params.scope_flags = KS_EPF_DEFAULT;
-    err = ifb_writeRootObjs(Server, params, Out, fout);
+    
+    // Variablen mehrerer Instanzen gemeinsam holen
+    IfbVarBatch VarBatch(Server, IFBS_GetGetVarBatchSize(), IFBS_GetSaveWindow());
+    VarBatch.srvVersion = get_serverVersion(Server);
+    pVarBatch = &VarBatch;
+    
+#if !PLT_SYSTEM_NT
+    if(IFBS_GetSaveConnections() > 1) {
+        // Root-Domains parallel ueber mehrere Verbindungen sichern
+        err = ifb_writeRootObjsPar(Server, params, Out, pSink, IFBS_GetSaveConnections());
+    } else
+#endif
+    {
+        err = ifb_writeRootObjs(Server, params, Out, pSink, 0);
+    }
+    
+    // Restliche Werte holen und zurueckgehaltene Ausgabe schreiben
+    pVarBatch = 0;
+    KS_RESULT flushErr = VarBatch.flush(Out, pSink);
+    if(!err) {
+        err = flushErr;
+    }
     if(err) {
-        if(fout) {
+        if(pSink) {
             if( Out.len() ) {
-                fputs((const char*)Out, fout);
+                pSink->put(Out);
                 // String-Buffer leeren
                 Out = "";
             }
@@ -1261,11 +2296,11 @@ Out += "*********************************************************************/\n
     // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
     // Rueckdokumentation der X-Links Basis-Objektes
     // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-    err = ifb_writeXlinksOfBases(Server, Out, fout);
+    err = ifb_writeXlinksOfBases(Server, Out, pSink);
     if(err) {
-        if(fout) {
+        if(pSink) {
             if(Out != "") {
-                fputs((const char*)Out, fout);
+                pSink->put(Out);
                 // String-Buffer leeren
                 Out = "";
             }
@@ -1285,11 +2320,11 @@ Out += "*********************************************************************/\n
     params.scope_flags = KS_EPF_DEFAULT;
 
     //                                      Recurs conLnk parentOnly
-    err = ifb_writeInstData(Server,params,Out,TRUE,FALSE, TRUE,      fout);
+    err = ifb_writeInstData(Server,params,Out,TRUE,FALSE, TRUE,      pSink);
     if(err) {
-        if(fout) {
+        if(pSink) {
             if( Out.len() ) {
-                fputs((const char*)Out, fout);
+                pSink->put(Out);
                 // String-Buffer leeren
                 Out = "";
             }
@@ -1310,11 +2345,11 @@ Out += "*********************************************************************/\n
     params.scope_flags = KS_EPF_DEFAULT;
 
     //                                      Recurs conLnk parentOnly
-    err = ifb_writeInstData(Server,params,Out,TRUE,FALSE,TRUE,fout);
+    err = ifb_writeInstData(Server,params,Out,TRUE,FALSE,TRUE,pSink);
     if(err) {
-        if(fout) {
+        if(pSink) {
             if( Out.len() ) {
-                fputs((const char*)Out, fout);
+                pSink->put(Out);
                 // String-Buffer leeren
                 Out = "";
             }
@@ -1334,11 +2369,11 @@ Out += "*********************************************************************/\n
     params.scope_flags = KS_EPF_DEFAULT;
 
     //                                      Recurs conLnk parentOnly
-    err = ifb_writeInstData(Server,params,Out,TRUE,TRUE,  FALSE,  fout);
+    err = ifb_writeInstData(Server,params,Out,TRUE,TRUE,  FALSE,  pSink);
     if(err) {
-        if(fout) {
+        if(pSink) {
             if( Out.len() ) {
-                fputs((const char*)Out, fout);
+                pSink->put(Out);
                 // String-Buffer leeren
                 Out = "";
             }
@@ -1355,11 +2390,129 @@ Out += "*********************************************************************/\n
 
 
 
+// Datenbasis des Servers in die Ausgabe schreiben
+/******************************************************************************/
+static KS_RESULT ifb_saveToSink(KscServerBase*   Server,
+                                IfbsOutSink     &Sink) {
+/******************************************************************************/
+
+    PltString Str("");
+
+    // Server-Daten nur einmal je Sicherung lesen
+    IfbsSession *pses = IFBS_OpenSession(Server);
+
+    KS_RESULT err = IFBS_GETDBCONTENTS(Server, Str, &Sink);
+
+    IFBS_CloseSession(pses);
+
+    Sink.put(Str);
+    KS_RESULT writeErr = Sink.flush();
+    if(!err) {
+        err = writeErr;
+    }
+
+    return err;
+}
+
+static void ifb_putFileHeader(IfbsOutSink &Sink, PltString &datei) {
+    Sink.put("/*********************************************************************\n");
+    Sink.put("* Datei : ");
+    Sink.put(datei);
+    Sink.put("\n*********************************************************************/\n");
+}
+
+/*
+*  Sicherung als .fbb : Der Text der Sicherung wird in Bloecke zerlegt, jeder
+*  fertige Block geparst und sofort binaer geschrieben
+*/
+struct IfbFbbSave {
+    IfbsFbdReader       Reader;
+    FB_PARSE_CONTEXT   *ctx;
+    IfbsFbbWriter      *pWriter;
+    KS_RESULT           err;
+};
+
+// Vollstaendige Bloecke schreiben
+/******************************************************************************/
+static void ifb_fbbSaveBlocks(IfbFbbSave *ps) {
+/******************************************************************************/
+
+    int kind;
+
+    while(!ps->err) {
+        kind = ps->Reader.next();
+        if( (kind == IFBS_FBDREAD_MORE) || (kind == FB_BLOCK_NONE) ) {
+            break;
+        }
+        if(kind < 0) {
+            ps->err = KS_ERR_BADPARAM;
+            break;
+        }
+        if(ps->Reader.parse(ps->ctx) != EXIT_SUCCESS) {
+            iFBS_SetParserError(ps->ctx);
+            ps->err = KS_ERR_BADPARAM;
+            break;
+        }
+        ps->pWriter->add(ps->ctx->par);
+    }
+}
+
+// Callback der Sicherung : Text uebernehmen
+/******************************************************************************/
+static int ifb_fbbSaveFnc(void *pUser, const char *data, size_t len) {
+/******************************************************************************/
+
+    IfbFbbSave *ps = (IfbFbbSave*)pUser;
+
+    ps->Reader.feed(data, len);
+    ifb_fbbSaveBlocks(ps);
+
+    return ps->err ? 1 : 0;
+}
+
+/******************************************************************************/
+static KS_RESULT ifb_saveFbb(KscServerBase* Server, IfbsOutSink &Sink) {
+/******************************************************************************/
+
+    KS_RESULT           err;
+    IfbFbbSave          Save;
+    IfbsFbbWriter       Writer(Sink);
+
+    Save.ctx = fb_parser_create();
+    if(!Save.ctx) {
+        return OV_ERR_HEAPOUTOFMEMORY;
+    }
+    Save.pWriter = &Writer;
+    Save.err = KS_ERR_OK;
+    Save.Reader.openText();
+
+    Writer.begin();
+    err = IFBS_DBSAVE_TOCALLBACK(Server, ifb_fbbSaveFnc, &Save);
+
+    // Rest nach dem letzten Block
+    Save.Reader.finish();
+    ifb_fbbSaveBlocks(&Save);
+    if(Save.err) {
+        // Fehler beim Zerlegen hat Vorrang vor dem Fehler der Ausgabe
+        err = Save.err;
+    }
+    if(!err) {
+        err = Writer.finish();
+    }
+    fb_parser_destroy(Save.ctx);
+
+    return err;
+}
+
+
 /******************************************************************************/
 KS_RESULT IFBS_DBSAVE(KscServerBase*         Server,
                                       PltString        &datei) {
 /******************************************************************************/
 
+    KS_RESULT err;
+    int       binary;
+
     if(!Server) {
             return KS_ERR_SERVERUNKNOWN;
     }
@@ -1368,33 +2521,69 @@ KS_RESULT IFBS_DBSAVE(KscServerBase*         Server,
             return KS_ERR_BADNAME;
     }
 
-    FILE *fout = fopen((const char*)datei, "w");
-    if(!fout) {
-                return KS_ERR_BADPATH;
+    // Endung .gz bzw. .zst : Text wird in einem eigenen Thread komprimiert
+    IfbsOutFile File;
+
+    binary = IFBS_IsFbbName((const char*)datei);
+    err = File.open((const char*)datei, binary);
+    if(err) {
+        return err;
     }
 
-    fputs("/*********************************************************************\n", fout);
-    fputs("* Datei : ", fout);
-    fputs((const char*)datei, fout);
-    fputs("\n*********************************************************************/\n", fout);
+    pSaveFile = &File;
+    if(binary) {
+        err = ifb_saveFbb(Server, File.sink());
+    } else {
+        ifb_putFileHeader(File.sink(), datei);
+        err = ifb_saveToSink(Server, File.sink());
+    }
+    pSaveFile = 0;
 
-    PltString Str("");
+    KS_RESULT writeErr = File.close();
+    if(!err) {
+        err = writeErr;
+    }
 
-    KS_RESULT err = IFBS_GETDBCONTENTS(Server, Str, fout);
+    return err;
+}
 
-//    fputs((const char*)Str, fout);
 
-    fclose(fout);
+/******************************************************************************/
+KS_RESULT IFBS_DBSAVE_TOCALLBACK(KscServerBase*    Server,
+                                 IfbsOutSinkFnc    fnc,
+                                 void             *pUser) {
+/******************************************************************************/
 
-    return err;
+    if(!Server) {
+            return KS_ERR_SERVERUNKNOWN;
+    }
+
+    IfbsOutSink Sink(fnc, pUser);
+
+    return ifb_saveToSink(Server, Sink);
 }
 
+// Callback fuer IFBS_DBSAVE_TOCALLBACK : Text an std::string anhaengen
+/******************************************************************************/
+int ifb_appendToString(void *pUser, const char *data, size_t len) {
+/******************************************************************************/
+    ((std::string*)pUser)->append(data, len);
+    return 0;
+}
 
+// Veraltet : Der ganze Text liegt am Ende zweimal im Speicher (std::string
+// und Kopie im PltString). Neue Aufrufer verwenden IFBS_DBSAVE_TOCALLBACK
 /******************************************************************************/
 KS_RESULT IFBS_DBSAVE_TOSTREAM(KscServerBase*         Server,
                                                      PltString         &Out) {
 /******************************************************************************/
 
- return IFBS_GETDBCONTENTS(Server, Out);
+    // PltString waechst bei += jedes Mal neu, daher erst std::string
+    std::string Text;
+
+    KS_RESULT err = IFBS_DBSAVE_TOCALLBACK(Server, ifb_appendToString, &Text);
 
+    Out = Text.c_str();
+
+    return err;
 }
@@ -0,0 +1,373 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_delbatch.cpp                                                         *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Loescht viele Objekte mit wenigen Diensten. Links werden mit wenigen     *
+*   Unlink-Diensten entfernt, die Objekte in der Reihenfolge Verbindungen,   *
+*   Instanzen, Container, Bibliotheken geloescht. Nur vom Server abgelehnte  *
+*   Objekte werden wiederholt.                                               *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+/*
+*  Max. Anzahl Objekte je DeleteObject- bzw. Unlink-Dienst
+*/
+static size_t ifbs_DeleteBatchSize = IFBS_DELETE_BATCHSIZE;
+
+/******************************************************************************/
+void IFBS_SetDeleteBatchSize(size_t anz) {
+/******************************************************************************/
+    if(anz == 0) {
+        anz = 1;
+    }
+    ifbs_DeleteBatchSize = anz;
+}
+
+/******************************************************************************/
+size_t IFBS_GetDeleteBatchSize() {
+/******************************************************************************/
+    return ifbs_DeleteBatchSize;
+}
+
+/*****************************************************************************/
+IfbsDeleteBatch::IfbsDeleteBatch(KscServerBase *Server, size_t batchSize)
+/*****************************************************************************/
+  : Server(Server),
+    batchSize(batchSize ? batchSize : IFBS_GetDeleteBatchSize()),
+    requests(0)
+{
+}
+
+/*****************************************************************************/
+int IfbsDeleteBatch::isPart(const char *path)
+/*****************************************************************************/
+{
+    const char *ph = path + strlen(path);
+
+    while(ph != path) {
+        ph--;
+        if((*ph) == '.') {
+            return 1;
+        }
+        if((*ph) == '/') {
+            // Kein Part
+            break;
+        }
+    }
+    return 0;
+}
+
+/*****************************************************************************/
+void IfbsDeleteBatch::addObject(const char *path, int stage, const char *what)
+/*****************************************************************************/
+{
+    Item    item;
+
+    // Parts werden mit dem oberen Objekt geloescht
+    if( (!path) || (!(*path)) || isPart(path) ) {
+        return;
+    }
+    if(!added.insert(std::string(path)).second) {
+        return;
+    }
+    item.path = path;
+    item.stage = stage;
+    item.what = what;
+    items.push_back(item);
+}
+
+/*****************************************************************************/
+void IfbsDeleteBatch::addUnlink(const char *link_path, const char *elem_path)
+/*****************************************************************************/
+{
+    linkPath.push_back(std::string(link_path));
+    elemPath.push_back(std::string(elem_path));
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsDeleteBatch::addXlinks(const char *path)
+/*****************************************************************************/
+{
+    /*
+    *  Wie delAllXlinks, die Link-Variablen werden aber mit einem GetVar
+    *  gelesen und die Elemente erst in run() entfernt
+    */
+    KsGetEPParams               params;
+    KsGetEPResult               result;
+    KS_RESULT                   err;
+    KS_RESULT                   lastErr = KS_ERR_OK;
+    KsString                    hs;
+    KscPackage                  pkg;
+    std::vector<KscVariable*>   vars;
+    std::vector<std::string>    names;
+    size_t                      i, k, size;
+
+    if(!Server) {
+        return KS_ERR_SERVERUNKNOWN;
+    }
+
+    params.path = path;
+    params.type_mask = KS_OT_LINK;
+    params.name_mask = "*";
+    params.scope_flags = KS_EPF_DEFAULT;
+
+    bool ok = Server->getEP(0, params, result);
+    if ( !ok ) {
+        err = Server->getLastResult();
+        if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
+        return err;
+    }
+    if ( result.result ) {
+        return result.result;
+    }
+    if(!result.items.size()) {
+        // Keine Links
+        return KS_ERR_OK;
+    }
+
+    KsString root = Server->getHostAndName();    // Merke : //host/server
+
+    while ( result.items.size() ) {
+        KsEngPropsHandle hpp = result.items.removeFirst();
+        if(!hpp) {
+            lastErr = KS_ERR_GENERIC;
+            continue;
+        }
+        hs = path;
+        hs += ".";
+        hs += hpp->identifier;
+
+        KscVariable *var = new KscVariable(root + hs);
+        if(!var) {
+            return OV_ERR_HEAPOUTOFMEMORY;
+        }
+        if(!pkg.add(KscVariableHandle(var, PltOsNew)) ) {
+            return OV_ERR_HEAPOUTOFMEMORY;
+        }
+        vars.push_back(var);
+        names.push_back(std::string((const char*)hs));
+    }
+
+    if(!pkg.getUpdate() ) {
+        // Einzelne Variablen koennen trotzdem gelesen sein
+        lastErr = KS_ERR_GENERIC;
+    }
+
+    for(i = 0; i < vars.size(); i++) {
+        const KsVarCurrProps* cp = vars[i]->getCurrProps();
+        if(!cp || !cp->value) {
+            lastErr = KS_ERR_GENERIC;
+            continue;
+        }
+        switch(cp->value->xdrTypeCode() ) {
+            case KS_VT_STRING:
+                            hs = (KsStringValue &) *cp->value;
+                            if( hs.len() ) {
+                                addUnlink(names[i].c_str(), (const char*)hs);
+                            }
+                            break;
+            case KS_VT_STRING_VEC:
+                            size = ((KsStringVecValue &) *cp->value).size();
+                            for ( k = 0; k < size; k++ ) {
+                                addUnlink(names[i].c_str(),
+                                          (const char*)(((KsStringVecValue &) *cp->value)[k]));
+                            }
+                            break;
+            default:
+                            break;
+        }
+    }
+
+    return lastErr;
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsDeleteBatch::unlinkAll()
+/*****************************************************************************/
+{
+    KS_RESULT   lastErr = KS_ERR_OK;
+    KS_RESULT   err;
+    size_t      i, k, anz;
+
+    if(!Server) {
+        return KS_ERR_SERVERUNKNOWN;
+    }
+    for(i = 0; i < linkPath.size(); i += anz) {
+        anz = linkPath.size() - i;
+        if(anz > batchSize) {
+            anz = batchSize;
+        }
+
+        KsUnlinkParams          unlinkpar;
+        KsArray<KsUnlinkItem>   unlinkit(anz);
+        KsUnlinkResult          ulres;
+
+        if(unlinkit.size() != anz) {
+            lastErr = OV_ERR_HEAPOUTOFMEMORY;
+            continue;
+        }
+        for(k = 0; k < anz; k++) {
+            unlinkit[k].link_path = linkPath[i+k].c_str();
+            unlinkit[k].element_path = elemPath[i+k].c_str();
+        }
+        unlinkpar.items = unlinkit;
+
+        err = KS_ERR_OK;
+        bool ok = Server->requestByOpcode ( KS_UNLINK, GetClientAV(), unlinkpar, ulres);
+        requests++;
+        if(!ok) {
+            err = Server->getLastResult();
+            if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
+        } else if(ulres.result) {
+            err = ulres.result;
+        } else if(ulres.results.size() != anz) {
+            err = KS_ERR_GENERIC;
+        } else {
+            for(k = 0; k < anz; k++) {
+                if(ulres.results[k]) {
+                    err = ulres.results[k];
+                }
+            }
+        }
+        if(err) {
+            lastErr = err;
+        }
+    }
+
+    linkPath.clear();
+    elemPath.clear();
+
+    return lastErr;
+}
+
+// Ein DeleteObject-Dienst fuer einen Abschnitt. Liefert die Anzahl
+// geloeschter Objekte
+/*****************************************************************************/
+size_t IfbsDeleteBatch::deleteChunk(std::vector<size_t>    &chunk,
+                                    std::vector<KS_RESULT> &errs,
+                                    std::vector<size_t>    &rejected,
+                                    PltString              *Logging)
+/*****************************************************************************/
+{
+    KsDeleteObjParams  objpar;
+    KsArray<KsString>  objpath(chunk.size());
+    KsDeleteObjResult  res;
+    KS_RESULT          err = KS_ERR_OK;
+    size_t             k;
+    size_t             deleted = 0;
+    int                log = (Logging && (*Logging) ) ? 1 : 0;
+
+    if(objpath.size() != chunk.size()) {
+        err = OV_ERR_HEAPOUTOFMEMORY;
+    } else {
+        for(k = 0; k < chunk.size(); k++) {
+            objpath[k] = items[chunk[k]].path.c_str();
+        }
+        objpar.paths = objpath;
+        bool ok = Server->requestByOpcode ( KS_DELETEOBJECT, GetClientAV(), objpar, res);
+        requests++;
+        if(!ok) {
+            err = Server->getLastResult();
+            if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
+        } else if(res.result) {
+            err = res.result;
+        } else if(res.results.size() != chunk.size()) {
+            err = KS_ERR_GENERIC;
+        }
+    }
+
+    for(k = 0; k < chunk.size(); k++) {
+        errs[chunk[k]] = err ? err : res.results[k];
+        if(errs[chunk[k]]) {
+            // Merke: Objekt nicht geloescht
+            rejected.push_back(chunk[k]);
+        } else {
+            deleted++;
+            if(log) {
+                *Logging += log_getOkMsg(items[chunk[k]].what,
+                                items[chunk[k]].path.c_str(), "deleted.");
+            }
+        }
+    }
+    return deleted;
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsDeleteBatch::run(PltString *Logging)
+/*****************************************************************************/
+{
+    std::vector<size_t>     open;       // noch nicht geloeschte Objekte
+    std::vector<size_t>     rejected;
+    std::vector<size_t>     chunk;
+    std::vector<KS_RESULT>  errs(items.size(), KS_ERR_OK);
+    KS_RESULT               lastErr = KS_ERR_OK;
+    size_t                  i, deleted;
+    int                     stage;
+    int                     log = (Logging && (*Logging) ) ? 1 : 0;
+
+    failed = "";
+    if(!Server) {
+        return KS_ERR_SERVERUNKNOWN;
+    }
+
+    // Links zuerst. Fehler wie bei delAllXlinks nicht auswerten
+    unlinkAll();
+
+    for(i = 0; i < items.size(); i++) {
+        open.push_back(i);
+    }
+
+    while(open.size()) {
+        rejected.clear();
+        deleted = 0;
+
+        for(stage = 0; stage < IFBS_DEL_STAGES; stage++) {
+            chunk.clear();
+            for(i = 0; i < open.size(); i++) {
+                if(items[open[i]].stage != stage) {
+                    continue;
+                }
+                chunk.push_back(open[i]);
+                if(chunk.size() >= batchSize) {
+                    deleted += deleteChunk(chunk, errs, rejected, Logging);
+                    chunk.clear();
+                }
+            }
+            if(chunk.size()) {
+                deleted += deleteChunk(chunk, errs, rejected, Logging);
+            }
+        }
+
+        // Nur wiederholen, solange Objekte geloescht werden
+        if(!deleted) {
+            break;
+        }
+        open = rejected;
+    }
+
+    for(i = 0; i < rejected.size(); i++) {
+        Item &item = items[rejected[i]];
+        lastErr = errs[rejected[i]];
+        if(!failed.size()) {
+            failed = item.path;
+        }
+        if(log) {
+            *Logging += log_getErrMsg(lastErr, item.what,
+                            item.path.c_str(), "couldn't be deleted.");
+        }
+    }
+
+    items.clear();
+    added.clear();
+
+    return lastErr;
+}
@@ -253,22 +253,29 @@ KS_RESULT delAllXlinks(KscServerBase* Server, PltString &Str) {
 }
 
 /******************************************************************************/
-KS_RESULT del_inst_childs(KscServerBase*  Server,
-                          PltString       &inst,
-                          PltString*      Logging) {
+KS_RESULT del_collect_childs(KscServerBase*       Server,
+                             IfbsDeleteBatch      &Del,
+                             PltString            &path,
+                             int                  inInstance,
+                             PltList<PltString>   &InstListe,
+                             PltList<PltString>   &PartListe,
+                             KS_RESULT            &LastErr,
+                             PltString*           Logging) {
 /******************************************************************************/
-
-    PltList<PltString>  TuListe;
-    PltList<PltString>  InstListe;
-    PltList<PltString>  VerbListe;
-    PltList<PltString>  PartListe;
+    /*
+    *  Traegt alle Unterobjekte von path in den Batch ein, Kinder vor ihrem
+    *  Parent-Objekt. Instanzen kommen in InstListe (ausschalten, Verbindungen
+    *  suchen), Parts von Instanzen in PartListe (nur Verbindungen suchen).
+    *  Liefert den Fehler beim Lesen von path, Fehler der Unterobjekte stehen
+    *  in LastErr.
+    */
     PltString           log;
+    PltString           curInst;
     KsGetEPParams       Pars;
     KsGetEPResult       result;
     KS_RESULT           err = KS_ERR_OK;
-    KS_RESULT           LastErr = KS_ERR_OK;
     
-    Pars.path = inst;
+    Pars.path = path;
     Pars.type_mask = (KS_OT_DOMAIN | KS_OT_HISTORY);
     Pars.name_mask = "*";
     Pars.scope_flags = KS_EPF_DEFAULT;
@@ -282,84 +289,123 @@ KS_RESULT del_inst_childs(KscServerBase*  Server,
     }
     if(err) {
         log = "\"%s\"  \"";
-        log += inst;
+        log += path;
         log += "\"";
         iFBS_SetLastError(1, err, log);
         if(Logging && (*Logging)) {
             *Logging += log_getErrMsg(err, "Can't read",
-                        (const char*)inst,"objects.");
+                        (const char*)path,"objects.");
         }
         return err;
     }
     
     while(result.items.size() ) {
         KsEngPropsHandle hpp = result.items.removeFirst();
+        curInst = path;
+        
         if( hpp->access_mode & KS_AC_PART) {
             // Alle Unterobjekte der Parts loeschen
-            log = inst;
-            log += ".";
-            log += (const char*)hpp->identifier;
-            err = del_inst_childs(Server, log, Logging);
-            if(err != KS_ERR_OK) {
-                return err;
+            curInst += ".";
+            curInst += (const char*)hpp->identifier;
+            err = del_collect_childs(Server, Del, curInst, 1, InstListe, PartListe, LastErr, Logging);
+            if(err) {
+                LastErr = err;
             }
-            PartListe.addLast(log);
-        } else {
-            log = inst;
-            log += "/";
-            log += (const char*)hpp->identifier;
-            if( ((KsDomainEngProps &)(*hpp)).class_identifier == CONTAINER_CLASS_PATH) {
-                TuListe.addLast(log);
+            if(inInstance) {
+                PartListe.addLast(curInst);
             } else {
-                InstListe.addLast(log);
+                InstListe.addLast(curInst);
+            }
+            continue;
+        }
+        
+        curInst += "/";
+        curInst += (const char*)hpp->identifier;
+        if( (hpp->xdrTypeCode() == KS_OT_DOMAIN) &&
+            (((KsDomainEngProps &)(*hpp)).class_identifier == CONTAINER_CLASS_PATH) ) {
+            // Container rekursiv loeschen
+            err = del_collect_childs(Server, Del, curInst, 0, InstListe, PartListe, LastErr, Logging);
+            if(err) {
+                LastErr = err;
+            }
+            Del.addObject(curInst, IFBS_DEL_CONTAINER);
+        } else {
+            // Instanz-Unterobjekte loeschen
+            err = del_collect_childs(Server, Del, curInst, 1, InstListe, PartListe, LastErr, Logging);
+            if(err) {
+                LastErr = err;
             }
+            if(inInstance) {
+                Del.addXlinks(curInst);
+            }
+            Del.addObject(curInst, IFBS_DEL_INSTANCE);
+            InstListe.addLast(curInst);
         }
     }
     
-    // Child-Instanzen ausschalten
-    TurnInstOff(Server,InstListe);
+    return KS_ERR_OK;
+}
 
-    // Verbindungen der Child-Instanzen holen und loeschen
-    GetVerbFromList(Server,InstListe,VerbListe);
-    TurnComConOff(Server, VerbListe);
-    DelObjsFromList(Server, VerbListe, Logging);
+/******************************************************************************/
+KS_RESULT del_run_batch(KscServerBase*       Server,
+                        IfbsDeleteBatch      &Del,
+                        PltList<PltString>   &InstListe,
+                        PltList<PltString>   &PartListe,
+                        PltString*           Logging) {
+/******************************************************************************/
+    /*
+    *  Instanzen ausschalten, ihre Verbindungen ausschalten und als erste
+    *  loeschen, dann alle Objekte des Batches loeschen
+    */
+    PltList<PltString>  VerbListe;
+    PltString           log;
+    KS_RESULT           err;
 
-    // Haben die Parts auch verbindungen?
-    while(VerbListe.size()) {log = VerbListe.removeFirst();}
-    GetVerbFromList(Server,PartListe,VerbListe);
+    // Instanzen ausschalten
+    TurnInstOff(Server, InstListe);
+
+    // Verbindungen der Instanzen und Parts holen
+    GetVerbFromList(Server, InstListe, VerbListe);
+    GetVerbFromList(Server, PartListe, VerbListe);
     TurnComConOff(Server, VerbListe);
-    DelObjsFromList(Server, VerbListe, Logging);
-    
-    // Alle Container rekursiv loeschen
-    while(TuListe.size() ) {
-        log = TuListe.removeFirst();
-        err = del_cont_recurs(Server,log,Logging);
-        if(err) {
-            PltString Str = IFBS_GetLastLogError();
-            if(Str == "" ) {
-                Str = "\"%s\"  \"";
-                Str += log;
-                Str += "\"";
-                iFBS_SetLastError(1, err, Str);
-            }
-            LastErr = err;
+    while(VerbListe.size()) {
+        log = VerbListe.removeFirst();
+        Del.addXlinks(log);
+        Del.addObject(log, IFBS_DEL_CONNECTION);
+    }
+
+    err = Del.run(Logging);
+    if(err) {
+        log = IFBS_GetLastLogError();
+        if(log == "" ) {
+            log = "\"%s\"  \"";
+            log += Del.getFailed();
+            log += "\"";
+            iFBS_SetLastError(1, err, log);
         }
     }
-        
+    return err;
+}
 
-    // Alle Child-Instanzen und deren Unterobjekte loeschen
-    while(InstListe.size()) {
-        PltList<PltString> hLst;
-        log = InstListe.removeFirst();
-        delAllXlinks(Server, log);
-        
-        // Instanz-Unterobjekte loeschen
-        del_inst_childs(Server, log, Logging);
-        
-        hLst.addLast(log);
-        DelObjsFromList(Server, hLst, Logging);
+/******************************************************************************/
+KS_RESULT del_inst_childs(KscServerBase*  Server,
+                          PltString       &inst,
+                          PltString*      Logging) {
+/******************************************************************************/
+
+    IfbsDeleteBatch     Del(Server);
+    PltList<PltString>  InstListe;
+    PltList<PltString>  PartListe;
+    KS_RESULT           err;
+    KS_RESULT           LastErr = KS_ERR_OK;
+    
+    err = del_collect_childs(Server, Del, inst, 1, InstListe, PartListe, LastErr, Logging);
+    if(err) {
+        return err;
     }
     
+    del_run_batch(Server, Del, InstListe, PartListe, Logging);
+    
     return LastErr;                  
 }
 
@@ -369,163 +415,22 @@ KS_RESULT del_cont_recurs(KscServerBase*  Server,
                           PltString*      Logging) {
 /******************************************************************************/
 
-    PltList<PltString>  TuListe;
+    IfbsDeleteBatch     Del(Server);
     PltList<PltString>  InstListe;
-    PltList<PltString>  VerbListe;
-    PltString           log;
-    PltString           curInst;
-    KsGetEPParams       Pars;
-    KsGetEPResult       result;
-    KS_RESULT           err = KS_ERR_OK;
+    PltList<PltString>  PartListe;
+    KS_RESULT           err;
     KS_RESULT           LastErr = KS_ERR_OK;
-    char                *help;
-    char                *ph;
     
-    Pars.path = tu;
-    Pars.type_mask = (KS_OT_DOMAIN | KS_OT_HISTORY);
-    Pars.name_mask = "*";
-    Pars.scope_flags = KS_EPF_DEFAULT;
-
-    bool ok = Server->getEP(0, Pars, result);
-    if ( !ok ) {
-        err = Server->getLastResult();
-        if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
-    } else if ( result.result != KS_ERR_OK ) {
-            err = result.result;
-    }
+    err = del_collect_childs(Server, Del, tu, 0, InstListe, PartListe, LastErr, Logging);
     if(err) {
-        log = "\"%s\"  \"";
-        log += tu;
-        log += "\"";
-        iFBS_SetLastError(1, err, log);
-        if(Logging && (*Logging)) {
-            *Logging += log_getErrMsg(err, "Can't read",
-                        (const char*)tu," objects.");
-        }
         return err;
     }
+    // Zum Schluss der Container selbst
+    Del.addObject(tu, IFBS_DEL_CONTAINER);
     
-    while(result.items.size() ) {
-        KsEngPropsHandle hpp = result.items.removeFirst();
-        curInst = tu;
-        
-        // Parts?
-        if( hpp->access_mode & KS_AC_PART) {
-            curInst += ".";
-        } else {
-            curInst += "/";
-        }
-
-        curInst += hpp->identifier;
-        if( ((KsDomainEngProps &)(*hpp)).class_identifier == CONTAINER_CLASS_PATH) {
-            TuListe.addLast(curInst);
-        } else {
-            InstListe.addLast(curInst);
-        }
-    }
-
-    // Child-Instanzen ausschalten
-    TurnInstOff(Server,InstListe);
-
-    // Verbindungen der Child-Instanzen holen und loeschen
-    GetVerbFromList(Server,InstListe,VerbListe);
-    DelObjsFromList(Server, VerbListe, Logging);
-
-    // Alle Container rekursiv loeschen
-    while(TuListe.size() ) {
-        curInst = TuListe.removeFirst();
-        err = del_cont_recurs(Server,curInst,Logging);
-        if(err) {
-            log = IFBS_GetLastLogError();
-            if(log == "" ) {
-                log = "\"%s\"  \"";
-                log += log;
-                log += "\"";
-                iFBS_SetLastError(1, err, log);
-            }
-            LastErr = err;
-        }
-    }
-
-    // Alle Instanzen loeschen
-    while(InstListe.size()) {
-        curInst = InstListe.removeFirst();
-        del_inst_childs(Server, curInst, Logging);
-                
-        err = IFBS_DELETE_OBJ(Server,curInst);
-        if(err != KS_ERR_OK) {
-            // Part erwischt?
-            int part = 0;
-            help = (char*)((const char*)curInst);
-            ph = help;
-            while(ph && (*ph)) ph++;
-            while(ph != help) {
-                ph--;
-                if((*ph) == '.') {
-                    part = 1;
-                    break;
-                }
-                if((*ph) == '/') {
-                    // Kein Part
-                    break;
-                }
-            }
-            if(!part) {
-                log = IFBS_GetLastLogError();
-                if(log == "" ) {
-                    log = "\"%s\"  \"";
-                    log += curInst;
-                    log += "\"";
-                    iFBS_SetLastError(1, err, log);
-                }
-                if(Logging && (*Logging)) {
-                    *Logging += log_getErrMsg(err, "Instance",
-                                (const char*)curInst,"not deleted.");
-                }
-            }
-        } else {
-            if(Logging && (*Logging)) {
-                *Logging += log_getOkMsg("Instance",(const char*)curInst,"deleted.");
-            }
-        }
-    }
-    
-    err = IFBS_DELETE_OBJ(Server,tu);
+    err = del_run_batch(Server, Del, InstListe, PartListe, Logging);
     if(err) {
-        // Part?
-        int part = 0;
-        help = (char*)((const char*)tu);
-        ph = help;
-        while(ph && (*ph)) ph++;
-        while(ph != help) {
-            ph--;
-            if((*ph) == '.') {
-                part = 1;
-                break;
-            }
-            if((*ph) == '/') {
-                // Kein Part
-                break;
-            }
-        }
-        if(!part) {
-            LastErr = err;
-            log = IFBS_GetLastLogError();
-            if(log == "" ) {
-                log = "\"%s\"  \"";
-                log += tu;
-                log += "\"";
-                iFBS_SetLastError(1, err, log);
-            }
-            if(Logging && (*Logging)) {
-                *Logging += log_getErrMsg(err,
-                            "Instance", (const char*)tu, "not deleted.");
-            }
-        }
-    } else {
-        if(Logging && (*Logging)) {
-            *Logging += log_getOkMsg("Instance",(const char*)tu,"deleted.");
-        }
+        LastErr = err;
     }
     return LastErr;
 }
@@ -540,70 +445,26 @@ KS_RESULT DelObjsFromList(KscServerBase*      Server,
     if(Liste.isEmpty())
         return KS_ERR_OK;
 
+    IfbsDeleteBatch    Del(Server);
     PltList<PltString> hListe;
-    PltList<PltString> badLst;
     PltString          Str;
-    size_t             i;
-    
-    KS_RESULT err = KS_ERR_OK;
-    KS_RESULT erg;
-    int       log = (Logging && (*Logging) ) ? 1 : 0;
     
+    // Objekte in der Reihenfolge der Liste loeschen
     while(Liste.size() ) {
         Str = Liste.removeFirst();
         hListe.addLast(Str);
 
-        delAllXlinks(Server,Str);
-
-        erg = IFBS_DELETE_OBJ(Server,Str);
-        if(erg) {
-            // Merke: Instanz nicht geloescht
-            badLst.addFirst(Str);
-        } else {
-            if(log) {
-                *Logging += log_getOkMsg("Instance",(const char*)Str,"deleted.");
-            }
-        }
+        Del.addXlinks(Str);
+        Del.addObject(Str, IFBS_DEL_INSTANCE);
     }
     
     while(hListe.size() ) {
         Liste.addLast(hListe.removeFirst());
     }
 
-    // Versuchen wir die Instanzen noch 5 mal zu loeschen
-    for(i=0; i<5; i++) {
-        while(badLst.size() ) {
-            Str = badLst.removeFirst();
-            erg = IFBS_DELETE_OBJ(Server,Str);
-            if(erg) {
-                if(i == 4) {
-                    // Anzahl der Versuche abgelaufen
-                    err = erg;
-                    if(log) {
-                        *Logging += log_getErrMsg(err,
-                                        "Instance", (const char*)Str,
-                                        "couldn't be deleted.");
-                    }
-                } else {
-                    // Noch eine Runde
-                    hListe.addLast(Str);
-                }
-            } else {
-                if(log) {
-                    *Logging += log_getOkMsg("Instance",(const char*)Str,"deleted.");
-                }
-            }
-        }
-        
-        while(hListe.size() ) {
-            badLst.addLast(hListe.removeFirst());
-        }
-    }
-
-    return err;
+    return Del.run(Logging);
 }
 
-
 /******************************************************************************/
 KS_RESULT TurnComConOff(KscServerBase*      Server,
                         PltList<PltString>  &VerbListe) {
@@ -615,17 +476,28 @@ KS_RESULT TurnComConOff(KscServerBase*      Server,
     PltList<PltString>    hListe;
     PltString             Str;
     KS_RESULT             err = KS_ERR_OK;
+    IfbsSetVarBatch       Batch(Server);
+    size_t                i, anz;
 
     KS_RESULT erg;
     
     PltString Value("FALSE");
     
+    // Alle Verbindungen mit wenigen SetVar-Diensten ausschalten
     while(VerbListe.size()) {
         Str = VerbListe.removeFirst();
         hListe.addLast(Str);
         Str += ".on";
         
-        erg = ifb_SeparateValueAndSet(Server, Str, Value, KS_VT_BOOL);
+        PltList<PltString> ValList;     // Wird beim Eintragen verbraucht
+        ValList.addLast(Value);
+        Batch.add(Batch.addOwner(), Str, ValList, KS_VT_BOOL);
+    }
+    Batch.flush();
+    
+    anz = hListe.size();
+    for(i = 0; i < anz; i++) {
+        erg = Batch.getResult(i);
         if(erg) {
             err = erg;
         }
@@ -650,17 +522,28 @@ KS_RESULT TurnInstOff(KscServerBase*      Server,
 
     PltString             Str;
     PltList<PltString>    hListe;
+    IfbsSetVarBatch       Batch(Server);
+    size_t                i, anz;
 
     KS_RESULT err = KS_ERR_OK;
     KS_RESULT erg;
     PltString Value("0");
     
+    // Alle Instanzen mit wenigen SetVar-Diensten ausschalten
     while(InstListe.size()) {
         Str = InstListe.removeFirst();
         hListe.addLast(Str);
         Str += ".actimode";
         
-        erg = ifb_SeparateValueAndSet(Server, Str, Value, KS_VT_INT);
+        PltList<PltString> ValList;     // Wird beim Eintragen verbraucht
+        ValList.addLast(Value);
+        Batch.add(Batch.addOwner(), Str, ValList, KS_VT_INT);
+    }
+    Batch.flush();
+    
+    anz = hListe.size();
+    for(i = 0; i < anz; i++) {
+        erg = Batch.getResult(i);
         if(erg) {
             err = erg;
         }
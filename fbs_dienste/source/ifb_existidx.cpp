@@ -0,0 +1,164 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_existidx.cpp                                                         *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Index der vorhandenen Objekte beim Laden. Jeder Container wird einmal    *
+*   gelesen (Kinder und Parts mit Klasse), danach ist die Pruefung, ob ein   *
+*   Objekt vorhanden ist, eine Suche im Speicher.                            *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+// Laenge des Container-Pfades ('/' oder '.' des Parts)
+/*****************************************************************************/
+size_t IfbsExistIndex::parentLen(const char *path)
+/*****************************************************************************/
+{
+    size_t len = strlen(path);
+
+    while(len > 0) {
+        len--;
+        if( (path[len] == '/') || (path[len] == '.') ) {
+            return len;
+        }
+    }
+    return 0;
+}
+
+/*****************************************************************************/
+void IfbsExistIndex::listContainer(KscServerBase     *Server,
+                                   const std::string &container)
+/*****************************************************************************/
+{
+    KsGetEPParams    params;
+    KsGetEPResult    result;
+    std::string      key;
+    const char      *typ;
+    KS_ACCESS        acc;
+
+    // Instanz im Root?
+    params.path = container.size() ? container.c_str() : "/";
+    params.name_mask = "*";
+    params.type_mask = KS_OT_DOMAIN | KS_OT_HISTORY;
+    params.scope_flags = KS_EPF_DEFAULT;
+
+    bool ok = Server->getEP(0, params, result);
+    if( !ok ) {
+        // Kommunikationsfehler : nicht merken, beim naechsten Mal neu lesen
+        return;
+    }
+
+    listed.insert(container);
+    if( result.result ) {
+        // Container nicht vorhanden
+        return;
+    }
+    while(result.items.size()) {
+        KsEngPropsHandle hpp = result.items.removeFirst();
+        if(!hpp) {
+            continue;
+        }
+        if(hpp->xdrTypeCode() == KS_OT_HISTORY) {
+            typ = (const char*)((KsHistoryEngProps &)(*hpp)).type_identifier;
+            acc = ((KsHistoryEngProps &)(*hpp)).access_mode;
+        } else {
+            typ = (const char*)((KsDomainEngProps &)(*hpp)).class_identifier;
+            acc = ((KsDomainEngProps &)(*hpp)).access_mode;
+        }
+        key = container;
+        key += (acc & KS_AC_PART) ? '.' : '/';
+        key += (const char*)hpp->identifier;
+        objects[key] = typ ? typ : "";
+    }
+}
+
+/*****************************************************************************/
+int IfbsExistIndex::exists(KscServerBase *Server,
+                           const char    *path,
+                           const char    *instClass,
+                           int            reread)
+/*****************************************************************************/
+{
+    std::unordered_map<std::string, std::string>::iterator it;
+
+    if( (!Server) || (!path) || (!(*path)) ) {
+        return 0;
+    }
+    std::string key(path);
+    std::string container(path, parentLen(path));
+
+    if(reread) {
+        listed.erase(container);
+    }
+    if(listed.find(container) == listed.end()) {
+        // Container noch nicht gelesen
+        listContainer(Server, container);
+    }
+    it = objects.find(key);
+
+    return (it != objects.end()) && ((!instClass) || (it->second == instClass));
+}
+
+/*****************************************************************************/
+void IfbsExistIndex::setCreated(const char *path, const char *instClass, int empty)
+/*****************************************************************************/
+{
+    if(!instClass) {
+        instClass = "";
+    }
+    if(journal) {
+        // Eintrag : Pfad \0 Klasse \0 leer
+        journal->append(path, strlen(path) + 1);
+        journal->append(instClass, strlen(instClass) + 1);
+        journal->push_back(empty ? '1' : '0');
+    }
+
+    objects[std::string(path)] = instClass;
+    if(empty) {
+        // Neue Instanz ist leer. Vom Konstruktor angelegte Kinder werden
+        // erst mit reread gelesen
+        listed.insert(std::string(path));
+    } else {
+        listed.erase(std::string(path));
+    }
+}
+
+/*****************************************************************************/
+void IfbsExistIndex::clear()
+/*****************************************************************************/
+{
+    listed.clear();
+    objects.clear();
+}
+
+/*****************************************************************************/
+void IfbsExistIndex::replay(const char *data, size_t len)
+/*****************************************************************************/
+{
+    const char *end = data + len;
+    const char *path;
+    const char *instClass;
+
+    while(data < end) {
+        path = data;
+        data += strnlen(data, end - data) + 1;
+        if(data >= end) {
+            break;
+        }
+        instClass = data;
+        data += strnlen(data, end - data) + 1;
+        if(data >= end) {
+            break;
+        }
+        setCreated(path, instClass, *data == '1');
+        data++;
+    }
+}
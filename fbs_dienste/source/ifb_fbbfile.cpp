@@ -0,0 +1,1106 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_fbbfile.cpp                                                          *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Binaere Sicherungsdatei (.fbb). Enthaelt die Bloecke wie eine .fbd-      *
+*   Datei nach dem Parsen, Namen und Pfade in einer String-Tabelle, Werte    *
+*   typisiert. Beim Laden wird nur die Struktur aufgebaut, Werte werden      *
+*   ohne Umwandlung aus Text in KsValue uebernommen. Text entsteht nur fuer  *
+*   Vergleich und Protokoll (ifb_fbbValueText).                              *
+*                                                                            *
+*   Aufbau (alle Zahlen little-endian) :                                     *
+*     "iFBSbin1"                                                             *
+*     Bloecke   : u8 Art, u32 Laenge, Inhalt                                 *
+*       LIBRARY  : u32 Name                                                  *
+*       INSTANCE : u32 Pfad, u32 Klasse, u32 Anzahl Variablen, Variablen     *
+*                  Variable : u32 Name, u8 Port, u8 Typ, u8 Vektor,          *
+*                  u32 Laenge, u32 Status, Wert                              *
+*                  Wert : u8 Kodierung, u32 Elemente, u32 Bytes, Elemente    *
+*       LINK     : u32 Assoziation, Eltern-Rolle, -Klasse, -Pfad,            *
+*                  Kind-Rolle, -Klasse, u32 Anzahl Kinder, u32 Pfade         *
+*     Strings   : u32 Anzahl, je String u32 Laenge, Zeichen, Nullbyte        *
+*     Index     : u32 Anzahl, je Block u8 Art, u64 Position                  *
+*     Ende      : u64 Position Strings, u64 Position Index, "iFBSidx1"       *
+*   Die u32-Namen sind Nummern in der String-Tabelle.                        *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+#include <string>
+
+#define IFB_FBB_MAGIC           "iFBSbin1"
+#define IFB_FBB_INDEXMAGIC      "iFBSidx1"
+#define IFB_FBB_MAGICLEN        8
+#define IFB_FBB_FOOTERLEN       (16 + IFB_FBB_MAGICLEN)
+
+/* Kodierung eines Wertes */
+#define IFB_FBB_ENC_TYPED       1   /* Elemente binaer */
+#define IFB_FBB_ENC_TEXT        2   /* Elemente als Text wie in der .fbd-Datei */
+
+/* Groesse eines typisierten Elements */
+#define IFB_FBB_TIMESIZE        12  /* u16 Jahr, u8 Monat, Tag, Stunde, Minute, Sekunde, 0, u32 usec */
+
+/*
+*   Zahlen little-endian schreiben und lesen
+*/
+static void ifb_fbbPut8(std::string &buf, unsigned int v) {
+    buf += (char)(v & 0xff);
+}
+
+static void ifb_fbbPut16(std::string &buf, unsigned int v) {
+    buf += (char)(v & 0xff);
+    buf += (char)((v >> 8) & 0xff);
+}
+
+static void ifb_fbbPut32(std::string &buf, unsigned long v) {
+    buf += (char)(v & 0xff);
+    buf += (char)((v >> 8) & 0xff);
+    buf += (char)((v >> 16) & 0xff);
+    buf += (char)((v >> 24) & 0xff);
+}
+
+static void ifb_fbbPut64(std::string &buf, unsigned long long v) {
+    ifb_fbbPut32(buf, (unsigned long)(v & 0xffffffffUL));
+    ifb_fbbPut32(buf, (unsigned long)(v >> 32));
+}
+
+static unsigned int ifb_fbbGet16(const unsigned char *p) {
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8);
+}
+
+static unsigned long ifb_fbbGet32(const unsigned char *p) {
+    return (unsigned long)p[0] | ((unsigned long)p[1] << 8) |
+           ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+static unsigned long long ifb_fbbGet64(const unsigned char *p) {
+    return (unsigned long long)ifb_fbbGet32(p) | ((unsigned long long)ifb_fbbGet32(p + 4) << 32);
+}
+
+// Vorzeichenbehaftete 32-Bit-Zahl
+static long ifb_fbbGetS32(const unsigned char *p) {
+    unsigned long v = ifb_fbbGet32(p);
+    return (v & 0x80000000UL) ? -(long)((~v & 0xffffffffUL) + 1) : (long)v;
+}
+
+static float ifb_fbbGetFloat(const unsigned char *p) {
+    unsigned long   v = ifb_fbbGet32(p);
+    unsigned int    u = (unsigned int)v;
+    float           f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static double ifb_fbbGetDouble(const unsigned char *p) {
+    unsigned long long  v = ifb_fbbGet64(p);
+    double              d;
+    memcpy(&d, &v, sizeof(d));
+    return d;
+}
+
+/*
+*   Groesse eines typisierten Elements, 0 wenn der Typ nicht typisiert
+*   gespeichert wird
+*/
+static size_t ifb_fbbElemSize(KS_VAR_TYPE typ) {
+    switch(typ) {
+        case KS_VT_BOOL:        return 1;
+        case KS_VT_INT:
+        case KS_VT_UINT:
+        case KS_VT_SINGLE:      return 4;
+        case KS_VT_DOUBLE:
+        case KS_VT_TIME_SPAN:   return 8;
+        case KS_VT_TIME:        return IFB_FBB_TIMESIZE;
+        default:                return 0;
+    }
+}
+
+/*
+*   Element als Text wie beim Sichern (ifb_getValueOnly)
+*/
+static void ifb_fbbFormat(KS_VAR_TYPE typ, const unsigned char *p, char *help) {
+    KsString    Value;
+
+    switch(typ) {
+        case KS_VT_BOOL:
+            strcpy(help, p[0] ? "TRUE" : "FALSE");
+            break;
+        case KS_VT_INT:
+            sprintf(help, "%ld", ifb_fbbGetS32(p));
+            break;
+        case KS_VT_UINT:
+            sprintf(help, "%lu", ifb_fbbGet32(p));
+            break;
+        case KS_VT_SINGLE:
+        case KS_VT_DOUBLE:
+            if(typ == KS_VT_SINGLE) {
+                sprintf(help, "%#f", ifb_fbbGetFloat(p));
+            } else {
+                sprintf(help, "%#f", (float)ifb_fbbGetDouble(p));
+            }
+            if(strchr(help, ',')) {
+                Value = help;
+                fixFloatValue(Value);
+                strncpy(help, (const char*)Value, 63);
+                help[63] = '\0';
+            }
+            break;
+        case KS_VT_TIME:
+            sprintf(help, "%4.4u-%2.2u-%2.2u %2.2u:%2.2u:%2.2u.%6.6lu",
+                    ifb_fbbGet16(p), p[2], p[3], p[4], p[5], p[6], ifb_fbbGet32(p + 8));
+            break;
+        case KS_VT_TIME_SPAN:
+            sprintf(help, "%ld.%6.6ld", ifb_fbbGetS32(p), ifb_fbbGetS32(p + 4));
+            break;
+        default:
+            help[0] = '\0';
+            break;
+    }
+}
+
+/*
+*   Element typisiert anhaengen. Liefert 1, wenn der Text daraus genau
+*   wieder entsteht, sonst 0 (buf unveraendert)
+*/
+static int ifb_fbbEncode(KS_VAR_TYPE typ, const char *text, std::string &buf) {
+    size_t          start = buf.size();
+    char            help[64];
+    char           *pEnd;
+    long            v;
+    float           f;
+    double          d;
+    unsigned int    u;
+    unsigned long long  w;
+    int             year, mon, day, hour, min, sec;
+    long            usec;
+    char            c;
+
+    if(!text) {
+        return 0;
+    }
+    switch(typ) {
+        case KS_VT_BOOL:
+            if(!strcmp(text, "TRUE")) {
+                ifb_fbbPut8(buf, 1);
+            } else if(!strcmp(text, "FALSE")) {
+                ifb_fbbPut8(buf, 0);
+            } else {
+                return 0;
+            }
+            return 1;
+        case KS_VT_INT:
+        case KS_VT_UINT:
+            // Nur Werte, die auch atoi() beim Laden aus Text genau liefert
+            v = strtol(text, &pEnd, 10);
+            if( (pEnd == text) || *pEnd || (v > 2147483647L) || (v < -2147483647L) ||
+                ((typ == KS_VT_UINT) && (v < 0)) ) {
+                return 0;
+            }
+            ifb_fbbPut32(buf, (unsigned long)v & 0xffffffffUL);
+            break;
+        case KS_VT_SINGLE:
+            f = (float)atof(text);
+            memcpy(&u, &f, sizeof(u));
+            ifb_fbbPut32(buf, u);
+            break;
+        case KS_VT_DOUBLE:
+            d = (double)atof(text);
+            memcpy(&w, &d, sizeof(w));
+            ifb_fbbPut64(buf, w);
+            break;
+        case KS_VT_TIME:
+            if(sscanf(text, "%d-%d-%d %d:%d:%d.%ld%c",
+                      &year, &mon, &day, &hour, &min, &sec, &usec, &c) != 7) {
+                return 0;
+            }
+            if( (year < 0) || (year > 9999) || (mon < 0) || (mon > 99) || (day < 0) || (day > 99) ||
+                (hour < 0) || (hour > 99) || (min < 0) || (min > 99) || (sec < 0) || (sec > 99) ||
+                (usec < 0) || (usec > 999999L) ) {
+                return 0;
+            }
+            ifb_fbbPut16(buf, (unsigned int)year);
+            ifb_fbbPut8(buf, (unsigned int)mon);
+            ifb_fbbPut8(buf, (unsigned int)day);
+            ifb_fbbPut8(buf, (unsigned int)hour);
+            ifb_fbbPut8(buf, (unsigned int)min);
+            ifb_fbbPut8(buf, (unsigned int)sec);
+            ifb_fbbPut8(buf, 0);
+            ifb_fbbPut32(buf, (unsigned long)usec);
+            break;
+        case KS_VT_TIME_SPAN:
+            if(sscanf(text, "%ld.%ld%c", &v, &usec, &c) != 2) {
+                return 0;
+            }
+            if( (v > 2147483647L) || (v < -2147483647L) || (usec < 0) || (usec > 999999L) ) {
+                return 0;
+            }
+            ifb_fbbPut32(buf, (unsigned long)v & 0xffffffffUL);
+            ifb_fbbPut32(buf, (unsigned long)usec);
+            break;
+        default:
+            return 0;
+    }
+
+    // Verlustfrei nur, wenn der Text wieder genau so entsteht
+    ifb_fbbFormat(typ, (const unsigned char*)buf.data() + start, help);
+    if(strcmp(help, text)) {
+        buf.resize(start);
+        return 0;
+    }
+    return 1;
+}
+
+/*****************************************************************************/
+unsigned long IfbsFbbWriter::str(const char *s)
+/*****************************************************************************/
+{
+    if(!s) {
+        s = "";
+    }
+    std::pair<std::unordered_map<std::string, unsigned long>::iterator, bool> res =
+        strIdx.insert(std::make_pair(std::string(s), (unsigned long)strs.size()));
+    if(res.second) {
+        // Schluessel bleibt an seiner Stelle, der Parser gibt s frei
+        strs.push_back(res.first->first.c_str());
+    }
+    return res.first->second;
+}
+
+/*****************************************************************************/
+void IfbsFbbWriter::putStr(const char *s)
+/*****************************************************************************/
+{
+    ifb_fbbPut32(buf, str(s));
+}
+
+/*****************************************************************************/
+void IfbsFbbWriter::flush()
+/*****************************************************************************/
+{
+    if(buf.size()) {
+        Sink.put(buf.data(), buf.size());
+        pos += buf.size();
+        buf.clear();
+    }
+}
+
+// Blocklaenge eintragen und Block im Index vermerken
+/*****************************************************************************/
+void IfbsFbbWriter::endBlock(int kind, size_t start)
+/*****************************************************************************/
+{
+    unsigned long len = (unsigned long)(buf.size() - start - 5);
+
+    buf[start + 1] = (char)(len & 0xff);
+    buf[start + 2] = (char)((len >> 8) & 0xff);
+    buf[start + 3] = (char)((len >> 16) & 0xff);
+    buf[start + 4] = (char)((len >> 24) & 0xff);
+
+    ifb_fbbPut8(index, (unsigned int)kind);
+    ifb_fbbPut64(index, pos + start);
+    anzBlocks++;
+
+    if(buf.size() >= IFBS_OUTSINK_CHUNKSIZE) {
+        flush();
+    }
+}
+
+/*****************************************************************************/
+void IfbsFbbWriter::putValue(Variables *pv)
+/*****************************************************************************/
+{
+    VariableItem   *pvi;
+    size_t          start;
+    size_t          anz = 0;
+    int             enc = IFB_FBB_ENC_TYPED;
+
+    if(pv->value && pv->value->fbb_value) {
+        // Typisierter Wert aus einer .fbb-Datei : unveraendert uebernehmen
+        const char *p = pv->value->fbb_value;
+        buf.append(p, 9 + ifb_fbbGet32((const unsigned char*)p + 5));
+        return;
+    }
+
+    for(pvi = pv->value; pvi; pvi = pvi->next) {
+        anz++;
+    }
+    if(!ifb_fbbElemSize(pv->var_typ)) {
+        enc = IFB_FBB_ENC_TEXT;
+    }
+
+    start = buf.size();
+    ifb_fbbPut8(buf, IFB_FBB_ENC_TYPED);
+    ifb_fbbPut32(buf, (unsigned long)anz);
+    ifb_fbbPut32(buf, 0);
+
+    if(enc == IFB_FBB_ENC_TYPED) {
+        for(pvi = pv->value; pvi; pvi = pvi->next) {
+            if(!ifb_fbbEncode(pv->var_typ, pvi->val, buf)) {
+                // Ein Element nicht verlustfrei : Wert als Text
+                buf.resize(start + 9);
+                enc = IFB_FBB_ENC_TEXT;
+                break;
+            }
+        }
+    }
+    if(enc == IFB_FBB_ENC_TEXT) {
+        buf[start] = (char)IFB_FBB_ENC_TEXT;
+        for(pvi = pv->value; pvi; pvi = pvi->next) {
+            const char *val = pvi->val ? pvi->val : "";
+            size_t      len = strlen(val);
+            ifb_fbbPut32(buf, (unsigned long)len);
+            buf.append(val, len + 1);
+        }
+    }
+
+    unsigned long len = (unsigned long)(buf.size() - start - 9);
+    buf[start + 5] = (char)(len & 0xff);
+    buf[start + 6] = (char)((len >> 8) & 0xff);
+    buf[start + 7] = (char)((len >> 16) & 0xff);
+    buf[start + 8] = (char)((len >> 24) & 0xff);
+}
+
+/*****************************************************************************/
+void IfbsFbbWriter::putVariable(Variables *pv)
+/*****************************************************************************/
+{
+    putStr(pv->var_name);
+    ifb_fbbPut8(buf, (unsigned int)pv->port_typ);
+    ifb_fbbPut8(buf, (unsigned int)pv->var_typ);
+    ifb_fbbPut8(buf, pv->vector ? 1 : 0);
+    ifb_fbbPut32(buf, (unsigned long)pv->len);
+    ifb_fbbPut32(buf, (unsigned long)pv->state);
+    putValue(pv);
+}
+
+/*****************************************************************************/
+void IfbsFbbWriter::begin()
+/*****************************************************************************/
+{
+    pos = 0;
+    anzBlocks = 0;
+    strIdx.clear();
+    strs.clear();
+    index.clear();
+    buf.assign(IFB_FBB_MAGIC, IFB_FBB_MAGICLEN);
+}
+
+// Bloecke in der Reihenfolge der Sicherung
+/*****************************************************************************/
+void IfbsFbbWriter::add(Dienst_param *par)
+/*****************************************************************************/
+{
+    DelInstItems   *plib;
+    InstanceItems  *pinst;
+    Variables      *pv;
+    LinksItems     *plink;
+    Child          *pchild;
+    size_t          start;
+    size_t          anz;
+
+    for(plib = par->NewLibs; plib; plib = plib->next) {
+        start = buf.size();
+        ifb_fbbPut8(buf, FB_BLOCK_LIBRARY);
+        ifb_fbbPut32(buf, 0);
+        putStr(plib->Inst_name);
+        endBlock(FB_BLOCK_LIBRARY, start);
+    }
+    for(pinst = par->Instance; pinst; pinst = pinst->next) {
+        start = buf.size();
+        ifb_fbbPut8(buf, FB_BLOCK_INSTANCE);
+        ifb_fbbPut32(buf, 0);
+        putStr(pinst->Inst_name);
+        putStr(pinst->Class_name);
+        anz = 0;
+        for(pv = pinst->Inst_var; pv; pv = pv->next) {
+            anz++;
+        }
+        ifb_fbbPut32(buf, (unsigned long)anz);
+        for(pv = pinst->Inst_var; pv; pv = pv->next) {
+            putVariable(pv);
+        }
+        endBlock(FB_BLOCK_INSTANCE, start);
+    }
+    for(plink = par->Links; plink; plink = plink->next) {
+        start = buf.size();
+        ifb_fbbPut8(buf, FB_BLOCK_LINK);
+        ifb_fbbPut32(buf, 0);
+        putStr(plink->asso_ident);
+        putStr(plink->parent_role);
+        putStr(plink->parent_class);
+        putStr(plink->parent_path);
+        putStr(plink->child_role);
+        putStr(plink->child_class);
+        anz = 0;
+        for(pchild = plink->children; pchild; pchild = pchild->next) {
+            anz++;
+        }
+        ifb_fbbPut32(buf, (unsigned long)anz);
+        for(pchild = plink->children; pchild; pchild = pchild->next) {
+            putStr(pchild->child_path);
+        }
+        endBlock(FB_BLOCK_LINK, start);
+    }
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsFbbWriter::finish()
+/*****************************************************************************/
+{
+    size_t              i;
+    unsigned long long  strPos;
+    unsigned long long  idxPos;
+
+    // String-Tabelle
+    strPos = pos + buf.size();
+    ifb_fbbPut32(buf, (unsigned long)strs.size());
+    for(i = 0; i < strs.size(); i++) {
+        size_t len = strlen(strs[i]);
+        ifb_fbbPut32(buf, (unsigned long)len);
+        buf.append(strs[i], len + 1);
+        if(buf.size() >= IFBS_OUTSINK_CHUNKSIZE) {
+            flush();
+        }
+    }
+
+    // Index der Bloecke und Ende
+    idxPos = pos + buf.size();
+    ifb_fbbPut32(buf, anzBlocks);
+    flush();
+    Sink.put(index.data(), index.size());
+    ifb_fbbPut64(buf, strPos);
+    ifb_fbbPut64(buf, idxPos);
+    buf.append(IFB_FBB_INDEXMAGIC, IFB_FBB_MAGICLEN);
+    flush();
+
+    return Sink.flush();
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsFbbWriter::write(Dienst_param *par)
+/*****************************************************************************/
+{
+    begin();
+    add(par);
+    return finish();
+}
+
+/*****************************************************************************/
+KS_RESULT IFBS_WriteFbb(Dienst_param *par, IfbsOutSink &Sink)
+/*****************************************************************************/
+{
+    IfbsFbbWriter Writer(Sink);
+
+    return Writer.write(par);
+}
+
+/*****************************************************************************/
+int IFBS_IsFbbName(const char *filename)
+/*****************************************************************************/
+{
+    size_t  len;
+
+    if(!filename) {
+        return 0;
+    }
+    // Endung der Kompression nicht beachten
+    len = strlen(filename) - strlen(IFBS_CompressionExt(IFBS_CompressionFromName(filename)));
+    return ( (len > 4) && !strncmp(filename + len - 4, ".fbb", 4) );
+}
+
+/*****************************************************************************/
+int IFBS_IsFbbData(const char *data, size_t len)
+/*****************************************************************************/
+{
+    return ( (len >= IFB_FBB_MAGICLEN) && !memcmp(data, IFB_FBB_MAGIC, IFB_FBB_MAGICLEN) );
+}
+
+/*****************************************************************************/
+int IFBS_IsFbbInput(FB_PARSE_CONTEXT *ctx)
+/*****************************************************************************/
+{
+    return ( ctx->input && (ctx->input_size >= IFB_FBB_MAGICLEN + IFB_FBB_FOOTERLEN) &&
+             IFBS_IsFbbData(ctx->input, ctx->input_size) );
+}
+
+/*
+*   Lesen einer .fbb-Datei in die Strukturen einer Parse-Sitzung
+*/
+class IfbFbbReader {
+public :
+    IfbFbbReader(FB_PARSE_CONTEXT *ctx)
+    : ctx(ctx), base((const unsigned char*)ctx->input), size(ctx->input_size) {}
+
+    int                 read();
+
+private :
+    int                 error(const char *msg);
+    int                 get32(size_t &p, unsigned long &v);
+    int                 getStr(size_t &p, char *&s);
+    int                 readLibrary(size_t p, size_t end, DelInstItems *&plib);
+    int                 readInstance(size_t p, size_t end, InstanceItems *&pinst);
+    int                 readVariable(size_t &p, size_t end, Variables *&pv);
+    int                 readLink(size_t p, size_t end, LinksItems *&plink);
+
+    FB_PARSE_CONTEXT           *ctx;
+    const unsigned char        *base;
+    size_t                      size;
+    std::vector<char*>          strs;
+};
+
+/*****************************************************************************/
+int IfbFbbReader::error(const char *msg)
+/*****************************************************************************/
+{
+    ctx->error_line = 0;
+    strncpy(ctx->error_msg, msg, sizeof(ctx->error_msg) - 1);
+    ctx->error_msg[sizeof(ctx->error_msg) - 1] = 0;
+    return EXIT_FAILURE;
+}
+
+/*****************************************************************************/
+int IfbFbbReader::get32(size_t &p, unsigned long &v)
+/*****************************************************************************/
+{
+    if(p + 4 > size) {
+        return 0;
+    }
+    v = ifb_fbbGet32(base + p);
+    p += 4;
+    return 1;
+}
+
+/*****************************************************************************/
+int IfbFbbReader::getStr(size_t &p, char *&s)
+/*****************************************************************************/
+{
+    unsigned long idx;
+
+    if( (!get32(p, idx)) || (idx >= strs.size()) ) {
+        return 0;
+    }
+    s = strs[idx];
+    return 1;
+}
+
+/*****************************************************************************/
+int IfbFbbReader::readLibrary(size_t p, size_t end, DelInstItems *&plib)
+/*****************************************************************************/
+{
+    plib = (DelInstItems*)fb_parser_alloc(ctx, sizeof(DelInstItems));
+    if(!plib) {
+        return 0;
+    }
+    plib->next = 0;
+    return ( getStr(p, plib->Inst_name) && (p == end) );
+}
+
+/*****************************************************************************/
+int IfbFbbReader::readVariable(size_t &p, size_t end, Variables *&pv)
+/*****************************************************************************/
+{
+    unsigned long   len, state, anz, bytes, i;
+    const unsigned char *pVal;
+    size_t          elem;
+    int             enc;
+    VariableItem   *pvi;
+    VariableItem  **ppNext;
+
+    pv = (Variables*)fb_parser_alloc(ctx, sizeof(Variables));
+    if(!pv) {
+        return 0;
+    }
+    pv->next = 0;
+    if( (!getStr(p, pv->var_name)) || (p + 3 > end) ) {
+        return 0;
+    }
+    pv->port_typ = (PortType)base[p];
+    pv->var_typ = (KS_VAR_TYPE)base[p + 1];
+    pv->vector = base[p + 2] ? 1 : 0;
+    p += 3;
+    if( (!get32(p, len)) || (!get32(p, state)) || (p + 9 > end) ) {
+        return 0;
+    }
+    pv->len = (int)len;
+    pv->state = (int)ifb_fbbGetS32(base + p - 4);
+
+    pVal = base + p;
+    enc = base[p];
+    anz = ifb_fbbGet32(base + p + 1);
+    bytes = ifb_fbbGet32(base + p + 5);
+    p += 9;
+    if(bytes > end - p) {
+        return 0;
+    }
+    end = p + bytes;
+
+    elem = ifb_fbbElemSize(pv->var_typ);
+    if(enc == IFB_FBB_ENC_TYPED) {
+        if( (!elem) || (bytes % elem) || (anz != bytes / elem) ) {
+            return 0;
+        }
+    } else if(enc != IFB_FBB_ENC_TEXT) {
+        return 0;
+    }
+
+    pv->value = 0;
+    ppNext = &pv->value;
+    for(i = 0; i < anz; i++) {
+        pvi = (VariableItem*)fb_parser_alloc(ctx, sizeof(VariableItem));
+        if(!pvi) {
+            return 0;
+        }
+        pvi->value_type = (DataType)pv->var_typ;
+        pvi->fbb_value = 0;
+        pvi->next = 0;
+        if(enc == IFB_FBB_ENC_TYPED) {
+            // Kein Text. Geladen wird der Wert, Vergleich und Protokoll
+            // formatieren ihn mit ifb_fbbValueText()
+            pvi->val = 0;
+            p += elem;
+        } else {
+            // Text bleibt in der Eingabe
+            if( (end - p < 4) || (!get32(p, len)) || (len >= end - p) || base[p + len] ) {
+                return 0;
+            }
+            pvi->val = (char*)base + p;
+            p += len + 1;
+        }
+        *ppNext = pvi;
+        ppNext = &pvi->next;
+    }
+    if(p != end) {
+        return 0;
+    }
+    if( (enc == IFB_FBB_ENC_TYPED) && pv->value ) {
+        pv->value->fbb_value = (const char*)pVal;
+    }
+    return 1;
+}
+
+/*****************************************************************************/
+int IfbFbbReader::readInstance(size_t p, size_t end, InstanceItems *&pinst)
+/*****************************************************************************/
+{
+    unsigned long   anz, i;
+    char           *cls;
+    Variables      *pv;
+    Variables     **ppNext;
+
+    pinst = (InstanceItems*)fb_parser_alloc(ctx, sizeof(InstanceItems));
+    if(!pinst) {
+        return 0;
+    }
+    pinst->next = 0;
+    pinst->Inst_var = 0;
+    if( (!getStr(p, pinst->Inst_name)) || (!getStr(p, cls)) || (!get32(p, anz)) ) {
+        return 0;
+    }
+    pinst->Class_name = cls;
+
+    ppNext = &pinst->Inst_var;
+    for(i = 0; i < anz; i++) {
+        if(!readVariable(p, end, pv)) {
+            return 0;
+        }
+        *ppNext = pv;
+        ppNext = &pv->next;
+    }
+    return (p == end);
+}
+
+/*****************************************************************************/
+int IfbFbbReader::readLink(size_t p, size_t end, LinksItems *&plink)
+/*****************************************************************************/
+{
+    unsigned long   anz, i;
+    Child          *pchild;
+    Child         **ppNext;
+
+    plink = (LinksItems*)fb_parser_alloc(ctx, sizeof(LinksItems));
+    if(!plink) {
+        return 0;
+    }
+    plink->next = 0;
+    plink->children = 0;
+    if( (!getStr(p, plink->asso_ident))   || (!getStr(p, plink->parent_role)) ||
+        (!getStr(p, plink->parent_class)) || (!getStr(p, plink->parent_path)) ||
+        (!getStr(p, plink->child_role))   || (!getStr(p, plink->child_class)) ||
+        (!get32(p, anz)) || (anz == 0) ) {
+        return 0;
+    }
+    ppNext = &plink->children;
+    for(i = 0; i < anz; i++) {
+        pchild = (Child*)fb_parser_alloc(ctx, sizeof(Child));
+        if( (!pchild) || (!getStr(p, pchild->child_path)) ) {
+            return 0;
+        }
+        pchild->next = 0;
+        *ppNext = pchild;
+        ppNext = &pchild->next;
+    }
+    return (p <= end);
+}
+
+/*****************************************************************************/
+int IfbFbbReader::read()
+/*****************************************************************************/
+{
+    unsigned long long  strPos;
+    unsigned long long  idxPos;
+    unsigned long       anz, len, i;
+    unsigned long long  blkPos;
+    size_t              p, end;
+    int                 kind;
+    DelInstItems       *plib;
+    InstanceItems      *pinst;
+    LinksItems         *plink;
+    DelInstItems      **ppLib;
+    InstanceItems     **ppInst;
+    LinksItems        **ppLink;
+
+    // Ende mit Positionen von String-Tabelle und Index
+    p = size - IFB_FBB_FOOTERLEN;
+    if(memcmp(base + p + 16, IFB_FBB_INDEXMAGIC, IFB_FBB_MAGICLEN)) {
+        return error("Bad binary file (incomplete)");
+    }
+    strPos = ifb_fbbGet64(base + p);
+    idxPos = ifb_fbbGet64(base + p + 8);
+    if( (strPos < IFB_FBB_MAGICLEN) || (strPos + 4 > idxPos) || (idxPos + 4 > p) ) {
+        return error("Bad binary file (index)");
+    }
+
+    // String-Tabelle. Die Strings bleiben in der Eingabe
+    p = (size_t)strPos;
+    get32(p, anz);
+    if(anz > (idxPos - p) / 5) {
+        return error("Bad binary file (strings)");
+    }
+    strs.resize(anz);
+    for(i = 0; i < anz; i++) {
+        if( (idxPos - p < 4) || (!get32(p, len)) || (len >= idxPos - p) || base[p + len] ) {
+            return error("Bad binary file (strings)");
+        }
+        strs[i] = (char*)base + p;
+        p += len + 1;
+    }
+
+    // Bloecke ueber den Index
+    p = (size_t)idxPos;
+    get32(p, anz);
+    if(anz > (size - IFB_FBB_FOOTERLEN - p) / 9) {
+        return error("Bad binary file (index)");
+    }
+    ppLib = &ctx->par->NewLibs;
+    while(*ppLib) ppLib = &(*ppLib)->next;
+    ppInst = &ctx->par->Instance;
+    while(*ppInst) ppInst = &(*ppInst)->next;
+    ppLink = &ctx->par->Links;
+    while(*ppLink) ppLink = &(*ppLink)->next;
+
+    for(i = 0; i < anz; i++, p += 9) {
+        kind = base[p];
+        blkPos = ifb_fbbGet64(base + p + 1);
+        if( (blkPos < IFB_FBB_MAGICLEN) || (blkPos + 5 > strPos) ||
+            (base[blkPos] != kind) ) {
+            return error("Bad binary file (block)");
+        }
+        len = ifb_fbbGet32(base + blkPos + 1);
+        if(len > strPos - blkPos - 5) {
+            return error("Bad binary file (block)");
+        }
+        end = (size_t)blkPos + 5 + len;
+
+        switch(kind) {
+            case FB_BLOCK_LIBRARY:
+                if(!readLibrary((size_t)blkPos + 5, end, plib)) {
+                    return error("Bad binary file (library)");
+                }
+                *ppLib = plib;
+                ppLib = &plib->next;
+                break;
+            case FB_BLOCK_INSTANCE:
+                if(!readInstance((size_t)blkPos + 5, end, pinst)) {
+                    return error("Bad binary file (instance)");
+                }
+                *ppInst = pinst;
+                ppInst = &pinst->next;
+                break;
+            case FB_BLOCK_LINK:
+                if(!readLink((size_t)blkPos + 5, end, plink)) {
+                    return error("Bad binary file (link)");
+                }
+                *ppLink = plink;
+                ppLink = &plink->next;
+                break;
+            default:
+                return error("Bad binary file (block)");
+        }
+        if(!ctx->first_block) {
+            ctx->first_block = kind;
+        }
+        ctx->last_block = kind;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*****************************************************************************/
+int IFBS_ReadFbb(FB_PARSE_CONTEXT *ctx)
+/*****************************************************************************/
+{
+    if(!IFBS_IsFbbInput(ctx)) {
+        return EXIT_FAILURE;
+    }
+    // Strings zeigen in die Eingabe, sie wird nur einmal gelesen
+    ctx->input_used = 1;
+    ctx->input_inplace = 1;
+
+    IfbFbbReader Reader(ctx);
+
+    return Reader.read();
+}
+
+/*
+*   Text des Elements idx einer Variable. Typisierte Elemente einer .fbb-
+*   Datei haben keinen Text, sie werden erst hier in help formatiert
+*/
+/*****************************************************************************/
+const char* ifb_fbbValueText(Variables     *pv,
+                             VariableItem  *pvi,
+                             size_t         idx,
+                             char          *help)
+/*****************************************************************************/
+{
+    const unsigned char *p;
+    size_t               elem;
+
+    if(pvi->val) {
+        return pvi->val;
+    }
+    p = pv->value ? (const unsigned char*)pv->value->fbb_value : 0;
+    elem = ifb_fbbElemSize(pv->var_typ);
+    if( (!p) || (!elem) || (idx >= ifb_fbbGet32(p + 1)) ) {
+        help[0] = '\0';
+        return help;
+    }
+    ifb_fbbFormat(pv->var_typ, p + 9 + idx * elem, help);
+    return help;
+}
+
+/*
+*   KsValue aus dem typisierten Wert einer .fbb-Datei (fbb_value)
+*/
+/*****************************************************************************/
+KsValue* ifb_fbbNewKsValue(KS_RESULT           &err,
+                           const char          *pValue,
+                           KS_VAR_TYPE          Typ)
+/*****************************************************************************/
+{
+    const unsigned char *p = (const unsigned char*)pValue;
+    size_t          anz, c;
+    struct tm       time;
+    KsValue        *pval = 0;
+
+    err = KS_ERR_OK;
+    if( (!p) || (p[0] != IFB_FBB_ENC_TYPED) ) {
+        err = KS_ERR_BADPARAM;
+        return 0;
+    }
+    anz = (size_t)ifb_fbbGet32(p + 1);
+    p += 9;
+
+    switch(Typ) {
+        case KS_VT_BOOL:
+            pval = new KsBoolValue(p[0] ? 1 : 0);
+            break;
+        case KS_VT_INT:
+            pval = new KsIntValue(ifb_fbbGetS32(p));
+            break;
+        case KS_VT_UINT:
+            pval = new KsUIntValue(ifb_fbbGet32(p));
+            break;
+        case KS_VT_SINGLE:
+            pval = new KsSingleValue(ifb_fbbGetFloat(p));
+            break;
+        case KS_VT_DOUBLE:
+            pval = new KsDoubleValue(ifb_fbbGetDouble(p));
+            break;
+        case KS_VT_TIME:
+            // Ortszeit wie beim Laden aus Text
+            memset(&time, 0, sizeof(time));
+            time.tm_year = (int)ifb_fbbGet16(p) - 1900;
+            time.tm_mon  = (int)p[2] - 1;
+            time.tm_mday = p[3];
+            time.tm_hour = p[4];
+            time.tm_min  = p[5];
+            time.tm_sec  = p[6];
+            time.tm_isdst = -1;
+            pval = new KsTimeValue(mktime(&time), (long)ifb_fbbGet32(p + 8));
+            break;
+        case KS_VT_TIME_SPAN:
+            pval = new KsTimeSpanValue(ifb_fbbGetS32(p), ifb_fbbGetS32(p + 4));
+            break;
+        case KS_VT_BOOL_VEC:
+            {
+                KsBoolVecValue *vec = new KsBoolVecValue(anz);
+                for(c = 0; vec && (c < anz); c++) {
+                    (*vec)[c] = p[c] ? TRUE : FALSE;
+                }
+                pval = vec;
+            }
+            break;
+        case KS_VT_INT_VEC:
+            {
+                KsIntVecValue *vec = new KsIntVecValue(anz);
+                for(c = 0; vec && (c < anz); c++) {
+                    (*vec)[c] = ifb_fbbGetS32(p + 4*c);
+                }
+                pval = vec;
+            }
+            break;
+        case KS_VT_UINT_VEC:
+            {
+                KsUIntVecValue *vec = new KsUIntVecValue(anz);
+                for(c = 0; vec && (c < anz); c++) {
+                    (*vec)[c] = ifb_fbbGet32(p + 4*c);
+                }
+                pval = vec;
+            }
+            break;
+        case KS_VT_SINGLE_VEC:
+            {
+                KsSingleVecValue *vec = new KsSingleVecValue(anz);
+                for(c = 0; vec && (c < anz); c++) {
+                    (*vec)[c] = ifb_fbbGetFloat(p + 4*c);
+                }
+                pval = vec;
+            }
+            break;
+        case KS_VT_DOUBLE_VEC:
+            {
+                KsDoubleVecValue *vec = new KsDoubleVecValue(anz);
+                for(c = 0; vec && (c < anz); c++) {
+                    (*vec)[c] = ifb_fbbGetDouble(p + 8*c);
+                }
+                pval = vec;
+            }
+            break;
+        case KS_VT_TIME_VEC:
+            {
+                KsTimeVecValue *vec = new KsTimeVecValue(anz);
+                for(c = 0; vec && (c < anz); c++) {
+                    const unsigned char *pt = p + IFB_FBB_TIMESIZE*c;
+                    memset(&time, 0, sizeof(time));
+                    time.tm_year = (int)ifb_fbbGet16(pt) - 1900;
+                    time.tm_mon  = (int)pt[2] - 1;
+                    time.tm_mday = pt[3];
+                    time.tm_hour = pt[4];
+                    time.tm_min  = pt[5];
+                    time.tm_sec  = pt[6];
+                    time.tm_isdst = -1;
+                    (*vec)[c].tv_sec = mktime(&time);
+                    (*vec)[c].tv_usec = (long)ifb_fbbGet32(pt + 8);
+                }
+                pval = vec;
+            }
+            break;
+        case KS_VT_TIME_SPAN_VEC:
+            {
+                KsTimeSpanVecValue *vec = new KsTimeSpanVecValue(anz);
+                for(c = 0; vec && (c < anz); c++) {
+                    (*vec)[c].tv_sec = ifb_fbbGetS32(p + 8*c);
+                    (*vec)[c].tv_usec = ifb_fbbGetS32(p + 8*c + 4);
+                }
+                pval = vec;
+            }
+            break;
+        default:
+            err = KS_ERR_NOTIMPLEMENTED;
+            return 0;
+    }
+    if(!pval) {
+        err = OV_ERR_HEAPOUTOFMEMORY;
+    }
+    return pval;
+}
+
+/*
+*   Konverter .fbd <-> .fbb. Die Art der Ausgabe bestimmt die Endung
+*/
+/*****************************************************************************/
+KS_RESULT IFBS_FBDCONVERT(PltString &infile, PltString &outfile)
+/*****************************************************************************/
+{
+    FB_PARSE_CONTEXT   *ctx;
+    DelInstItems       *plib;
+    InstanceItems      *pinst;
+    LinksItems         *plink;
+    PltString           Out;
+    IfbsOutFile         File;
+    KS_RESULT           err;
+    KS_RESULT           writeErr;
+
+    ctx = fb_parser_create();
+    if(!ctx) {
+        return OV_ERR_HEAPOUTOFMEMORY;
+    }
+    if(!fb_parser_openfile(ctx, (const char*)infile)) {
+        fb_parser_destroy(ctx);
+        return OV_ERR_CANTOPENFILE;
+    }
+    if(IFBS_ParseInput(ctx) != EXIT_SUCCESS) {
+        iFBS_SetParserError(ctx);
+        fb_parser_destroy(ctx);
+        return KS_ERR_BADPARAM;
+    }
+
+    err = File.open((const char*)outfile, IFBS_IsFbbName((const char*)outfile));
+    if(err) {
+        fb_parser_destroy(ctx);
+        return err;
+    }
+
+    if(IFBS_IsFbbName((const char*)outfile)) {
+        err = IFBS_WriteFbb(ctx->par, File.sink());
+    } else {
+        // Text wie im Vergleich, Bloecke in der Reihenfolge der Sicherung
+        Out  = "/*********************************************************************\n";
+        Out += "* Datei : ";
+        Out += outfile;
+        Out += "\n*********************************************************************/\n";
+        File.sink().put(Out);
+        for(plib = ctx->par->NewLibs; plib; plib = plib->next) {
+            Out = "";
+            put_library(plib->Inst_name, 0, Out);
+            File.sink().put(Out);
+        }
+        for(pinst = ctx->par->Instance; pinst; pinst = pinst->next) {
+            Out = "";
+            put_instance(pinst, Out);
+            File.sink().put(Out);
+        }
+        for(plink = ctx->par->Links; plink; plink = plink->next) {
+            Out = "";
+            put_link(plink, "LINK", Out);
+            File.sink().put(Out);
+        }
+        err = File.sink().getError();
+    }
+
+    writeErr = File.close();
+    if(!err) {
+        err = writeErr;
+    }
+    fb_parser_destroy(ctx);
+
+    return err;
+}
@@ -0,0 +1,328 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_fbdreader.cpp                                                        *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Liest eine Sicherungsdatei blockweise. Blockenden (END_LIBRARY;,         *
+*   END_INSTANCE;, END_LINK; ausserhalb von Strings und Kommentaren) werden  *
+*   wie beim parallelen Parsen gesucht. Jeder Block wird einzeln in einer    *
+*   wiederverwendeten Parse-Sitzung geparst.                                 *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+/*****************************************************************************/
+IfbsFbdReader::IfbsFbdReader()
+/*****************************************************************************/
+  : len(0),
+    pos(0),
+    scan(0),
+    state(0),
+    line(0),
+    eof(0),
+    readErr(0),
+    pushed(0),
+    blockLen(0),
+    blockLine(0)
+{
+}
+
+/*****************************************************************************/
+int IfbsFbdReader::open(const char *filename)
+/*****************************************************************************/
+{
+    close();
+
+    // Komprimierte Dateien werden beim Lesen entpackt
+    if(file.open(filename) != KS_ERR_OK) {
+        return 0;
+    }
+    buf.resize(IFBS_FBDREAD_BUFSIZE);
+    block.assign(2, 0);
+    return 1;
+}
+
+/*****************************************************************************/
+void IfbsFbdReader::openText()
+/*****************************************************************************/
+{
+    close();
+
+    pushed = 1;
+    buf.resize(IFBS_FBDREAD_BUFSIZE);
+    block.assign(2, 0);
+}
+
+/*****************************************************************************/
+void IfbsFbdReader::feed(const char *text, size_t anz)
+/*****************************************************************************/
+{
+    if( (!pushed) || eof ) {
+        return;
+    }
+    discard();
+    if(len + anz > buf.size()) {
+        buf.resize( (len + anz > 2 * buf.size()) ? (len + anz) : (2 * buf.size()) );
+    }
+    memcpy(&buf[len], text, anz);
+    len += anz;
+}
+
+/*****************************************************************************/
+void IfbsFbdReader::finish()
+/*****************************************************************************/
+{
+    eof = 1;
+}
+
+/*****************************************************************************/
+void IfbsFbdReader::close()
+/*****************************************************************************/
+{
+    file.close();
+    len = 0;
+    pos = 0;
+    scan = 0;
+    state = 0;
+    line = 0;
+    eof = 0;
+    readErr = 0;
+    pushed = 0;
+    blockLen = 0;
+    blockLine = 0;
+}
+
+// Bereits gelieferte Bloecke verwerfen
+/*****************************************************************************/
+void IfbsFbdReader::discard()
+/*****************************************************************************/
+{
+    if(pos > 0) {
+        memmove(&buf[0], &buf[pos], len - pos);
+        len  -= pos;
+        scan -= pos;
+        pos = 0;
+    }
+}
+
+// Naechstes Stueck der Datei lesen. Reicht der Puffer nicht, wird er
+// vergroessert
+/*****************************************************************************/
+int IfbsFbdReader::fill()
+/*****************************************************************************/
+{
+    long    anz;
+
+    if(eof) {
+        return 0;
+    }
+    discard();
+    if(len == buf.size()) {
+        buf.resize(buf.size() * 2);
+    }
+    anz = file.read(&buf[len], buf.size() - len);
+    if(anz <= 0) {
+        if(anz < 0) {
+            readErr = 1;
+        }
+        eof = 1;
+        return 0;
+    }
+    len += (size_t)anz;
+    return 1;
+}
+
+static int ifb_isTokenChar(char c) {
+    return ( ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+             ((c >= '0') && (c <= '9')) || (c == '_') || (c == '%') ||
+             (c == '/') || (c == '.') );
+}
+
+/*
+*  Vor dem Pufferende bleiben so viele Zeichen ungeprueft, bis die Datei
+*  weiter gelesen ist (laengstes Blockende mit Leerzeichen)
+*/
+#define IFB_FBDREAD_LOOKAHEAD   64
+#define IFB_FBDREAD_WAIT        ((size_t)-1)
+
+// Beginnt bei i ein Blockende? Liefert die Position nach dem ';', 0 oder
+// IFB_FBDREAD_WAIT, wenn das Ende erst nach dem Weiterlesen feststeht
+/*****************************************************************************/
+size_t IfbsFbdReader::matchBlockEnd(size_t i)
+/*****************************************************************************/
+{
+    static const char  *Ends[3] = { "END_INSTANCE", "END_LINK", "END_LIBRARY" };
+    size_t              k, n = 0;
+
+    if( (i > pos) && ifb_isTokenChar(buf[i-1]) ) {
+        return 0;
+    }
+    for(k = 0; k < 3; k++) {
+        n = strlen(Ends[k]);
+        if( (len - i > n) && !strncmp(&buf[i], Ends[k], n) ) {
+            break;
+        }
+    }
+    if(k == 3) {
+        return 0;
+    }
+    i += n;
+    while( (i < len) && ((buf[i] == ' ') || (buf[i] == '\t')) ) {
+        i++;
+    }
+    if(i >= len) {
+        return eof ? 0 : IFB_FBDREAD_WAIT;
+    }
+    if(buf[i] == ';') {
+        return i + 1;
+    }
+    return 0;
+}
+
+// Erstes Zeichen nach Kommentaren und Leerzeichen
+/*****************************************************************************/
+size_t IfbsFbdReader::skipSpace(size_t start, size_t end)
+/*****************************************************************************/
+{
+    size_t  i = start;
+
+    while(i < end) {
+        if( (buf[i] == '/') && (i+1 < end) && (buf[i+1] == '*') ) {
+            for(i += 2; (i+1 < end) && !((buf[i] == '*') && (buf[i+1] == '/')); i++) {
+            }
+            i += 2;
+        } else if( (buf[i] == ' ') || (buf[i] == '\t') || (buf[i] == '\r') || (buf[i] == '\n') ) {
+            i++;
+        } else {
+            break;
+        }
+    }
+    return (i < end) ? i : end;
+}
+
+// Art des Blocks nach Kommentaren und Leerzeichen
+/*****************************************************************************/
+int IfbsFbdReader::blockKind(size_t start, size_t end)
+/*****************************************************************************/
+{
+    size_t  i = skipSpace(start, end);
+
+    if( (end - i > 8) && !strncmp(&buf[i], "INSTANCE", 8) && !ifb_isTokenChar(buf[i+8]) ) {
+        return FB_BLOCK_INSTANCE;
+    }
+    if( (end - i > 7) && !strncmp(&buf[i], "LIBRARY", 7) && !ifb_isTokenChar(buf[i+7]) ) {
+        return FB_BLOCK_LIBRARY;
+    }
+    if( (end - i > 4) && !strncmp(&buf[i], "LINK", 4) && !ifb_isTokenChar(buf[i+4]) ) {
+        return FB_BLOCK_LINK;
+    }
+    return -1;
+}
+
+/*****************************************************************************/
+int IfbsFbdReader::next()
+/*****************************************************************************/
+{
+    size_t  end = 0;
+    size_t  limit;
+    size_t  i;
+    char    c;
+
+    if( (!file.isOpen()) && (!pushed) ) {
+        return -1;
+    }
+    // Zeile am Beginn des Blocks. Mit feed() wird ein Block evtl. ueber
+    // mehrere Aufrufe untersucht
+    if(scan == pos) {
+        blockLine = line;
+    }
+
+    for(;;) {
+        if(eof) {
+            limit = len;
+        } else {
+            limit = (len > IFB_FBDREAD_LOOKAHEAD) ? (len - IFB_FBDREAD_LOOKAHEAD) : 0;
+        }
+        // Zeilen werden wie im Scanner gezaehlt (nicht in Strings)
+        for(i = scan; i < limit; i++) {
+            c = buf[i];
+            if(state == 1) {
+                if( (c == '"') && (buf[i-1] != '\\') ) {
+                    state = 0;
+                }
+            } else if(state == 2) {
+                if( (c == '*') && (i+1 < len) && (buf[i+1] == '/') ) {
+                    state = 0;
+                    i++;
+                } else if(c == '\n') {
+                    line++;
+                }
+            } else if(c == '"') {
+                state = 1;
+            } else if( (c == '/') && (i+1 < len) && (buf[i+1] == '*') ) {
+                state = 2;
+                i++;
+            } else if(c == '\n') {
+                line++;
+            } else if(c == 'E') {
+                end = matchBlockEnd(i);
+                if(end) {
+                    break;
+                }
+            }
+        }
+        if(end == IFB_FBDREAD_WAIT) {
+            // Blockende erst nach dem Weiterlesen pruefen
+            end = 0;
+        } else if(end) {
+            scan = end;
+            break;
+        }
+        scan = i;
+        if(eof) {
+            break;
+        }
+        if(pushed) {
+            // Weiter nach dem naechsten feed()
+            return IFBS_FBDREAD_MORE;
+        }
+        if(!fill() && readErr) {
+            return -1;
+        }
+    }
+
+    if(!end) {
+        // Nur noch Kommentare und Leerzeichen?
+        if( (state != 0) || (skipSpace(pos, len) < len) ) {
+            // Unvollstaendiger Block
+            return -1;
+        }
+        pos = len;
+        return FB_BLOCK_NONE;
+    }
+
+    blockLen = end - pos;
+    block.resize(blockLen + 2);
+    memcpy(&block[0], &buf[pos], blockLen);
+    block[blockLen] = 0;
+    block[blockLen + 1] = 0;
+
+    i = pos;
+    pos = end;
+    return blockKind(i, end);
+}
+
+/*****************************************************************************/
+int IfbsFbdReader::parse(FB_PARSE_CONTEXT *ctx)
+/*****************************************************************************/
+{
+    fb_parser_reset(ctx);
+    return fb_parser_parsechunk(ctx, &block[0], blockLen, blockLine);
+}
@@ -52,6 +52,18 @@ extern "C" void lts_encode(FILE* infile,char **outbuf,char *cmd,char *fileName,c
 
 KS_RESULT IFBS_UPLOAD_GETPATH(KscServerBase*  Server, PltString &path) {
 
+    // Pfad bereits in der Sitzung gemerkt?
+    IfbsSession *pses = IFBS_GetSession(Server);
+    if(pses) {
+        return pses->getUploadPath(path);
+    }
+    return ifb_readUploadPath(Server, path);
+}
+
+//  HFN: Pfad der Upload-Instanz vom Server lesen
+//  =============================================
+KS_RESULT ifb_readUploadPath(KscServerBase*  Server, PltString &path) {
+
     KsGetEPParams       params;           /* Parameter fr getPP-Service       */
     KsGetEPResult            result;
     size_t              size;
@@ -91,22 +103,24 @@ KS_RESULT IFBS_UPLOAD_GETPATH(KscServerBase*  Server, PltString &path) {
     char            *ph;
     char            *help;
     
+    PltList<PltString>  Libs;
+    
     root = Server->getHostAndName();
-    Var = OV_VARLIBS_PATH;
 
-    KscVariable v(root+Var); 
-    if(!v.getUpdate() ) {
-        fehler = v.getLastResult();
-        if(fehler == KS_ERR_OK) fehler = KS_ERR_GENERIC;
-            return fehler;
+    // Liste der Bibliotheken ueber die Sitzung holen
+    IfbsSession *pses = IFBS_OpenSession(Server);
+    if(!pses) {
+        return OV_ERR_HEAPOUTOFMEMORY;
     }
-    const KsVarCurrProps *cp = v.getCurrProps();
-    if((!cp) || (!(cp->value)) ) {
-            return KS_ERR_GENERIC;
+    fehler = pses->getLibraries(Libs);
+    IFBS_CloseSession(pses);
+    if(fehler) {
+        return fehler;
     }
-    size = ((KsStringVecValue &) *cp->value).size();
-    for ( i = 0; i < size; i++ ) {
-        instPath = ((KsStringVecValue &) *cp->value)[i];
+    
+    instPath = "";
+    while( Libs.size() ) {
+        instPath = Libs.removeFirst();
         // String-Ende suchen
         help = (char*)((const char*)instPath);
         ph = help;
@@ -148,7 +162,7 @@ KS_RESULT IFBS_UPLOAD_GETPATH(KscServerBase*  Server, PltString &path) {
         if(fehler == KS_ERR_OK) fehler = KS_ERR_GENERIC;
             return fehler;
     }
-    cp = V.getCurrProps();
+    const KsVarCurrProps *cp = V.getCurrProps();
     if((!cp) || (!(cp->value)) ) {
             return KS_ERR_GENERIC;
     }
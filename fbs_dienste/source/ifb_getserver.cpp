@@ -112,3 +112,76 @@ KscServerBase *GetServerByName( PltString &HaS, KS_RESULT &err)
 
     return serv;        
 }
+
+/*****************************************************************************/
+static KscServerBase *ifb_newServerConnection(const KsString &h_a_s, KS_RESULT &err)
+/*****************************************************************************/
+{
+    // Eigene Verbindung zum Server. Nicht ueber den Server-Cache
+    // des Clients, damit mehrere Threads parallel arbeiten koennen.
+    KsGetEPParams   params;
+    KscServer      *pserv;
+    
+    pserv = new KscServer(h_a_s, KS_RPC_PROGRAM_NUMBER);
+    if(!pserv) {
+        err = OV_ERR_HEAPOUTOFMEMORY;
+        return NULL;
+    }
+    
+    // Ist der Server "ansprechbar" ?
+    params.path = "/vendor/server_time";
+    params.type_mask = KS_OT_ANY;
+    params.name_mask = "*";
+    params.scope_flags = KS_EPF_DEFAULT;
+    err = Get_getEP_ErrOnly(pserv, params);
+    if(err) {
+        delete pserv;
+        return NULL;
+    }
+    
+    return pserv;
+}
+
+/*****************************************************************************/
+KscServerBase *IFBS_OpenServerConnection(KscServerBase *Server, KS_RESULT &err)
+/*****************************************************************************/
+{
+    if(!Server) {
+        err = KS_ERR_SERVERUNKNOWN;
+        return NULL;
+    }
+    
+    return ifb_newServerConnection(Server->getHostAndName(), err);
+}
+
+/*****************************************************************************/
+KscServerBase *IFBS_ConnectServer(PltString &HaS, KS_RESULT &err)
+/*****************************************************************************/
+{
+    // Wie GetServerByName, aber ohne dessen statischen Server-Cache.
+    // Die Verbindung muss mit IFBS_CloseServerConnection geschlossen werden.
+    KsString    h_a_s("//");
+    PltString   log("");
+    KscServerBase *pserv;
+    
+    h_a_s += HaS;
+    
+    pserv = ifb_newServerConnection(h_a_s, err);
+    if(!pserv) {
+        log = "\"%s\"  \"";
+        log += HaS;
+        log += "\"";
+        iFBS_SetLastError(1, err, log);
+    }
+    
+    return pserv;
+}
+
+/*****************************************************************************/
+void IFBS_CloseServerConnection(KscServerBase *Server)
+/*****************************************************************************/
+{
+    if(Server) {
+        delete Server;
+    }
+}
@@ -279,10 +279,11 @@ KS_RESULT Check_Vars_in_lib(KscServerBase* Server,
 }
 
 /*****************************************************************************/
-KS_RESULT SearchErrorCreateInst(KscServerBase* Server,
-                            KS_RESULT      &result,
-                            InstanceItems* pinst,
-                            PltString&     out)    {
+KS_RESULT SearchErrorCreateInst(KscServerBase*  Server,
+                            KS_RESULT       &result,
+                            InstanceItems*  pinst,
+                            PltString&      out,
+                            IfbsExistIndex* pIdx)    {
 /*****************************************************************************/
 
   char*         path;
@@ -311,7 +312,12 @@ KS_RESULT SearchErrorCreateInst(KscServerBase* Server,
                params.name_mask = "*";
                params.scope_flags = KS_EPF_DEFAULT;
                
-               err = Get_getEP_ErrOnly(Server, params);
+               // Klasse und Container aus dem Index (Container nur einmal lesen)
+               if(pIdx) {
+                  err = pIdx->exists(Server, pinst->Class_name) ? KS_ERR_OK : KS_ERR_BADPATH;
+               } else {
+                  err = Get_getEP_ErrOnly(Server, params);
+               }
                if(err) {
                   out += "     [ Type ";
                   out += pinst->Class_name;
@@ -345,9 +351,14 @@ KS_RESULT SearchErrorCreateInst(KscServerBase* Server,
                }
                *ph = '\0';
                params.path = path;
+               if(pIdx) {
+                  err = pIdx->exists(Server, path) ? KS_ERR_OK : KS_ERR_BADPATH;
+               }
                *ph = '/';
                
-               err = Get_getEP_ErrOnly(Server, params);
+               if(!pIdx) {
+                  err = Get_getEP_ErrOnly(Server, params);
+               }
                if(err) {
                   out += "     [ Container ";
                   out += path;
@@ -1005,28 +1016,20 @@ KS_RESULT SearchErrorCreateCon(KscServerBase* Server,
 /*****************************************************************************/
 int test_connectionDataOk(
     float         serverVersion,
-    Dienst_param  *Params,
+    IfbsLinkIndex &LinkIdx,
     InstanceItems *pinst,
     ConData       &CR,
     PltString     &out ) {
 /*****************************************************************************/
-    PltString       VerbName;
     PltString       log;
     LinksItems*     pOcLink;
     LinksItems*     pIcLink;
-    LinksItems*     hLinks;
-    
-    VerbName = pinst->Inst_name;
+    char            help[64];
     
     // Link "outputcon" suchen
     log = "outputcon";
             
-    pOcLink = Params->Links;
-    while( (pOcLink) &&
-           ((VerbName != pOcLink->children->child_path) ||
-           (log != pOcLink->child_role)) ) {
-        pOcLink = pOcLink->next;
-    }
+    pOcLink = LinkIdx.find(pinst->Inst_name, "outputcon");
     if(!pOcLink) {
         if(serverVersion < 2.4) {
             out += log_getErrMsg(KS_ERR_OK, "Link \"outputcon\" to connection",
@@ -1037,12 +1040,7 @@ int test_connectionDataOk(
         
     // Link "inputcon" suchen
     log = "inputcon";
-    pIcLink = Params->Links;
-    while( (pIcLink) &&
-           ((VerbName != pIcLink->children->child_path) ||
-           (log != pIcLink->child_role)) ) {
-        pIcLink = pIcLink->next;
-    }
+    pIcLink = LinkIdx.find(pinst->Inst_name, "inputcon");
     if(!pIcLink) {
         if(serverVersion < 2.4) {
             out += log_getErrMsg(KS_ERR_OK, "Link \"inputcon\" to connection",
@@ -1070,7 +1068,7 @@ int test_connectionDataOk(
             }
         } else if( !strcmp(pcv->var_name, "on") ) {
             if(pcv->value) {
-                log = pcv->value->val;
+                log = ifb_fbbValueText(pcv, pcv->value, 0, help);
                 if(log == "TRUE")
                     CR.on = TRUE;
                 else
@@ -1078,7 +1076,7 @@ int test_connectionDataOk(
             }
         } else if( !strcmp(pcv->var_name, "sourcetrig") ) {
             if(pcv->value) {
-                log = pcv->value->val;
+                log = ifb_fbbValueText(pcv, pcv->value, 0, help);
                 if(log == "TRUE")
                     CR.source_trig = TRUE;
                 else
@@ -1089,112 +1087,86 @@ int test_connectionDataOk(
     }
 
 
-    // Die Link-Struktur wird nicht mehr gebraucht. Speicher freigeben
-    hLinks = Params->Links;
-    if(hLinks != pOcLink) {
-        while(hLinks->next != pOcLink) {
-            hLinks = hLinks->next;
-        }
-        hLinks->next = pOcLink->next;
-    } else {
-        Params->Links = hLinks->next;
-    } 
-    if(pOcLink->children) {
-        free(pOcLink->children);
-    }
-    free(pOcLink);
-
-    hLinks = Params->Links;
-    if(hLinks != pIcLink) {
-        while(hLinks->next != pIcLink) {
-            hLinks = hLinks->next;
-        }
-        hLinks->next = pIcLink->next;
-    } else {
-        Params->Links = hLinks->next;
-    }
-    
-    if(pIcLink->children) {
-        free(pIcLink->children);
-    }
-    free(pIcLink);
+    // Die Link-Struktur wird nicht mehr gebraucht. Wird nach dem Anlegen
+    // aller Verbindungen mit LinkIdx.purge() aus der Liste entfernt
+    LinkIdx.remove(pOcLink);
+    LinkIdx.remove(pIcLink);
 
     return 1;
 }
 
 /*****************************************************************************/
-void checkParentDomainsInDB(KscServerBase* Server,
-                            PltList<PltString> &NotLoadedLibs,
-                            Dienst_param* Params,
-                            PltString&     out) {
+KS_RESULT FB_CreateConnection(KscServerBase*  Server,
+                              InstanceItems*  pinst,
+                              ConData*        pCR,
+                              PltString&      out,
+                              IfbsExistIndex* pIdx) {
 /*****************************************************************************/
-    PltString       hStr;
-    char            help[512];
-    char           *ph;
-    size_t          anz;
-    KsGetEPParams   pars;
-    InstanceItems  *pinst;
-    int             found;
-    InstanceItems   pNewInst;
+    KS_RESULT       error;
+    KS_RESULT       hr;
+    PltString       log;
     
-    // Wenn eine Instanz in DB-Sicherung nicht gefunden wurde, lege die als Domain an    
-	pNewInst.Class_name = "/acplt/ov/domain";
-	pNewInst.Inst_var = 0;
-	pNewInst.next = 0;
-
-    anz = NotLoadedLibs.size();
-    while( anz > 0) {
-        hStr = NotLoadedLibs.removeFirst();
-        NotLoadedLibs.addLast(hStr);
-        anz--;
+    if(!pCR) {
+        // Unvollstaendige Verbindung. Die vorhandenen Links folgen als Links
+        return FB_CreateNewInstance(Server, pinst, out, pIdx);
+    }
+    
+    // Verbindung anlegen
+    error = IFBS_CREATE_COMCON(Server, *pCR, pinst->Inst_var);
+    if(!error) {
+        return KS_ERR_OK;
+    }
+    
+    PltString cMsg("");
+    if( test_ConnectionExists(Server, *pCR, cMsg) ) {
+        // Werte der Variablen aktualisiren
+        Dienst_param        svcPar;
+        SetInstVarItems     setVars;
         
-        sprintf(help, (const char*)hStr);
-        ph = help;
-        ph++;       // 1. '/' ignorieren
+        setVars.next = 0;
+        setVars.Inst_name = pinst->Inst_name;                    
+        setVars.Inst_var  = pinst->Inst_var;
         
-        // Alle Parent-Objekte
-        while(ph && (*ph) ) {
-            if(*ph == '/') {
-                *ph = '\0';
-                hStr = help;
-                *ph = '/';
-                                
-                // Pruefen, ob on DB bereits vorhanden
-                pars.path = hStr;
-                pars.type_mask = KS_OT_ANY;
-                pars.name_mask = "*";
-                pars.scope_flags = KS_EPF_DEFAULT;
-
-                found = 1;
-                if( Get_getEP_ErrOnly(Server,pars) != KS_ERR_OK ) {
-                    // IN DB nicht vorhanden. Steht die Instanz in Sicherung?
-                    found = 0;
-                    pinst = Params->Instance;
-                    while(pinst) {
-                        if(hStr == pinst->Inst_name) {
-                            found = 1;
-                            FB_CreateNewInstance(Server,pinst,out);
-                            break;
-                        }
-                        pinst = pinst->next;
-                    }
-                    // Ueber alle gesicherte Instanzen
-                }
-                // Instanz in DB nicht vorhanden?
-                
-                if(found == 0) {
-                    // Dann als Container anlegen
-                    pNewInst.Inst_name = (char*)((const char*)hStr);
-                    FB_CreateNewInstance(Server,&pNewInst,out);
-                }
-            }
-            // Trenner '/' gefunden
-            
-            ph++;
-        }
-        // Ueber alle Pfad-Parentobjekte
+        svcPar.Set_Inst_Var = &setVars;
+        svcPar.DelInst = 0;
+        svcPar.OldLibs = 0;
+        svcPar.NewLibs = 0;
+        svcPar.Links   = 0;
+        svcPar.UnLinks = 0;
+        
+        // Fehler beim Setzen sind protokolliert, die Verbindung ist vorhanden
+        set_new_value(Server, &svcPar, out);
+        return KS_ERR_OK;
+    }
+    
+    out += log_getErrMsg(error,
+            "Connection", (const char*)pCR->identifier,
+            " couldn't be created.");
+        
+    // Fehler bereits gefunden?
+    if(cMsg != "") {
+        out += cMsg;
+    } else {
+        log = "";
+        hr = KS_ERR_OK;
+        iFBS_SetLastError(1, hr, log);
+        
+        SearchErrorCreateCon(Server,error,*pCR,pinst->Inst_var,out);
+    }
+    
+    return error;
+}
+
+/*****************************************************************************/
+static void ifb_prependInstances(InstanceItems** ppList, std::vector<InstanceItems*> &Items)
+/*****************************************************************************/
+{
+    size_t i;
+    
+    for(i = Items.size(); i > 0; i--) {
+        Items[i-1]->next = *ppList;
+        *ppList = Items[i-1];
     }
-    // Ueber alle nicht geladene Bibliotheken
 }
 
 /*****************************************************************************/
@@ -1207,13 +1179,78 @@ KS_RESULT import_eval(KscServerBase* Server,
     char            path[256];
     KS_RESULT       error;
     LinksItems*     pLinks;
-    Child*          pChild;
     PltString       log;
     PltString       libpath;
 
 //    KscAvSimpleModule  *AV = GetClientAV();
     FbCreateInstParams  CrPar;
 
+    size_t               pLen;
+    Dienst_param         tempObjs;
+    InstanceItems*        pinst;
+    InstanceItems*        pverb_objs;
+    InstanceItems*        pinst_objs;
+    
+    KS_RESULT       hr;
+
+    /*
+    * Das ist missbrauch von CreateObject-Dienst und Netzwerkuebertragungszeit,
+    *  weil wir alle Instanzen nur mit einem Dienst erzeugen koennen. Falls aber
+    *  nur eine von n Instanzen nicht angelegt wird, muessen wir alle erfolgreich
+    *  angelegten Instanzen aufraeumen. Deswegen muesen wir genau wissen, an
+    *  welcher Stelle wir uns befinden.                                        
+    */
+    tempObjs.Instance = 0;
+	tempObjs.Set_Inst_Var = 0;
+	tempObjs.DelInst = 0;
+	tempObjs.OldLibs = 0;
+	tempObjs.NewLibs = 0;
+	tempObjs.Links = 0;
+	tempObjs.UnLinks = 0;
+
+    /* 
+    *  Zunaechst werden alle Funktionsbausteine und Tasks angelegt.
+    *  Alle Verbindungsobjekte werden aussortiert
+    */
+    sprintf(path,"/%s/", FB_CONN_CONTAINER);
+    pLen = strlen(path);
+
+    pverb_objs = 0;
+    pinst_objs = 0;
+    while(Params->Instance) {
+    
+        pinst=Params->Instance;
+        Params->Instance = pinst->next;
+        
+        if( !strncmp(pinst->Inst_name, path, pLen) ) {
+            // Es ist Verbinduns-Objekt
+            pinst->next = pverb_objs;
+            pverb_objs  = pinst;
+        } else {
+            // Benutzer-Instanz oder Container
+            pinst->next = pinst_objs;
+            pinst_objs  = pinst;
+        }
+    }
+
+    // Nun stehen Instanzen in umgekehrten Reihenfolge
+    while(pinst_objs) {
+        pinst=pinst_objs;
+        pinst_objs = pinst->next;
+        
+        pinst->next = Params->Instance;
+        Params->Instance = pinst;
+    }
+
+    // Gestufte Aktivierung : Werte werden nach dem Laden der Bibliotheken
+    // ersetzt (siehe unten) und am Ende gesetzt
+    IfbsStagedActivation    Staged;
+
+    // Ladeplan : Abhaengigkeiten der Bibliotheken, Instanzen, Verbindungen
+    // und Links
+    IfbsLoadPlan    Plan;
+    Plan.addInstances(Params->Instance);
+
 ///////////////////////////////////////////////////////////////////////////////
 //  Bibliotheke laden                                                        //
 ///////////////////////////////////////////////////////////////////////////////
@@ -1221,7 +1258,8 @@ KS_RESULT import_eval(KscServerBase* Server,
     DelInstItems*      plib;
     PltList<PltString> LoadedLibs;
     PltList<PltString> NotLoadedLibs;
-    int                i, anz;
+    PltList<KS_RESULT> NotLoadedErr;
+    int                i, anz, loaded;
     
     CrPar.factory = LIBRARY_FACTORY_PATH;
     libpath = "/";
@@ -1241,7 +1279,8 @@ KS_RESULT import_eval(KscServerBase* Server,
                 CrPar.path = libpath;
                 CrPar.path += plib->Inst_name;
             }
-            error = IFBS_CREATE_INST(Server,CrPar);
+            Plan.addLibrary((const char*)CrPar.path);
+            error = IFBS_CREATE_INST(Server,CrPar,&Plan.getExistIndex());
             if(error) {
                 if(error == KS_ERR_ALREADYEXISTS) {
                     LoadedLibs.addFirst(CrPar.path);
@@ -1254,7 +1293,9 @@ KS_RESULT import_eval(KscServerBase* Server,
                     log += "\"";
                     iFBS_SetLastError(1, error, log);
                 } else {
-                    NotLoadedLibs.addFirst(CrPar.path);
+                    // Reihenfolge der Datei beibehalten
+                    NotLoadedLibs.addLast(CrPar.path);
+                    NotLoadedErr.addLast(error);
                 }
             } else {
                     out += log_getOkMsg("Library",plib->Inst_name,"loaded.");
@@ -1268,380 +1309,244 @@ KS_RESULT import_eval(KscServerBase* Server,
         if(NotLoadedLibs.size() > 0) {
             // Wird die Sicherung in eine leere DB geladen? Dann gibt es eventuell
             // die Container nicht
-            checkParentDomainsInDB(Server, NotLoadedLibs, Params, out);
+            Plan.createParentDomains(Server, NotLoadedLibs, out);
         
-            // Starten wir 5 Versuche (wegen moeglichen Reihenfolge-Problem)
-            int anzLoops = 5;
-            while(NotLoadedLibs.size() && anzLoops > 0) {
-    
+            // Wiederholen, solange weitere Bibliotheken geladen werden
+            // (Bibliothek haengt von einer spaeter stehenden ab)
+            do {
+                loaded = 0;
                 anz = NotLoadedLibs.size();
                 for(i=0; i<anz; i++) {
                     log = NotLoadedLibs.removeFirst();
+                    NotLoadedErr.removeFirst();
     
                     CrPar.path = log;
                     
-                    error = IFBS_CREATE_INST(Server,CrPar);
+                    error = IFBS_CREATE_INST(Server,CrPar,&Plan.getExistIndex());
                     if(error != KS_ERR_OK) {
                         NotLoadedLibs.addLast(log);
+                        NotLoadedErr.addLast(error);
                     } else {
-                        out += log_getOkMsg("Library",(const char*)log,"loaded.");                    
+                        out += log_getOkMsg("Library",(const char*)log,"loaded.");
+                        LoadedLibs.addFirst(log);
+                        loaded++;
                     }
                 }
-                anzLoops--;
-            }
+            } while(loaded && NotLoadedLibs.size());
         }
         
-        // Gibt es immer noch nicht geladene Bibliotheken?
+        // Nicht geladene Bibliotheken einmal melden
         while( NotLoadedLibs.size() ) {
             log = NotLoadedLibs.removeFirst();
+            error = NotLoadedErr.removeFirst();
             
-            CrPar.path = log;
-            
-            error = IFBS_CREATE_INST(Server,CrPar);
-            if(error != KS_ERR_OK) {
-                out += log_getErrMsg(error,
-                        "Library", (const char*)log,
-                        "couldn't be loaded.");
-            
-                log  = "\"%s\"  \"";
-                log += CrPar.path;
-                log += "\"";
-                iFBS_SetLastError(1, error, log);
-            } else {
-                out += log_getOkMsg("Library",(const char*)CrPar.path,"loaded.");                    
-            }
+            Plan.setLibraryResult((const char*)log, error);
+            out += log_getErrMsg(error,
+                    "Library", (const char*)log,
+                    "couldn't be loaded.");
+        
+            libpath  = "\"%s\"  \"";
+            libpath += log;
+            libpath += "\"";
+            iFBS_SetLastError(1, error, libpath);
         }
         
+        // Bibliotheken, Klassen und Assoziationen neu lesen
+        IFBS_InvalidateSession(Server, IFBS_SD_LIBDATA);
+        
     } /* if NewLibs */
 
+    // Gestufte Aktivierung : Instanzen mit actimode=0 und Verbindungen mit
+    // on=FALSE anlegen. Fehlt die Variable in der Datei, entscheidet die
+    // Klasse (Klassen sind jetzt geladen)
+    if( IFBS_GetStagedActivation() ) {
+        IfbsSession *pses = IFBS_OpenSession(Server);
+        for(pinst = Params->Instance; pinst; pinst = pinst->next) {
+            Staged.deactivate(pses, pinst, "actimode", "0", KS_VT_INT);
+        }
+        for(pinst = pverb_objs; pinst; pinst = pinst->next) {
+            Staged.deactivate(pses, pinst, "on", "FALSE", KS_VT_BOOL);
+        }
+        IFBS_CloseSession(pses);
+    }
+
 
 ///////////////////////////////////////////////////////////////////////////////
-//  Instanzen und Verbindungen anlegen                                       //
+//  Instanzen, Verbindungen und Links anlegen                                //
 ///////////////////////////////////////////////////////////////////////////////
+
+    // Ab Server-Version 2.4 konnen auch "unvollstaendige"
+    //    Verbindungsobjekte angelegt werden
+    float serverVersion = get_serverVersion(Server);
     
-    size_t               pLen;
-    Dienst_param         tempObjs;
-    InstanceItems*        pinst;
-    InstanceItems*        pverb_objs;
-    InstanceItems*        pinst_objs;
+    // Index ueber die Links fuer die Suche der Verbindungs-Links
+    IfbsLinkIndex LinkIdx(Params->Links);
     
-    KS_RESULT       hr;
-
-    /*
-    * Das ist missbrauch von CreateObject-Dienst und Netzwerkuebertragungszeit,
-    *  weil wir alle Instanzen nur mit einem Dienst erzeugen koennen. Falls aber
-    *  nur eine von n Instanzen nicht angelegt wird, muessen wir alle erfolgreich
-    *  angelegten Instanzen aufraeumen. Deswegen muesen wir genau wissen, an
-    *  welcher Stelle wir uns befinden.                                        
-    */
-    tempObjs.Instance = 0;
-	tempObjs.Set_Inst_Var = 0;
-	tempObjs.DelInst = 0;
-	tempObjs.OldLibs = 0;
-	tempObjs.NewLibs = 0;
-	tempObjs.Links = 0;
-	tempObjs.UnLinks = 0;
-
-    /* 
-    *  Zunaechst werden alle Funktionsbausteine und Tasks angelegt.
-    *  Alle Verbindungsobjekte werden aussortiert
-    */
-    sprintf(path,"/%s/", FB_CONN_CONTAINER);
-    pLen = strlen(path);
-
-    pverb_objs = 0;
-    pinst_objs = 0;
-    while(Params->Instance) {
+    size_t                   lvl, b, anzVerb;
+    std::vector<KS_RESULT>   Results;
+    std::vector<KS_RESULT>   ConResults;
+    InstanceItems*           pfailed;
+    InstanceItems*           pbad;
+    PltString                firstLog;
     
-        pinst=Params->Instance;
-        Params->Instance = pinst->next;
-        
-        if( !strncmp(pinst->Inst_name, path, pLen) ) {
-            // Es ist Verbinduns-Objekt
-            pinst->next = pverb_objs;
-            pverb_objs  = pinst;
+    // Verbindungen in den Ladeplan. Sie haengen von Quell- und Ziel-FB ab,
+    // ihre Links werden mit der Verbindung angelegt
+    anzVerb = 0;
+    for(pinst = pverb_objs; pinst; pinst = pinst->next) {
+        anzVerb++;
+    }
+    std::vector<ConData>     ConDatas(anzVerb);
+    
+    pbad = 0;
+    for(pinst = pverb_objs, b = 0; pinst; pinst = pinst->next, b++) {
+        if( test_connectionDataOk(serverVersion, LinkIdx, pinst, ConDatas[b], out) ) {
+            Plan.addConnection(pinst, &ConDatas[b]);
         } else {
-            // Benutzer-Instanz oder Container
-            pinst->next = pinst_objs;
-            pinst_objs  = pinst;
+            // Ohne Links nur als einfache Instanz (ab Version 2.4)
+            Plan.addConnection(pinst, 0);
+            if( (serverVersion < 2.4) && (!pbad) ) {
+                pbad = pinst;
+            }
+        }
+    }
+    // Die Verbindungen gehoeren jetzt zum Ladeplan
+    pverb_objs = 0;
+    
+    // Uebrige Links (Task- und X-Links, Links unvollstaendiger Verbindungen).
+    // Sie haengen von Parent und Kindern ab
+    for(pLinks = Params->Links; pLinks; pLinks = pLinks->next) {
+        if( !LinkIdx.isRemoved(pLinks) ) {
+            Plan.addLink(pLinks);
         }
     }
+    
+    // Objekte ebenenweise nach dem Ladeplan anlegen. Bereits mit den
+    // Containern der Bibliotheken angelegte Instanzen sind fertig.
+    size_t                   anzLevels = Plan.build();
 
-    // Nun stehen Instanzen in umgekehrten Reihenfolge
-    while(pinst_objs) {
-        pinst=pinst_objs;
-        pinst_objs = pinst->next;
-        
-        pinst->next = Params->Instance;
-        Params->Instance = pinst;
+    Params->Instance = 0;
+    ifb_prependInstances(&tempObjs.Instance, Plan.getCreated());
+    
+    // Instanzen von nicht geladenen Bibliotheken? Nichts anlegen
+    error = Plan.getBlocked(out, firstLog);
+    if(error) {
+        iFBS_SetLastError(1, error, firstLog);
     }
-                            
-    // Alle Instanzen anlegen
-    while(Params->Instance) {
     
-        pinst=Params->Instance;
-        Params->Instance = pinst->next;
+    if( (!error) && pbad ) {
+        // Vor Version 2.4 braucht eine Verbindung beide Links
+        error = KS_ERR_BADPARAM;
+        out += log_getErrMsg(error,
+                "Connection", pbad->Inst_name,
+                " couldn't be created.");
+        firstLog  = "\"%s\"  \"";
+        firstLog += pbad->Inst_name;
+        firstLog += "\"";
+        iFBS_SetLastError(1, error, firstLog);
+    }
+    
+    if( (!error) && (anzLevels > 0) ) {
+        Plan.setConnections(IFBS_GetLoadConnections());
+    }
 
+    for(lvl = 0; (!error) && (lvl < anzLevels); lvl++) {
+        std::vector<InstanceItems*> &Items = Plan.getLevel(lvl);
+        std::vector<InstanceItems*> &Conns = Plan.getConnections(lvl);
         
-        error = FB_CreateNewInstance(Server,pinst,out);
-        if(error) {
+        Results.assign(Items.size(), KS_ERR_OK);
+        ConResults.assign(Conns.size(), KS_ERR_OK);
+        Plan.createLevel(Server, lvl,
+                         Results.size() ? &Results[0] : 0,
+                         ConResults.size() ? &ConResults[0] : 0,
+                         out);
+        
+        pfailed = 0;
+        for(b=0; b<Items.size(); b++) {
+            pinst = Items[b];
+            if(Results[b] == KS_ERR_OK) {
+                // Merke: Instanz angelegt
+                pinst->next = tempObjs.Instance;
+                tempObjs.Instance = pinst;
+                continue;
+            }
             
+            // Fehler nur fuer die fehlgeschlagenen Instanzen suchen
             log = "";
             hr = KS_ERR_OK;
             iFBS_SetLastError(1, hr, log);
-            SearchErrorCreateInst(Server,error,pinst,out);
-            log = IFBS_GetLastLogError();
-            if(log == "" ) {
-                log = "\"%s\"  ";
-                log += pinst->Inst_name;
-                log += "\"";
-                iFBS_SetLastError(1, error, log);
-            }
-            if(DEL_INST) {
-                aufraeumen(Server, &tempObjs, out);  /* Loesche angelegte Instanzen */
-                DelObjsFromList(Server, LoadedLibs, &out);/* Loesche geladene Bibliotheken */
-            }
-
-            /* Aktuelle Instanz zurueck zu Liste */
-            pinst->next = Params->Instance;
-            Params->Instance = pinst;
-            /* Bereits angelegte Objs anhaengen */
-            while(tempObjs.Instance) {
-                pinst = tempObjs.Instance;
-                tempObjs.Instance = pinst->next;
-                
-                pinst->next = Params->Instance;
-                Params->Instance = pinst;
-            }
-            /* Einsortierte Verb.-Objs anhaengen */
-            while(pverb_objs) {
-                pinst = pverb_objs;
-                pverb_objs = pinst->next;
-                
-                pinst->next = Params->Instance;
-                Params->Instance = pinst;
+            SearchErrorCreateInst(Server,Results[b],pinst,out,&Plan.getExistIndex());
+            if(!error) {
+                error = Results[b];
+                firstLog = IFBS_GetLastLogError();
+                if(firstLog == "" ) {
+                    firstLog = "\"%s\"  ";
+                    firstLog += pinst->Inst_name;
+                    firstLog += "\"";
+                }
             }
-
-            return error;
+            pinst->next = pfailed;
+            pfailed = pinst;
         }
         
-        // Merke: Instanz angelegt
-        pinst->next = tempObjs.Instance;
-        tempObjs.Instance = pinst;
-
-    } /* Ueber alle Instanzen */
-
-
-    // Ab Server-Version 2.4 konnen auch "unvollstaendige"
-    //    Verbindungsobjekte angelegt werden
-    float serverVersion = get_serverVersion(Server);
-    
-     /*
-    *  Alle Instanzen sind angelegt.
-    *  Lege Verbindungsobjekte an
-    */
-    while(pverb_objs) {
-        pinst = pverb_objs;
-        pverb_objs = pinst->next;
-
-        ConData CR;
-        
-        // Alle Daten vorhanden?
-        if( test_connectionDataOk(serverVersion, Params, pinst, CR, out) ) {
-            // Verbindung anlegen
-            error = IFBS_CREATE_COMCON(Server, CR, pinst->Inst_var);
-            if(error) {
-                PltString cMsg("");
-                if( test_ConnectionExists(Server, CR, cMsg) ) {
-                    // Werte der Variablen aktualisiren
-                    Dienst_param        svcPar;
-                    SetInstVarItems     setVars;
-                    
-                    setVars.next = 0;
-                    setVars.Inst_name = pinst->Inst_name;                    
-                    setVars.Inst_var  = pinst->Inst_var;
-                    
-                    svcPar.Set_Inst_Var = &setVars;
-                    svcPar.DelInst = 0;
-                    svcPar.OldLibs = 0;
-                    svcPar.NewLibs = 0;
-                    svcPar.Links   = 0;
-                    svcPar.UnLinks = 0;
-                    
-                    error = set_new_value(Server, &svcPar, out);
-                } else {
-                        
-                    out += log_getErrMsg(error,
-                            "Connection", (const char*)CR.identifier,
-                            " couldn't be created.");
-                        
-                    // Fehler bereits gefunden?
-                    if(cMsg != "") {
-                        out += cMsg;
-                    } else {
-                        log = "";
-                        hr = KS_ERR_OK;
-                        iFBS_SetLastError(1, hr, log);
-    
-                        SearchErrorCreateCon(Server,error,CR,pinst->Inst_var,out);
-    
-                        log = IFBS_GetLastLogError();
-                        if(log == "" ) {
-                            log = "\"%s\"  ";
-                            log += CR.identifier;
-                            log += "\"";
-                            iFBS_SetLastError(1, error, log);
-                        }
-                    }
-                        
-                    if(DEL_INST) {
-                        aufraeumen(Server, &tempObjs, out);      /* Loesche angelegte Instanzen */
-                        DelObjsFromList(Server, LoadedLibs, &out);/* Loesche geladene Bibliotheken */
-                    }
-                    /* Aktuelle Instanz zurueck zu Liste */
-                    pinst->next = Params->Instance;
-                    Params->Instance = pinst;
-                    /* Bereits angelegte Objs anhaengen */
-                    while(tempObjs.Instance) {
-                        pinst = tempObjs.Instance;
-                        tempObjs.Instance = pinst->next;
-                        
-                        pinst->next = Params->Instance;
-                        Params->Instance = pinst;
-                    }
-                    /* Einsortierte Verb.-Objs anhaengen */
-                    while(pverb_objs) {
-                        pinst = pverb_objs;
-                        pverb_objs = pinst->next;
-                        
-                        pinst->next = Params->Instance;
-                        Params->Instance = pinst;
-                    }
-                    return error;
-                }
+        for(b=0; b<Conns.size(); b++) {
+            pinst = Conns[b];
+            if(ConResults[b] == KS_ERR_OK) {
+                // Merke: Verbindung angelegt
+                pinst->next = tempObjs.Instance;
+                tempObjs.Instance = pinst;
+                continue;
             }
             
-        } else {
-            // Es sind nicht alle Daten vorhanden.
-            if(serverVersion >= 2.4) {
-                // Dann...
-                error = FB_CreateNewInstance(Server,pinst,out);
-                if(error) {
-                    
-                    if(DEL_INST) {
-                        aufraeumen(Server, &tempObjs, out);  /* Loesche angelegte Instanzen */
-                        DelObjsFromList(Server, LoadedLibs, &out);/* Loesche geladene Bibliotheken */
-                    }
-        
-                    /* Aktuelle Instanz zurueck zu Liste */
-                    pinst->next = Params->Instance;
-                    Params->Instance = pinst;
-                    /* Bereits angelegte Objs anhaengen */
-                    while(tempObjs.Instance) {
-                        pinst = tempObjs.Instance;
-                        tempObjs.Instance = pinst->next;
-                        
-                        pinst->next = Params->Instance;
-                        Params->Instance = pinst;
-                    }
-                    /* Einsortierte Verb.-Objs anhaengen */
-                    while(pverb_objs) {
-                        pinst = pverb_objs;
-                        pverb_objs = pinst->next;
-                        
-                        pinst->next = Params->Instance;
-                        Params->Instance = pinst;
-                    }
-        
-                    return error;
-                }
-                
-            } else {
-                out += log_getErrMsg(error,
-                        "Connection", pinst->Inst_name,
-                        " couldn't be created.");
-
-                if(DEL_INST) {
-                    aufraeumen(Server, &tempObjs, out);      /* Loesche angelegte Instanzen */
-                    DelObjsFromList(Server, LoadedLibs, &out);/* Loesche geladene Bibliotheken */
-                }
-                /* Aktuelle Instanz zurueck zu Liste */
-                pinst->next = Params->Instance;
-                Params->Instance = pinst;
-                /* Bereits angelegte Objs anhaengen */
-                while(tempObjs.Instance) {
-                    pinst = tempObjs.Instance;
-                    tempObjs.Instance = pinst->next;
-                    
-                    pinst->next = Params->Instance;
-                    Params->Instance = pinst;
-                }
-                /* Einsortierte Verb.-Objs anhaengen */
-                while(pverb_objs) {
-                    pinst = pverb_objs;
-                    pverb_objs = pinst->next;
-                    
-                    pinst->next = Params->Instance;
-                    Params->Instance = pinst;
-                }
-                return KS_ERR_BADPARAM;
+            // Fehler ist bereits von FB_CreateConnection protokolliert
+            if(!error) {
+                error = ConResults[b];
+                firstLog  = "\"%s\"  \"";
+                firstLog += pinst->Inst_name;
+                firstLog += "\"";
             }
+            pinst->next = pfailed;
+            pfailed = pinst;
         }
-            
-        // Merke: Verbindung angelegt
-        pinst->next = tempObjs.Instance;
-        tempObjs.Instance = pinst;
         
-    } /* while pverb_objs */
-
-    /* Fertig. Objekte zur Gesammt-Liste zurueck */
-    Params->Instance = tempObjs.Instance;
-
-
-///////////////////////////////////////////////////////////////////////////////
-//  Dienst Link                                                              //
-///////////////////////////////////////////////////////////////////////////////
-
-    if(Params->Links) {
-        // Es sind nur Task- und X- Links in der Liste.
-        // Die Verbindungs-Links sind schon aussortiert und ausgefuert.
-        pLinks = Params->Links;
-
-        FbLinkParams Pars;
-        Pars.place = KS_PMH_END;
+        if(error) {
+            // Erster Fehler bleibt der gemeldete Fehler
+            iFBS_SetLastError(1, error, firstLog);
+            
+            /* Fehlgeschlagene Instanzen zurueck zu Liste */
+            Params->Instance = pfailed;
+        }
+    } /* Ueber alle Ebenen */
+    
+    if(error) {
+        if(DEL_INST) {
+            aufraeumen(Server, &tempObjs, out);  /* Loesche angelegte Instanzen */
+            DelObjsFromList(Server, LoadedLibs, &out);/* Loesche geladene Bibliotheken */
+        }
         
-        while(pLinks) {
-            Pars.parent_path = pLinks->parent_path;
-            Pars.parent_path += ".";
-            Pars.parent_path += pLinks->child_role;
-
-            pChild = pLinks->children;
+        /* Nicht angelegte Instanzen und Verbindungen zurueck zu Liste */
+        for(; lvl < anzLevels; lvl++) {
+            ifb_prependInstances(&Params->Instance, Plan.getLevel(lvl));
+            ifb_prependInstances(&Params->Instance, Plan.getConnections(lvl));
+        }
+        /* Bereits angelegte Objs anhaengen */
+        while(tempObjs.Instance) {
+            pinst = tempObjs.Instance;
+            tempObjs.Instance = pinst->next;
+            
+            pinst->next = Params->Instance;
+            Params->Instance = pinst;
+        }
 
-            while(pChild) {
-                Pars.elem_path = pChild->child_path;
-                
-                error = ifb_createLink(Server, Pars);
-                if(error) {
-                    if(error != KS_ERR_ALREADYEXISTS) {
-                        out += log_getErrMsg(error,
-                            "Parent ",pLinks->parent_path,
-                            " and child ", pChild->child_path,
-                            " couldn't be linked.");                    
-                    }
-                } else {
-                        out += log_getOkMsg("Parent",pLinks->parent_path,
-                                            "and child",pChild->child_path,
-                                            "linked.");
-                }
-                
-                pChild = pChild->next; 
-            } /* while pchild */
+        return error;
+    }
 
-            pLinks = pLinks->next;
-        } /* while pLinks     */
+    /* Links der angelegten Verbindungen aus der Liste entfernen */
+    LinkIdx.purge(&Params->Links);
 
-    }   /* if Params->Links */
+    /* Fertig. Objekte zur Gesammt-Liste zurueck */
+    Params->Instance = tempObjs.Instance;
 
-    return KS_ERR_OK;
+    // Alle Objekte und Links vorhanden. Gemerkte Werte setzen
+    return Staged.activate(Server, out);
 
 }
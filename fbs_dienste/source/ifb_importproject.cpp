@@ -39,45 +39,6 @@
 */
 #include "ifbslibdef.h"
 
-/*
-*        globale Variablen
-*        -----------------
-*/
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-Dienst_param*   ppar;
-
-//extern int      yydebug;
-//extern FILE*    yyin;
-//extern int      current_line;
-
-#ifdef __cplusplus
-}
-#endif
-
-/*
-*        Funktionsprototypen
-*        -------------------
-*/
-
-int yyparse(void);
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-    
-struct yy_buffer_state* yy_scan_string( char* str );
-void   yy_delete_buffer(struct yy_buffer_state* buf);
-
-void InitInputFileStream(FILE*);
-
-#ifdef __cplusplus
-}
-#endif
-
 /*****************************************************************************/
 KS_RESULT IFBS_DBLOAD(KscServerBase* Server,
                       PltString&     inpfile,
@@ -92,9 +53,7 @@ KS_RESULT IFBS_DBLOAD(KscServerBase* Server,
     PltString out;
         int PROTOFILE = 0;
     FILE*    yyout = 0;
-    
-        yydebug = 0;
-        current_line = 0;
+    FB_PARSE_CONTEXT* ctx;      // Parse-Sitzung
 
         /*
         *        check option settings
@@ -117,8 +76,18 @@ KS_RESULT IFBS_DBLOAD(KscServerBase* Server,
             PROTOFILE = 1;
     }
 
-    yyin = fopen((const char*)inpfile, "r");
-    if(!yyin) {
+    ctx = fb_parser_create();
+    if(!ctx) {
+        if(PROTOFILE) {
+            fprintf(yyout, "%s", (const char*)log_getErrMsg(KS_ERR_OK, "Not enough memory to allocate buffer."));
+            fclose(yyout);
+        }
+        return OV_ERR_HEAPOUTOFMEMORY;
+    }
+
+    // Datei in den Speicher einblenden
+    if(!fb_parser_openfile(ctx, (const char*)inpfile)) {
+        fb_parser_destroy(ctx);
         if(PROTOFILE) {
             fprintf(yyout,"%s", (const char*)log_getErrMsg(KS_ERR_OK,"Can't open file",(const char*)inpfile));
             fclose(yyout);
@@ -158,38 +127,19 @@ fflush(yyout);
 
 
 
-        ppar = (Dienst_param*)malloc(sizeof(Dienst_param));
-        if(!ppar) {
-            fprintf(yyout, "%s", (const char*)log_getErrMsg(KS_ERR_OK, "Not enough memory to allocate buffer."));
-            return OV_ERR_HEAPOUTOFMEMORY;
-        }
-        ppar->Instance = 0;
-        ppar->Set_Inst_Var = 0;
-        ppar->DelInst = 0;
-        ppar->OldLibs = 0;
-        ppar->NewLibs = 0;
-        ppar->Links = 0;
-        ppar->UnLinks = 0;
-
-
         /*
         *   Eingabe parsen
         */
-        out = "";
-    iFBS_PrintParserError(1, out); /* LastError loeschen */
-
-    InitInputFileStream(yyin);
-        exit_status = yyparse();
-
-        fclose(yyin);
+        exit_status = IFBS_ParseInput(ctx);
 
         /*
         *        Ausgabe erzeugen
         */
         if(exit_status != EXIT_SUCCESS) {  
             
+            iFBS_SetParserError(ctx);
             if(PROTOFILE) {
-                out = IFBS_GetParserError();
+                out = IFBS_GetParserError(ctx);
                 if( out == "" ) {
                     fprintf(yyout,"%s", (const char*)log_getErrMsg(KS_ERR_OK,"Parse error.","File", (const char*)inpfile));
                 } else {
@@ -198,9 +148,7 @@ fflush(yyout);
                 fflush(yyout);
                 fclose(yyout);
             }
-            memfre(ppar);
-            free(ppar);
-            fb_parser_freestrings();
+            fb_parser_destroy(ctx);
                 
             return KS_ERR_BADPARAM;
         }
@@ -210,7 +158,14 @@ fflush(yyout);
         }
         
         out = "";
-    error = import_eval(Server, ppar, out);
+    // Server-Daten nur einmal je Laden lesen
+    IfbsSession *pses = IFBS_OpenSession(Server);
+    error = import_eval(Server, ctx->par, out);
+    if(error) {
+        // Bei Fehler wurden eventuell Bibliotheken wieder geloescht
+        IFBS_InvalidateSession(Server, IFBS_SD_LIBDATA);
+    }
+    IFBS_CloseSession(pses);
 
     if(PROTOFILE) {
         fputs((const char*)out, yyout);
@@ -218,9 +173,7 @@ fflush(yyout);
     }
     
     /* Speicher freigeben */
-    memfre(ppar);
-    free(ppar);
-    fb_parser_freestrings();
+    fb_parser_destroy(ctx);
     
     return error;
 }
@@ -245,13 +198,12 @@ KS_RESULT LoadDupl(KscServerBase* Server, PltString &ImpString)
     PltString       NewName;    // Neuen Name der Verbindung
     PltString       Assoc;      // Assoziations-Identifier
     
-        yydebug = 0;
-        current_line = 0;
-
     size_t    Count;            // Merker : Anzahl der Verbindungen
     KS_RESULT err;              // Ergebnis des Dienstes
+    IfbsSession *pses;          // Sitzung fuer Server-Daten
     
-    struct yy_buffer_state* buf;
+    FB_PARSE_CONTEXT* ctx;      // Parse-Sitzung
+    Dienst_param*     ppar;     // Ergebnis des Parsens
     
         /*
         *        check option settings
@@ -264,31 +216,22 @@ KS_RESULT LoadDupl(KscServerBase* Server, PltString &ImpString)
                 return KS_ERR_OK;
         }
 
-        ppar = (Dienst_param*)malloc(sizeof(Dienst_param));
-        if(!ppar) {
+        ctx = fb_parser_create();
+        if(!ctx) {
                 return OV_ERR_HEAPOUTOFMEMORY;
         }
-        ppar->Instance = 0;
-        ppar->Set_Inst_Var = 0;
-        ppar->DelInst = 0;
-        ppar->OldLibs = 0;
-        ppar->NewLibs = 0;
-        ppar->Links = 0;
-        ppar->UnLinks = 0;
+        ppar = ctx->par;
 
 
         /*
         *   Eingabe parsen
         */
-        buf = yy_scan_string( (char*)(const char*)ImpString );
-    exit_status =  yyparse();
-    yy_delete_buffer( buf );
+    exit_status = fb_parser_parsestring(ctx, (const char*)ImpString);
 
     /* String geparst ? */
         if(exit_status != EXIT_SUCCESS) {
-            memfre(ppar);
-            free(ppar);
-        fb_parser_freestrings();
+        iFBS_SetParserError(ctx);
+        fb_parser_destroy(ctx);
         
         return KS_ERR_BADPARAM;
     }
@@ -326,6 +269,8 @@ KS_RESULT LoadDupl(KscServerBase* Server, PltString &ImpString)
     
     // Gibt es Verbindungen ?
     if(Count) {
+        // Index ueber die Links fuer die Suche der Verbindungs-Links
+        IfbsLinkIndex LinkIdx(ppar->Links);
         
         // Dann erzeugen wir neuen Name fuer Verbindungs-Objekt.
         GenerateComConName(Assoc);      // Neuen Name der Verbindung erzeugen
@@ -374,14 +319,7 @@ KS_RESULT LoadDupl(KscServerBase* Server, PltString &ImpString)
                             break;
                     }
                 
-                        pLinks = ppar->Links;
-                        while(  (pLinks) ) {
-                            if( (VerbName == pLinks->children->child_path) &&
-                                (Assoc == pLinks->child_role) ) {
-                                    break;
-                             }
-                            pLinks = pLinks->next;
-                        }
+                        pLinks = LinkIdx.find(VerbName, Assoc);
                         if(!pLinks) {
                         // Link nicht gefunden
                         for(i = 0; i < j; i++) {
@@ -406,7 +344,13 @@ KS_RESULT LoadDupl(KscServerBase* Server, PltString &ImpString)
     // Instanzen anlegen :
     
     VerbName = "";
+    pses = IFBS_OpenSession(Server);
     err = import_eval(Server, ppar, VerbName);
+    if(err) {
+        // Bei Fehler wurden eventuell Bibliotheken wieder geloescht
+        IFBS_InvalidateSession(Server, IFBS_SD_LIBDATA);
+    }
+    IFBS_CloseSession(pses);
 
     // Neue erzeugte Strings freigeben
     for(i = 0; i < Count; i++) {
@@ -414,9 +358,7 @@ KS_RESULT LoadDupl(KscServerBase* Server, PltString &ImpString)
     }
     
 EXIT_FNC:
-        memfre(ppar);
-        free(ppar);
-    fb_parser_freestrings();
+    fb_parser_destroy(ctx);
 
     return err;
 }
@@ -0,0 +1,139 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_linkindex.cpp                                                        *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Index ueber die geparsten Links (Child-Pfad, Child-Rolle). Wird beim     *
+*   Laden zum Finden der Links der Verbindungsobjekte benutzt.               *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+/*****************************************************************************/
+void IfbsLinkIndex::makeKey(std::string &key, const char *child_path, const char *child_role)
+/*****************************************************************************/
+{
+    key = child_path ? child_path : "";
+    key += '\0';
+    key += child_role ? child_role : "";
+}
+
+/*****************************************************************************/
+void IfbsLinkIndex::build(LinksItems *Links)
+/*****************************************************************************/
+{
+    std::string key;
+    
+    index.clear();
+    removed.clear();
+    roles.clear();
+    
+    // Reihenfolge der Liste bleibt je Schluessel erhalten
+    while(Links) {
+        if(Links->children) {
+            makeKey(key, Links->children->child_path, Links->child_role);
+            index[key].push_back(Links);
+            roles.insert(std::string(Links->child_role ? Links->child_role : ""));
+        }
+        Links = Links->next;
+    }
+}
+
+/*****************************************************************************/
+LinksItems* IfbsLinkIndex::find(const char *child_path, const char *child_role)
+/*****************************************************************************/
+{
+    std::string key;
+    
+    makeKey(key, child_path, child_role);
+    
+    std::unordered_map<std::string, std::vector<LinksItems*> >::iterator it = index.find(key);
+    if( (it == index.end()) || it->second.empty() ) {
+        return 0;
+    }
+    return it->second.front();
+}
+
+/*****************************************************************************/
+void IfbsLinkIndex::remove(LinksItems *pLink)
+/*****************************************************************************/
+{
+    std::string key;
+    size_t      i;
+    
+    if( (!pLink) || (!pLink->children) ) {
+        return;
+    }
+    makeKey(key, pLink->children->child_path, pLink->child_role);
+    
+    std::unordered_map<std::string, std::vector<LinksItems*> >::iterator it = index.find(key);
+    if(it == index.end()) {
+        return;
+    }
+    for(i = 0; i < it->second.size(); i++) {
+        if(it->second[i] == pLink) {
+            it->second.erase(it->second.begin() + i);
+            removed.insert(pLink);
+            break;
+        }
+    }
+}
+
+/*****************************************************************************/
+int IfbsLinkIndex::isRemoved(LinksItems *pLink)
+/*****************************************************************************/
+{
+    return removed.count(pLink) ? 1 : 0;
+}
+
+/*****************************************************************************/
+void IfbsLinkIndex::removeChild(const char *child_path)
+/*****************************************************************************/
+{
+    std::unordered_set<std::string>::iterator                   role;
+    std::unordered_map<std::string, std::vector<LinksItems*> >::iterator it;
+    std::string                                                 key;
+    size_t                                                      i;
+
+    // Es gibt nur wenige Rollen, daher je Rolle ein Schluessel
+    for(role = roles.begin(); role != roles.end(); ++role) {
+        makeKey(key, child_path, role->c_str());
+        it = index.find(key);
+        if(it == index.end()) {
+            continue;
+        }
+        for(i = 0; i < it->second.size(); i++) {
+            removed.insert(it->second[i]);
+        }
+        it->second.clear();
+    }
+}
+
+/*****************************************************************************/
+void IfbsLinkIndex::purge(LinksItems **ppLinks)
+/*****************************************************************************/
+{
+    LinksItems *pLink;
+    
+    if(removed.empty()) {
+        return;
+    }
+    
+    // Entfernte Links aus der Liste aushaengen. Der Speicher gehoert dem Parser
+    while(*ppLinks) {
+        pLink = *ppLinks;
+        if(removed.count(pLink)) {
+            *ppLinks = pLink->next;
+        } else {
+            ppLinks = &(pLink->next);
+        }
+    }
+    removed.clear();
+}
@@ -0,0 +1,755 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_loadplan.cpp                                                         *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Ladeplan einer Sicherung. Die Abhaengigkeiten (Bibliothek, Container,    *
+*   Instanz, Part, Verbindung, Link) werden aus den geparsten Daten          *
+*   bestimmt. Die Objekte werden ebenenweise angelegt, unabhaengige Zweige   *
+*   auf Wunsch ueber mehrere Prozesse mit eigener Verbindung gleichzeitig.   *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+#if !PLT_SYSTEM_NT
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+/*
+*  Max. Anzahl paralleler Verbindungen beim Laden
+*/
+static size_t ifbs_LoadConnections = IFBS_LOADCONNECTIONS;
+
+/******************************************************************************/
+void IFBS_SetLoadConnections(size_t anz) {
+/******************************************************************************/
+    if(anz == 0) {
+        anz = 1;
+    }
+    ifbs_LoadConnections = anz;
+}
+
+/******************************************************************************/
+size_t IFBS_GetLoadConnections() {
+/******************************************************************************/
+    return ifbs_LoadConnections;
+}
+
+// Laenge des Parent-Pfades ('/' oder '.' des Parts), 0 = kein Parent
+/*****************************************************************************/
+size_t IfbsLoadPlan::parentLen(const char *path)
+/*****************************************************************************/
+{
+    size_t len;
+
+    if(!path) {
+        return 0;
+    }
+    len = strlen(path);
+    while(len > 0) {
+        len--;
+        if( (path[len] == '/') || (path[len] == '.') ) {
+            return len;
+        }
+    }
+    return 0;
+}
+
+/*****************************************************************************/
+void IfbsLoadPlan::addLibrary(const char *libPath)
+/*****************************************************************************/
+{
+    std::string key(libPath ? libPath : "");
+
+    if(libIdx.find(key) != libIdx.end()) {
+        return;
+    }
+    libIdx[key] = libs.size();
+    libs.push_back(key);
+    libErr.push_back(KS_ERR_OK);
+}
+
+/*****************************************************************************/
+void IfbsLoadPlan::setLibraryResult(const char *libPath, KS_RESULT err)
+/*****************************************************************************/
+{
+    std::unordered_map<std::string, size_t>::iterator it;
+
+    it = libIdx.find(std::string(libPath ? libPath : ""));
+    if(it != libIdx.end()) {
+        libErr[it->second] = err;
+    }
+}
+
+/*****************************************************************************/
+void IfbsLoadPlan::addNode(InstanceItems *pinst, ConData *pcon, int isConn)
+/*****************************************************************************/
+{
+    Node    node;
+
+    node.pinst = pinst;
+    node.pcon = pcon;
+    node.isConn = isConn;
+    node.parent = -1;
+    node.source = -1;
+    node.target = -1;
+    node.library = -1;
+    node.blocked = -1;
+    node.level = -1;
+    node.created = 0;
+
+    // Bei doppelten Instanzen gilt die erste
+    if(instIdx.find(std::string(pinst->Inst_name)) == instIdx.end()) {
+        instIdx[std::string(pinst->Inst_name)] = nodes.size();
+    }
+    nodes.push_back(node);
+}
+
+/*****************************************************************************/
+void IfbsLoadPlan::addInstances(InstanceItems *Instances)
+/*****************************************************************************/
+{
+    while(Instances) {
+        addNode(Instances, 0, 0);
+        Instances = Instances->next;
+    }
+}
+
+/*****************************************************************************/
+void IfbsLoadPlan::addConnection(InstanceItems *pinst, ConData *pCR)
+/*****************************************************************************/
+{
+    addNode(pinst, pCR, 1);
+}
+
+/*****************************************************************************/
+void IfbsLoadPlan::addLink(LinksItems *pLink)
+/*****************************************************************************/
+{
+    links.push_back(pLink);
+}
+
+// Index des Objekts in der Sicherung, -1 = nicht in Sicherung
+/*****************************************************************************/
+long IfbsLoadPlan::nodeOf(const char *path)
+/*****************************************************************************/
+{
+    std::unordered_map<std::string, size_t>::iterator it;
+
+    it = instIdx.find(std::string(path ? path : ""));
+    if(it == instIdx.end()) {
+        return -1;
+    }
+    return (long)it->second;
+}
+
+/*****************************************************************************/
+InstanceItems* IfbsLoadPlan::findInstance(const char *path)
+/*****************************************************************************/
+{
+    std::unordered_map<std::string, size_t>::iterator it;
+
+    it = instIdx.find(std::string(path ? path : ""));
+    if(it == instIdx.end()) {
+        return 0;
+    }
+    return nodes[it->second].pinst;
+}
+
+/*****************************************************************************/
+void IfbsLoadPlan::setCreated(InstanceItems *pinst)
+/*****************************************************************************/
+{
+    std::unordered_map<std::string, size_t>::iterator it;
+
+    it = instIdx.find(std::string(pinst->Inst_name));
+    if( (it != instIdx.end()) && (nodes[it->second].pinst == pinst) ) {
+        nodes[it->second].created = 1;
+    }
+}
+
+/*****************************************************************************/
+void IfbsLoadPlan::createParentDomains(KscServerBase      *Server,
+                                       PltList<PltString> &Paths,
+                                       PltString          &out)
+/*****************************************************************************/
+{
+    // Wird die Sicherung in eine leere DB geladen, gibt es eventuell die
+    // Container nicht. Jeder Pfad wird nur einmal geprueft.
+    std::unordered_set<std::string>  checked;
+    InstanceItems                    NewInst;
+    InstanceItems                   *pinst;
+    std::string                      path;
+    size_t                           i, anz;
+
+    NewInst.Class_name = CONTAINER_CLASS_PATH;
+    NewInst.Inst_var = 0;
+    NewInst.next = 0;
+
+    anz = Paths.size();
+    while(anz > 0) {
+        PltString hStr = Paths.removeFirst();
+        Paths.addLast(hStr);
+        anz--;
+
+        path = (const char*)hStr;
+
+        // Alle Parent-Objekte von oben nach unten (1. '/' ignorieren)
+        for(i = 1; i < path.size(); i++) {
+            if(path[i] != '/') {
+                continue;
+            }
+            std::string parent(path, 0, i);
+            if(!checked.insert(parent).second) {
+                continue;
+            }
+
+            if( existIdx.exists(Server, parent.c_str()) ) {
+                // In DB vorhanden
+                continue;
+            }
+
+            // Steht die Instanz in der Sicherung? Sonst als Container anlegen
+            pinst = findInstance(parent.c_str());
+            if(pinst) {
+                if( FB_CreateNewInstance(Server, pinst, out, &existIdx) == KS_ERR_OK ) {
+                    setCreated(pinst);
+                }
+            } else {
+                NewInst.Inst_name = (char*)parent.c_str();
+                FB_CreateNewInstance(Server, &NewInst, out, &existIdx);
+            }
+        }
+    }
+}
+
+// Ebene und blockierende Bibliothek einer Instanz oder Verbindung
+/*****************************************************************************/
+int IfbsLoadPlan::levelOf(size_t i)
+/*****************************************************************************/
+{
+    Node   *pnode = &nodes[i];
+    long    dep[3];
+    size_t  len, d;
+    int     lvl;
+
+    if(pnode->level >= 0) {
+        return pnode->level;
+    }
+    // Gegen Zyklen (doppelte Instanzen) vorbelegen
+    pnode->level = 0;
+
+    // Parent in der Sicherung?
+    len = parentLen(pnode->pinst->Inst_name);
+    if(len > 0) {
+        std::unordered_map<std::string, size_t>::iterator it =
+            instIdx.find(std::string(pnode->pinst->Inst_name, len));
+        if( (it != instIdx.end()) && (it->second != i) ) {
+            pnode->parent = (long)it->second;
+        }
+    }
+
+    // Bibliothek der Klasse in der Sicherung?
+    len = parentLen(pnode->pinst->Class_name);
+    if(len > 0) {
+        std::unordered_map<std::string, size_t>::iterator it =
+            libIdx.find(std::string(pnode->pinst->Class_name, len));
+        if(it != libIdx.end()) {
+            pnode->library = (long)it->second;
+            if(libErr[it->second] != KS_ERR_OK) {
+                pnode->blocked = pnode->library;
+            }
+        }
+    }
+
+    // Quell- und Ziel-FB einer Verbindung in der Sicherung?
+    if(pnode->pcon) {
+        pnode->source = nodeOf((const char*)pnode->pcon->source_fb);
+        pnode->target = nodeOf((const char*)pnode->pcon->target_fb);
+    }
+
+    // Eine Ebene ueber der hoechsten noch nicht angelegten Abhaengigkeit
+    dep[0] = pnode->parent;
+    dep[1] = pnode->source;
+    dep[2] = pnode->target;
+    for(d = 0; d < 3; d++) {
+        if( (dep[d] < 0) || ((size_t)dep[d] == i) ) {
+            continue;
+        }
+        lvl = levelOf((size_t)dep[d]);
+        // Vektor kann beim Aufruf nicht wachsen, Zeiger bleibt gueltig
+        if(pnode->blocked < 0) {
+            pnode->blocked = nodes[dep[d]].blocked;
+        }
+        if( (!nodes[dep[d]].created) && (lvl + 1 > pnode->level) ) {
+            pnode->level = lvl + 1;
+        }
+    }
+
+    return pnode->level;
+}
+
+// Ebene eines Links : eine ueber Parent und Kindern
+/*****************************************************************************/
+int IfbsLoadPlan::linkLevelOf(LinksItems *pLink)
+/*****************************************************************************/
+{
+    Child  *pChild;
+    long    n;
+    int     level = 0;
+
+    n = nodeOf(pLink->parent_path);
+    if( (n >= 0) && (!nodes[n].created) && (levelOf((size_t)n) + 1 > level) ) {
+        level = nodes[n].level + 1;
+    }
+    for(pChild = pLink->children; pChild; pChild = pChild->next) {
+        n = nodeOf(pChild->child_path);
+        if( (n >= 0) && (!nodes[n].created) && (levelOf((size_t)n) + 1 > level) ) {
+            level = nodes[n].level + 1;
+        }
+    }
+    return level;
+}
+
+/*****************************************************************************/
+size_t IfbsLoadPlan::build()
+/*****************************************************************************/
+{
+    std::vector<int>    linkLvl(links.size(), 0);
+    size_t              i, lvl, g;
+    int                 maxLvl = -1;
+
+    for(i = 0; i < nodes.size(); i++) {
+        nodes[i].level = -1;
+        nodes[i].parent = -1;
+        nodes[i].source = -1;
+        nodes[i].target = -1;
+        nodes[i].library = -1;
+        nodes[i].blocked = -1;
+    }
+    for(i = 0; i < nodes.size(); i++) {
+        if(levelOf(i) > maxLvl) {
+            maxLvl = nodes[i].level;
+        }
+    }
+    for(i = 0; i < links.size(); i++) {
+        linkLvl[i] = linkLevelOf(links[i]);
+        if(linkLvl[i] > maxLvl) {
+            maxLvl = linkLvl[i];
+        }
+    }
+
+    levelList.clear();
+    groupList.clear();
+    connList.clear();
+    conDataList.clear();
+    linkList.clear();
+    createdList.clear();
+    levelList.resize((size_t)(maxLvl + 1));
+    groupList.resize((size_t)(maxLvl + 1));
+    connList.resize((size_t)(maxLvl + 1));
+    conDataList.resize((size_t)(maxLvl + 1));
+    linkList.resize((size_t)(maxLvl + 1));
+
+    // Kinder eines Parents je Ebene zusammenfassen (Reihenfolge der Datei)
+    std::vector<std::unordered_map<std::string, size_t> > groupIdx((size_t)(maxLvl + 1));
+    std::vector<std::vector<std::vector<InstanceItems*> > > groups((size_t)(maxLvl + 1));
+
+    for(i = 0; i < nodes.size(); i++) {
+        if(nodes[i].created) {
+            createdList.push_back(nodes[i].pinst);
+            continue;
+        }
+        lvl = (size_t)nodes[i].level;
+        if(nodes[i].isConn) {
+            connList[lvl].push_back(nodes[i].pinst);
+            conDataList[lvl].push_back(nodes[i].pcon);
+            continue;
+        }
+        std::string parent(nodes[i].pinst->Inst_name, parentLen(nodes[i].pinst->Inst_name));
+        std::unordered_map<std::string, size_t>::iterator it = groupIdx[lvl].find(parent);
+        if(it == groupIdx[lvl].end()) {
+            g = groups[lvl].size();
+            groupIdx[lvl][parent] = g;
+            groups[lvl].push_back(std::vector<InstanceItems*>());
+        } else {
+            g = it->second;
+        }
+        groups[lvl][g].push_back(nodes[i].pinst);
+    }
+
+    for(lvl = 0; lvl < levelList.size(); lvl++) {
+        for(g = 0; g < groups[lvl].size(); g++) {
+            groupList[lvl].push_back(levelList[lvl].size());
+            levelList[lvl].insert(levelList[lvl].end(), groups[lvl][g].begin(), groups[lvl][g].end());
+        }
+    }
+    for(i = 0; i < links.size(); i++) {
+        linkList[(size_t)linkLvl[i]].push_back(links[i]);
+    }
+
+    return levelList.size();
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsLoadPlan::getBlocked(PltString &out, PltString &log)
+/*****************************************************************************/
+{
+    std::vector<size_t>  anzBlocked(libs.size(), 0);
+    KS_RESULT            err = KS_ERR_OK;
+    char                 help[64];
+    size_t               i;
+
+    for(i = 0; i < nodes.size(); i++) {
+        if(nodes[i].blocked >= 0) {
+            anzBlocked[nodes[i].blocked]++;
+        }
+    }
+    for(i = 0; i < libs.size(); i++) {
+        if(!anzBlocked[i]) {
+            continue;
+        }
+        sprintf(help, "%lu", (unsigned long)anzBlocked[i]);
+        out += log_getErrMsg(libErr[i], help, "instance(s) not created. Library",
+                             libs[i].c_str(), "couldn't be loaded.");
+        if(err == KS_ERR_OK) {
+            err = libErr[i];
+            log  = "\"%s\"  \"";
+            log += libs[i].c_str();
+            log += "\"";
+        }
+    }
+    return err;
+}
+
+/*****************************************************************************/
+size_t IfbsLoadPlan::setConnections(size_t anz)
+/*****************************************************************************/
+{
+    // Die Verbindung des Aufrufers zaehlt mit
+    anzConn = anz ? anz : 1;
+    return anzConn;
+}
+
+/*
+*  Arbeit einer Ebene. Die Eintraege sind die Instanzen, danach die
+*  Verbindungen, danach die Links der Ebene. Ein Abschnitt sind aufeinander
+*  folgende Parent-Gruppen bis zur Batch-Groesse oder eine groessere Gruppe,
+*  bzw. bis zu Batch-Groesse Verbindungen oder Links. Ein Abschnitt wird von
+*  einer Verbindung der Reihe nach angelegt, Abschnitt k von Prozess
+*  k % anzProc (0 = Aufrufer).
+*/
+class IfbPlanWork {
+public:
+    InstanceItems     **pinst;
+    InstanceItems     **pcon;       // Verbindungen ab Eintrag anzInst
+    ConData           **pcr;
+    LinksItems        **plink;      // Links ab Eintrag anzInst + anzCon
+    size_t              anzInst;
+    size_t              anzCon;
+    KS_RESULT          *results;
+    IfbsExistIndex     *pIdx;
+    size_t              batchSize;
+    std::vector<size_t> start;      // Beginn der Abschnitte, letzter = Ende
+    PltArray<PltString> *outs;      // Ausgabe je Abschnitt
+};
+
+// Links eines Abschnitts mit wenigen Link-Diensten anlegen und protokollieren
+/*****************************************************************************/
+static void ifb_planLinks(IfbPlanWork *work, size_t k, KscServerBase *Server)
+/*****************************************************************************/
+{
+    std::string                 linkPath;
+    std::vector<std::string>    LinkPaths;
+    std::vector<std::string>    ElemPaths;
+    std::vector<KS_RESULT>      Results;
+    PltString                  &out = (*work->outs)[k];
+    LinksItems                 *pLinks;
+    Child                      *pChild;
+    KS_RESULT                   error;
+    size_t                      i, lnr;
+
+    for(i = work->start[k]; i < work->start[k+1]; i++) {
+        pLinks = work->plink[i - work->anzInst - work->anzCon];
+        linkPath  = pLinks->parent_path;
+        linkPath += ".";
+        linkPath += pLinks->child_role;
+
+        for(pChild = pLinks->children; pChild; pChild = pChild->next) {
+            LinkPaths.push_back(linkPath);
+            ElemPaths.push_back(pChild->child_path);
+        }
+    }
+    ifb_createLinks(Server, LinkPaths, ElemPaths, Results);
+
+    lnr = 0;
+    for(i = work->start[k]; i < work->start[k+1]; i++) {
+        pLinks = work->plink[i - work->anzInst - work->anzCon];
+        for(pChild = pLinks->children; pChild; pChild = pChild->next) {
+            error = Results[lnr];
+            lnr++;
+            if(error) {
+                if(error != KS_ERR_ALREADYEXISTS) {
+                    out += log_getErrMsg(error,
+                        "Parent ",pLinks->parent_path,
+                        " and child ", pChild->child_path,
+                        " couldn't be linked.");
+                }
+            } else {
+                out += log_getOkMsg("Parent",pLinks->parent_path,
+                                    "and child",pChild->child_path,
+                                    "linked.");
+            }
+        }
+        work->results[i] = KS_ERR_OK;
+    }
+}
+
+/*****************************************************************************/
+static void ifb_planSection(IfbPlanWork *work, size_t k, KscServerBase *Server)
+/*****************************************************************************/
+{
+    size_t  i, anz;
+
+    if(work->start[k] >= work->anzInst + work->anzCon) {
+        ifb_planLinks(work, k, Server);
+        return;
+    }
+    if(work->start[k] >= work->anzInst) {
+        for(i = work->start[k]; i < work->start[k+1]; i++) {
+            anz = i - work->anzInst;
+            work->results[i] = FB_CreateConnection(Server, work->pcon[anz], work->pcr[anz],
+                                                   (*work->outs)[k], work->pIdx);
+        }
+        return;
+    }
+    for(i = work->start[k]; i < work->start[k+1]; i += anz) {
+        anz = work->start[k+1] - i;
+        if(anz > work->batchSize) {
+            anz = work->batchSize;
+        }
+        FB_CreateNewInstances(Server, work->pinst + i, anz, work->results + i,
+                              (*work->outs)[k], work->pIdx);
+    }
+}
+
+#if !PLT_SYSTEM_NT
+/*
+*  Ergebnis eines Prozesses in seiner Temp-Datei : je Abschnitt die Ergebnisse
+*  der Instanzen, Laenge und Text der Ausgabe, danach Laenge und Daten des
+*  Journals des Existenz-Index.
+*/
+/*****************************************************************************/
+static int ifb_planWrite(FILE *f, const void *data, size_t len)
+/*****************************************************************************/
+{
+    return (fwrite(&len, sizeof(len), 1, f) == 1) &&
+           ((!len) || (fwrite(data, 1, len, f) == len));
+}
+
+/*****************************************************************************/
+static int ifb_planRead(FILE *f, std::vector<char> &buf)
+/*****************************************************************************/
+{
+    size_t len;
+
+    if(fread(&len, sizeof(len), 1, f) != 1) {
+        return 0;
+    }
+    buf.resize(len + 1);
+    buf[len] = '\0';
+    return (!len) || (fread(&buf[0], 1, len, f) == len);
+}
+
+/*****************************************************************************/
+static void ifb_planChild(IfbPlanWork *work, size_t nr, size_t anzProc,
+                          KscServerBase *Server, FILE *f)
+/*****************************************************************************/
+{
+    KS_RESULT       err;
+    KscServerBase  *conn;
+    std::string     journal;
+    size_t          k, anz;
+    int             ok;
+
+    // Eigene Verbindung, die des Aufrufers gehoert dem Elternprozess
+    conn = IFBS_OpenServerConnection(Server, err);
+    if(!conn) {
+        _exit(1);
+    }
+    work->pIdx->setJournal(&journal);
+
+    ok = 1;
+    for(k = nr; ok && (k + 1 < work->start.size()); k += anzProc) {
+        ifb_planSection(work, k, conn);
+        anz = work->start[k+1] - work->start[k];
+        ok = ifb_planWrite(f, work->results + work->start[k], anz * sizeof(KS_RESULT)) &&
+             ifb_planWrite(f, (const char*)(*work->outs)[k], (*work->outs)[k].len());
+    }
+    ok = ok && ifb_planWrite(f, journal.data(), journal.size()) && (fflush(f) == 0);
+
+    IFBS_CloseServerConnection(conn);
+    _exit(ok ? 0 : 1);
+}
+
+/*****************************************************************************/
+static int ifb_planResult(IfbPlanWork *work, size_t nr, size_t anzProc, FILE *f)
+/*****************************************************************************/
+{
+    std::vector<char>   buf;
+    size_t              k, anz;
+
+    rewind(f);
+    for(k = nr; k + 1 < work->start.size(); k += anzProc) {
+        anz = work->start[k+1] - work->start[k];
+        if( (!ifb_planRead(f, buf)) || (buf.size() != anz * sizeof(KS_RESULT) + 1) ) {
+            return 0;
+        }
+        memcpy(work->results + work->start[k], &buf[0], anz * sizeof(KS_RESULT));
+        if(!ifb_planRead(f, buf)) {
+            return 0;
+        }
+        (*work->outs)[k] = &buf[0];
+    }
+    if(!ifb_planRead(f, buf)) {
+        return 0;
+    }
+    work->pIdx->replay(&buf[0], buf.size() - 1);
+    return 1;
+}
+#endif
+
+/*****************************************************************************/
+void IfbsLoadPlan::createLevel(KscServerBase *Server, size_t lvl,
+                               KS_RESULT *results, KS_RESULT *conResults,
+                               PltString &out)
+/*****************************************************************************/
+{
+    std::vector<InstanceItems*> &items = levelList[lvl];
+    std::vector<size_t>         &grp = groupList[lvl];
+    std::vector<InstanceItems*> &cons = connList[lvl];
+    std::vector<ConData*>       &crs = conDataList[lvl];
+    std::vector<LinksItems*>    &lks = linkList[lvl];
+    std::vector<KS_RESULT>       Results(items.size() + cons.size() + lks.size(), KS_ERR_OK);
+    IfbPlanWork                  work;
+    size_t                       g, k, end, anzProc;
+
+    if(!Results.size()) {
+        return;
+    }
+
+    work.pinst = items.size() ? &items[0] : 0;
+    work.pcon = cons.size() ? &cons[0] : 0;
+    work.pcr = crs.size() ? &crs[0] : 0;
+    work.plink = lks.size() ? &lks[0] : 0;
+    work.anzInst = items.size();
+    work.anzCon = cons.size();
+    work.results = &Results[0];
+    work.pIdx = &existIdx;
+    work.batchSize = IFBS_GetCreateObjBatchSize();
+
+    // Abschnitte bilden
+    g = 0;
+    while(g < grp.size()) {
+        work.start.push_back(grp[g]);
+        g++;
+        while( (g < grp.size()) && (grp[g] - work.start.back() < work.batchSize) ) {
+            end = (g + 1 < grp.size()) ? grp[g+1] : items.size();
+            if(end - work.start.back() > work.batchSize) {
+                break;
+            }
+            g++;
+        }
+    }
+    // Verbindungen und Links je Batch-Groesse
+    for(g = 0; g < cons.size(); g += work.batchSize) {
+        work.start.push_back(items.size() + g);
+    }
+    for(g = 0; g < lks.size(); g += work.batchSize) {
+        work.start.push_back(items.size() + cons.size() + g);
+    }
+    work.start.push_back(Results.size());
+
+    PltArray<PltString> Outs(work.start.size());
+    work.outs = &Outs;
+
+    anzProc = work.start.size() - 1;
+    if(anzProc > anzConn) {
+        anzProc = anzConn;
+    }
+#if PLT_SYSTEM_NT
+    anzProc = 1;
+#else
+    if(anzProc > 1) {
+        // Die KS-Verbindungen und der Fehlerzustand der Bibliothek sind
+        // nicht fuer Threads ausgelegt. Weitere Abschnitte legen daher
+        // Kind-Prozesse ueber eigene Verbindungen an, das Ergebnis kommt
+        // ueber eine Temp-Datei zurueck.
+        std::vector<FILE*>  Files(anzProc, (FILE*)0);
+        std::vector<pid_t>  Pids(anzProc, (pid_t)-1);
+        int                 st;
+
+        fflush(stdout);
+        fflush(stderr);
+        for(k = 1; k < anzProc; k++) {
+            Files[k] = tmpfile();
+            if(!Files[k]) {
+                continue;
+            }
+            Pids[k] = fork();
+            if(Pids[k] == 0) {
+                ifb_planChild(&work, k, anzProc, Server, Files[k]);
+            }
+        }
+
+        for(k = 0; k + 1 < work.start.size(); k += anzProc) {
+            ifb_planSection(&work, k, Server);
+        }
+
+        for(k = 1; k < anzProc; k++) {
+            st = -1;
+            if(Pids[k] > 0) {
+                while( (waitpid(Pids[k], &st, 0) < 0) && (errno == EINTR) ) {
+                }
+            }
+            if( (st != 0) || (!ifb_planResult(&work, k, anzProc, Files[k])) ) {
+                // Prozess fehlgeschlagen : Abschnitte selbst anlegen. Schon
+                // angelegte Instanzen werden im Index nachgelesen
+                for(g = k; g + 1 < work.start.size(); g += anzProc) {
+                    Outs[g] = "";
+                    ifb_planSection(&work, g, Server);
+                }
+            }
+            if(Files[k]) {
+                fclose(Files[k]);
+            }
+        }
+    } else
+#endif
+    {
+        for(k = 0; k + 1 < work.start.size(); k++) {
+            ifb_planSection(&work, k, Server);
+        }
+    }
+
+    // Ausgabe in Reihenfolge der Ebene
+    for(k = 0; k + 1 < work.start.size(); k++) {
+        out += Outs[k];
+    }
+    for(g = 0; g < items.size(); g++) {
+        results[g] = Results[g];
+    }
+    for(g = 0; g < cons.size(); g++) {
+        conResults[g] = Results[items.size() + g];
+    }
+}
@@ -247,41 +247,38 @@ PltString IFBS_GetLastLogError() {
 }
 
 /******************************************************************************/
-PltString iFBS_PrintParserError(int set, PltString& Err) {
+PltString IFBS_GetParserError(FB_PARSE_CONTEXT *ctx) {
 /******************************************************************************/
+ PltString Str;
+ char ph[64];
 
- static PltString Str;
-
- if(set) {
-    Str = Err;
+ if( (!ctx) || (!ctx->error_msg[0]) ) {
+    return Str;
  }
  
- return Str;
-
-}
-
-/******************************************************************************/
-PltString IFBS_GetParserError() {
-/******************************************************************************/
- PltString Str;
+ sprintf(ph, "line : %d : ", ctx->error_line);
+ 
+ Str = ph;
+ Str += ctx->error_msg;
 
- return iFBS_PrintParserError(0, Str);
+ return Str;
 }
 
 /******************************************************************************/
-extern "C" void iFBS_SetParserError(int line, char* msg) {
+void iFBS_SetParserError(FB_PARSE_CONTEXT *ctx) {
 /******************************************************************************/
  
  PltString Str;
  KS_RESULT err = 0;
  char ph[1024];
+ int  line;
+ const char *msg;
  
- sprintf(ph, "line : %d : ", line);
- 
- Str = ph;
- Str += msg;
-
- iFBS_PrintParserError( 1, Str);
+ if(!ctx) {
+    return;
+ }
+ line = ctx->error_line;
+ msg = ctx->error_msg[0] ? ctx->error_msg : "Parse error.";
  
  sprintf(ph, "%d  \"%s\"  \"line %s\"  %d  \"%s\"",
               FB_ERR_ATPARSE,
@@ -44,138 +44,22 @@
 void memfre(Dienst_param* parms)
 /*****************************************************************************/
 {
-    InstanceItems*         delinst;
-    Variables*            delvar;
-    VariableItem*        delval;
-
-    SetInstVarItems* delsetvar;
-    DelInstItems*    deldinst;
-
-    LinksItems*            dellinks;
-    Child*                    delchild;
-
+    /*
+    *   Alle Strukturen liegen im Speicher des Parsers und werden mit
+    *   fb_parser_destroy() in einem Schritt freigegeben. Hier werden
+    *   nur die Listen geleert.
+    */
     if( !parms ) {
         return;
     }
     
-    while(parms->Instance) {
-        
-        delinst = parms->Instance;
-
-        parms->Instance = delinst->next;
-        
-        while(delinst->Inst_var) {
-
-            delvar = delinst->Inst_var;
-            delinst->Inst_var = delvar->next;
-            
-            while(delvar->value) {
-
-                delval = delvar->value;
-                delvar->value = delval->next;
-
-                free(delval);
-            } /* while delvar->value */
-
-            free(delvar);
-
-        } /* while delinst->Inst_var */
-
-        free(delinst);
-
-    } /* while parms->Instance */
-
-    while(parms->Set_Inst_Var) {
-
-        delsetvar = parms->Set_Inst_Var;
-        parms->Set_Inst_Var = delsetvar->next;
-        
-        while(delsetvar->Inst_var) {
-        
-            delvar = delsetvar->Inst_var;
-            delsetvar->Inst_var = delvar->next;
-            
-            while(delvar->value) {
-
-                delval = delvar->value;
-                delvar->value = delval->next;
-                
-                free(delval);
-            } /* while delvar->value */
-
-            free(delvar);
-
-        } /* while delsetvar->Inst_var */
-
-        free(delsetvar);
-
-    } /* while parms->Set_Inst_Var */
-
-
-    while(parms->DelInst) {
-        
-        deldinst = parms->DelInst;
-        parms->DelInst = deldinst->next;
-        
-        free(deldinst);
-
-    } /* while parms->DelInst */
-
-
-    while(parms->OldLibs) {
-        
-        deldinst = parms->OldLibs;
-        parms->OldLibs = deldinst->next;
-
-        free(deldinst);
-
-    } /* while parms->OldLibs */
-
-    while(parms->NewLibs) {
-        
-        deldinst = parms->NewLibs;
-        parms->NewLibs = deldinst->next;
-
-        free(deldinst);
-
-    } /* while parms->NewLibs */
-
-
-    while(parms->Links) {
-
-        dellinks = parms->Links;
-        parms->Links = dellinks->next;
-        
-        while(dellinks->children) {
-
-            delchild = dellinks->children;
-            dellinks->children = delchild->next;
-            
-            free(delchild);
-
-        } /* while dellinks->children */
-
-        free(dellinks);
-
-    } /* while parms->Links */
-
-    while(parms->UnLinks) {
-
-        dellinks = parms->UnLinks;
-        parms->UnLinks = dellinks->next;
-    
-        while(dellinks->children) {
-
-            delchild = dellinks->children;
-            dellinks->children = delchild->next;
-            
-            free(delchild);
-
-        } /* while dellinks->children */
-
-        free(dellinks);
-
-    } /* while parms->UnLinks */
+    parms->Instance = 0;
+    parms->Set_Inst_Var = 0;
+    parms->DelInst = 0;
+    parms->OldLibs = 0;
+    parms->NewLibs = 0;
+    parms->Links = 0;
+    parms->UnLinks = 0;
 
     return;
 
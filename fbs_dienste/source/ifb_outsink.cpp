@@ -0,0 +1,241 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_outsink.cpp                                                          *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Ausgabe in wiederverwendete Buffer fester Groesse. Volle Buffer werden   *
+*   mit einem writev() in eine Datei geschrieben oder einer Callback-        *
+*   Funktion uebergeben.                                                     *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+#include <fcntl.h>
+#if !PLT_SYSTEM_NT
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <errno.h>
+#else
+#include <io.h>
+#endif
+
+/*****************************************************************************/
+int IfbsOutSink::openFile(const char *filename, int binary)
+/*****************************************************************************/
+{
+#if !PLT_SYSTEM_NT
+    return open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+#else
+    return _open(filename, _O_WRONLY | _O_CREAT | _O_TRUNC | (binary ? _O_BINARY : _O_TEXT),
+                 _S_IREAD | _S_IWRITE);
+#endif
+}
+
+/*****************************************************************************/
+void IfbsOutSink::closeFile(int fd)
+/*****************************************************************************/
+{
+    if(fd >= 0) {
+#if !PLT_SYSTEM_NT
+        close(fd);
+#else
+        _close(fd);
+#endif
+    }
+}
+
+/*****************************************************************************/
+IfbsOutSink::IfbsOutSink(int fd, size_t chunkSize)
+/*****************************************************************************/
+  : fd(fd),
+    fnc(0),
+    pUser(0)
+{
+    init(chunkSize);
+}
+
+/*****************************************************************************/
+IfbsOutSink::IfbsOutSink(IfbsOutSinkFnc fnc, void *pUser, size_t chunkSize)
+/*****************************************************************************/
+  : fd(-1),
+    fnc(fnc),
+    pUser(pUser)
+{
+    init(chunkSize);
+}
+
+/*****************************************************************************/
+void IfbsOutSink::init(size_t size)
+/*****************************************************************************/
+{
+    chunkSize = size ? size : IFBS_OUTSINK_CHUNKSIZE;
+    cur = 0;
+    written = 0;
+    err = KS_ERR_OK;
+    // Buffer werden erst bei Bedarf angelegt
+    chunks.resize(1);
+    used.assign(1, 0);
+}
+
+/*****************************************************************************/
+void IfbsOutSink::put(const char *text)
+/*****************************************************************************/
+{
+    if(text) {
+        put(text, strlen(text));
+    }
+}
+
+/*****************************************************************************/
+void IfbsOutSink::put(PltString &Str)
+/*****************************************************************************/
+{
+    if(Str.len()) {
+        put((const char*)Str, Str.len());
+    }
+}
+
+/*****************************************************************************/
+void IfbsOutSink::put(const char *text, size_t len)
+/*****************************************************************************/
+{
+    size_t  anz;
+
+    if(err) {
+        return;
+    }
+    if(len >= chunkSize) {
+        // Grosser Text wird ohne Kopie nach dem Inhalt der Buffer geschrieben
+        write(text, len);
+        return;
+    }
+    while(len) {
+        if(chunks[cur].size() != chunkSize) {
+            chunks[cur].resize(chunkSize);
+        }
+        anz = chunkSize - used[cur];
+        if(anz > len) {
+            anz = len;
+        }
+        memcpy(&chunks[cur][used[cur]], text, anz);
+        used[cur] += anz;
+        text += anz;
+        len -= anz;
+
+        if(used[cur] == chunkSize) {
+            // Naechster Buffer. Sind alle voll, werden sie geschrieben
+            if(cur + 1 < IFBS_OUTSINK_CHUNKS) {
+                cur++;
+                if(chunks.size() <= cur) {
+                    chunks.resize(cur + 1);
+                    used.push_back(0);
+                }
+            } else {
+                write(0, 0);
+            }
+        }
+    }
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsOutSink::flush()
+/*****************************************************************************/
+{
+    if(!err) {
+        write(0, 0);
+    }
+    return err;
+}
+
+// Alle Buffer und danach text schreiben. Die Buffer sind danach leer
+/*****************************************************************************/
+void IfbsOutSink::write(const char *text, size_t len)
+/*****************************************************************************/
+{
+    size_t  i, n;
+
+    if(fnc) {
+        for(i = 0; (!err) && (i <= cur); i++) {
+            if(used[i]) {
+                if(fnc(pUser, &chunks[i][0], used[i])) {
+                    err = OV_ERR_CANTWRITETOFILE;
+                }
+                written += used[i];
+            }
+        }
+        if( (!err) && len ) {
+            if(fnc(pUser, text, len)) {
+                err = OV_ERR_CANTWRITETOFILE;
+            }
+            written += len;
+        }
+    } else {
+#if !PLT_SYSTEM_NT
+        struct iovec    iov[IFBS_OUTSINK_CHUNKS + 1];
+        ssize_t         res;
+        size_t          k = 0;
+
+        n = 0;
+        for(i = 0; i <= cur; i++) {
+            if(used[i]) {
+                iov[n].iov_base = &chunks[i][0];
+                iov[n].iov_len = used[i];
+                n++;
+            }
+        }
+        if(len) {
+            iov[n].iov_base = (void*)text;
+            iov[n].iov_len = len;
+            n++;
+        }
+        // Teilweise Schreiben fortsetzen
+        while( (!err) && (k < n) ) {
+            res = writev(fd, &iov[k], (int)(n - k));
+            if(res < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                err = OV_ERR_CANTWRITETOFILE;
+                break;
+            }
+            written += (size_t)res;
+            while( (k < n) && ((size_t)res >= iov[k].iov_len) ) {
+                res -= iov[k].iov_len;
+                k++;
+            }
+            if(k < n) {
+                iov[k].iov_base = (char*)iov[k].iov_base + res;
+                iov[k].iov_len -= res;
+            }
+        }
+#else
+        for(i = 0; (!err) && (i <= cur); i++) {
+            if( used[i] && (_write(fd, &chunks[i][0], (unsigned int)used[i]) != (int)used[i]) ) {
+                err = OV_ERR_CANTWRITETOFILE;
+            }
+            written += used[i];
+        }
+        if( (!err) && len ) {
+            n = (size_t)_write(fd, text, (unsigned int)len);
+            if(n != len) {
+                err = OV_ERR_CANTWRITETOFILE;
+            }
+            written += len;
+        }
+#endif
+    }
+
+    for(i = 0; i <= cur; i++) {
+        used[i] = 0;
+    }
+    cur = 0;
+}
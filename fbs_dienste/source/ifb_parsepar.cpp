@@ -0,0 +1,250 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_parsepar.cpp                                                         *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Paralleles Parsen einer Sicherungsdatei. Die Datei ist eine Folge        *
+*   unabhaengiger LIBRARY-, INSTANCE- und LINK-Bloecke. Ein Vorlauf sucht    *
+*   Blockenden (END_INSTANCE; / END_LINK; ausserhalb von Strings und         *
+*   Kommentaren), an denen die Eingabe geteilt wird. Die Teile werden in     *
+*   eigenen Parse-Sitzungen gleichzeitig geparst und in Dateireihenfolge     *
+*   zusammengefuegt. Das Teilen braucht die ganze Datei in einem Puffer.     *
+*   Komprimierter Text wird daher nicht geteilt, sondern sequentiell beim    *
+*   Entpacken geparst (fb_parser_parseinput).                                *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+#include <thread>
+
+/*
+*  Max. Anzahl Threads beim Parsen (0 = Anzahl Prozessoren)
+*/
+static size_t ifbs_ParseThreads = IFBS_PARSETHREADS;
+
+/******************************************************************************/
+void IFBS_SetParseThreads(size_t anz) {
+/******************************************************************************/
+    ifbs_ParseThreads = anz;
+}
+
+/******************************************************************************/
+size_t IFBS_GetParseThreads() {
+/******************************************************************************/
+    return ifbs_ParseThreads;
+}
+
+/*
+*  Zeichen eines Bezeichners oder Pfades
+*/
+static int ifb_isTokenChar(char c) {
+    return ( ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+             ((c >= '0') && (c <= '9')) || (c == '_') || (c == '%') ||
+             (c == '/') || (c == '.') );
+}
+
+static int ifb_isSpace(char c) {
+    return ( (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n') );
+}
+
+/*
+*  Prueft, ob bei pos ein Blockende (END_INSTANCE; oder END_LINK;) beginnt.
+*  Liefert die Position nach dem ';' oder 0
+*/
+static size_t ifb_matchBlockEnd(const char *pIn, size_t size, size_t pos) {
+    size_t  len;
+
+    if( (pos > 0) && ifb_isTokenChar(pIn[pos-1]) ) {
+        return 0;
+    }
+    if( (size - pos > 12) && !strncmp(pIn + pos, "END_INSTANCE", 12) ) {
+        len = 12;
+    } else if( (size - pos > 8) && !strncmp(pIn + pos, "END_LINK", 8) ) {
+        len = 8;
+    } else {
+        return 0;
+    }
+    pos += len;
+    while( (pos < size) && ((pIn[pos] == ' ') || (pIn[pos] == '\t')) ) {
+        pos++;
+    }
+    if( (pos < size) && (pIn[pos] == ';') ) {
+        return pos + 1;
+    }
+    return 0;
+}
+
+/*
+*  Sucht bis zu anz-1 Teilungspunkte, je einen nach k*size/anz. Ein Teil endet
+*  hinter dem ';' eines Blockendes, die folgenden 2 Leerzeichen werden zu
+*  Nullbytes (Ende-Kennung fuer den Scanner). pStart/pLine erhalten Beginn und
+*  Zeile der Teile, pEnd ihr Ende. Liefert die Anzahl Teile.
+*  Die Zeilen werden wie im Scanner gezaehlt (nicht in Strings).
+*/
+static size_t ifb_findChunks(const char  *pIn,
+                             size_t       size,
+                             size_t       anz,
+                             size_t      *pStart,
+                             size_t      *pEnd,
+                             int         *pLine) {
+    size_t  i, end;
+    size_t  n = 1;
+    size_t  next = size / anz;
+    int     line = 0;
+    int     state = 0;      /* 0 = Text, 1 = String, 2 = Kommentar */
+
+    pStart[0] = 0;
+    pLine[0] = 0;
+
+    for(i = 0; (i < size) && (n < anz); i++) {
+        switch(state) {
+            case 1:
+                if( (pIn[i] == '"') && (pIn[i-1] != '\\') ) {
+                    state = 0;
+                }
+                break;
+            case 2:
+                if( (pIn[i] == '*') && (i+1 < size) && (pIn[i+1] == '/') ) {
+                    state = 0;
+                    i++;
+                } else if(pIn[i] == '\n') {
+                    line++;
+                }
+                break;
+            default:
+                if(pIn[i] == '"') {
+                    state = 1;
+                } else if( (pIn[i] == '/') && (i+1 < size) && (pIn[i+1] == '*') ) {
+                    state = 2;
+                    i++;
+                } else if(pIn[i] == '\n') {
+                    line++;
+                } else if( (pIn[i] == 'E') && (i >= next) ) {
+                    end = ifb_matchBlockEnd(pIn, size, i);
+                    /* 2 Leerzeichen nach dem Blockende werden Nullbytes */
+                    if( end && (end + 2 < size) &&
+                        ifb_isSpace(pIn[end]) && ifb_isSpace(pIn[end+1]) ) {
+                        pEnd[n-1] = end;
+                        line += (pIn[end] == '\n') + (pIn[end+1] == '\n');
+                        pStart[n] = end + 2;
+                        pLine[n] = line;
+                        n++;
+                        next = (size / anz) * n;
+                        i = end + 1;
+                    }
+                }
+                break;
+        }
+    }
+    pEnd[n-1] = size;
+
+    return n;
+}
+
+/*
+*  Parst einen Teil in einer eigenen Sitzung
+*/
+static void ifb_parseChunk(FB_PARSE_CONTEXT *ctx, char *base, size_t len, int line, int *pStatus) {
+    *pStatus = fb_parser_parsechunk(ctx, base, len, line);
+}
+
+/******************************************************************************/
+int IFBS_ParseInput(FB_PARSE_CONTEXT *ctx) {
+/******************************************************************************/
+    size_t  anz, n, i;
+    int     exit_status = EXIT_SUCCESS;
+
+    // Komprimierter Text (input_stream) : sequentiell aus dem Strom
+    if( (!ctx->input) || ctx->input_used ) {
+        return fb_parser_parseinput(ctx);
+    }
+    // Binaere Datei braucht keinen Parser
+    if(IFBS_IsFbbInput(ctx)) {
+        return IFBS_ReadFbb(ctx);
+    }
+
+    // Anzahl Teile
+    anz = IFBS_GetParseThreads();
+    if(anz == 0) {
+        anz = std::thread::hardware_concurrency();
+    }
+    if(anz > ctx->input_size / IFBS_PARSECHUNK_MIN) {
+        anz = ctx->input_size / IFBS_PARSECHUNK_MIN;
+    }
+    if(anz <= 1) {
+        return fb_parser_parseinput(ctx);
+    }
+
+    PltArray<size_t>              Start(anz);
+    PltArray<size_t>              End(anz);
+    PltArray<int>                 Line(anz);
+    PltArray<int>                 Status(anz);
+    PltArray<FB_PARSE_CONTEXT*>   Chunks(anz);
+    PltArray<std::thread*>        Threads(anz);
+    if( (Start.size() != anz) || (End.size() != anz) || (Line.size() != anz) ||
+        (Status.size() != anz) || (Chunks.size() != anz) || (Threads.size() != anz) ) {
+        return fb_parser_parseinput(ctx);
+    }
+
+    n = ifb_findChunks(ctx->input, ctx->input_size, anz, &Start[0], &End[0], &Line[0]);
+    if(n <= 1) {
+        return fb_parser_parseinput(ctx);
+    }
+
+    // Sitzungen der Teile
+    for(i = 0; i < n; i++) {
+        Chunks[i] = fb_parser_create();
+        if(!Chunks[i]) {
+            while(i--) {
+                fb_parser_destroy(Chunks[i]);
+            }
+            return fb_parser_parseinput(ctx);
+        }
+    }
+
+    ctx->current_line = 0;
+    ctx->error_line = 0;
+    ctx->error_msg[0] = 0;
+    ctx->input_used = 1;
+
+    for(i = 0; i < n; i++) {
+        ctx->input[End[i]] = 0;
+        ctx->input[End[i]+1] = 0;
+    }
+
+    // Den ersten Teil im eigenen Thread parsen
+    for(i = 1; i < n; i++) {
+        Threads[i] = new std::thread(ifb_parseChunk, Chunks[i], ctx->input + Start[i],
+                                     End[i] - Start[i], Line[i], &Status[i]);
+    }
+    ifb_parseChunk(Chunks[0], ctx->input, End[0], 0, &Status[0]);
+    for(i = 1; i < n; i++) {
+        Threads[i]->join();
+        delete Threads[i];
+    }
+
+    // Erster Fehler in Dateireihenfolge
+    for(i = 0; i < n; i++) {
+        if(Status[i] != EXIT_SUCCESS) {
+            ctx->error_line = Chunks[i]->error_line;
+            strcpy(ctx->error_msg, Chunks[i]->error_msg);
+            exit_status = EXIT_FAILURE;
+            break;
+        }
+    }
+    if(exit_status != EXIT_SUCCESS) {
+        for(i = 0; i < n; i++) {
+            fb_parser_destroy(Chunks[i]);
+        }
+        return exit_status;
+    }
+
+    return fb_parser_merge(ctx, &Chunks[0], n);
+}
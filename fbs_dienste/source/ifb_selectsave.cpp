@@ -149,7 +149,7 @@ KS_RESULT get_connectionList(
 
 /******************************************************************************/
 KS_RESULT saveConsFromList(KscServerBase* Server, PltList<PltString> &conList,
-                          PltString& out, FILE *fout) {
+                          PltString& out, IfbsOutSink *pSink) {
 /******************************************************************************/
     char     *help;
     char     *ph;
@@ -189,7 +189,7 @@ KS_RESULT saveConsFromList(KscServerBase* Server, PltList<PltString> &conList,
                                     FALSE,      // TRUE: Rekursive Sicherung
                                     TRUE,       // TRUE: FB-Links sichern
                                     FALSE,      // TRUE: Nur ParentLinks sichern
-                                    fout
+                                    pSink
                                     );
         if(err) {
             out += log_getErrMsg(err);
@@ -203,7 +203,7 @@ KS_RESULT saveConsFromList(KscServerBase* Server, PltList<PltString> &conList,
 
 /******************************************************************************/
 KS_RESULT write_inst_from_class(KscServerBase* Server, FbDirParams& param,
-                          PltString& out, FILE *fout) {
+                          PltString& out, IfbsOutSink *pSink) {
 /******************************************************************************/
 
     KsString                 root = Server->getHostAndName();
@@ -323,7 +323,7 @@ KS_RESULT write_inst_from_class(KscServerBase* Server, FbDirParams& param,
                                     FALSE,      // Keine Rekursion!
                                     FALSE,      // FB-Links noch nicht sichern
                                     FALSE,      // Alle sonstige Links sichern
-                                    fout
+                                    pSink
                                     );
             if(err) {
                 out += log_getErrMsg(err);
@@ -340,7 +340,7 @@ KS_RESULT write_inst_from_class(KscServerBase* Server, FbDirParams& param,
     }
 
     // Verbindungen sichern
-    err = saveConsFromList(Server, conList, out, fout);
+    err = saveConsFromList(Server, conList, out, pSink);
     if(err) {
         out += log_getErrMsg(err);
         return err;
@@ -446,7 +446,7 @@ void write_help_message_from_select_save(PltString &out) {
 /******************************************************************************/
 KS_RESULT saveInstances(KscServerBase* Server, FbDirParams& Pars,
                         PltList<PltString> &libList, PltList<PltString> &conList,
-                        PltString& out, int& Recurs, FILE *fout) {
+                        PltString& out, int& Recurs, IfbsOutSink *pSink) {
 /******************************************************************************/
 
     KsGetEPParams       params;         // Hilfsparameter
@@ -504,7 +504,7 @@ KS_RESULT saveInstances(KscServerBase* Server, FbDirParams& Pars,
                                     FALSE,      // Keine Rekursion!
                                     FALSE,      // FB-Links nicht sichern
                                     FALSE,      // Alle sonstige Links sichern
-                                    fout
+                                    pSink
                                     );
             if(err) {
                 out += log_getErrMsg(err);
@@ -528,9 +528,9 @@ KS_RESULT saveInstances(KscServerBase* Server, FbDirParams& Pars,
         }
 
         // Schreiben in Datei ?
-        if(fout) {
+        if(pSink) {
             if(out != "") {
-                fputs((const char*)out, fout);
+                pSink->put(out);
                 // String-Buffer leeren
                 out = "";
             }
@@ -543,7 +543,7 @@ KS_RESULT saveInstances(KscServerBase* Server, FbDirParams& Pars,
             helpParams.name_mask = "*";
             
             err = saveInstances(Server, helpParams, libList, conList,
-                                out, Recurs, fout);
+                                out, Recurs, pSink);
             if(err) {
                 out += log_getErrMsg(err);
                 return err;
@@ -556,7 +556,7 @@ KS_RESULT saveInstances(KscServerBase* Server, FbDirParams& Pars,
 
 /******************************************************************************/
 KS_RESULT write_db_data(KscServerBase* Server, FbDirParams& Pars,
-                        PltString& out, int& Recurs, FILE *fout) {
+                        PltString& out, int& Recurs, IfbsOutSink *pSink) {
 /******************************************************************************/
 
     PltList<PltString>  HasConList;     // Liste der Instanzen mit Verbindungen
@@ -564,23 +564,23 @@ KS_RESULT write_db_data(KscServerBase* Server, FbDirParams& Pars,
     PltList<PltString>  conList;        // Liste aller Verbindungen
     KsString            libName;
 
-    KS_RESULT err = saveInstances(Server, Pars, libList, conList, out, Recurs, fout);
+    KS_RESULT err = saveInstances(Server, Pars, libList, conList, out, Recurs, pSink);
     if(err) {
         out += log_getErrMsg(err);
         return err;
     }
 
     // Verbindungen sichern
-    err = saveConsFromList(Server, conList, out, fout);
+    err = saveConsFromList(Server, conList, out, pSink);
     if(err) {
         out += log_getErrMsg(err);
         return err;
     }
 
     // Schreiben in Datei ?
-    if(fout) {
+    if(pSink) {
         if(out != "") {
-            fputs((const char*)out, fout);
+            pSink->put(out);
             // String-Buffer leeren
             out = "";
         }
@@ -592,9 +592,9 @@ KS_RESULT write_db_data(KscServerBase* Server, FbDirParams& Pars,
     }
 
     // Schreiben in Datei ?
-    if(fout) {
+    if(pSink) {
         if(out != "") {
-            fputs((const char*)out, fout);
+            pSink->put(out);
             // String-Buffer leeren
             out = "";
         }
@@ -604,7 +604,7 @@ KS_RESULT write_db_data(KscServerBase* Server, FbDirParams& Pars,
 }
 
 /******************************************************************************/
-void writeHeadSelectSave(KscServerBase* Server, PltString &out, FILE* fout)
+void writeHeadSelectSave(KscServerBase* Server, PltString &out, IfbsOutSink* pSink)
 /******************************************************************************/
 {
     struct tm* t;
@@ -636,8 +636,8 @@ void writeHeadSelectSave(KscServerBase* Server, PltString &out, FILE* fout)
     out += "*********************************************************************/\n\n";
 
     // Schreiben in Datei ?
-    if(fout) {
-        fputs((const char*)out, fout);
+    if(pSink) {
+        pSink->put(out);
         // String-Buffer leeren
         out = "";
     }
@@ -647,7 +647,7 @@ void writeHeadSelectSave(KscServerBase* Server, PltString &out, FILE* fout)
 KS_RESULT select_save_eval(KscServerBase   *Server,
                            FbDirParams     &Pars,
                            PltString       &out,
-                           FILE*           fout=0)
+                           IfbsOutSink*    pSink=0)
 /******************************************************************************/
 {
     char*       ph;                                 /* Hilfszeiger */
@@ -667,7 +667,7 @@ KS_RESULT select_save_eval(KscServerBase   *Server,
     iFBS_SetLastError(1, err, log);
 
     // Head der Datei
-    writeHeadSelectSave(Server, out, fout);
+    writeHeadSelectSave(Server, out, pSink);
     
     // Was soll gesichert werden?
     FbDirParams  param;
@@ -727,7 +727,7 @@ KS_RESULT select_save_eval(KscServerBase   *Server,
             return KS_ERR_BADPATH;
         }
         
-        err = write_inst_from_class(Server, param, out, fout);
+        err = write_inst_from_class(Server, param, out, pSink);
 
     } else {
         if( (!strncmp(ph, FB_INSTANZ_CONTAINER, strlen(FB_INSTANZ_CONTAINER))) &&
@@ -746,15 +746,15 @@ KS_RESULT select_save_eval(KscServerBase   *Server,
             return KS_ERR_BADPATH;
         }
         
-        err = write_db_data(Server, param, out, Recurs, fout);
+        err = write_db_data(Server, param, out, Recurs, pSink);
     }
 
     free(phelp);
 
     // Schreiben in Datei ?
-    if(fout) {
+    if(pSink) {
         if(out != "") {
-            fputs((const char*)out, fout);
+            pSink->put(out);
             // String-Buffer leeren
             out = "";
         }
@@ -769,7 +769,7 @@ KS_RESULT select_save(KscServerBase*  Server,
                       PltString       &datei)
 /******************************************************************************/
  {
-    FILE*              fout;
+    int                fd;
     KS_RESULT          err;
     PltString          Out("");
 
@@ -784,8 +784,8 @@ KS_RESULT select_save(KscServerBase*  Server,
         iFBS_SetLastError(1, err, Out);
         return err;
     }
-    fout = fopen((const char*)datei, "w");
-    if(!fout) {
+    fd = IfbsOutSink::openFile((const char*)datei);
+    if(fd < 0) {
         err = OV_ERR_CANTOPENFILE;
         Out = "\"%s\"  \"";
         Out += datei;
@@ -794,8 +794,12 @@ KS_RESULT select_save(KscServerBase*  Server,
         return err;
     }
 
-    err = select_save_eval(Server, Pars, Out, fout);
-    fputs((const char*)Out, fout);
+    IfbsOutSink Sink(fd);
+    err = select_save_eval(Server, Pars, Out, &Sink);
+    Sink.put(Out);
+    if(!err) {
+        err = Sink.flush();
+    }
     if(err) {
         Out = IFBS_GetLastLogError();
         if(Out == "") {
@@ -803,7 +807,8 @@ KS_RESULT select_save(KscServerBase*  Server,
         }
     }
 
-    fclose(fout);
+    Sink.flush();
+    IfbsOutSink::closeFile(fd);
     return err;
 }
 
@@ -0,0 +1,291 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_session.cpp                                                          *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Sitzung einer Server-Verbindung. Merkt sich die Server-Daten, die sich   *
+*   waehrend Sichern/Laden nicht aendern (Version, Bibliotheken, ...).       *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+/*
+*   Liste der geoeffneten Sitzungen
+*/
+static IfbsSession *pSessions = 0;
+
+/*****************************************************************************/
+IfbsSession::IfbsSession(KscServerBase *Server)
+/*****************************************************************************/
+: next(0), refcount(0), server(Server), valid(0), version(0), pClassVars(0)
+{
+    host_and_name = Server->getHostAndName();
+    host = Server->getHost();
+    name = Server->getName();
+}
+
+/*****************************************************************************/
+void IfbsSession::invalidate(IFBS_SESSION_DATA what)
+/*****************************************************************************/
+{
+    valid &= ~what;
+
+    if(what & IFBS_SD_LIBRARIES) {
+        while(libraries.size()) libraries.removeFirst();
+    }
+    if(what & IFBS_SD_CLASSES) {
+        while(classes.size()) classes.removeFirst();
+        delete pClassVars;
+        pClassVars = 0;
+    }
+    if(what & IFBS_SD_ASSOCS) {
+        while(associations.size()) associations.removeFirst();
+    }
+    if(what & IFBS_SD_UPLOAD) {
+        upload_path = "";
+    }
+}
+
+/*****************************************************************************/
+float IfbsSession::getServerVersion()
+/*****************************************************************************/
+{
+    if( !(valid & IFBS_SD_VERSION) ) {
+        version = ifb_readServerVersion(server);
+        valid |= IFBS_SD_VERSION;
+    }
+    return version;
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsSession::readStringVec(IFBS_SESSION_DATA   what,
+                                     const char         *varPath,
+                                     PltList<PltString> &cache,
+                                     PltList<PltString> &Liste)
+/*****************************************************************************/
+{
+    size_t  i, siz;
+
+    if( !(valid & what) ) {
+        KsString    Path(host_and_name);
+        Path += varPath;
+
+        KscVariable Var(Path);
+        if(!Var.getUpdate() ) {
+            KS_RESULT err = Var.getLastResult();
+            if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
+            return err;
+        }
+        const KsVarCurrProps *cp = Var.getCurrProps();
+        if((!cp) || (!(cp->value)) ) {
+            return KS_ERR_GENERIC;
+        }
+        if(cp->value->xdrTypeCode() != KS_VT_STRING_VEC) {
+            return KS_ERR_BADTYPE;
+        }
+
+        while(cache.size()) cache.removeFirst();
+        siz = ((KsStringVecValue &) *cp->value).size();
+        for ( i = 0; i < siz; i++ ) {
+            cache.addLast( (const char*)((KsStringVecValue &) *cp->value)[i] );
+        }
+        valid |= what;
+    }
+
+    // Kopie zurueckgeben
+    if(!cache.isEmpty() ) {
+        PltListIterator<PltString> *it = (PltListIterator<PltString> *)cache.newIterator();
+        for(; *it; ++(*it) ) {
+            Liste.addLast(**it);
+        }
+        delete it;
+    }
+
+    return KS_ERR_OK;
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsSession::getLibraries(PltList<PltString> &Liste)
+/*****************************************************************************/
+{
+    return readStringVec(IFBS_SD_LIBRARIES, OV_VARLIBS_PATH, libraries, Liste);
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsSession::getClasses(PltList<PltString> &Liste)
+/*****************************************************************************/
+{
+    return readStringVec(IFBS_SD_CLASSES, "/vendor/classes", classes, Liste);
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsSession::getAssociations(PltList<PltString> &Liste)
+/*****************************************************************************/
+{
+    return readStringVec(IFBS_SD_ASSOCS, "/vendor/associations", associations, Liste);
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsSession::getUploadPath(PltString &path)
+/*****************************************************************************/
+{
+    if( !(valid & IFBS_SD_UPLOAD) ) {
+        KS_RESULT err = ifb_readUploadPath(server, upload_path);
+        if(err) {
+            path = "";
+            return err;
+        }
+        valid |= IFBS_SD_UPLOAD;
+    }
+    path = upload_path;
+
+    return KS_ERR_OK;
+}
+
+/*****************************************************************************/
+int IfbsSession::classHasVariable(const char *classPath, const char *varName)
+/*****************************************************************************/
+{
+    KsString        key(classPath);
+    KsString        clPath(classPath);
+    KsGetEPParams   params;
+    unsigned long   found;
+    KS_RESULT       err;
+    int             tiefe;
+
+    key += ".";
+    key += varName;
+
+    if(!pClassVars) {
+        pClassVars = new PltHashTable<KsString, unsigned long>;
+        if(!pClassVars) {
+            return -1;
+        }
+    }
+    if(pClassVars->query(key, found)) {
+        return (int)found;
+    }
+
+    // Variable in der Klasse oder in einer Basis-Klasse suchen
+    found = 0;
+    params.type_mask = KS_OT_ANY;
+    params.name_mask = varName;
+    params.scope_flags = KS_EPF_DEFAULT;
+    for(tiefe = 0; tiefe < 64; tiefe++) {
+        params.path = clPath;
+        err = Get_getEP_ErrOnly(server, params);
+        if(err == KS_ERR_OK) {
+            found = 1;
+            break;
+        }
+        if(err != 1) {
+            // Klasse nicht lesbar
+            return -1;
+        }
+
+        KsString    Path(host_and_name);
+        Path += clPath;
+        Path += ".baseclass";
+
+        KscVariable Var(Path);
+        if(!Var.getUpdate() ) {
+            return -1;
+        }
+        const KsVarCurrProps *cp = Var.getCurrProps();
+        if( (!cp) || (!cp->value) ) {
+            return -1;
+        }
+        clPath = (const char*)((KsStringValue &) *cp->value);
+        if(clPath == "") {
+            // Ende der Klassen-Hierarchie
+            break;
+        }
+    }
+
+    pClassVars->add(key, found);
+    return (int)found;
+}
+
+/*****************************************************************************/
+IfbsSession* IFBS_OpenSession(KscServerBase *Server)
+/*****************************************************************************/
+{
+    IfbsSession *pses;
+
+    if(!Server) {
+        return 0;
+    }
+
+    // Sitzung bereits geoeffnet?
+    pses = IFBS_GetSession(Server);
+    if(!pses) {
+        pses = new IfbsSession(Server);
+        if(!pses) {
+            return 0;
+        }
+        pses->next = pSessions;
+        pSessions = pses;
+    }
+    pses->refcount++;
+
+    return pses;
+}
+
+/*****************************************************************************/
+void IFBS_CloseSession(IfbsSession *Session)
+/*****************************************************************************/
+{
+    IfbsSession **pp;
+
+    if(!Session) {
+        return;
+    }
+    Session->refcount--;
+    if(Session->refcount > 0) {
+        return;
+    }
+
+    // Aus der Liste entfernen
+    pp = &pSessions;
+    while(*pp) {
+        if(*pp == Session) {
+            *pp = Session->next;
+            break;
+        }
+        pp = &((*pp)->next);
+    }
+    delete Session;
+}
+
+/*****************************************************************************/
+IfbsSession* IFBS_GetSession(KscServerBase *Server)
+/*****************************************************************************/
+{
+    IfbsSession *pses = pSessions;
+
+    while(pses) {
+        if(pses->getServer() == Server) {
+            return pses;
+        }
+        pses = pses->next;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+void IFBS_InvalidateSession(KscServerBase *Server, IFBS_SESSION_DATA what)
+/*****************************************************************************/
+{
+    IfbsSession *pses = IFBS_GetSession(Server);
+    if(pses) {
+        pses->invalidate(what);
+    }
+}
@@ -491,6 +491,141 @@ KsValue* ifb_CrNewKsValue(
 
 } /* ifb_CrNewKsValue() */
 
+/*
+*  Vektoren elementweise vergleichen
+*/
+/*****************************************************************************/
+template<class V>
+static int ifb_sameVector(KsValue &a, KsValue &b)
+/*****************************************************************************/
+{
+    V       &va = (V &)a;
+    V       &vb = (V &)b;
+    size_t  i;
+
+    if(va.size() != vb.size()) {
+        return 0;
+    }
+    for(i = 0; i < va.size(); i++) {
+        if( !(va[i] == vb[i]) ) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*****************************************************************************/
+static int ifb_sameTime(const KsTime &a, const KsTime &b)
+/*****************************************************************************/
+{
+    return (a.tv_sec == b.tv_sec) && (a.tv_usec == b.tv_usec);
+}
+
+/*****************************************************************************/
+int ifb_sameKsValue(const KsValue *pa, const KsValue *pb)
+/*****************************************************************************/
+{
+    /*
+    *  Vergleicht zwei Werte gleichen Typs exakt (ohne Formatierung).
+    *  Liefert 1, wenn die Werte gleich sind. Unbekannte Typen gelten als
+    *  verschieden.
+    */
+    size_t          i;
+
+    if( (!pa) || (!pb) ) {
+        return 0;
+    }
+    if(pa->xdrTypeCode() != pb->xdrTypeCode()) {
+        return 0;
+    }
+
+    KsValue &a = (KsValue &)*pa;
+    KsValue &b = (KsValue &)*pb;
+
+    switch(a.xdrTypeCode()) {
+        case KS_VT_VOID:
+                        return 1;
+        case KS_VT_BOOL:
+                        return (bool)((KsBoolValue &)a) == (bool)((KsBoolValue &)b);
+        case KS_VT_INT:
+                        return (long)((KsIntValue &)a) == (long)((KsIntValue &)b);
+        case KS_VT_UINT:
+                        return (unsigned long)((KsUIntValue &)a) ==
+                               (unsigned long)((KsUIntValue &)b);
+        case KS_VT_SINGLE:
+                        return (float)((KsSingleValue &)a) == (float)((KsSingleValue &)b);
+        case KS_VT_DOUBLE:
+                        return (double)((KsDoubleValue &)a) == (double)((KsDoubleValue &)b);
+        case KS_VT_STRING:
+                        {
+                            KsString sa = (KsStringValue &)a;
+                            KsString sb = (KsStringValue &)b;
+                            return sa == sb;
+                        }
+        case KS_VT_TIME:
+                        return ifb_sameTime((KsTimeValue &)a, (KsTimeValue &)b);
+        case KS_VT_TIME_SPAN:
+                        {
+                            KsTimeSpan ta = (KsTimeSpanValue &)a;
+                            KsTimeSpan tb = (KsTimeSpanValue &)b;
+                            ta.normalize();
+                            tb.normalize();
+                            return (ta.tv_sec == tb.tv_sec) && (ta.tv_usec == tb.tv_usec);
+                        }
+        case KS_VT_BYTE_VEC:
+                        return ifb_sameVector<KsByteVecValue>(a, b);
+        case KS_VT_BOOL_VEC:
+                        return ifb_sameVector<KsBoolVecValue>(a, b);
+        case KS_VT_INT_VEC:
+                        return ifb_sameVector<KsIntVecValue>(a, b);
+        case KS_VT_UINT_VEC:
+                        return ifb_sameVector<KsUIntVecValue>(a, b);
+        case KS_VT_SINGLE_VEC:
+                        return ifb_sameVector<KsSingleVecValue>(a, b);
+        case KS_VT_DOUBLE_VEC:
+                        return ifb_sameVector<KsDoubleVecValue>(a, b);
+        case KS_VT_STRING_VEC:
+                        return ifb_sameVector<KsStringVecValue>(a, b);
+        case KS_VT_TIME_VEC:
+                        {
+                            KsTimeVecValue &va = (KsTimeVecValue &)a;
+                            KsTimeVecValue &vb = (KsTimeVecValue &)b;
+                            if(va.size() != vb.size()) {
+                                return 0;
+                            }
+                            for(i = 0; i < va.size(); i++) {
+                                if( !ifb_sameTime(va[i], vb[i]) ) {
+                                    return 0;
+                                }
+                            }
+                            return 1;
+                        }
+        case KS_VT_TIME_SPAN_VEC:
+                        {
+                            KsTimeSpanVecValue &va = (KsTimeSpanVecValue &)a;
+                            KsTimeSpanVecValue &vb = (KsTimeSpanVecValue &)b;
+                            if(va.size() != vb.size()) {
+                                return 0;
+                            }
+                            for(i = 0; i < va.size(); i++) {
+                                KsTimeSpan ta = va[i];
+                                KsTimeSpan tb = vb[i];
+                                ta.normalize();
+                                tb.normalize();
+                                if( (ta.tv_sec != tb.tv_sec) || (ta.tv_usec != tb.tv_usec) ) {
+                                    return 0;
+                                }
+                            }
+                            return 1;
+                        }
+        default:
+                        break;
+    }
+
+    return 0;
+
+} /* ifb_sameKsValue() */
+
 /*****************************************************************************/
 KS_RESULT PrepareStringValue(PltString& wert) {
 /*****************************************************************************/
@@ -0,0 +1,268 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_setvarbatch.cpp                                                      *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Setzt Variablen mehrerer Objekte mit wenigen SetVar-Diensten. Die        *
+*   Ergebnisse der Items werden den Objekten (Owner) zugeordnet. Auf Wunsch  *
+*   werden die aktuellen Werte vorher gelesen und nur Aenderungen gesendet.  *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+/*
+*  Max. Anzahl Variablen je SetVar-Dienst
+*/
+static size_t ifbs_SetVarBatchSize = IFBS_SETVAR_BATCHSIZE;
+
+/******************************************************************************/
+void IFBS_SetSetVarBatchSize(size_t anz) {
+/******************************************************************************/
+    if(anz == 0) {
+        anz = 1;
+    }
+    ifbs_SetVarBatchSize = anz;
+}
+
+/******************************************************************************/
+size_t IFBS_GetSetVarBatchSize() {
+/******************************************************************************/
+    return ifbs_SetVarBatchSize;
+}
+
+/*
+*  Beim Aendern nur Werte schreiben, die der Server noch nicht hat
+*/
+static int ifbs_SkipUnchanged = 0;
+
+/******************************************************************************/
+void IFBS_SetSkipUnchanged(int on) {
+/******************************************************************************/
+    ifbs_SkipUnchanged = on;
+}
+
+/******************************************************************************/
+int IFBS_GetSkipUnchanged() {
+/******************************************************************************/
+    return ifbs_SkipUnchanged;
+}
+
+/*****************************************************************************/
+IfbsSetVarBatch::IfbsSetVarBatch(KscServerBase *Server, size_t batchSize)
+/*****************************************************************************/
+  : Server(Server),
+    batchSize(batchSize ? batchSize : IFBS_GetSetVarBatchSize()),
+    requests(0),
+    skipUnchanged(FALSE),
+    skipped(0)
+{
+}
+
+/*****************************************************************************/
+size_t IfbsSetVarBatch::addOwner()
+/*****************************************************************************/
+{
+    results.push_back(KS_ERR_OK);
+    return results.size() - 1;
+}
+
+/*****************************************************************************/
+void IfbsSetVarBatch::setResult(size_t owner, KS_RESULT err)
+/*****************************************************************************/
+{
+    // Erster Fehler bleibt
+    if( err && (results[owner] == KS_ERR_OK) ) {
+        results[owner] = err;
+    }
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsSetVarBatch::getResult(size_t owner)
+/*****************************************************************************/
+{
+    return results[owner];
+}
+
+/*****************************************************************************/
+void IfbsSetVarBatch::add(size_t owner, KsSetVarItem &item)
+/*****************************************************************************/
+{
+    items.addLast(item);
+    itemOwner.push_back(owner);
+    if(itemOwner.size() >= batchSize) {
+        send();
+    }
+}
+
+/*****************************************************************************/
+void IfbsSetVarBatch::add(size_t              owner,
+                          PltString          &VarPath,
+                          PltList<PltString> &ValList,
+                          KS_VAR_TYPE         Typ,
+                          KS_STATE            Status,
+                          bool                prepareString)
+/*****************************************************************************/
+{
+    KS_RESULT           fehler = KS_ERR_OK;
+    KsVarCurrProps*     var_props;
+    KsSetVarItem        item;
+
+    var_props = new KsVarCurrProps;
+    if(!var_props) {
+        setResult(owner, OV_ERR_HEAPOUTOFMEMORY);
+        return;
+    }
+    var_props->value.bindTo(ifb_CrNewKsValue(fehler, ValList, Typ, prepareString), PltOsNew);
+    if(fehler) {
+        delete var_props;
+        setResult(owner, fehler);
+        return;
+    }
+    var_props->state = Status;
+
+    item.path_and_name = VarPath;
+    item.curr_props.bindTo( (KsCurrProps*)var_props, PltOsNew);
+
+    add(owner, item);
+}
+
+/*****************************************************************************/
+void IfbsSetVarBatch::flush()
+/*****************************************************************************/
+{
+    if(itemOwner.size()) {
+        send();
+    }
+}
+
+/*
+*  Aktuelle Werte der Items mit einem GetVar-Dienst lesen. same[i] wird
+*  gesetzt, wenn der Server den Wert (und den Status, falls angegeben)
+*  schon hat. Bei Fehlern wird alles geschrieben
+*/
+/*****************************************************************************/
+void IfbsSetVarBatch::readCurrent(KsSetVarParams &setpar, std::vector<char> &same)
+/*****************************************************************************/
+{
+    size_t          anz = setpar.items.size();
+    size_t          i;
+    KsGetVarParams  params(anz);
+    KsGetVarResult  result;
+
+    same.assign(anz, 0);
+    if(params.identifiers.size() != anz) {
+        return;
+    }
+    for(i = 0; i < anz; i++) {
+        params.identifiers[i] = setpar.items[i].path_and_name;
+    }
+    bool ok = Server->requestByOpcode(KS_GETVAR, GetClientAV(), params, result);
+    requests++;
+    if( (!ok) || result.result || (result.items.size() != anz) ) {
+        return;
+    }
+
+    for(i = 0; i < anz; i++) {
+        if(result.items[i].result) {
+            continue;
+        }
+        KsVarCurrProps *cur = PLT_DYNAMIC_PCAST(KsVarCurrProps, result.items[i].item.getPtr());
+        KsVarCurrProps *neu = PLT_DYNAMIC_PCAST(KsVarCurrProps, setpar.items[i].curr_props.getPtr());
+        if( (!cur) || (!neu) || (!cur->value) || (!neu->value) ) {
+            continue;
+        }
+        // Status nur vergleichen, wenn er in der Datei angegeben ist
+        if( neu->state && (neu->state != cur->state) ) {
+            continue;
+        }
+        if( ifb_sameKsValue(cur->value.getPtr(), neu->value.getPtr()) ) {
+            same[i] = 1;
+        }
+    }
+}
+
+/*****************************************************************************/
+void IfbsSetVarBatch::send()
+/*****************************************************************************/
+{
+    size_t                  anz = itemOwner.size();
+    size_t                  i, k, n;
+    KS_RESULT               err = KS_ERR_OK;
+    KsSetVarParams          setpar(anz);
+    std::vector<char>       same(anz, 0);
+    std::vector<size_t>     sendIdx;    // Nummern der zu schreibenden Items
+    std::vector<KS_RESULT>  res(anz, KS_ERR_OK);
+
+    if(!Server) {
+        err = KS_ERR_SERVERUNKNOWN;
+    } else if(setpar.items.size() != anz) {
+        err = OV_ERR_HEAPOUTOFMEMORY;
+    } else {
+        for(i = 0; i < anz; i++) {
+            setpar.items[i] = items.removeFirst();
+        }
+        if(skipUnchanged) {
+            readCurrent(setpar, same);
+        }
+        for(i = 0; i < anz; i++) {
+            if(same[i]) {
+                skipped++;
+            } else {
+                sendIdx.push_back(i);
+            }
+        }
+    }
+
+    n = sendIdx.size();
+    if( (!err) && n ) {
+        KsSetVarParams  part(n == anz ? 0 : n);
+        KsSetVarResult  erg(n);
+        KsSetVarParams *psend = &setpar;
+
+        if(n != anz) {
+            // Nur die geaenderten Werte senden
+            if(part.items.size() != n) {
+                err = OV_ERR_HEAPOUTOFMEMORY;
+            } else {
+                for(k = 0; k < n; k++) {
+                    part.items[k] = setpar.items[sendIdx[k]];
+                }
+                psend = &part;
+            }
+        }
+        if(!err) {
+            bool ok = Server->requestByOpcode(KS_SETVAR, GetClientAV(), *psend, erg);
+            requests++;
+            if(!ok) {
+                err = Server->getLastResult();
+                if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
+            } else if(erg.result) {
+                err = erg.result;
+            } else if(erg.results.size() != n) {
+                err = KS_ERR_GENERIC;
+            }
+        }
+        for(k = 0; k < n; k++) {
+            res[sendIdx[k]] = err ? err : erg.results[k].result;
+        }
+    } else if(err) {
+        res.assign(anz, err);
+    }
+
+    // Ergebnisse den Objekten zuordnen
+    for(i = 0; i < anz; i++) {
+        setResult(itemOwner[i], res[i]);
+    }
+
+    while(items.size()) {
+        items.removeFirst();
+    }
+    itemOwner.clear();
+}
@@ -0,0 +1,172 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_staged.cpp                                                           *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   Gestufte Aktivierung beim Laden. Instanzen werden mit actimode=0 und     *
+*   Verbindungen mit on=FALSE angelegt. Sind alle Objekte und Links          *
+*   vorhanden, werden die Werte aus der Datei mit wenigen SetVar-Diensten    *
+*   gesetzt.                                                                 *
+*                                                                            *
+*****************************************************************************/
+
+#include "ifbslibdef.h"
+
+/*
+*  Gestufte Aktivierung beim Laden ein/aus
+*/
+static int ifbs_StagedActivation = 0;
+
+/******************************************************************************/
+void IFBS_SetStagedActivation(int on) {
+/******************************************************************************/
+    ifbs_StagedActivation = on;
+}
+
+/******************************************************************************/
+int IFBS_GetStagedActivation() {
+/******************************************************************************/
+    return ifbs_StagedActivation;
+}
+
+/*****************************************************************************/
+int IfbsStagedActivation::deactivate(IfbsSession   *pses,
+                                     InstanceItems *pinst,
+                                     const char    *varName,
+                                     const char    *offValue,
+                                     KS_VAR_TYPE    varType)
+/*****************************************************************************/
+{
+    Variables *pvar = pinst->Inst_var;
+    char       help[64];
+
+    while(pvar) {
+        if( !strcmp(pvar->var_name, varName) ) {
+            break;
+        }
+        pvar = pvar->next;
+    }
+    if( pvar && ((!pvar->value) || pvar->vector || (pvar->len == 0)) ) {
+        return 0;
+    }
+    if( pvar && (!strcmp(ifb_fbbValueText(pvar, pvar->value, 0, help), offValue)) ) {
+        // Bereits aus
+        return 0;
+    }
+    if( (!pvar) &&
+        ((!pses) || (pses->classHasVariable(pinst->Class_name, varName) != 1)) ) {
+        // Klasse ohne diese Variable (z.B. Domain) oder unbekannt
+        return 0;
+    }
+
+    objects.push_back(Object());
+    Object &obj = objects.back();
+
+    obj.Inst_name = pinst->Inst_name;
+    obj.pinst = pinst;
+    obj.offValue = offValue;
+    obj.off.val = &obj.offValue[0];
+    obj.off.fbb_value = 0;
+    obj.off.next = 0;
+
+    if(!pvar) {
+        // Variable fehlt : mit Aus-Wert vorne einfuegen
+        obj.varName = varName;
+        pvar = &obj.added;
+        pvar->var_name = &obj.varName[0];
+        pvar->port_typ = INPUT_PORT;
+        pvar->var_typ = varType;
+        pvar->state = 0;
+        pvar->len = 1;
+        pvar->vector = 0;
+        pvar->next = pinst->Inst_var;
+        pinst->Inst_var = pvar;
+        obj.pvar = pvar;
+        obj.saved = 0;
+        obj.off.value_type = (varType == KS_VT_BOOL) ? DT_BOOLIAN : DT_GANZZAHL;
+    } else {
+        obj.pvar = pvar;
+        obj.saved = pvar->value;
+        obj.off.value_type = pvar->value->value_type;
+    }
+
+    pvar->value = &obj.off;
+    return 1;
+}
+
+/*****************************************************************************/
+void IfbsStagedActivation::restore()
+/*****************************************************************************/
+{
+    Variables **ppvar;
+    size_t      i;
+
+    for(i = 0; i < objects.size(); i++) {
+        if(objects[i].saved) {
+            objects[i].pvar->value = objects[i].saved;
+            continue;
+        }
+        // Hinzugefuegte Variable wieder aus der Liste nehmen
+        ppvar = &objects[i].pinst->Inst_var;
+        while( *ppvar && (*ppvar != objects[i].pvar) ) {
+            ppvar = &(*ppvar)->next;
+        }
+        if(*ppvar) {
+            *ppvar = objects[i].pvar->next;
+        }
+    }
+}
+
+/*****************************************************************************/
+KS_RESULT IfbsStagedActivation::activate(KscServerBase *Server, PltString &out)
+/*****************************************************************************/
+{
+    IfbsSetVarBatch     Batch(Server);
+    Variables           var;
+    PltString           log;
+    KS_RESULT           err;
+    KS_RESULT           fehler = KS_ERR_OK;
+    size_t              i, n;
+
+    restore();
+    if(!objects.size()) {
+        return KS_ERR_OK;
+    }
+
+    // Nur die gemerkte Variable setzen. Eine hinzugefuegte Variable bleibt aus
+    for(i = 0; i < objects.size(); i++) {
+        if(!objects[i].saved) {
+            continue;
+        }
+        var = *objects[i].pvar;
+        var.next = 0;
+        ifb_addInstanceValues(Batch, objects[i].Inst_name.c_str(), &var);
+    }
+    Batch.flush();
+
+    for(i = 0, n = 0; i < objects.size(); i++) {
+        if(!objects[i].saved) {
+            continue;
+        }
+        err = Batch.getResult(n++);
+        if(!err) {
+            continue;
+        }
+        fehler = err;
+        out += log_getErrMsg(err, "Instance", objects[i].Inst_name.c_str(),
+                             "couldn't be activated.");
+        log  = "\"%s\"  \"";
+        log += objects[i].Inst_name.c_str();
+        log += "\"";
+        iFBS_SetLastError(1, err, log);
+    }
+
+    objects.clear();
+    return fehler;
+}
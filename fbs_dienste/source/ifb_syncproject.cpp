@@ -0,0 +1,249 @@
+/*****************************************************************************
+*                                                                            *
+*    iFBSpro  ACPLT/KS Dienste-Schnittstelle (C++)                           *
+*   ================================================                         *
+*                                                                            *
+*   Datei                                                                    *
+*   -----                                                                    *
+*   ifb_syncproject.cpp                                                      *
+*                                                                            *
+*   Beschreibung                                                             *
+*   ------------                                                             *
+*   iFBSpro-Dienst "IFBS_DBSYNC". Die Datenbasis des Servers wird in den     *
+*   Speicher gesichert und mit der Datei verglichen. Nur die Differenzen     *
+*   werden mit update_eval() auf den Server geschrieben, ohne Vergleichs-    *
+*   und Update-Datei.                                                        *
+*                                                                            *
+*****************************************************************************/
+
+/*
+*        Includes
+*        --------
+*/
+#include "ifbslibdef.h"
+
+/*
+*   Ergebnis des Vergleichs in die Struktur fuer update_eval() umsetzen.
+*   Die neuen Listenelemente liegen im Speicher der Parse-Sitzung ctx
+*/
+/*****************************************************************************/
+static KS_RESULT ifb_syncParams(FB_PARSE_CONTEXT* ctx,
+                                Dienst_param*     newpar,
+                                Dienst_param*     oldpar,
+                                Dienst_param*     upd,
+                                Dienst_param*     Params)
+/*****************************************************************************/
+{
+    InstanceItems*      pinst;
+    DelInstItems*       pdel;
+    DelInstItems**      ppDel;
+    SetInstVarItems*    pset;
+    SetInstVarItems**   ppSet;
+
+    Params->OldLibs = oldpar->NewLibs;
+    Params->NewLibs = newpar->NewLibs;
+    Params->Instance = newpar->Instance;
+    Params->UnLinks = oldpar->Links;
+    Params->Links = newpar->Links;
+
+    // Zu loeschende Instanzen
+    Params->DelInst = 0;
+    ppDel = &Params->DelInst;
+    for(pinst = oldpar->Instance; pinst; pinst = pinst->next) {
+        pdel = (DelInstItems*)fb_parser_alloc(ctx, sizeof(DelInstItems));
+        if(!pdel) {
+            return OV_ERR_HEAPOUTOFMEMORY;
+        }
+        pdel->Inst_name = pinst->Inst_name;
+        pdel->next = 0;
+        *ppDel = pdel;
+        ppDel = &pdel->next;
+    }
+
+    // Instanzen mit geaenderten Parametern. Inst_var enthaelt nur noch
+    // die geaenderten Variablen
+    Params->Set_Inst_Var = 0;
+    ppSet = &Params->Set_Inst_Var;
+    for(pinst = upd->Instance; pinst; pinst = pinst->next) {
+        pset = (SetInstVarItems*)fb_parser_alloc(ctx, sizeof(SetInstVarItems));
+        if(!pset) {
+            return OV_ERR_HEAPOUTOFMEMORY;
+        }
+        pset->Inst_name = pinst->Inst_name;
+        pset->Inst_var = pinst->Inst_var;
+        pset->next = 0;
+        *ppSet = pset;
+        ppSet = &pset->next;
+    }
+
+    return KS_ERR_OK;
+}
+
+/*
+*   Hauptprogramm
+*        -------------
+*/
+/*****************************************************************************/
+KS_RESULT  IFBS_DBSYNC(KscServerBase *Server,
+                       PltString     &datei,
+                       PltString     &err_outfile)
+/*****************************************************************************/
+{
+    /*
+    *        Variablen
+    */
+    int               exit_status;
+    KS_RESULT         error;
+    int               PROTOFILE = 0;
+    PltString         Str;
+    PltString         msg;
+    std::string       Text;         // Sicherung des Servers
+    FILE              *yyout = 0;
+    FB_PARSE_CONTEXT  *newctx;      // Parse-Sitzung der Datei
+    FB_PARSE_CONTEXT  *oldctx;      // Parse-Sitzung der Server-Datenbasis
+    Dienst_param      upd;
+    Dienst_param      Params;
+
+    if(!Server) {
+        return KS_ERR_SERVERUNKNOWN;
+    }
+
+    if( err_outfile.len() ) {
+        yyout = fopen((const char*)err_outfile, "a");
+        if(!yyout) {
+            return OV_ERR_CANTOPENFILE;
+        }
+        PROTOFILE = 1;
+    }
+
+    newctx = fb_parser_create();
+    oldctx = fb_parser_create();
+    if( (!newctx) || (!oldctx) ) {
+        if(newctx) fb_parser_destroy(newctx);
+        if(oldctx) fb_parser_destroy(oldctx);
+        if(PROTOFILE) {
+            fclose(yyout);
+        }
+        return OV_ERR_HEAPOUTOFMEMORY;
+    }
+
+    if(!fb_parser_openfile(newctx, (const char*)datei)) {
+        if(PROTOFILE) {
+            fprintf(yyout, "%s",
+                (const char*)log_getErrMsg(KS_ERR_OK, "can't open file", (const char*)datei));
+            fclose(yyout);
+        }
+        fb_parser_destroy(newctx);
+        fb_parser_destroy(oldctx);
+        return OV_ERR_CANTOPENFILE;
+    }
+
+///////////////////////////////////////////////////////////////////////////////
+
+if(PROTOFILE)
+{
+fprintf(yyout,"\n\n/*********************************************************************\n");
+fprintf(yyout,"======================================================================\n");
+fprintf(yyout,"  Datei : %s\n\n", (const char*)err_outfile);
+fprintf(yyout,"  Abgleich der Datenbasis mit %s.\n", (const char*)datei);
+
+struct        tm* t;
+time_t        timer;
+
+PltTime tt = PltTime::now();
+
+timer = (time_t)tt.tv_sec;
+t=localtime(&timer);
+if(t) {
+    fprintf(yyout,"  Ereignisprotokoll vom  %4.4d-%2.2d-%2.2d %2.2d:%2.2d:%2.2d\n\n",
+                t->tm_year+1900, t->tm_mon+1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec );
+}
+fprintf(yyout,"  HOST       : %s\n", (const char*)Server->getHost());
+
+fprintf(yyout,"  SERVER     : %s\n", (const char*)Server->getName());
+
+fprintf(yyout,"======================================================================\n");
+fprintf(yyout,"*********************************************************************/\n\n");
+fflush(yyout);
+}
+///////////////////////////////////////////////////////////////////////////////
+
+    /*
+    *   Soll-Zustand parsen
+    */
+    exit_status = IFBS_ParseInput(newctx);
+    if(exit_status != EXIT_SUCCESS) {
+        iFBS_SetParserError(newctx);
+        if(PROTOFILE) {
+            Str = IFBS_GetParserError(newctx);
+            if( Str == "" ) {
+                Str = "Parse error.";
+            }
+            fprintf(yyout, "%s",
+                (const char*)log_getErrMsg(KS_ERR_OK, (const char*)Str,
+                                           "File", (const char*)datei));
+            fclose(yyout);
+        }
+        fb_parser_destroy(newctx);
+        fb_parser_destroy(oldctx);
+        return KS_ERR_BADPARAM;
+    }
+
+    // Server-Daten nur einmal je Abgleich lesen
+    IfbsSession *pses = IFBS_OpenSession(Server);
+
+    /*
+    *   Ist-Zustand des Servers in den Speicher sichern und parsen
+    */
+    error = IFBS_DBSAVE_TOCALLBACK(Server, ifb_appendToString, &Text);
+    if(error) {
+        msg = log_getErrMsg(error, "Server", (const char*)Server->getName(),
+                            "couldn't be read.");
+    } else {
+        exit_status = fb_parser_parsestring(oldctx, Text.c_str());
+        if(exit_status != EXIT_SUCCESS) {
+            iFBS_SetParserError(oldctx);
+            msg = log_getErrMsg(KS_ERR_OK, "Parse error in data of server",
+                                (const char*)Server->getName());
+            error = KS_ERR_BADPARAM;
+        }
+    }
+    // Gesicherter Text wird nicht mehr benoetigt
+    std::string().swap(Text);
+
+    /*
+    *   Vergleichen und nur die Differenzen schreiben
+    */
+    if(!error) {
+        memset(&upd, 0, sizeof(upd));
+        memset(&Params, 0, sizeof(Params));
+
+        error = compare_model(newctx->par, oldctx->par, &upd, msg);
+        if(error) {
+            error = KS_ERR_BADPARAM;
+        } else {
+            error = ifb_syncParams(oldctx, newctx->par, oldctx->par, &upd, &Params);
+        }
+        if(!error) {
+            error = update_eval(Server, &Params, msg);
+            if(error) {
+                // Bei Fehler wurden eventuell Bibliotheken wieder geloescht
+                IFBS_InvalidateSession(Server, IFBS_SD_LIBDATA);
+            }
+        }
+        memfre(&upd);
+        memfre(&Params);
+    }
+
+    IFBS_CloseSession(pses);
+
+    if(PROTOFILE) {
+        fputs((const char*)msg, yyout);
+        fclose(yyout);
+    }
+
+    fb_parser_destroy(newctx);
+    fb_parser_destroy(oldctx);
+
+    return error;
+}
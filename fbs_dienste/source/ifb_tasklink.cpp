@@ -282,3 +282,156 @@ KS_RESULT IFBS_UNLINK_FROM_TASK(KscServerBase* Server,
     
     return err;  
 }
+
+/*
+*  Ergebnisse eines Link- bzw. Unlink-Dienstes fuer einen Abschnitt
+*  eintragen. Liefert den letzten Fehler
+*/
+/*****************************************************************************/
+static KS_RESULT ifb_linkChunkResults(KscServerBase*           Server,
+                                      bool                     ok,
+                                      KS_RESULT                result,
+                                      KsArray<KS_RESULT>       &res,
+                                      size_t                   first,
+                                      size_t                   anz,
+                                      std::vector<KS_RESULT>   &results)
+/*****************************************************************************/
+{
+    KS_RESULT   err = KS_ERR_OK;
+    size_t      k;
+
+    if(!ok) {
+        err = Server->getLastResult();
+        if(err == KS_ERR_OK) err = KS_ERR_GENERIC;
+    } else if(result) {
+        err = result;
+    } else if(res.size() != anz) {
+        err = KS_ERR_GENERIC;
+    }
+    for(k = 0; k < anz; k++) {
+        if(err) {
+            results[first+k] = err;
+        } else {
+            results[first+k] = res[k];
+        }
+    }
+    if(!err) {
+        for(k = 0; k < anz; k++) {
+            if(res[k]) {
+                err = res[k];
+            }
+        }
+    }
+    return err;
+}
+
+/*
+*  Link-Dienst fuer viele Elemente (Platzierung am Ende). Es werden je
+*  Dienst hoechstens IFBS_GetDeleteBatchSize() Elemente gesendet.
+*  results enthaelt das Ergebnis je Element. Liefert den letzten Fehler
+*/
+/*****************************************************************************/
+KS_RESULT ifb_createLinks(KscServerBase*            Server,
+                          std::vector<std::string>  &linkPath,
+                          std::vector<std::string>  &elemPath,
+                          std::vector<KS_RESULT>    &results)
+/*****************************************************************************/
+{
+    KS_RESULT   lastErr = KS_ERR_OK;
+    KS_RESULT   err;
+    size_t      batchSize = IFBS_GetDeleteBatchSize();
+    size_t      i, k, anz;
+
+    results.assign(linkPath.size(), KS_ERR_OK);
+    if(!Server) {
+        results.assign(linkPath.size(), KS_ERR_SERVERUNKNOWN);
+        return KS_ERR_SERVERUNKNOWN;
+    }
+    for(i = 0; i < linkPath.size(); i += anz) {
+        anz = linkPath.size() - i;
+        if(anz > batchSize) {
+            anz = batchSize;
+        }
+
+        KsLinkParams         linkpar;
+        KsArray<KsLinkItem>  objlinks(anz);
+        KsLinkResult         lres;
+
+        if(objlinks.size() != anz) {
+            for(k = 0; k < anz; k++) {
+                results[i+k] = OV_ERR_HEAPOUTOFMEMORY;
+            }
+            lastErr = OV_ERR_HEAPOUTOFMEMORY;
+            continue;
+        }
+        for(k = 0; k < anz; k++) {
+            objlinks[k].link_path = linkPath[i+k].c_str();
+            objlinks[k].element_path = elemPath[i+k].c_str();
+            objlinks[k].place.hint = KS_PMH_END;
+        }
+        linkpar.items = objlinks;
+
+        bool ok = Server->requestByOpcode ( KS_LINK, GetClientAV(), linkpar, lres);
+        err = ifb_linkChunkResults(Server, ok, lres.result, lres.results,
+                                   i, anz, results);
+        if(err) {
+            lastErr = err;
+        }
+    }
+
+    return lastErr;
+}
+
+/*
+*  Unlink-Dienst fuer viele Elemente, wie ifb_createLinks()
+*/
+/*****************************************************************************/
+KS_RESULT ifb_deleteLinks(KscServerBase*            Server,
+                          std::vector<std::string>  &linkPath,
+                          std::vector<std::string>  &elemPath,
+                          std::vector<KS_RESULT>    &results)
+/*****************************************************************************/
+{
+    KS_RESULT   lastErr = KS_ERR_OK;
+    KS_RESULT   err;
+    size_t      batchSize = IFBS_GetDeleteBatchSize();
+    size_t      i, k, anz;
+
+    results.assign(linkPath.size(), KS_ERR_OK);
+    if(!Server) {
+        results.assign(linkPath.size(), KS_ERR_SERVERUNKNOWN);
+        return KS_ERR_SERVERUNKNOWN;
+    }
+    for(i = 0; i < linkPath.size(); i += anz) {
+        anz = linkPath.size() - i;
+        if(anz > batchSize) {
+            anz = batchSize;
+        }
+
+        KsUnlinkParams          unlinkpar;
+        KsArray<KsUnlinkItem>   unlinkit(anz);
+        KsUnlinkResult          ulres;
+
+        if(unlinkit.size() != anz) {
+            for(k = 0; k < anz; k++) {
+                results[i+k] = OV_ERR_HEAPOUTOFMEMORY;
+            }
+            lastErr = OV_ERR_HEAPOUTOFMEMORY;
+            continue;
+        }
+        for(k = 0; k < anz; k++) {
+            unlinkit[k].link_path = linkPath[i+k].c_str();
+            unlinkit[k].element_path = elemPath[i+k].c_str();
+        }
+        unlinkpar.items = unlinkit;
+
+        bool ok = Server->requestByOpcode ( KS_UNLINK, GetClientAV(), unlinkpar, ulres);
+        err = ifb_linkChunkResults(Server, ok, ulres.result, ulres.results,
+                                   i, anz, results);
+        if(err) {
+            lastErr = err;
+        }
+    }
+
+    return lastErr;
+}
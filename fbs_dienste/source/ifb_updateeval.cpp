@@ -94,6 +94,10 @@
         }
         plib = plib->next;
     }
+    if(Params->OldLibs) {
+        // Bibliotheken, Klassen und Assoziationen neu lesen
+        IFBS_InvalidateSession(Server, IFBS_SD_LIBDATA);
+    }
 
 ///////////////////////////////////////////////////////////////////////////////
 //  Neue Instanzen anlegen                                                   //
@@ -115,23 +119,63 @@
 
 
 
+/*****************************************************************************/
+size_t ifb_addInstanceValues(IfbsSetVarBatch& Batch,
+                             const char*      Inst_name,
+                             Variables*       Inst_var,
+                             int              isVendor)
+/*****************************************************************************/
+{
+    KsArray<KsSetVarItem>   items;
+    KsString                VarName;    // Merker : NAme der zu setzender Variable
+    size_t                  owner;      // Nummer der Instanz im Batch
+    size_t                  siz;
+    size_t                  i;
+    KS_RESULT               error;
+
+    owner = Batch.addOwner();
+    error = GetCreateObjectVar( Inst_var, items);
+    if(error) {
+        Batch.setResult(owner, error);
+        return owner;
+    }
+    siz = items.size();
+    for(i = 0; i < siz; i++) {
+        VarName = items[i].path_and_name;
+        items[i].path_and_name = Inst_name;
+        if(isVendor) {
+            // Trenner ist '/'. Der Variable wurde '.' hinzugefuegt
+            items[i].path_and_name += "/";
+            items[i].path_and_name += VarName.substr(1);
+        } else {
+            // Part-Variable. Trenner '.' bereits in Name
+            items[i].path_and_name += VarName;
+        }
+        Batch.add(owner, items[i]);
+    }
+    return owner;
+}
+
 /*****************************************************************************/
 int set_new_value(KscServerBase* Server, Dienst_param* Params,
                   PltString& out)
 /*****************************************************************************/
 {
-    KsSetVarParams          setpar(1);
-    KsSetVarResult          erg(1);
-    KscAvSimpleModule       *AV = GetClientAV();
+    /*
+    *  Die Variablen aller Instanzen werden gesammelt und mit wenigen
+    *  SetVar-Diensten gesetzt. Die Ergebnisse werden danach je Instanz in
+    *  der Reihenfolge der Liste gemeldet. Mit IFBS_SetSkipUnchanged(1)
+    *  werden Werte, die der Server schon hat, nicht geschrieben.
+    */
+    IfbsSetVarBatch         Batch(Server);
 
     SetInstVarItems         *pset;
     PltString               log;
+    char                    help[64];
     int                     error;
     int                     fehler = 0;
-    size_t                  siz;        // Merker : Anzahl zu setzenden Variablen
-    size_t                  i;          // Lauf-Variable
+    size_t                  owner;      // Nummer der Instanz im Batch
     KsString                VarName;    // Merker : NAme der zu setzender Variable
-    //char                    help[256];
     int                     isVendor = 0;
 
     if( !Params->Set_Inst_Var) {
@@ -149,38 +193,18 @@ int set_new_value(KscServerBase* Server, Dienst_param* Params,
         isVendor = 1;
     }
     
+    Batch.setSkipUnchanged(IFBS_GetSkipUnchanged() ? TRUE : FALSE);
     while(pset) {
-        error = GetCreateObjectVar( pset->Inst_var, setpar.items);
-        if(!error) {
-            siz = setpar.items.size();
-            for(i = 0; i < siz; i++) {
-                VarName = setpar.items[i].path_and_name;
-                setpar.items[i].path_and_name = pset->Inst_name;
-                if(isVendor) {
-                    // Trenner ist '/'. Der Variable wurde '.' hinzugefuegt
-                    setpar.items[i].path_and_name += "/";
-                    setpar.items[i].path_and_name += VarName.substr(1);
-                } else {
-                    // Part-Variable. Trenner '.' bereits in Name
-                    setpar.items[i].path_and_name += VarName;
-                }
-            }
-            bool ok = Server->requestByOpcode ( KS_SETVAR, AV, setpar, erg);
-            if(!ok) {
-                error = Server->getLastResult();
-                if(error == KS_ERR_OK) error = KS_ERR_GENERIC;
-            } else if(erg.result) {
-                error = erg.result;
-            } else {
-                siz = erg.results.size();
-                for(i = 0; i < siz; i++) {
-                    if( erg.results[i].result) {
-                        error = erg.results[i].result;
-                        break;
-                    }
-                }
-            }
-        }
+        ifb_addInstanceValues(Batch, pset->Inst_name, pset->Inst_var, isVendor);
+        pset = pset->next;
+    } /* while pset */ 
+    Batch.flush();
+
+    pset = Params->Set_Inst_Var;
+    owner = 0;
+    while(pset) {
+        error = Batch.getResult(owner);
+        owner++;
         if(error) {
             // Letzte Fehler-Kode merken
             fehler = error;
@@ -198,6 +222,11 @@ int set_new_value(KscServerBase* Server, Dienst_param* Params,
         pset = pset->next;
     } /* while pset */ 
 
+    if(IFBS_GetSkipUnchanged()) {
+        sprintf(help, "%lu", (unsigned long)Batch.getSkipped());
+        out += log_getOkMsg("Values", help, "unchanged, not written.");
+    }
+
     return fehler;
 
 } /* set_new_value() */
@@ -274,59 +303,73 @@ KS_RESULT unlink_old_link(KscServerBase* Server, Dienst_param* Params,
                           PltString& out)
 /*****************************************************************************/
 {
-    KS_RESULT               error;
-    LinksItems*             punlink;
-    Child*                  pch;
-    //char                    help[256];
-    PltString               Str;
-    FbLinkParams            Pars;
-    PltString               InpConLinkName("inputcon");
-    PltString               OutConLinkName("outputcon");
+    /*
+    *  Alle Kinder aller Links werden gesammelt und mit wenigen
+    *  Unlink-Diensten geloest. Die Ergebnisse werden danach in der
+    *  Reihenfolge der Liste gemeldet.
+    */
+    KS_RESULT                   error;
+    LinksItems*                 punlink;
+    Child*                      pch;
+    PltString                   Str;
+    std::string                 linkPath;
+    std::vector<std::string>    LinkPaths;
+    std::vector<std::string>    ElemPaths;
+    std::vector<KS_RESULT>      Results;
+    size_t                      i;
+    PltString                   InpConLinkName("inputcon");
+    PltString                   OutConLinkName("outputcon");
         
     if(!Params->UnLinks) {
         return 0;
     }
     
-    punlink = Params->UnLinks;
-    
-    while(punlink) {
+    for(punlink = Params->UnLinks; punlink; punlink = punlink->next) {
         // Connection-Links muessen nicht geloest werden
-        if( (InpConLinkName != punlink->child_role) &&
-            (OutConLinkName != punlink->child_role) ) {
-            
-            Pars.parent_path = punlink->parent_path;
-            Pars.parent_path += ".";
-            Pars.parent_path += punlink->child_role;
-            
-            pch = punlink->children;
-            
-            while(pch) {
-                Pars.elem_path = pch->child_path;
-                error = ifb_deleteLink(Server,Pars);
-                if(error) {
-                    out += log_getErrMsg(
-                        error,
-                        "Parent",   punlink->parent_path,
-                        "und Child",pch->child_path,
-                        "couldn't be unlinked.");
-               
-                    Str = "\"%s %s\"  \"";
-                    Str += punlink->parent_path;
-                    Str += "\" \"";
-                    Str += pch->child_path;
-                    Str += "\"";
-               
-                    iFBS_SetLastError(1, error, Str);
-                } else {
-                    out += log_getOkMsg(
-                        "Parent",punlink->parent_path,
-                        "and Child",pch->child_path,"unlinked");
-                }
-                pch = pch->next;
+        if( (InpConLinkName == punlink->child_role) ||
+            (OutConLinkName == punlink->child_role) ) {
+            continue;
+        }
+        linkPath  = punlink->parent_path;
+        linkPath += ".";
+        linkPath += punlink->child_role;
+        for(pch = punlink->children; pch; pch = pch->next) {
+            LinkPaths.push_back(linkPath);
+            ElemPaths.push_back(pch->child_path);
+        }
+    }
+    ifb_deleteLinks(Server, LinkPaths, ElemPaths, Results);
+
+    i = 0;
+    for(punlink = Params->UnLinks; punlink; punlink = punlink->next) {
+        if( (InpConLinkName == punlink->child_role) ||
+            (OutConLinkName == punlink->child_role) ) {
+            continue;
+        }
+        for(pch = punlink->children; pch; pch = pch->next) {
+            error = Results[i];
+            i++;
+            if(error) {
+                out += log_getErrMsg(
+                    error,
+                    "Parent",   punlink->parent_path,
+                    "und Child",pch->child_path,
+                    "couldn't be unlinked.");
+           
+                Str = "\"%s %s\"  \"";
+                Str += punlink->parent_path;
+                Str += "\" \"";
+                Str += pch->child_path;
+                Str += "\"";
+           
+                iFBS_SetLastError(1, error, Str);
+            } else {
+                out += log_getOkMsg(
+                    "Parent",punlink->parent_path,
+                    "and Child",pch->child_path,"unlinked");
             }
-            punlink = punlink->next;
-        } /* Keine Connection-Links */
-    } /* while punlink */
+        }
+    } /* for punlink */
 
     return KS_ERR_OK;
 
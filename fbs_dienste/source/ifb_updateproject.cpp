@@ -40,23 +40,6 @@
 */
 #include "ifbslibdef.h"
 
-/*
-*        globale Variablen
-*        -----------------
-*/
-//extern Dienst_param*         ppar;
-
-//extern int                 yydebug;
-//extern int                 current_line;
-//extern FILE*         yyin;
-
-/*
-*        Funktionsprototypen
-*        -------------------
-*/
-int yyparse(void);
-extern "C" void InitInputFileStream(FILE*);
-
 /*
 *   Hauptprogramm
 *        -------------
@@ -74,11 +57,9 @@ KS_RESULT  IFBS_DBUPDATE(KscServerBase *Server,
         int error;
         int PROTOFILE = 0;
 
-        yydebug = 0;
-        current_line = 0;
-
     PltString Str;
     FILE           *yyout = 0;
+    FB_PARSE_CONTEXT *ctx;      // Parse-Sitzung
     
     if(!Server) {
         return KS_ERR_SERVERUNKNOWN;
@@ -95,8 +76,17 @@ KS_RESULT  IFBS_DBUPDATE(KscServerBase *Server,
             PROTOFILE = 1;
     }
 
-    yyin = fopen((const char*)datei, "r");
-    if(!yyin) {
+    ctx = fb_parser_create();
+    if(!ctx) {
+            if(PROTOFILE) {
+                fclose(yyout);
+            }
+        return OV_ERR_HEAPOUTOFMEMORY;
+    }
+
+    // Datei in den Speicher einblenden
+    if(!fb_parser_openfile(ctx, (const char*)datei)) {
+            fb_parser_destroy(ctx);
             if(PROTOFILE) {
                 fclose(yyout);
             }
@@ -133,39 +123,18 @@ fflush(yyout);
 }
 ///////////////////////////////////////////////////////////////////////////////
 
-        ppar = (Dienst_param*)malloc(sizeof(Dienst_param));
-        if(!ppar) {
-                if(PROTOFILE) {
-                        fclose(yyout);
-                }
-                return OV_ERR_HEAPOUTOFMEMORY;
-        }
-
-        ppar->Instance = 0;
-        ppar->Set_Inst_Var = 0;
-        ppar->DelInst = 0;
-        ppar->OldLibs = 0;
-        ppar->NewLibs = 0;
-        ppar->Links = 0;
-        ppar->UnLinks = 0;
-
         /*
         *   Eingabe parsen
         */
-        Str = "";
-    iFBS_PrintParserError(1, Str); /* LastError loeschen */
-
-    InitInputFileStream(yyin);
-
-        exit_status = yyparse();
-        fclose(yyin);
+        exit_status = IFBS_ParseInput(ctx);
 
         /*
         *        Ausgabe erzeugen
         */
         if(exit_status != EXIT_SUCCESS) {
+                iFBS_SetParserError(ctx);
                 if(PROTOFILE) {
-                    Str = IFBS_GetParserError();
+                    Str = IFBS_GetParserError(ctx);
                     if( Str == "" ) {
                         fprintf(yyout, "%s",
                             (const char*)log_getErrMsg(
@@ -182,23 +151,26 @@ fflush(yyout);
                     }
                     fclose(yyout);
                 }
-        memfre(ppar);
-        free(ppar);
-        fb_parser_freestrings();
+        fb_parser_destroy(ctx);
         return KS_ERR_BADPARAM;
     }
 
     Str = "";
-    error = update_eval(Server, ppar, Str);
+    // Server-Daten nur einmal je Aktualisierung lesen
+    IfbsSession *pses = IFBS_OpenSession(Server);
+    error = update_eval(Server, ctx->par, Str);
+    if(error) {
+        // Bei Fehler wurden eventuell Bibliotheken wieder geloescht
+        IFBS_InvalidateSession(Server, IFBS_SD_LIBDATA);
+    }
+    IFBS_CloseSession(pses);
 
     if(PROTOFILE) {
        fputs((const char*)Str, yyout);
            fclose(yyout);
     }
     
-    memfre(ppar);
-    free(ppar);
-    fb_parser_freestrings();
+    fb_parser_destroy(ctx);
 
     return error;
 }